@@ -0,0 +1,129 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: Animation.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+ /// \brief Jerarquía de articulaciones de una malla con skinning.
+ /// \details Las articulaciones están ordenadas de forma que el padre siempre
+ /// precede al hijo, lo que permite resolver la jerarquía en una sola pasada.
+struct Skeleton
+{
+    /// Índice del padre de cada articulación (-1 para la raíz).
+    std::vector<int32_t> parents;
+
+    /// Inversa de la transformación de cada articulación en la pose de reposo.
+    std::vector<glm::mat4> inverseBind;
+
+    /// \brief Número de articulaciones.
+    uint32_t jointCount() const
+    {
+        return (static_cast<uint32_t>(parents.size()));
+    }
+};
+
+/// \brief Poses locales de un lote de personajes en formato SoA (una componente por array).
+/// \details Los canales se indexan por <tt>joint * characterStride + character</tt>:
+/// la misma articulación de personajes consecutivos es contigua, de modo que el
+/// muestreo procesa varios personajes por instrucción SIMD.
+struct PoseBatch
+{
+    /// Personajes por línea de caché de un canal (16 floats = 64 bytes).
+    static constexpr uint32_t CACHE_LINE_CHARACTERS = 16;
+
+    /// Articulaciones por personaje.
+    uint32_t jointCount = 0;
+    /// Personajes del lote.
+    uint32_t characterCount = 0;
+    /// Separación entre articulaciones en los canales: \c characterCount redondeado a
+    /// \c CACHE_LINE_CHARACTERS, para que tramos de personajes múltiplos de 16
+    /// no compartan líneas de caché entre hebras.
+    uint32_t characterStride = 0;
+
+    /// Traslación local.
+    std::vector<float> tx, ty, tz;
+    /// Rotación local (cuaternión x, y, z, w).
+    std::vector<float> rx, ry, rz, rw;
+
+    /// \brief Redimensiona todos los canales.
+    /// \param joints Número de articulaciones.
+    /// \param characters Número de personajes.
+    void resize(uint32_t joints, uint32_t characters);
+
+    /// \brief Posición de una articulación de un personaje en los canales.
+    size_t index(uint32_t joint, uint32_t character) const
+    {
+        return (size_t(joint) * characterStride + character);
+    }
+};
+
+/// \brief Clip de animación muestreado a frecuencia constante y en bucle.
+/// \details Los canales se guardan en SoA indexados por
+/// <tt>key * jointCount + joint</tt>: las claves de un mismo instante son contiguas.
+struct AnimationClip
+{
+    /// Claves por segundo.
+    float sampleRate = 30.0f;
+    /// Número de claves (el clip vuelve a la clave 0 tras la última).
+    uint32_t keyCount = 0;
+    /// Articulaciones animadas.
+    uint32_t jointCount = 0;
+
+    /// Traslación local por clave y articulación.
+    std::vector<float> tx, ty, tz;
+    /// Rotación local (cuaternión) por clave y articulación.
+    std::vector<float> rx, ry, rz, rw;
+
+    /// \brief Duración del bucle en segundos.
+    float duration() const
+    {
+        return ((sampleRate > 0.0f) ? static_cast<float>(keyCount) / sampleRate : 0.0f);
+    }
+};
+
+/// \brief Muestreo de clips y cálculo de la paleta de skinning en CPU.
+class AnimationSampler
+{
+public:
+    /// \brief Muestrea un clip para los personajes [begin, end) de un lote.
+    /// \details Interpola linealmente traslaciones y hace nlerp de rotaciones entre
+    /// las dos claves que rodean a cada instante. Con SSE cada carril es un personaje
+    /// distinto en la misma articulación, así que los grupos de cuatro personajes
+    /// llenan los registros sea cual sea el número de articulaciones; el resto del
+    /// tramo se hace en escalar. Sólo se escriben los personajes del tramo, así que
+    /// varias hebras pueden muestrear tramos disjuntos del mismo lote.
+    /// \param clip Clip a muestrear.
+    /// \param times Instante (s) de cada personaje del lote.
+    /// \param begin Primer personaje.
+    /// \param end Personaje final (excluido).
+    /// \param poses Salida (ya dimensionada con \c clip.jointCount articulaciones).
+    static void sampleBatch(
+        const AnimationClip& clip,
+        const float* times,
+        uint32_t begin,
+        uint32_t end,
+        PoseBatch& poses);
+
+    /// \brief Resuelve la jerarquía y produce las matrices de skinning.
+    /// \param skeleton Esqueleto (padres antes que hijos).
+    /// \param poses Lote de poses locales muestreadas.
+    /// \param character Personaje del lote.
+    /// \param skinMatrices Salida: \c jointCount matrices (modelo * inversa de reposo).
+    static void computeSkinMatrices(
+        const Skeleton& skeleton,
+        const PoseBatch& poses,
+        uint32_t character,
+        glm::mat4* skinMatrices);
+};
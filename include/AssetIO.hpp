@@ -0,0 +1,203 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AssetIO.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct io_uring;
+
+ /// \brief Implementación usada por \c AssetIO para leer ficheros.
+enum class AssetIOBackend
+{
+    /// Hebras que leen cada fichero con llamadas bloqueantes (disponible siempre).
+    ThreadPool,
+    /// Cola de envío/finalización de io_uring (Linux con liburing).
+    IoUring
+};
+
+/// \brief Resultado de una lectura, entregado al callback de la petición.
+struct AssetReadResult
+{
+    /// Ruta leída.
+    std::string path;
+    /// Contenido del fichero si la petición no indicó \c destination.
+    std::vector<char> data;
+    /// Tamaño del fichero (bytes).
+    uint64_t size = 0;
+    /// \c true si se leyó el fichero completo.
+    bool ok = false;
+    /// Descripción del error si \c ok es \c false.
+    std::string error;
+};
+
+/// \brief Petición de lectura de un fichero completo.
+struct AssetReadRequest
+{
+    /// Ruta del fichero (tal cual, sin prefijos).
+    std::string path;
+    /// Memoria destino (p.ej., un \c VulkanBuffer de staging mapeado); si es
+    /// \c nullptr el contenido se devuelve en \c AssetReadResult::data.
+    void* destination = nullptr;
+    /// Bytes disponibles en \c destination.
+    uint64_t capacity = 0;
+    /// Se invoca desde una hebra de E/S al terminar (con éxito o no).
+    std::function<void(AssetReadResult&)> onComplete;
+};
+
+/// \brief Conjunto de lecturas enviadas juntas con \c AssetIO::submit.
+class AssetBatch
+{
+public:
+    /// \brief Espera a que terminen todas las lecturas (y sus callbacks).
+    /// \details Lanza \c std::runtime_error con el primer error si alguna falló.
+    void wait();
+
+    /// \brief Indica si ya han terminado todas las lecturas.
+    bool isDone();
+
+private:
+    friend class AssetIO;
+
+    /// \brief Marca una lectura como terminada.
+    /// \param error Mensaje de error (vacío si tuvo éxito).
+    void complete(const std::string& error);
+
+    /// Protege el estado del lote.
+    std::mutex mutex;
+    /// Despierta a quien espera en \c wait.
+    std::condition_variable done;
+    /// Lecturas pendientes.
+    size_t remaining = 0;
+    /// Primer error registrado.
+    std::string firstError;
+};
+
+/// \brief Capa de lectura asíncrona de ficheros del motor.
+/// \details Las peticiones se agrupan en lotes; cada fichero se lee en bloques de
+/// \c CHUNK_SIZE y, con io_uring, hasta \c queueDepth bloques de varios ficheros
+/// quedan en vuelo a la vez, lo que permite mantener ocupada una unidad NVMe
+/// desde una sola hebra. Sin io_uring (otras plataformas, o si el kernel no lo
+/// permite) se usa un conjunto de hebras con lecturas bloqueantes. Los callbacks
+/// se ejecutan en las hebras de E/S y deben ser breves y seguros entre hebras.
+class AssetIO
+{
+public:
+    /// Tamaño de cada lectura individual (bytes).
+    static constexpr uint64_t CHUNK_SIZE = 1ull << 20;
+
+    /// \brief Crea la cola de E/S y sus hebras.
+    /// \param preferred Implementación preferida; si no está disponible se usa \c ThreadPool.
+    /// \param threadCount Hebras del \c ThreadPool.
+    /// \param queueDepth Lecturas en vuelo con io_uring.
+    explicit AssetIO(
+        AssetIOBackend preferred = AssetIOBackend::IoUring,
+        uint32_t threadCount = 4,
+        uint32_t queueDepth = 64);
+
+    /// \brief Detiene las hebras; las peticiones no iniciadas terminan con error.
+    ~AssetIO();
+
+    AssetIO(const AssetIO&) = delete;
+    AssetIO& operator=(const AssetIO&) = delete;
+
+    /// \brief Encola un lote de lecturas.
+    /// \param requests Peticiones del lote.
+    /// \return Lote sobre el que esperar.
+    std::shared_ptr<AssetBatch> submit(std::vector<AssetReadRequest> requests);
+
+    /// \brief Implementación en uso.
+    AssetIOBackend getBackend() const
+    {
+        return (backend);
+    }
+
+    /// \brief Bytes leídos desde la creación.
+    uint64_t getBytesRead() const
+    {
+        return (bytesRead.load());
+    }
+
+    /// \brief Lecturas individuales (bloques) completadas desde la creación.
+    uint64_t getReadCount() const
+    {
+        return (readCount.load());
+    }
+
+    /// \brief Nombre legible de una implementación.
+    static const char* backendName(AssetIOBackend backend);
+
+    /// \brief Mide MB/s e IOPS leyendo todos los ficheros de \c directories.
+    /// \details Lee los ficheros en un único bloque de memoria (como lo haría
+    /// una subida a staging) con cada implementación disponible. En Linux se
+    /// pide al kernel que descarte sus páginas en caché antes de cada pasada.
+    /// \param directories Carpetas a recorrer recursivamente.
+    /// \param out Flujo donde se escribe el informe.
+    static void benchmark(const std::vector<std::string>& directories, std::ostream& out);
+
+private:
+    /// \brief Petición encolada junto a su lote.
+    struct Job
+    {
+        /// Petición original.
+        AssetReadRequest request;
+        /// Lote al que pertenece.
+        std::shared_ptr<AssetBatch> batch;
+    };
+
+    /// \brief Bucle de una hebra del \c ThreadPool.
+    void poolLoop();
+
+    /// \brief Bucle de la hebra que gestiona el anillo de io_uring.
+    void ringLoop();
+
+    /// \brief Entrega el resultado de una petición y la marca como terminada.
+    /// \param job Petición terminada.
+    /// \param result Resultado (se mueve al callback).
+    void finish(Job& job, AssetReadResult& result);
+
+    /// Implementación en uso.
+    AssetIOBackend backend = AssetIOBackend::ThreadPool;
+
+    /// Lecturas en vuelo con io_uring.
+    uint32_t queueDepth = 64;
+
+    /// Anillo de io_uring (sólo con \c IoUring).
+    io_uring* ring = nullptr;
+
+    /// Protege \c jobs y \c stopping.
+    std::mutex mutex;
+
+    /// Despierta a las hebras de E/S.
+    std::condition_variable wakeUp;
+
+    /// Peticiones aún no iniciadas.
+    std::deque<Job> jobs;
+
+    /// Indica a las hebras que deben terminar.
+    bool stopping = false;
+
+    /// Hebras de E/S.
+    std::vector<std::thread> threads;
+
+    /// Bytes leídos.
+    std::atomic<uint64_t> bytesRead {0};
+
+    /// Lecturas completadas.
+    std::atomic<uint64_t> readCount {0};
+};
@@ -0,0 +1,108 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AsyncCompute.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Perf.hpp"
+#include "VulkanDevice.hpp"
+
+#include <cstdint>
+#include <vector>
+
+ /// \brief Envíos de cómputo por frame a una cola de cómputo dedicada.
+ /// \details Cada frame en vuelo tiene su command buffer en la familia de cómputo. Los
+ /// pases que sólo usan cómputo (simulación de partículas, etc.) se graban en él con
+ /// \c begin y se envían con \c submit, que señaliza un semáforo de línea temporal y
+ /// devuelve la espera que debe añadirse al envío de gráficos del mismo frame. Así el
+ /// cómputo del frame N avanza mientras la cola de gráficos termina el frame N-1.
+ /// Los pases deben escribir en recursos que el render del frame anterior no lea
+ /// (p.ej., duplicados por frame en vuelo). Si el dispositivo no tiene cola de cómputo
+ /// dedicada o semáforos de línea temporal, \c begin devuelve \c VK_NULL_HANDLE y los
+ /// pases se graban en el command buffer de gráficos.
+class AsyncCompute
+{
+public:
+    /// \brief Crea el command pool, los command buffers, el semáforo y las consultas.
+    /// \param device Dispositivo Vulkan.
+    /// \param framesInFlight Número de frames en vuelo.
+    /// \param allowed Permite usar la cola dedicada (\c false fuerza el camino en serie).
+    AsyncCompute(VulkanDevice& device, uint32_t framesInFlight, bool allowed = true);
+
+    /// \brief Libera los recursos (la cola debe estar inactiva).
+    ~AsyncCompute();
+
+    AsyncCompute(const AsyncCompute&) = delete;
+    AsyncCompute& operator=(const AsyncCompute&) = delete;
+
+    /// \brief Indica si el cómputo se envía a una cola dedicada.
+    bool isEnabled() const
+    {
+        return (enabled);
+    }
+
+    /// \brief Empieza a grabar el cómputo del frame.
+    /// \details Antes de reutilizar el command buffer mide el solape de su envío
+    /// anterior con el render del frame que lo precedió.
+    /// \param frameIndex Índice de frame en vuelo.
+    /// \param perf Métricas con los timestamps de los frames de gráficos.
+    /// \return Command buffer de cómputo, o \c VK_NULL_HANDLE si no hay cola dedicada.
+    VkCommandBuffer begin(uint32_t frameIndex, const Perf& perf);
+
+    /// \brief Cierra y envía el cómputo del frame.
+    /// \param frameIndex Índice de frame en vuelo.
+    /// \return Espera que el envío de gráficos del frame debe añadir.
+    TimelineWait submit(uint32_t frameIndex);
+
+    /// \brief Último solape medido.
+    const AsyncComputeStats& getStats() const
+    {
+        return (stats);
+    }
+
+private:
+    /// \brief Lee los timestamps del envío anterior de \c frameIndex y actualiza \c stats.
+    /// \param frameIndex Índice de frame en vuelo.
+    /// \param perf Métricas con los timestamps de los frames de gráficos.
+    void measureOverlap(uint32_t frameIndex, const Perf& perf);
+
+    /// Dispositivo Vulkan.
+    VulkanDevice& device;
+
+    /// Frames en vuelo.
+    uint32_t framesInFlight = 0;
+
+    /// Hay cola dedicada en uso.
+    bool enabled = false;
+
+    /// Command pool de la familia de cómputo.
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+
+    /// Un command buffer por frame en vuelo.
+    std::vector<VkCommandBuffer> commandBuffers;
+
+    /// Semáforo de línea temporal señalizado por cada envío.
+    VkSemaphore timeline = VK_NULL_HANDLE;
+
+    /// Último valor señalizado.
+    uint64_t lastValue = 0;
+
+    /// Valor señalizado por el último envío de cada frame en vuelo.
+    std::vector<uint64_t> frameValues;
+
+    /// Timestamps de inicio/fin por frame en vuelo (nulo si la familia no los admite).
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+
+    /// Las consultas se reinician desde la CPU.
+    bool hostReset = false;
+
+    /// Conversión de ticks a nanosegundos.
+    double timestampPeriodNs = 1.0;
+
+    /// Último solape medido.
+    AsyncComputeStats stats {};
+};
@@ -0,0 +1,152 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AsyncScheduler.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "AssetIO.hpp"
+#include "Task.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+ /// \brief Conjunto de hebras que reanudan corrutinas \c Task.
+ /// \details Las esperas (\c schedule, \c readFile, \c UploadQueue::wait) no bloquean
+ /// ninguna hebra: la corrutina queda suspendida y, cuando el evento llega (callback de
+ /// \c AssetIO, semáforo de la GPU), su manejador se encola aquí y la reanuda una
+ /// hebra trabajadora. Así un proceso de carga se escribe de forma secuencial
+ /// (leer, parsear, subir, esperar) y varios procesos se solapan entre sí.
+class AsyncScheduler
+{
+public:
+    /// \brief Espera que traslada la corrutina a una hebra del planificador.
+    struct ScheduleAwaiter
+    {
+        AsyncScheduler& scheduler;
+
+        bool await_ready() const noexcept
+        {
+            return (false);
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.post(handle);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    /// \brief Espera que lee un fichero completo con \c AssetIO.
+    /// \details La corrutina se reanuda en una hebra del planificador; si la lectura
+    /// falla, \c co_await lanza \c std::runtime_error.
+    struct ReadAwaiter
+    {
+        AsyncScheduler& scheduler;
+        AssetIO& io;
+        std::string path;
+        AssetReadResult result;
+
+        bool await_ready() const noexcept
+        {
+            return (false);
+        }
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        std::vector<char> await_resume();
+    };
+
+    /// \brief Crea las hebras trabajadoras.
+    /// \param workerCount Número de hebras (mínimo 1).
+    /// \param cpus CPUs a las que fijar las hebras (vacío = sin afinidad).
+    explicit AsyncScheduler(uint32_t workerCount = 2, std::vector<uint32_t> cpus = {});
+
+    /// \brief Detiene las hebras. Las tareas lanzadas deben haber terminado (\c waitIdle).
+    ~AsyncScheduler();
+
+    AsyncScheduler(const AsyncScheduler&) = delete;
+    AsyncScheduler& operator=(const AsyncScheduler&) = delete;
+
+    /// \brief \c co_await continúa la corrutina en una hebra del planificador.
+    ScheduleAwaiter schedule()
+    {
+        return (ScheduleAwaiter {*this});
+    }
+
+    /// \brief \c co_await lee \p path y devuelve su contenido.
+    /// \param io Lector de ficheros que atiende la petición.
+    /// \param path Ruta del fichero.
+    ReadAwaiter readFile(AssetIO& io, const std::string& path)
+    {
+        return (ReadAwaiter {*this, io, path, {}});
+    }
+
+    /// \brief Encola una corrutina suspendida para que la reanude una hebra trabajadora.
+    /// \param handle Corrutina a reanudar.
+    void post(std::coroutine_handle<> handle);
+
+    /// \brief Lanza una tarea sin esperar a su resultado.
+    /// \details La tarea empieza en una hebra trabajadora; su excepción, si la hay,
+    /// se relanza en \c waitIdle.
+    /// \param task Tarea a ejecutar.
+    void spawn(Task<void> task);
+
+    /// \brief Bloquea hasta que terminan todas las tareas lanzadas con \c spawn.
+    /// \details Relanza la primera excepción producida por alguna de ellas.
+    void waitIdle();
+
+private:
+    /// \brief Corrutina sin dueño que ejecuta una tarea lanzada con \c spawn.
+    struct Detached;
+
+    /// \brief Cuerpo de las tareas lanzadas con \c spawn.
+    static Detached run(AsyncScheduler& scheduler, Task<void> task);
+
+    /// \brief Registra el final de una tarea lanzada.
+    /// \param error Excepción producida por la tarea (nula si terminó bien).
+    void finish(std::exception_ptr error);
+
+    /// \brief Bucle de las hebras trabajadoras.
+    void workerLoop();
+
+    /// CPUs a las que se fijan las hebras trabajadoras.
+    std::vector<uint32_t> cpus;
+
+    /// Hebras trabajadoras.
+    std::vector<std::thread> workers;
+
+    /// Protege la cola y los contadores.
+    std::mutex mutex;
+
+    /// Despierta a las hebras trabajadoras.
+    std::condition_variable wakeUp;
+
+    /// Avisa a \c waitIdle cuando no quedan tareas.
+    std::condition_variable idle;
+
+    /// Corrutinas listas para reanudarse.
+    std::deque<std::coroutine_handle<>> ready;
+
+    /// Tareas lanzadas que aún no han terminado.
+    size_t outstanding = 0;
+
+    /// Primera excepción producida por una tarea lanzada.
+    std::exception_ptr failure;
+
+    /// Indica a las hebras que deben terminar.
+    bool stopping = false;
+};
@@ -12,13 +12,48 @@
 #include "GraphicsPipeline.hpp"
 #include "VulkanDevice.hpp"
 
+#include <array>
 #include <memory>
+#include <vector>
 
- /// \brief Sistema de renderizado bsico para geometra opaca.
+ /// \brief Visualizacin de depuracin de la geometra opaca.
+enum class DebugView : uint32_t
+{
+    /// Sombreado normal.
+    Off = 0,
+    /// Mapa de calor de fragmentos sombreados por pxel (mezcla aditiva).
+    Overdraw,
+    /// Mapa de calor de luces evaluadas por pxel (oscuro si no llegan al pxel).
+    LightCount,
+    /// Un color por malla; los impostores conservan su aspecto.
+    Lod,
+    /// Sombreado normal ms las cajas envolventes (verde: malla, amarillo: impostor,
+    /// rojo: descartada por el culling de frustum).
+    Bounds
+};
+
+/// \brief Variante del bucle de grabacin de \c BasicRenderer.
+/// \details Cada combinacin se compila como un bucle propio y se elige una vez por
+/// frame en \c BasicRenderer::prepareRecording.
+struct RecordVariant
+{
+    /// Descarta los objetos cuya esfera envolvente queda fuera del frustum de la cmara.
+    bool culling = false;
+    /// Ordena los objetos por malla y omite \c Model::bind si la malla no cambia.
+    bool bindElision = true;
+    /// Usa el bucle especializado en compilacin; si es \c false, uno genrico que
+    /// comprueba las opciones en cada objeto (referencia para las mediciones).
+    bool specialized = true;
+};
+
+/// \brief Sistema de renderizado bsico para geometra opaca.
  /// \details Encapsula la creacin del \c VkPipelineLayout y del \c GraphicsPipeline
  /// asociado al \c VkRenderPass principal. Proporciona el mtodo \c render
  /// para emitir las draw calls de la escena empleando los recursos globales
  /// (descriptor set con UBO, etc.) definidos en \c FrameInfo.
+ /// Si el dispositivo admite aritmtica y varyings de 16 bits se crea adems una
+ /// variante de media precisin de los shaders (\c simple_shader_fp16), que pasa a
+ /// ser la activa; \c setHalfPrecision permite volver a la de 32 bits.
 class BasicRenderer
 {
     public:
@@ -40,21 +75,140 @@ class BasicRenderer
         BasicRenderer& operator=(const BasicRenderer&) = delete;
 
         /// \brief Renderiza la escena para el frame actual.
-        /// \details Enlaza el pipeline, configura los descriptor sets globales
-        /// y emite las draw calls sobre los objetos disponibles en \c frameInfo.
+        /// \details Prepara la grabacin y graba todos los objetos en el command buffer
+        /// principal de \c frameInfo (camino de una sola hebra).
         /// \param frameInfo Contexto del frame (command buffer, descriptor set, cmara, etc.).
         void render(FrameInfo& frameInfo);
 
-        /// \brief Graba draw calls de un rango [begin, end) de gameObjects en un command buffer 
+        /// \brief Prepara la grabacin del frame.
+        /// \details Rene una sola vez los objetos con malla que no sustituye un impostor
+        /// (ordenados por malla si se omiten enlaces redundantes), extrae el frustum de la
+        /// cmara si hay culling y elige el bucle de grabacin de la variante y la
+        /// visualizacin activas. Debe llamarse desde la hebra principal antes de
+        /// repartir \c recordRange entre hebras.
+        /// \param frameInfo Contexto del frame.
+        void prepareRecording(FrameInfo& frameInfo);
+
+        /// \brief Objetos preparados para grabar (lmite de los rangos de \c recordRange).
+        size_t getRecordCount() const
+        {
+            return (drawList.size());
+        }
+
+        /// \brief Graba draw calls de un rango [begin, end) de objetos en un command buffer 
         /// ya iniciado.
         /// \param frameInfo Contexto del frame.
         /// \param cbSec Command buffer secundario ya comenzado con inheritance correcto.
-        /// \param begin ndice inicial (incluido) dentro de la vista de objetos a dibujar.
+        /// \param begin ndice inicial (incluido) dentro de la lista preparada.
         /// \param end   ndice final (excluido).
-        void recordRange(FrameInfo& frameInfo, VkCommandBuffer cbSec, size_t begin, size_t end);
+        /// \return Draws grabados (menos que el rango si hay culling).
+        /// \pre \c prepareRecording se ha llamado en este frame.
+        uint32_t recordRange(FrameInfo& frameInfo, VkCommandBuffer cbSec, size_t begin, size_t end);
+
+        /// \brief Selecciona la variante del bucle de grabacin.
+        /// \details Se aplica en el siguiente \c prepareRecording.
+        /// \param variant Opciones del bucle.
+        void setRecordVariant(const RecordVariant& variant)
+        {
+            recordVariant = variant;
+        }
+
+        /// \brief Variante del bucle de grabacin.
+        const RecordVariant& getRecordVariant() const
+        {
+            return (recordVariant);
+        }
+
+        /// \brief Indica si existe la variante de media precisin.
+        bool supportsHalfPrecision() const
+        {
+            return (halfPipeline != nullptr);
+        }
+
+        /// \brief Selecciona la variante de shaders para los siguientes draws.
+        /// \param enabled \c true para fp16 (se ignora si no est disponible).
+        void setHalfPrecision(bool enabled)
+        {
+            useHalfPrecision = enabled && supportsHalfPrecision();
+        }
+
+        /// \brief Indica si la variante activa es la de media precisin.
+        bool isHalfPrecision() const
+        {
+            return (useHalfPrecision);
+        }
+
+        /// \brief Selecciona la visualizacin de depuracin de los siguientes draws.
+        /// \details Crea la tubera de la variante la primera vez que se pide, de modo
+        /// que las que no se usan no cuestan ni memoria ni tiempo de arranque. Debe
+        /// llamarse desde la hebra principal, antes de grabar el frame.
+        /// \param view Visualizacin a usar.
+        void setDebugView(DebugView view);
+
+        /// \brief Visualizacin de depuracin activa.
+        DebugView getDebugView() const
+        {
+            return (debugView);
+        }
+
+        /// \brief Dibuja las cajas envolventes de los objetos con malla.
+        /// \details Slo hace algo con \c DebugView::Bounds; debe grabarse dentro del
+        /// render pass principal, despus de la geometra. Con culling, las mallas que
+        /// quedan fuera del frustum de \c prepareRecording se marcan aparte.
+        /// \param frameInfo Contexto del frame.
+        void renderBounds(FrameInfo& frameInfo);
+
+        /// \brief Nombre legible de una visualizacin.
+        /// \param view Visualizacin a describir.
+        static const char* debugViewName(DebugView view);
 
 
     private:
+        /// \brief Planos del frustum (\c xyz normal hacia dentro, \c w distancia).
+        using Frustum = std::array<glm::vec4, 6>;
+
+        /// \brief Puntero a una instancia del bucle de grabacin.
+        using RecordLoop = uint32_t (BasicRenderer::*)(VkCommandBuffer, size_t, size_t);
+
+        /// \brief Bucle de grabacin de un rango de \c drawList.
+        /// \details Las opciones de \p policy son constantes en las instancias de
+        /// \c StaticRecordPolicy, as que el compilador elimina las ramas que no aplican
+        /// y cada variante queda como un bucle propio sin comprobaciones por objeto.
+        /// \param policy Opciones del bucle.
+        /// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+        /// \param begin ndice inicial (incluido).
+        /// \param end ndice final (excluido).
+        /// \return Draws grabados.
+        template <typename Policy>
+        uint32_t recordObjects(const Policy& policy, VkCommandBuffer commandBuffer, size_t begin, size_t end);
+
+        /// \brief Bucle especializado para las opciones de \p Policy.
+        /// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+        /// \param begin ndice inicial (incluido).
+        /// \param end ndice final (excluido).
+        /// \return Draws grabados.
+        template <typename Policy>
+        uint32_t recordSpecialized(VkCommandBuffer commandBuffer, size_t begin, size_t end);
+
+        /// \brief Bucle genrico: las opciones se comprueban en cada objeto.
+        /// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+        /// \param begin ndice inicial (incluido).
+        /// \param end ndice final (excluido).
+        /// \return Draws grabados.
+        uint32_t recordGeneric(VkCommandBuffer commandBuffer, size_t begin, size_t end);
+
+        /// \brief Extrae los planos del frustum de una matriz proyeccin * vista.
+        /// \param viewProjection Matriz a descomponer (profundidad en [0, 1]).
+        /// \return Planos normalizados (\c xyz normal hacia dentro, \c w distancia).
+        static Frustum extractFrustum(const glm::mat4& viewProjection);
+
+        /// \brief Comprueba si una esfera toca el frustum.
+        /// \param planes Planos del frustum.
+        /// \param center Centro de la esfera en mundo.
+        /// \param radius Radio de la esfera.
+        /// \return \c true si no queda completamente fuera de algn plano.
+        static bool sphereInFrustum(const Frustum& planes, const glm::vec3& center, float radius);
+
         /// \brief Crea el \c VkPipelineLayout en funcin del layout de descriptores global.
         /// \param globalDescriptorSetLayout Layout del descriptor set global 
         /// (binding de UBO, texturas, ...).
@@ -62,16 +216,72 @@ class BasicRenderer
         void createPipelineLayout(VkDescriptorSetLayout globalDescriptorSetLayout);
 
         /// \brief Crea el \c GraphicsPipeline asociado al \c renderPass.
+        /// \details Tambin crea la variante fp16 si el dispositivo la admite.
         /// \param renderPass Render pass donde se usar este pipeline.
         /// \pre Requiere que \c pipelineLayout haya sido creado.
         void createGraphicsPipeline(VkRenderPass renderPass);
 
+        /// \brief Crea la tubera de una visualizacin de depuracin.
+        /// \param view Visualizacin (distinta de \c Off y \c Bounds).
+        /// \return Tubera creada.
+        std::unique_ptr<GraphicsPipeline> createDebugPipeline(DebugView view);
+
+        /// \brief Pipeline de la variante activa.
+        GraphicsPipeline& activePipeline()
+        {
+            if (debugPipeline != nullptr)
+            {
+                return (*debugPipeline);
+            }
+
+            return (useHalfPrecision ? *halfPipeline : *pipeline);
+        }
+
+        /// \brief Escribe el color de depuracin de un draw en las push constants.
+        /// \param object Objeto a dibujar.
+        /// \param normalMatrix Matriz de normales del draw (su ltima columna no la
+        /// usan los shaders de iluminacin).
+        void writeDebugColor(const GameObject& object, glm::mat4& normalMatrix) const;
+
         /// Dispositivo Vulkan usado para crear/gestionar recursos.
         VulkanDevice& device;
 
+        /// Render pass de destino (para crear las variantes de depuracin bajo demanda).
+        VkRenderPass renderPass;
+
         /// Pipeline grfico para el pass de geometra bsica.
         std::unique_ptr<GraphicsPipeline> pipeline;
 
+        /// Variante de media precisin (nula si el dispositivo no la admite).
+        std::unique_ptr<GraphicsPipeline> halfPipeline;
+
+        /// Usar \c halfPipeline en los draws.
+        bool useHalfPrecision = false;
+
+        /// Visualizacin de depuracin activa.
+        DebugView debugView = DebugView::Off;
+
+        /// Variantes de depuracin creadas bajo demanda (ndice = \c DebugView).
+        std::unique_ptr<GraphicsPipeline> debugPipelines[5];
+
+        /// Tubera de depuracin de \c debugView (nula si sombrea con normalidad).
+        GraphicsPipeline* debugPipeline = nullptr;
+
+        /// Tubera de lneas de \c renderBounds (nula hasta que se usa).
+        std::unique_ptr<GraphicsPipeline> boundsPipeline;
+
+        /// Variante del bucle de grabacin.
+        RecordVariant recordVariant {};
+
+        /// Objetos a grabar en el frame (de \c prepareRecording).
+        std::vector<GameObject*> drawList;
+
+        /// Frustum de la cmara del frame (slo con culling).
+        Frustum frustum {};
+
+        /// Bucle elegido en \c prepareRecording.
+        RecordLoop recordLoop = nullptr;
+
         /// Layout del pipeline (sets, push constants, estados fijos).
         VkPipelineLayout pipelineLayout;
 };
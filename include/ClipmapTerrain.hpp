@@ -0,0 +1,179 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ClipmapTerrain.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "GraphicsPipeline.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <vector>
+
+ /// \brief Terreno de altura ilimitado renderizado con clipmaps geométricos.
+ /// \details El terreno se divide en \c LEVEL_COUNT niveles concéntricos centrados
+ /// en la cámara; el nivel \c l tiene un espaciado de <tt>BASE_SPACING * 2^l</tt> y
+ /// cubre <tt>LEVEL_CELLS x LEVEL_CELLS</tt> celdas. Todos los niveles comparten
+ /// una única rejilla de vértices: el nivel 0 dibuja la rejilla completa y el
+ /// resto un anillo con el hueco que ocupa el nivel más fino (nueve variantes
+ /// de índices según la paridad del ajuste a la rejilla), de modo que el número
+ /// de draws es siempre \c LEVEL_COUNT.
+ ///
+ /// Las alturas viven en un SSBO con una región de <tt>LEVEL_SAMPLES^2</tt> muestras
+ /// por nivel direccionada de forma toroidal: al mover la cámara sólo se generan
+ /// y suben las filas y columnas que entran en cada nivel. El vertex shader lee
+ /// las alturas y, cerca del borde exterior, las funde con el nivel más grueso
+ /// para que no haya grietas entre niveles. La memoria es fija y no depende del
+ /// tamaño del terreno.
+class ClipmapTerrain
+{
+public:
+    /// Celdas por lado de cada nivel (múltiplo de 4).
+    static constexpr int LEVEL_CELLS = 128;
+    /// Muestras por lado de cada nivel.
+    static constexpr int LEVEL_SAMPLES = LEVEL_CELLS + 1;
+    /// Número de niveles.
+    static constexpr uint32_t LEVEL_COUNT = 5;
+    /// Espaciado del nivel más fino (unidades de mundo).
+    static constexpr float BASE_SPACING = 0.25f;
+
+    /// \brief Construye la rejilla, los búferes de alturas y la tubería.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param renderPass Render pass donde se dibuja el terreno.
+    /// \param globalSetLayout Layout de descriptores global (set 0).
+    ClipmapTerrain(
+        VulkanDevice& device,
+        VkRenderPass renderPass,
+        VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Libera recursos asociados.
+    ~ClipmapTerrain();
+
+    ClipmapTerrain(const ClipmapTerrain&) = delete;
+    ClipmapTerrain& operator=(const ClipmapTerrain&) = delete;
+
+    /// \brief Recentra los niveles en la cámara y graba la subida de las regiones nuevas.
+    /// \details Debe llamarse fuera del render pass y antes de \c render.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Dibuja todos los niveles (un draw indexado por nivel).
+    /// \param frameInfo Contexto del frame con el render pass activo.
+    void render(FrameInfo& frameInfo);
+
+    /// \brief Altura del terreno (hacia "arriba", -Y) en un punto del plano XZ.
+    /// \details Función procedural determinista; alrededor del origen es plana
+    /// para no interferir con la escena existente.
+    /// \param x Coordenada X de mundo.
+    /// \param z Coordenada Z de mundo.
+    /// \return Altura sobre \c baseLevel.
+    static float heightAt(float x, float z);
+
+    /// \brief Coordenada Y de mundo de la superficie (el eje -Y es "arriba").
+    /// \param x Coordenada X de mundo.
+    /// \param z Coordenada Z de mundo.
+    float surfaceY(float x, float z) const
+    {
+        return (baseLevel - heightAt(x, z));
+    }
+
+    /// \brief Muestras generadas y subidas en el último \c update.
+    uint32_t getStreamedSamples() const
+    {
+        return (streamedSamples);
+    }
+
+private:
+    /// \brief Estado residente de un nivel.
+    struct Level
+    {
+        /// Índice de rejilla (en unidades del nivel) de la esquina mínima.
+        glm::ivec2 origin {0, 0};
+        /// Indica si la región del nivel contiene datos válidos.
+        bool resident = false;
+    };
+
+    /// \brief Rango de índices dentro del búfer de índices compartido.
+    struct IndexRange
+    {
+        /// Primer índice.
+        uint32_t first = 0;
+        /// Número de índices.
+        uint32_t count = 0;
+    };
+
+    /// \brief Crea la rejilla compartida y las variantes de índices.
+    void createGrid();
+
+    /// \brief Crea el SSBO de alturas, los staging por frame y su descriptor set.
+    void createHeightBuffers();
+
+    /// \brief Crea el pipeline layout.
+    /// \param globalSetLayout Layout de descriptores global.
+    void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Crea la tubería gráfica del terreno.
+    /// \param renderPass Render pass objetivo.
+    void createPipeline(VkRenderPass renderPass);
+
+    /// \brief Origen ajustado de un nivel para la posición de cámara dada.
+    /// \details Se ajusta al doble del espaciado del nivel para que el nivel fino
+    /// quede siempre alineado con los vértices del grueso.
+    /// \param level Índice de nivel.
+    /// \param cameraPosition Posición de la cámara en mundo.
+    glm::ivec2 levelOrigin(uint32_t level, const glm::vec3& cameraPosition) const;
+
+    /// \brief Genera en staging las muestras que faltan de un nivel y sus copias.
+    /// \param level Índice de nivel.
+    /// \param origin Nuevo origen del nivel.
+    /// \param staging Memoria mapeada del staging del frame.
+    /// \param written Muestras ya escritas en \c staging (se actualiza).
+    void streamLevel(uint32_t level, const glm::ivec2& origin, float* staging, uint32_t& written);
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Altura de referencia (Y de mundo) del terreno.
+    float baseLevel = 0.5f;
+
+    /// Estado residente de cada nivel.
+    Level levels[LEVEL_COUNT];
+
+    /// Muestras subidas en el último frame.
+    uint32_t streamedSamples = 0;
+
+    /// Vértices de la rejilla compartida (coordenadas enteras en vec2).
+    std::unique_ptr<VulkanBuffer> gridBuffer;
+    /// Índices de la rejilla completa y de las nueve variantes de anillo.
+    std::unique_ptr<VulkanBuffer> indexBuffer;
+    /// Rango de la rejilla completa (nivel 0).
+    IndexRange fullRange {};
+    /// Rangos de anillo indexados por <tt>(hueco.z + 1) * 3 + (hueco.x + 1)</tt>.
+    IndexRange ringRanges[9] {};
+
+    /// Alturas de todos los niveles (regiones toroidales).
+    std::unique_ptr<VulkanBuffer> heightBuffer;
+    /// Staging visible por el host, uno por frame en vuelo.
+    std::vector<std::unique_ptr<VulkanBuffer>> stagingBuffers;
+    /// Copias pendientes del frame actual.
+    std::vector<VkBufferCopy> copyRegions;
+
+    /// Pool propio para el descriptor set de alturas.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+    /// Layout del set de alturas.
+    std::unique_ptr<DescriptorSetLayout> setLayout;
+    /// Descriptor set del SSBO de alturas.
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    /// Pipeline layout (set global + set de alturas + push constants).
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    /// Tubería gráfica del terreno.
+    std::unique_ptr<GraphicsPipeline> pipeline;
+};
@@ -0,0 +1,118 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ClockCalibration.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+struct DeviceCapabilities;
+
+ /// \brief Origen de la correspondencia entre el reloj de la GPU y el de la CPU.
+enum class ClockDomain : uint32_t
+{
+    /// Sin timestamps de GPU: no hay correspondencia.
+    None = 0,
+    /// \c VK_EXT_calibrated_timestamps: muestras simultáneas de ambos relojes.
+    Calibrated = 1,
+    /// Estimada en la CPU a partir del momento en que se observa terminado cada frame.
+    Estimated = 2
+};
+
+/// \brief Traduce timestamps de GPU (ticks) al reloj \c std::chrono::steady_clock.
+/// \details Con \c VK_EXT_calibrated_timestamps se toma cada frame una pareja de
+/// muestras (dispositivo y \c CLOCK_MONOTONIC o \c QueryPerformanceCounter) y el
+/// desfase es exacto salvo la desviación que informa el driver. Sin la extensión se
+/// estima: el final de un frame en GPU siempre es anterior al instante en que la CPU
+/// lo ve terminado, así que el mínimo de <tt>observado - fin</tt> sobre una ventana de
+/// frames acota el desfase por arriba; es tanto más preciso cuanto más a menudo espera
+/// la CPU a la GPU y sitúa los pases de GPU, como mucho, algo más tarde de lo real.
+class ClockCalibration
+{
+public:
+    /// \brief Elige el método según el perfil del dispositivo.
+    /// \param device Dispositivo lógico.
+    /// \param capabilities Perfil del dispositivo (timestamps, extensión calibrada).
+    void init(VkDevice device, const DeviceCapabilities& capabilities);
+
+    /// \brief Actualiza el desfase con el último frame resuelto.
+    /// \param gpuEndTick Timestamp final del frame (ticks de dispositivo).
+    /// \param observed Instante en que la CPU vio el frame terminado.
+    void update(uint64_t gpuEndTick, std::chrono::steady_clock::time_point observed);
+
+    /// \brief Indica si ya se pueden traducir timestamps.
+    bool isValid() const
+    {
+        return (hasOffset);
+    }
+
+    /// \brief Traduce un timestamp de GPU a nanosegundos de \c steady_clock.
+    /// \param tick Timestamp de dispositivo.
+    double toHostNs(uint64_t tick) const
+    {
+        return (double(tick) * periodNs + offsetNs);
+    }
+
+    /// \brief Nanosegundos de \c steady_clock de un instante de la CPU.
+    static double hostNs(std::chrono::steady_clock::time_point time)
+    {
+        return (std::chrono::duration<double, std::nano>(time.time_since_epoch()).count());
+    }
+
+    /// \brief Método en uso.
+    ClockDomain getDomain() const
+    {
+        return (domain);
+    }
+
+    /// \brief Incertidumbre de la última calibración (ns; 0 si es una estimación).
+    double getDeviationNs() const
+    {
+        return (deviationNs);
+    }
+
+    /// \brief Nombre legible de un método.
+    static const char* domainName(ClockDomain domain);
+
+private:
+    /// Frames sobre los que se toma el mínimo en el modo estimado.
+    static constexpr size_t ESTIMATE_WINDOW = 120;
+
+    /// \brief Toma una pareja de muestras calibradas.
+    /// \return \c false si el driver rechaza la consulta.
+    bool sampleCalibrated();
+
+    /// Método en uso.
+    ClockDomain domain = ClockDomain::None;
+    /// Dispositivo lógico.
+    VkDevice device = VK_NULL_HANDLE;
+    /// \c vkGetCalibratedTimestampsEXT (nulo sin la extensión).
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps = nullptr;
+    /// Dominio del reloj de la CPU equivalente a \c steady_clock.
+    VkTimeDomainEXT hostDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    /// Nanosegundos por tick del reloj de la CPU (\c QueryPerformanceFrequency en Windows).
+    double hostTickNs = 1.0;
+    /// Nanosegundos por tick de GPU.
+    double periodNs = 1.0;
+    /// Desfase: <tt>host = tick * periodNs + offsetNs</tt>.
+    double offsetNs = 0.0;
+    /// Desviación máxima de la última muestra calibrada (ns).
+    double deviationNs = 0.0;
+    /// Ya hay un desfase utilizable.
+    bool hasOffset = false;
+
+    /// Candidatos a desfase de los últimos frames (modo estimado).
+    std::array<double, ESTIMATE_WINDOW> candidates {};
+    /// Candidatos válidos en \c candidates.
+    size_t candidateCount = 0;
+    /// Próxima posición de escritura en \c candidates.
+    size_t candidateHead = 0;
+};
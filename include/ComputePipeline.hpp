@@ -0,0 +1,48 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ComputePipeline.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "VulkanDevice.hpp"
+
+#include <string>
+
+ /// \brief Encapsula la creación y uso de una \c VkPipeline de cómputo.
+ /// \details Carga un único módulo SPIR-V (usando la caché de shaders de
+ /// \c GraphicsPipeline) y lo asocia al \c VkPipelineLayout recibido.
+ /// El layout lo crea y destruye el sistema que usa la tubería.
+class ComputePipeline
+{
+public:
+    /// \brief Construye la tubería de cómputo.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param computePath Ruta del shader de cómputo en SPIR-V (.spv).
+    /// \param layout Pipeline layout (descriptores/constantes) compatible con el shader.
+    ComputePipeline(
+        VulkanDevice& device,
+        const std::string& computePath,
+        VkPipelineLayout layout);
+
+    /// \brief Destruye la \c VkPipeline y el módulo de shader.
+    ~ComputePipeline();
+
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+    /// \brief Enlaza la tubería al \c commandBuffer activo.
+    /// \param commandBuffer Command buffer.
+    void bind(VkCommandBuffer commandBuffer);
+
+private:
+    /// Dispositivo lógico usado para crear la tubería.
+    VulkanDevice& device;
+    /// Handle de la \c VkPipeline creada.
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    /// Módulo de shader de cómputo.
+    VkShaderModule computeModule = VK_NULL_HANDLE;
+};
@@ -0,0 +1,130 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: DeviceCapabilities.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <iosfwd>
+
+ /// \brief Perfil de capacidades del dispositivo físico, consultado una sola vez.
+ /// \details Recoge las características opcionales (Vulkan 1.0 a 1.3) y los límites que
+ /// usan los subsistemas para elegir su camino rápido. \c VulkanDevice habilita todas
+ /// las características soportadas al crear el dispositivo lógico, de modo que un
+ /// campo a \c true significa "soportada y habilitada".
+struct DeviceCapabilities
+{
+    /// Versión de Vulkan efectiva (mínimo entre la del dispositivo y la de la instancia).
+    uint32_t apiVersion = VK_API_VERSION_1_0;
+
+    /// Filtrado anisótropo.
+    bool samplerAnisotropy = false;
+    /// Varios draws por llamada indirecta (\c drawCount > 1).
+    bool multiDrawIndirect = false;
+    /// \c firstInstance distinto de cero en draws indirectos.
+    bool drawIndirectFirstInstance = false;
+    /// Relleno en modo línea/punto (depuración en alambre).
+    bool fillModeNonSolid = false;
+    /// Enteros de 16 bits en shaders.
+    bool shaderInt16 = false;
+    /// Consultas de estadísticas de pipeline.
+    bool pipelineStatisticsQuery = false;
+
+    /// Acceso de 16 bits a storage buffers (Vulkan 1.1).
+    bool storageBuffer16BitAccess = false;
+    /// Acceso de 16 bits a uniform y storage buffers (Vulkan 1.1).
+    bool uniformAndStorageBuffer16BitAccess = false;
+    /// Entradas y salidas de 16 bits entre etapas de shader (Vulkan 1.1).
+    bool storageInputOutput16 = false;
+    /// \c gl_DrawID / \c gl_BaseInstance en shaders (Vulkan 1.1).
+    bool shaderDrawParameters = false;
+    /// Render a varias vistas en una pasada (Vulkan 1.1).
+    bool multiview = false;
+
+    /// Semáforos de línea temporal (Vulkan 1.2).
+    bool timelineSemaphore = false;
+    /// \c vkCmdDrawIndexedIndirectCount (Vulkan 1.2).
+    bool drawIndirectCount = false;
+    /// \c vkResetQueryPool desde la CPU (Vulkan 1.2).
+    bool hostQueryReset = false;
+    /// Indexado de descriptores: arrays sin tamaño, parcialmente enlazados e
+    /// indexados de forma no uniforme (Vulkan 1.2).
+    bool descriptorIndexing = false;
+    /// Aritmética de 16 bits en coma flotante (Vulkan 1.2).
+    bool shaderFloat16 = false;
+    /// Enteros de 8 bits en shaders (Vulkan 1.2).
+    bool shaderInt8 = false;
+    /// Acceso de 8 bits a storage buffers (Vulkan 1.2).
+    bool storageBuffer8BitAccess = false;
+    /// Direcciones de búfer en shaders (Vulkan 1.2).
+    bool bufferDeviceAddress = false;
+    /// Disposición escalar de bloques (Vulkan 1.2).
+    bool scalarBlockLayout = false;
+
+    /// \c vkCmdPipelineBarrier2 y \c vkQueueSubmit2 (Vulkan 1.3).
+    bool synchronization2 = false;
+    /// Render sin render pass ni framebuffer (Vulkan 1.3).
+    bool dynamicRendering = false;
+    /// Mejoras de maintenance4 (Vulkan 1.3).
+    bool maintenance4 = false;
+
+    /// Timestamps en las colas de gráficos y cómputo.
+    bool timestamps = false;
+    /// Nanosegundos por tick de timestamp.
+    float timestampPeriod = 1.0f;
+    /// \c VK_EXT_calibrated_timestamps: muestras simultáneas de los relojes de GPU y CPU.
+    bool calibratedTimestamps = false;
+    /// Máximo \c drawCount de un draw indirecto.
+    uint32_t maxDrawIndirectCount = 1;
+
+    /// \brief Consulta las capacidades de un dispositivo físico.
+    /// \param physicalDevice Dispositivo físico.
+    /// \param instanceVersion Versión de Vulkan solicitada al crear la instancia.
+    /// \return Perfil con las características soportadas.
+    static DeviceCapabilities query(VkPhysicalDevice physicalDevice, uint32_t instanceVersion);
+
+    /// \brief Indica si pueden usarse los shaders de media precisión (aritmética y
+    /// varyings de 16 bits).
+    bool halfPrecisionShading() const
+    {
+        return (shaderFloat16 && storageInputOutput16);
+    }
+
+    /// \brief Imprime el perfil y, para cada característica ausente, el camino alternativo.
+    /// \param out Flujo de salida.
+    void print(std::ostream& out) const;
+};
+
+/// \brief Cadena \c pNext con las características a habilitar en \c vkCreateDevice.
+/// \details Contiene punteros a sus propios miembros, por lo que no es copiable y
+/// debe vivir hasta que se cree el dispositivo.
+struct DeviceFeatureChain
+{
+    /// \brief Rellena y enlaza las estructuras según el perfil.
+    /// \param capabilities Características soportadas (todas se habilitan).
+    explicit DeviceFeatureChain(const DeviceCapabilities& capabilities);
+
+    DeviceFeatureChain(const DeviceFeatureChain&) = delete;
+    DeviceFeatureChain& operator=(const DeviceFeatureChain&) = delete;
+
+    /// \brief Primer eslabón, para \c VkDeviceCreateInfo::pNext.
+    const void* head() const
+    {
+        return (&features);
+    }
+
+    /// Características de Vulkan 1.0.
+    VkPhysicalDeviceFeatures2 features {};
+    /// Características de Vulkan 1.1.
+    VkPhysicalDeviceVulkan11Features vulkan11 {};
+    /// Características de Vulkan 1.2.
+    VkPhysicalDeviceVulkan12Features vulkan12 {};
+    /// Características de Vulkan 1.3.
+    VkPhysicalDeviceVulkan13Features vulkan13 {};
+};
@@ -20,6 +20,7 @@
 #include "GameObject.hpp"
 
 class Perf;
+enum class DebugView : uint32_t;
 
 /// \brief Capa de interfaz de usuario basada en Dear ImGui.
 /// \details Inicializa ImGui para GLFW+Vulkan, gestiona el descriptor pool propio
@@ -33,15 +34,25 @@ class EditorUI
         static constexpr int WIDTH = 1600;
         static constexpr int HEIGHT = 900;
 
-        /// \brief Constructor por defecto.
-        EditorUI();
+        /// \brief Constructor.
+        /// \param visible Si es \c false la ventana se crea oculta (modo headless).
+        explicit EditorUI(bool visible = true);
 
         /// \brief Destructor.
         ~EditorUI();
 
-        /// \brief Inicializa el backend de ImGui para Vulkan y GLFW.
-        /// \details Crea contexto ImGui, configura estilo, inicializa \c ImGui_ImplGlfw
-        /// y \c ImGui_ImplVulkan y crea un descriptor pool propio para UI.
+        /// \brief Crea el contexto de ImGui, aplica el estilo e inicializa \c ImGui_ImplGlfw.
+        /// \details Debe llamarse desde la hebra principal (GLFW) antes de \c buildFonts e \c init.
+        void createContext();
+
+        /// \brief Carga las fuentes del atlas de ImGui.
+        /// \details No depende de Vulkan, por lo que puede ejecutarse en una hebra
+        /// de trabajo mientras se crea la swapchain.
+        void buildFonts();
+
+        /// \brief Inicializa el backend de ImGui para Vulkan.
+        /// \details Crea un descriptor pool propio para UI e inicializa \c ImGui_ImplVulkan.
+        /// Requiere haber llamado antes a \c createContext.
         /// \param instance Instancia de Vulkan.
         /// \param physicalDevice Dispositivo fsico empleado por la aplicacin.
         /// \param device Dispositivo lgico (VkDevice).
@@ -60,7 +71,8 @@ class EditorUI
         /// \brief Comienza un frame de ImGui.
         /// \details Llama a \c ImGui_ImplVulkan_NewFrame, \c ImGui_ImplGlfw_NewFrame
         /// y \c ImGui::NewFrame(). Debe invocarse una vez por frame antes de
-        /// construir los paneles.
+        /// construir los paneles. En los frames que no toca reconstruir la UI
+        /// (ver \c setRefreshInterval) no hace nada.
         void beginFrame();
 
         /// \brief Dibuja un panel de inspeccin/edicin para \c gameObjects.
@@ -78,6 +90,15 @@ class EditorUI
         /// \param device VkDevice con el que se cre el descriptor pool.
         void cleanup(VkDevice device);
 
+        /// \brief Fija cada cuntos frames se reconstruye la UI.
+        /// \details En los frames intermedios se vuelven a grabar los draw data del
+        /// ltimo frame reconstruido, sin recorrer los paneles.
+        /// \param frames Intervalo en frames (1 = cada frame).
+        void setRefreshInterval(uint32_t frames)
+        {
+            refreshInterval = (frames > 0) ? frames : 1;
+        }
+
         /// \brief Inyecta el recolector de mtricas de rendimiento.
         /// \details Permite a la UI consultar/mostrar estadsticas (CPU/GPU/FPS).
         /// \param p Puntero a \c Perf vlido mientras se use la UI.
@@ -86,6 +107,12 @@ class EditorUI
             perf = p;
         }
 
+        /// \brief Visualizacin de depuracin elegida en el panel.
+        DebugView getDebugView() const
+        {
+            return (debugView);
+        }
+
         /// \brief Acceso a la ventana principal (GLFW).
         /// \return Referencia a la ventana propietaria de la UI.
         Window& getWindow()
@@ -102,10 +129,22 @@ class EditorUI
         VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
 
         /// Ventana GLFW de la aplicacin/editor.
-        Window window{WIDTH, HEIGHT, "Vulkan API"};
+        Window window;
 
         /// Mtricas de rendimiento.
         Perf* perf = nullptr;
+
+        /// Visualizacin de depuracin elegida (\c DebugView::Off por defecto).
+        DebugView debugView {};
+
+        /// Frames entre reconstrucciones de la UI.
+        uint32_t refreshInterval = 1;
+
+        /// Frames transcurridos desde la creacin.
+        uint64_t frameCounter = 0;
+
+        /// Indica si el frame actual reconstruye la UI.
+        bool rebuildFrame = true;
 };
 
 
@@ -0,0 +1,117 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameCapture.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "FrameContext.hpp"
+#include "Model.hpp"
+
+#include <string>
+#include <vector>
+
+ /// \brief Objeto de escena capturado (lo que necesitan \c BasicRenderer y
+ /// \c PointLightSystem para grabar sus draws).
+struct CapturedObject
+{
+    /// Índice en \c FrameCapture::getModels, o \c FrameCapture::NO_MODEL.
+    uint32_t model = 0;
+
+    /// Distinto de cero si el objeto es una luz puntual.
+    uint32_t hasLight = 0;
+
+    /// Intensidad de la luz (si \c hasLight).
+    float lightIntensity = 0.0f;
+
+    /// Distinto de cero si la luz está horneada (\c PointLight::baked).
+    uint32_t lightBaked = 0;
+
+    /// Distinto de cero si el objeto es geometría estática (\c GameObject::staticGeometry).
+    uint32_t staticGeometry = 0;
+
+    /// Color del objeto o de la luz.
+    glm::vec3 color {};
+
+    /// Transformación (de ella salen las push constants).
+    Transform transform {};
+};
+
+/// \brief Captura binaria de lo que graba un frame de la escena principal.
+/// \details Guarda el \c GlobalUbo del frame, la variante de shaders activa, la
+/// geometría de cada malla dibujada (leída de la GPU, así que incluye p.ej. la pose
+/// de skinning) y los objetos que dibujan \c BasicRenderer y \c PointLightSystem.
+/// Con ello \c FrameReplay reconstruye la escena sin \c loadGameObjects, entrada ni
+/// sistemas de simulación. El fichero empieza por una cabecera con versión y tamaños
+/// de las estructuras; \c load rechaza capturas de otra versión o compilación.
+class FrameCapture
+{
+public:
+    /// Identificador de formato ("VKFC").
+    static constexpr uint32_t MAGIC = 0x43464B56;
+    /// Versión del formato (2: luces horneadas y geometría estática).
+    static constexpr uint32_t VERSION = 2;
+    /// Valor de \c CapturedObject::model para objetos sin malla.
+    static constexpr uint32_t NO_MODEL = 0xFFFFFFFF;
+
+    /// \brief Captura el estado de un frame ya actualizado.
+    /// \details Debe llamarse con el dispositivo inactivo (lee las mallas de la GPU).
+    /// Omite los objetos dibujados como impostor, que no graba \c BasicRenderer.
+    /// \param frameInfo Contexto del frame (objetos y listas de luces ya calculadas).
+    /// \param ubo UBO global del frame.
+    /// \param halfPrecision Variante de shaders activa en \c BasicRenderer.
+    /// \return Captura en memoria.
+    static FrameCapture capture(const FrameInfo& frameInfo, const GlobalUbo& ubo, bool halfPrecision);
+
+    /// \brief Guarda la captura en un fichero binario.
+    /// \param path Ruta del fichero.
+    void save(const std::string& path) const;
+
+    /// \brief Carga una captura guardada con \c save.
+    /// \param path Ruta del fichero.
+    /// \return Captura en memoria.
+    static FrameCapture load(const std::string& path);
+
+    /// \brief UBO global del frame capturado.
+    const GlobalUbo& getUbo() const
+    {
+        return (ubo);
+    }
+
+    /// \brief Variante de shaders que estaba activa.
+    bool isHalfPrecision() const
+    {
+        return (halfPrecision);
+    }
+
+    /// \brief Geometría de las mallas capturadas.
+    const std::vector<Model::Builder>& getModels() const
+    {
+        return (models);
+    }
+
+    /// \brief Objetos capturados.
+    const std::vector<CapturedObject>& getObjects() const
+    {
+        return (objects);
+    }
+
+    /// \brief Número de draws de \c BasicRenderer en la captura.
+    uint32_t getDrawCount() const;
+
+private:
+    /// UBO global del frame.
+    GlobalUbo ubo {};
+
+    /// Variante de shaders activa.
+    bool halfPrecision = false;
+
+    /// Geometría de cada malla distinta.
+    std::vector<Model::Builder> models;
+
+    /// Objetos de la escena que graban draws.
+    std::vector<CapturedObject> objects;
+};
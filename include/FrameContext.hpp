@@ -27,10 +27,18 @@ struct GpuPointLight
     glm::vec4 color {};    
 };
 
+/// Número máximo de luces puntuales en \c GlobalUbo (debe coincidir con los shaders).
+static constexpr int MAX_LIGHTS = 10;
+
+/// Número máximo de vistas de un pase multivista (las seis caras de un cubo).
+static constexpr int MAX_VIEWS = 6;
+
 /// \brief UBO global compartido por los shaders.
 /// \details Contiene matrices de cámara, luz ambiental y un conjunto acotado
 /// de luces puntuales. La disposición y alineación siguen reglas
-/// std140, de ahí el \c alignas(16) en el padding final.
+/// std140, de ahí el \c alignas(16) de \c viewProjections.
+/// \c viewProjections se indexa con \c gl_ViewIndex en los pases multivista;
+/// el pase principal sólo rellena la primera.
 struct GlobalUbo
 {
     /// Matriz de proyección (perspectiva u ortográfica).
@@ -46,13 +54,16 @@ struct GlobalUbo
     glm::vec4 ambientLightColor {1.0f, 1.0f, 1.0f, 0.05f};
 
     /// Array fijo de luces puntuales.
-    GpuPointLight pointLights[10];
+    GpuPointLight pointLights[MAX_LIGHTS];
 
     /// Número de luces activas en \c pointLights.
     uint32_t numLights = 0;
 
-    // Relleno para respetar alineación std140 (múltiplos de 16 bytes).
-    alignas(16) int _padding[3]{};
+    /// Número de vistas válidas en \c viewProjections.
+    uint32_t viewCount = 1;
+
+    /// Producto proyección * vista de cada vista del pase.
+    alignas(16) glm::mat4 viewProjections[MAX_VIEWS] {};
 };
 
 /// \brief Contexto de datos inmutable por frame que comparten los sistemas de render.
@@ -78,5 +89,9 @@ struct FrameInfo
 
     /// Objetos de escena direccionados por id.
     std::unordered_map<unsigned int, GameObject>& gameObjects;
+
+    /// Command buffer para pases sólo de cómputo. Con cómputo asíncrono pertenece a la
+    /// cola de cómputo; si no, es el mismo que \c commandBuffer.
+    VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE;
 };
 
@@ -0,0 +1,141 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameReplay.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "FrameCapture.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+class BasicRenderer;
+class LightGrid;
+class PointLightSystem;
+
+ /// \brief Resultado de reproducir una captura.
+struct FrameReplayResult
+{
+    /// Repeticiones medidas.
+    uint32_t iterations = 0;
+    /// Draws de \c BasicRenderer por repetición.
+    uint32_t draws = 0;
+    /// Luces puntuales dibujadas por repetición.
+    uint32_t lights = 0;
+    /// Tiempo de grabación del command buffer (ms, mediana y p99).
+    float recordMs = 0.0f;
+    float recordP99Ms = 0.0f;
+    /// Tiempo de la llamada a \c vkQueueSubmit (ms, mediana y p99).
+    float submitMs = 0.0f;
+    float submitP99Ms = 0.0f;
+    /// Espera de la CPU al fence tras el envío (ms, mediana); incluye la latencia de
+    /// envío y de señalización, no sólo la ejecución.
+    float fenceWaitMs = 0.0f;
+    /// Ejecución en GPU medida con timestamps (ms, mediana y p99; válida si \c gpuTimed).
+    float gpuMs = 0.0f;
+    float gpuP99Ms = 0.0f;
+    /// El dispositivo admite timestamps en la cola de gráficos.
+    bool gpuTimed = false;
+};
+
+/// \brief Reproduce una \c FrameCapture para medir sólo grabación y envío.
+/// \details Reconstruye las mallas y los objetos de la captura, escribe su UBO en
+/// el de la aplicación y recalcula con \c LightGrid las listas de luces de esa
+/// escena. Cada repetición graba \c BasicRenderer::render y \c PointLightSystem::render
+/// en un render pass fuera de pantalla compatible con el de la swapchain (sirven las
+/// tuberías ya creadas) entre dos timestamps de GPU, lo envía y espera a su fence; no
+/// intervienen la swapchain, la entrada ni los sistemas de simulación, así que el
+/// resultado es estable entre ejecuciones. Sólo debe usarse con el dispositivo inactivo.
+class FrameReplay
+{
+public:
+    /// \brief Reconstruye la escena y crea el destino fuera de pantalla.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param capture Captura a reproducir.
+    /// \param colorFormat Formato de color de la swapchain.
+    /// \param depthFormat Formato de profundidad de la swapchain.
+    /// \param extent Tamaño de la imagen.
+    FrameReplay(
+        VulkanDevice& device,
+        const FrameCapture& capture,
+        VkFormat colorFormat,
+        VkFormat depthFormat,
+        VkExtent2D extent);
+
+    /// \brief Libera la escena reconstruida y los recursos de render.
+    ~FrameReplay();
+
+    FrameReplay(const FrameReplay&) = delete;
+    FrameReplay& operator=(const FrameReplay&) = delete;
+
+    /// \brief Reproduce la captura \c iterations veces.
+    /// \param basicRenderer Renderizador de la geometría.
+    /// \param pointLightSystem Renderizador de las luces.
+    /// \param lightGrid Listas de luces por objeto (se recalculan una vez).
+    /// \param uboBuffer UBO global enlazado en \c globalDescriptorSet.
+    /// \param globalDescriptorSet Set global del frame 0.
+    /// \param iterations Repeticiones a medir.
+    /// \return Tiempos medidos.
+    FrameReplayResult run(
+        BasicRenderer& basicRenderer,
+        PointLightSystem& pointLightSystem,
+        LightGrid& lightGrid,
+        VulkanBuffer& uboBuffer,
+        VkDescriptorSet globalDescriptorSet,
+        uint32_t iterations);
+
+    /// \brief Imprime el resultado en una línea.
+    /// \param result Resultado de \c run.
+    /// \param out Flujo de salida.
+    static void print(const FrameReplayResult& result, std::ostream& out);
+
+private:
+    /// \brief Crea el render pass, las imágenes y el framebuffer.
+    void createTarget();
+
+    /// Dispositivo Vulkan.
+    VulkanDevice& device;
+    /// UBO de la captura.
+    GlobalUbo ubo {};
+    /// Variante de shaders de la captura.
+    bool halfPrecision = false;
+    /// Objetos reconstruidos.
+    std::unordered_map<unsigned int, GameObject> gameObjects;
+
+    /// Formato de color.
+    VkFormat colorFormat;
+    /// Formato de profundidad.
+    VkFormat depthFormat;
+    /// Tamaño de la imagen.
+    VkExtent2D extent;
+
+    /// Render pass fuera de pantalla.
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    /// Imagen de color.
+    VkImage colorImage = VK_NULL_HANDLE;
+    /// Memoria de la imagen de color.
+    VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+    /// Vista de la imagen de color.
+    VkImageView colorView = VK_NULL_HANDLE;
+    /// Imagen de profundidad.
+    VkImage depthImage = VK_NULL_HANDLE;
+    /// Memoria de la imagen de profundidad.
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    /// Vista de la imagen de profundidad.
+    VkImageView depthView = VK_NULL_HANDLE;
+    /// Framebuffer fuera de pantalla.
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    /// Pool del command buffer de reproducción.
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    /// Command buffer reutilizado en cada repetición.
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    /// Fence de cada envío.
+    VkFence fence = VK_NULL_HANDLE;
+};
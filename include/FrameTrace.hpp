@@ -0,0 +1,161 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameTrace.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Perf.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+ /// \brief Instantes de las fases de un frame en la hebra de render (\c steady_clock).
+struct FrameTraceMarks
+{
+    /// Antes de \c Renderer::beginFrame (espera de fence y adquisición).
+    std::chrono::steady_clock::time_point acquire {};
+    /// Tras \c beginFrame: actualización de sistemas y pases previos.
+    std::chrono::steady_clock::time_point update {};
+    /// Inicio del render pass principal y grabación de draws.
+    std::chrono::steady_clock::time_point record {};
+    /// Antes de \c Renderer::endFrame (envío y presentación).
+    std::chrono::steady_clock::time_point submit {};
+    /// Tras \c endFrame.
+    std::chrono::steady_clock::time_point end {};
+};
+
+/// \brief Contadores de un frame que acompañan a sus fases en la traza.
+struct TraceCounters
+{
+    /// ms de CPU y de GPU del frame (\c PerfStats).
+    float cpuFrameMs = 0.0f;
+    float gpuFrameMs = 0.0f;
+    /// ms bloqueados en la swapchain.
+    float blockedMs = 0.0f;
+    /// ms de GPU del cómputo asíncrono.
+    float asyncComputeMs = 0.0f;
+    /// ms de CPU de la rejilla de luces.
+    float lightGridMs = 0.0f;
+    /// Celdas del mundo pendientes de carga.
+    uint32_t pendingCells = 0;
+    /// Asignaciones de memoria de dispositivo hechas durante el frame.
+    uint32_t allocations = 0;
+    /// Bytes asignados durante el frame.
+    uint64_t allocatedBytes = 0;
+};
+
+/// \brief Frame grabado en la traza.
+struct TraceFrame
+{
+    /// Número de frame (\c Perf::getFrameSerial).
+    uint64_t serial = 0;
+    /// Fases en la CPU (ns de \c steady_clock).
+    double acquireNs = 0.0;
+    double updateNs = 0.0;
+    double recordNs = 0.0;
+    double submitNs = 0.0;
+    double endNs = 0.0;
+    /// Intervalo en la GPU (ns de \c steady_clock), válido si \c hasGpu.
+    GpuFrameSpan gpu {};
+    bool hasGpu = false;
+    /// Contadores del frame.
+    TraceCounters counters {};
+};
+
+/// \brief Traza conjunta CPU/GPU de varios frames en formato Chrome Trace Event.
+/// \details La hebra de render añade las fases de cada frame con \c addFrame y, cuando
+/// \c Perf los resuelve (unos frames más tarde), los intervalos de GPU ya traducidos al
+/// reloj de la CPU con \c addGpuFrame. Al completarse se escribe un JSON que abren
+/// \c chrome://tracing y Perfetto, con una pista para la CPU, otra para la cola de
+/// gráficos y una flecha del envío de cada frame a su inicio en la GPU. La latencia de
+/// cola es <tt>inicio en GPU - envío</tt> y las burbujas, los huecos de la GPU entre
+/// frames consecutivos. Los contadores de cada frame se escriben como series y las
+/// asignaciones de memoria, además, como eventos instantáneos.
+class FrameTrace
+{
+public:
+    /// \brief Prepara una traza de \p frameCount frames.
+    explicit FrameTrace(uint32_t frameCount);
+
+    /// \brief Añade las fases de CPU de un frame (se ignora si la traza ya está llena).
+    /// \param serial Número de frame.
+    /// \param marks Instantes de las fases.
+    /// \param counters Contadores del frame.
+    void addFrame(uint64_t serial, const FrameTraceMarks& marks, const TraceCounters& counters);
+
+    /// \brief Construye un frame de la traza.
+    /// \param serial Número de frame.
+    /// \param marks Instantes de las fases.
+    /// \param counters Contadores del frame.
+    static TraceFrame makeFrame(uint64_t serial, const FrameTraceMarks& marks, const TraceCounters& counters);
+
+    /// \brief Asocia un intervalo de GPU a su frame en una secuencia ordenada por número.
+    /// \param frames Frames ordenados por \c serial (\c std::vector o \c std::deque).
+    /// \param span Intervalo traducido al reloj de la CPU.
+    template <typename Frames>
+    static void attachGpuFrame(Frames& frames, const GpuFrameSpan& span)
+    {
+        if (frames.empty() || span.serial < frames.front().serial)
+        {
+            return;
+        }
+
+        // Los números son consecutivos salvo frames descartados al recrear la swapchain.
+        auto frame = std::lower_bound(frames.begin(), frames.end(), span.serial,
+            [](const TraceFrame& candidate, uint64_t serial)
+            {
+                return (candidate.serial < serial);
+            });
+
+        if (frame != frames.end() && frame->serial == span.serial)
+        {
+            frame->gpu = span;
+            frame->hasGpu = true;
+        }
+    }
+
+    /// \brief Escribe frames en formato Chrome Trace Event (JSON).
+    /// \param path Ruta del fichero.
+    /// \param frames Frames a escribir, en orden.
+    /// \param hitch Frame lento a marcar (opcional).
+    static void writeFrames(
+        const std::string& path,
+        const std::vector<TraceFrame>& frames,
+        const HitchRecord* hitch = nullptr);
+
+    /// \brief Asocia el intervalo de GPU a su frame (se ignora si no está en la traza).
+    /// \param span Intervalo traducido al reloj de la CPU.
+    void addGpuFrame(const GpuFrameSpan& span);
+
+    /// \brief Indica si se han grabado todos los frames y sus intervalos de GPU.
+    bool isComplete() const;
+
+    /// \brief Escribe la traza en formato Chrome Trace Event (JSON).
+    /// \param path Ruta del fichero.
+    void write(const std::string& path) const;
+
+    /// \brief Imprime latencia de cola, burbujas y método de calibración.
+    /// \param clock Correspondencia de relojes usada.
+    /// \param out Flujo de salida.
+    void print(const ClockCalibration& clock, std::ostream& out) const;
+
+    /// \brief Frames grabados.
+    const std::vector<TraceFrame>& getFrames() const
+    {
+        return (frames);
+    }
+
+private:
+    /// Frames a grabar.
+    uint32_t capacity = 0;
+    /// Frames grabados, en orden.
+    std::vector<TraceFrame> frames;
+};
@@ -46,6 +46,7 @@ struct Transform
 struct PointLight
 {
     float intensity = 1.0f; ///< Intensidad de la luz (factor multiplicativo).
+    bool baked = false;     ///< Horneada en la geometría estática: queda fija y sólo ilumina en ejecución a los objetos dinámicos.
 };
 
 /// \brief Entidad mínima renderizable o lógica de la escena.
@@ -92,6 +93,19 @@ class GameObject
         /// Malla asociada.
         std::shared_ptr<Model> model{};
 
+        /// Permite sustituir la malla por un impostor a distancia (falso si la
+        /// geometría cambia cada frame, p.ej., con skinning).
+        bool allowImpostor = true;
+
+        /// Lo fija \c ImpostorSystem cada frame: si es \c true la malla no se dibuja.
+        bool drawAsImpostor = false;
+
+        /// Geometría estática: recibe y bloquea la iluminación horneada por \c LightBaker.
+        bool staticGeometry = false;
+
+        /// Lo fija \c LightGrid cada frame: lista de luces del objeto (0 = la de la cámara).
+        uint32_t lightList = 0;
+
         /// Componente de luz puntual.
         std::unique_ptr<PointLight> light = nullptr;
 
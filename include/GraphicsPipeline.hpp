@@ -94,6 +94,24 @@ public:
     /// \param config Referencia a \c PipelineConfig a modificar.
     static void enableAlphaBlending(PipelineConfig& config);
 
+    /// \brief Lee un shader SPIR-V y lo guarda en la cach compartida.
+    /// \details Permite adelantar la lectura de disco (p.ej., desde una hebra del
+    /// arranque) antes de construir la tubera. Es seguro llamarla concurrentemente.
+    /// \param path Ruta del shader (misma que se pasar al constructor).
+    static void preloadShader(const std::string& path);
+
+    /// \brief Guarda en la cach compartida un shader ledo por otra va (p.ej., \c AssetIO).
+    /// \details Es seguro llamarla concurrentemente.
+    /// \param path Ruta del shader (misma que se pasar al constructor).
+    /// \param code Bytecode SPIR-V.
+    static void storeShader(const std::string& path, std::vector<char> code);
+
+    /// \brief Devuelve el cdigo de un shader, desde la cach si fue precargado.
+    /// \details Tambin la usan otras tuberas (p.ej., \c ComputePipeline).
+    /// \param path Ruta del shader.
+    /// \return Bytecode SPIR-V.
+    static std::vector<char> loadShader(const std::string& path);
+
 private:
     /// \brief Carga un archivo binario (SPIR-V) a memoria.
     /// \param path Ruta del archivo.
@@ -0,0 +1,143 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: HitchDetector.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "FrameTrace.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+ /// \brief Parámetros de \c HitchDetector.
+struct HitchSettings
+{
+    /// Umbral absoluto (ms). Si es 0 se usa el relativo.
+    float thresholdMs = 0.0f;
+    /// Umbral relativo: múltiplo de la mediana del periodo de frame en la ventana.
+    float relativeThreshold = 3.0f;
+    /// Mínimo del umbral relativo (ms), para no disparar con frames muy cortos.
+    float minimumMs = 8.0f;
+    /// Segundos anteriores al frame lento que se vuelcan.
+    float windowSeconds = 3.0f;
+    /// Segundos posteriores al frame lento que se vuelcan.
+    float afterSeconds = 0.5f;
+    /// Segundos mínimos entre dos volcados.
+    float cooldownSeconds = 10.0f;
+    /// Directorio de las trazas.
+    std::string directory = ".";
+};
+
+/// \brief Detecta frames lentos y vuelca la traza de los segundos que los rodean.
+/// \details Siempre activo: guarda en un anillo las fases de CPU, los intervalos de GPU
+/// y los contadores (incluidas las asignaciones de memoria) de los últimos segundos.
+/// Cuando el periodo de un frame supera el umbral, espera a tener \c afterSeconds
+/// posteriores, copia la ventana y una hebra de escritura la vuelca como traza Chrome
+/// Trace Event con el frame marcado, sin detener la hebra de render. Los volcados se
+/// limitan a uno cada \c cooldownSeconds; los frames lentos detectados mientras tanto
+/// se registran sin traza, y los que caen en la ventana posterior de uno pendiente se
+/// registran con la traza de éste.
+class HitchDetector
+{
+public:
+    /// \brief Prepara el detector.
+    /// \param settings Umbral, ventana y límite de frecuencia.
+    explicit HitchDetector(const HitchSettings& settings);
+
+    /// \brief Vuelca el frame lento pendiente, termina de escribir las trazas encoladas y
+    /// detiene la hebra de escritura.
+    ~HitchDetector();
+
+    HitchDetector(const HitchDetector&) = delete;
+    HitchDetector& operator=(const HitchDetector&) = delete;
+
+    /// \brief Añade un frame terminado y comprueba si es lento.
+    /// \param serial Número de frame.
+    /// \param marks Instantes de sus fases.
+    /// \param counters Contadores del frame.
+    /// \param records Salida: frames lentos volcados, omitidos o incluidos en la traza
+    /// de otro (se vacía en cada llamada).
+    /// \return \c true si \p records contiene algún frame lento nuevo.
+    bool addFrame(
+        uint64_t serial,
+        const FrameTraceMarks& marks,
+        const TraceCounters& counters,
+        std::vector<HitchRecord>& records);
+
+    /// \brief Asocia el intervalo de GPU a su frame.
+    /// \param span Intervalo traducido al reloj de la CPU.
+    void addGpuFrame(const GpuFrameSpan& span)
+    {
+        FrameTrace::attachGpuFrame(frames, span);
+    }
+
+    /// \brief Umbral vigente (ms).
+    float getThresholdMs() const
+    {
+        return (thresholdMs);
+    }
+
+private:
+    /// Máximo de frames en el anillo (acota la memoria con tasas de frame muy altas).
+    static constexpr size_t MAX_FRAMES = 4096;
+    /// Frames necesarios antes de usar el umbral relativo (arranque, compilación de shaders).
+    static constexpr size_t MIN_FRAMES = 30;
+
+    /// \brief Traza encolada para la hebra de escritura.
+    struct DumpJob
+    {
+        /// Ruta de destino.
+        std::string path;
+        /// Frames de la ventana.
+        std::vector<TraceFrame> window;
+        /// Frame lento marcado.
+        HitchRecord hitch;
+    };
+
+    /// \brief Ruta de la traza de un frame lento.
+    std::string tracePathOf(const HitchRecord& hitch) const;
+
+    /// \brief Copia la ventana alrededor de \c pending y la encola para escribirla.
+    void dump();
+
+    /// \brief Bucle de la hebra de escritura.
+    void writerLoop();
+
+    /// Parámetros.
+    HitchSettings settings;
+    /// Últimos frames, en orden.
+    std::deque<TraceFrame> frames;
+    /// Umbral calculado con el último frame (ms).
+    float thresholdMs = 0.0f;
+    /// Primer frame observado (ns de \c steady_clock).
+    double startNs = 0.0;
+    /// Final del último volcado (ns; negativo si aún no ha habido ninguno).
+    double lastDumpNs = -1.0;
+    /// Frame lento a la espera de sus segundos posteriores.
+    HitchRecord pending {};
+    /// Final del frame pendiente (ns).
+    double pendingEndNs = 0.0;
+    /// Hay un volcado pendiente.
+    bool hasPending = false;
+    /// Periodos de los frames del anillo (reutilizado para la mediana).
+    std::vector<float> periods;
+
+    /// Protege \c jobs y \c stopping.
+    std::mutex mutex;
+    /// Despierta a la hebra de escritura.
+    std::condition_variable wakeUp;
+    /// Trazas pendientes de escribir.
+    std::deque<DumpJob> jobs;
+    /// Indica a la hebra de escritura que termine tras vaciar \c jobs.
+    bool stopping = false;
+    /// Hebra de escritura (los volcados no bloquean la hebra de render).
+    std::thread writer;
+};
@@ -0,0 +1,195 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ImpostorSystem.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "GraphicsPipeline.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+ /// \brief Parámetros de sustitución de mallas por impostores.
+struct ImpostorSettings
+{
+    /// Distancia (centro de la esfera envolvente a la cámara) a partir de la cual
+    /// un objeto pasa a dibujarse como impostor.
+    float switchDistance = 12.0f;
+
+    /// Fracción de \c switchDistance que hay que acercarse para volver a la malla;
+    /// evita que un objeto en el umbral alterne cada frame.
+    float hysteresis = 0.15f;
+};
+
+/// \brief Sustituye objetos lejanos por quads orientados que muestrean un atlas.
+/// \details Para cada \c Model se hornea, una sola vez y dentro del command
+/// buffer del frame, un atlas octaédrico de <tt>GRID x GRID</tt> vistas
+/// ortográficas en un render pass fuera de pantalla. Los atlas se guardan en
+/// caché por modelo y sólo se regeneran tras \c invalidate. Cada frame, los
+/// objetos más allá de la distancia de cambio (con histéresis) se marcan con
+/// \c GameObject::drawAsImpostor, \c BasicRenderer los omite y \c render los
+/// dibuja con un draw instanciado por atlas: un quad de seis vértices generado
+/// en el vertex shader, igual que el billboard de \c point_light.vert, pero
+/// orientado según la vista del atlas más cercana a la dirección de la cámara.
+class ImpostorSystem
+{
+public:
+    /// Vistas por lado del atlas octaédrico.
+    static constexpr uint32_t GRID = 8;
+    /// Resolución (píxeles por lado) de cada atlas.
+    static constexpr uint32_t ATLAS_SIZE = 1024;
+    /// Máximo de modelos con atlas en caché.
+    static constexpr uint32_t MAX_ATLASES = 32;
+    /// Máximo de impostores dibujados por frame.
+    static constexpr uint32_t MAX_INSTANCES = 4096;
+
+    /// \brief Crea el render pass de horneado, las tuberías y los búferes de instancias.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param renderPass Render pass donde se dibujan los impostores.
+    /// \param globalSetLayout Layout de descriptores global (set 0).
+    ImpostorSystem(
+        VulkanDevice& device,
+        VkRenderPass renderPass,
+        VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Libera atlas, tuberías y recursos asociados.
+    ~ImpostorSystem();
+
+    ImpostorSystem(const ImpostorSystem&) = delete;
+    ImpostorSystem& operator=(const ImpostorSystem&) = delete;
+
+    /// \brief Decide qué objetos se dibujan como impostor y hornea los atlas pendientes.
+    /// \details Debe llamarse fuera del render pass y antes de grabar la escena.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Dibuja los impostores del frame (un draw instanciado por atlas).
+    /// \param frameInfo Contexto del frame con el render pass activo.
+    void render(FrameInfo& frameInfo);
+
+    /// \brief Fuerza a volver a hornear el atlas de un modelo la próxima vez que se use.
+    /// \param model Modelo cuyo atlas ha quedado obsoleto.
+    void invalidate(const Model* model);
+
+    /// \brief Acceso a los parámetros para ajustarlos en tiempo de ejecución.
+    ImpostorSettings& getSettings()
+    {
+        return (settings);
+    }
+
+    /// \brief Impostores dibujados en el último frame.
+    uint32_t getImpostorCount() const
+    {
+        return (impostorCount);
+    }
+
+private:
+    /// \brief Atlas de vistas de un modelo.
+    struct Atlas
+    {
+        /// Modelo horneado (se mantiene vivo mientras el atlas esté en caché).
+        std::shared_ptr<Model> model;
+        /// Imagen de color del atlas.
+        VkImage image = VK_NULL_HANDLE;
+        /// Memoria de la imagen.
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        /// Vista de la imagen.
+        VkImageView view = VK_NULL_HANDLE;
+        /// Framebuffer de horneado (atlas + profundidad compartida).
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        /// Descriptor set con el atlas como combined image sampler.
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        /// Indica si el contenido es válido.
+        bool baked = false;
+        /// Primera instancia del frame actual en el búfer de instancias.
+        uint32_t firstInstance = 0;
+        /// Instancias del frame actual.
+        uint32_t instanceCount = 0;
+    };
+
+    /// \brief Crea el render pass de horneado y la imagen de profundidad compartida.
+    void createBakeTargets();
+
+    /// \brief Crea el sampler, los layouts, el pool y los búferes de instancias.
+    void createDescriptors();
+
+    /// \brief Crea los pipeline layouts de horneado y de render.
+    /// \param globalSetLayout Layout de descriptores global.
+    void createPipelineLayouts(VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Crea las tuberías de horneado y de render.
+    /// \param renderPass Render pass donde se dibujan los impostores.
+    void createPipelines(VkRenderPass renderPass);
+
+    /// \brief Devuelve el atlas de un modelo, creándolo (sin hornear) si no existe.
+    /// \param model Modelo a buscar.
+    /// \return Atlas o \c nullptr si se ha alcanzado \c MAX_ATLASES.
+    Atlas* findOrCreateAtlas(const std::shared_ptr<Model>& model);
+
+    /// \brief Graba el horneado de las \c GRID x \c GRID vistas de un atlas.
+    /// \param commandBuffer Command buffer del frame (fuera de render pass).
+    /// \param atlas Atlas destino.
+    void bakeAtlas(VkCommandBuffer commandBuffer, Atlas& atlas);
+
+    /// \brief Libera los objetos Vulkan de un atlas.
+    /// \param atlas Atlas a destruir.
+    void destroyAtlas(Atlas& atlas);
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Parámetros de sustitución.
+    ImpostorSettings settings {};
+
+    /// Atlas en caché, indexados por modelo.
+    std::unordered_map<const Model*, std::unique_ptr<Atlas>> atlases;
+
+    /// Estado con histéresis de cada objeto (\c true = impostor); \c update descarta los
+    /// de objetos que ya no están en la escena.
+    std::unordered_map<unsigned int, bool> impostorState;
+
+    /// Impostores dibujados en el último frame.
+    uint32_t impostorCount = 0;
+
+    /// Formato de la profundidad de horneado.
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    /// Profundidad compartida por todos los horneados.
+    VkImage depthImage = VK_NULL_HANDLE;
+    /// Memoria de la profundidad.
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    /// Vista de la profundidad.
+    VkImageView depthView = VK_NULL_HANDLE;
+    /// Render pass de horneado (deja el atlas listo para muestrear).
+    VkRenderPass bakeRenderPass = VK_NULL_HANDLE;
+
+    /// Sampler lineal del atlas.
+    VkSampler sampler = VK_NULL_HANDLE;
+    /// Pool para los sets de instancias y de atlas.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+    /// Layout del set de instancias (set 1).
+    std::unique_ptr<DescriptorSetLayout> instanceSetLayout;
+    /// Layout del set de atlas (set 2).
+    std::unique_ptr<DescriptorSetLayout> atlasSetLayout;
+    /// Instancias visibles por el host, una por frame en vuelo.
+    std::vector<std::unique_ptr<VulkanBuffer>> instanceBuffers;
+    /// Set de instancias de cada frame en vuelo.
+    std::vector<VkDescriptorSet> instanceSets;
+
+    /// Layout de horneado (sólo push constants).
+    VkPipelineLayout bakeLayout = VK_NULL_HANDLE;
+    /// Layout de render (global + instancias + atlas).
+    VkPipelineLayout renderLayout = VK_NULL_HANDLE;
+    /// Tubería de horneado.
+    std::unique_ptr<GraphicsPipeline> bakePipeline;
+    /// Tubería de impostores.
+    std::unique_ptr<GraphicsPipeline> renderPipeline;
+};
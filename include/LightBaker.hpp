@@ -0,0 +1,249 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: LightBaker.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Model.hpp"
+
+#include <functional>
+#include <ostream>
+#include <vector>
+
+ /// \brief Parámetros de \c LightBaker.
+struct LightBakeSettings
+{
+    /// Calcula la oclusión ambiental de cada vértice.
+    bool ambientOcclusion = true;
+    /// Rayos de oclusión ambiental por vértice.
+    uint32_t aoSamples = 64;
+    /// Distancia máxima a la que un obstáculo ocluye (unidades de mundo).
+    float aoDistance = 0.5f;
+    /// Añade un rebote de luz indirecta.
+    bool bounce = true;
+    /// Rayos de rebote por vértice.
+    uint32_t bounceSamples = 64;
+    /// Rayos de rebote por sonda de \c bakeProbes.
+    uint32_t probeSamples = 256;
+    /// Hebras de trabajo (0 = \c std::thread::hardware_concurrency).
+    uint32_t threads = 0;
+};
+
+/// \brief Luz puntual estática que se hornea.
+struct BakeLight
+{
+    /// Posición en mundo.
+    glm::vec3 position {0.0f};
+    /// Color (RGB).
+    glm::vec3 color {1.0f};
+    /// Intensidad.
+    float intensity = 1.0f;
+    /// Alcance, con la misma atenuación con ventana que \c simple_shader.frag.
+    float range = 1.0f;
+};
+
+/// \brief Malla estática que recibe y bloquea la luz.
+struct BakeTarget
+{
+    /// Vértices e índices de la malla; \c bake reescribe su irradiancia.
+    Model::Builder* builder = nullptr;
+    /// Transformación de modelo a mundo.
+    glm::mat4 transform {1.0f};
+};
+
+/// \brief Resultado del último horneado.
+struct LightBakeStats
+{
+    /// Vértices horneados.
+    uint32_t vertices = 0;
+    /// Triángulos de la BVH.
+    uint32_t triangles = 0;
+    /// Nodos de la BVH.
+    uint32_t nodes = 0;
+    /// Luces horneadas.
+    uint32_t lights = 0;
+    /// Hebras usadas.
+    uint32_t threads = 0;
+    /// Sondas horneadas por \c bakeProbes.
+    uint32_t probes = 0;
+    /// Rayos lanzados (sombra, oclusión y rebote).
+    uint64_t rays = 0;
+    /// Construcción de la BVH (ms).
+    float buildMs = 0.0f;
+    /// Horneado de los vértices (ms).
+    float bakeMs = 0.0f;
+    /// Horneado de las sondas (ms).
+    float probeMs = 0.0f;
+};
+
+/// \brief Horneador de iluminación estática en los vértices.
+/// \details Construye una BVH (división por la mediana del eje mayor de los
+/// centroides) sobre los triángulos de las mallas estáticas y calcula en la CPU, con
+/// varias hebras, la luz que reciben sus vértices: directa de las luces estáticas con
+/// rayos de sombra, y opcionalmente oclusión ambiental y un rebote indirecto con
+/// muestras de coseno sobre el hemisferio. El resultado se escribe en
+/// \c Model::Vertex::irradiance, de modo que en ejecución esas luces no se evalúan
+/// sobre la geometría estática (\c LightGrid las omite en sus listas).
+class LightBaker
+{
+public:
+    /// Coeficientes SH L2 por sonda (debe coincidir con \c ProbeGrid::COEFFICIENTS).
+    static constexpr uint32_t PROBE_COEFFICIENTS = 9;
+
+    /// \brief Prepara el horneador.
+    /// \param settings Muestras, rebote y hebras.
+    explicit LightBaker(const LightBakeSettings& settings);
+
+    /// \brief Añade una luz estática.
+    /// \param light Luz a hornear.
+    void addLight(const BakeLight& light);
+
+    /// \brief Hornea la iluminación de \p targets en la irradiancia de sus vértices.
+    /// \details Todas las mallas bloquean la luz y la reciben. Se guarda la irradiancia
+    /// E de las luces horneadas en \c rgb y la oclusión ambiental en \c a;
+    /// \c simple_shader.frag calcula <tt>albedo * (ambiente * AO + E + luces dinámicas)</tt>,
+    /// así que las luces dinámicas se suman sin quedar escaladas por lo horneado. El
+    /// color de los vértices (el albedo) no cambia.
+    /// \param targets Mallas estáticas (se modifican).
+    /// \param progress Flujo donde se informa del avance.
+    /// \return Estadísticas del horneado.
+    const LightBakeStats& bake(std::vector<BakeTarget>& targets, std::ostream& progress);
+
+    /// \brief Hornea la irradiancia de una rejilla de sondas en armónicos esféricos L2.
+    /// \details Debe llamarse después de \c bake, cuya BVH y luces reutiliza. Cada sonda
+    /// proyecta en SH la luz directa de las luces visibles (con rayos de sombra) y la
+    /// reflejada por la geometría estática (muestras uniformes sobre la esfera, con
+    /// <tt>albedo * E</tt> en el punto alcanzado), y la convoluciona con el coseno.
+    /// \param origin Posición de la primera sonda.
+    /// \param spacing Distancia entre sondas en cada eje.
+    /// \param resolution Sondas por eje.
+    /// \param coefficients Salida: \c PROBE_COEFFICIENTS por sonda (RGB en xyz), con el
+    /// índice <tt>x + resolution.x * (y + resolution.y * z)</tt>.
+    /// \param progress Flujo donde se informa del avance.
+    /// \return Estadísticas del horneado.
+    const LightBakeStats& bakeProbes(
+        const glm::vec3& origin,
+        const glm::vec3& spacing,
+        const glm::uvec3& resolution,
+        std::vector<glm::vec4>& coefficients,
+        std::ostream& progress);
+
+    /// \brief Resultado del último horneado.
+    const LightBakeStats& getStats() const
+    {
+        return (stats);
+    }
+
+    /// \brief Imprime las estadísticas (incluidos rayos por segundo).
+    /// \param stats Resultado de \c bake (y \c bakeProbes).
+    /// \param out Flujo de salida.
+    static void print(const LightBakeStats& stats, std::ostream& out);
+
+private:
+    /// Triángulos por hoja de la BVH.
+    static constexpr uint32_t LEAF_TRIANGLES = 4;
+    /// Vértices por tarea de las hebras.
+    static constexpr uint32_t CHUNK_VERTICES = 256;
+    /// Sondas por tarea de las hebras.
+    static constexpr uint32_t CHUNK_PROBES = 1;
+
+    /// \brief Triángulo en mundo con sus aristas precalculadas.
+    struct Triangle
+    {
+        /// Primer vértice.
+        glm::vec3 v0 {};
+        /// \c v1 - \c v0.
+        glm::vec3 edge1 {};
+        /// \c v2 - \c v0.
+        glm::vec3 edge2 {};
+        /// Albedo medio (colores de vértice originales).
+        glm::vec3 albedo {};
+    };
+
+    /// \brief Nodo de la BVH.
+    struct Node
+    {
+        /// Esquina mínima de la caja.
+        glm::vec3 boundsMin {};
+        /// Hijo izquierdo (interior; el derecho es el siguiente) o primer triángulo (hoja).
+        uint32_t leftOrFirst = 0;
+        /// Esquina máxima de la caja.
+        glm::vec3 boundsMax {};
+        /// Triángulos de la hoja (0 en nodos interiores).
+        uint32_t count = 0;
+    };
+
+    /// \brief Intersección más cercana de un rayo.
+    struct Hit
+    {
+        /// Distancia.
+        float t = 0.0f;
+        /// Triángulo alcanzado.
+        uint32_t triangle = 0;
+    };
+
+    /// \brief Reparte \p count elementos entre las hebras en tareas de \p chunk.
+    /// \details Las hebras toman tareas de un contador atómico; la hebra llamante sólo
+    /// informa del avance cada \c PROGRESS_STEP %.
+    /// \param count Elementos a procesar.
+    /// \param chunk Elementos por tarea.
+    /// \param label Nombre de la fase en los mensajes de avance.
+    /// \param progress Flujo donde se informa del avance.
+    /// \param work Trabajo de un elemento; recibe su índice y el contador de rayos de la hebra.
+    /// \return Rayos lanzados en total.
+    uint64_t parallelFor(
+        uint32_t count,
+        uint32_t chunk,
+        const char* label,
+        std::ostream& progress,
+        const std::function<void(uint32_t, uint64_t&)>& work);
+
+    /// \brief Construye la BVH sobre \c triangles.
+    void buildBvh();
+
+    /// \brief Subdivide un nodo y, recursivamente, sus hijos.
+    /// \param index Nodo a subdividir (ya con su rango de \p order).
+    /// \param centroids Centroides de los triángulos.
+    /// \param order Índices de los triángulos, que se reordenan por hojas.
+    void subdivide(uint32_t index, const std::vector<glm::vec3>& centroids, std::vector<uint32_t>& order);
+
+    /// \brief Recorre la BVH con un rayo.
+    /// \param origin Origen del rayo.
+    /// \param direction Dirección (normalizada).
+    /// \param tMax Distancia máxima.
+    /// \param hit Salida de la intersección más cercana; si es nulo basta con la primera.
+    /// \return \c true si el rayo alcanza algún triángulo antes de \p tMax.
+    bool trace(const glm::vec3& origin, const glm::vec3& direction, float tMax, Hit* hit) const;
+
+    /// \brief Irradiancia directa de las luces estáticas, con rayos de sombra.
+    /// \param position Punto en mundo.
+    /// \param normal Normal en mundo (normalizada).
+    /// \param rays Contador de rayos de la hebra.
+    /// \return Irradiancia (misma escala que \c simple_shader.frag).
+    glm::vec3 directLight(const glm::vec3& position, const glm::vec3& normal, uint64_t& rays) const;
+
+    /// \brief Irradiancia que se guarda en un vértice.
+    /// \param position Punto en mundo.
+    /// \param normal Normal en mundo (normalizada).
+    /// \param seed Semilla del vértice (resultado reproducible).
+    /// \param rays Contador de rayos de la hebra.
+    /// \return Irradiancia E (\c rgb) y oclusión ambiental (\c a).
+    glm::vec4 bakeVertex(const glm::vec3& position, const glm::vec3& normal, uint32_t seed, uint64_t& rays) const;
+
+    /// Parámetros.
+    LightBakeSettings settings;
+    /// Luces estáticas.
+    std::vector<BakeLight> lights;
+    /// Triángulos de la escena estática (en el orden de las hojas).
+    std::vector<Triangle> triangles;
+    /// Nodos de la BVH (el 0 es la raíz).
+    std::vector<Node> nodes;
+    /// Desplazamiento de los orígenes de los rayos sobre la superficie.
+    float rayEpsilon = 1e-4f;
+    /// Resultado del último horneado.
+    LightBakeStats stats {};
+};
@@ -0,0 +1,201 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: LightGrid.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "FrameContext.hpp"
+#include "Perf.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <vector>
+
+ /// \brief Parámetros de la rejilla de luces.
+struct LightGridSettings
+{
+    /// Lado de cada celda de la rejilla (unidades de mundo).
+    float cellSize = 2.0f;
+
+    /// Irradiancia a partir de la cual una luz deja de influir; fija su alcance
+    /// como <tt>sqrt(intensidad / influenceCutoff)</tt>.
+    float influenceCutoff = 0.01f;
+
+    /// Luces asignadas como máximo a cada objeto (se acota a \c MAX_OBJECT_LIGHTS).
+    uint32_t maxLightsPerObject = 8;
+};
+
+/// \brief Asigna a cada objeto las luces puntuales que más le influyen.
+/// \details Cada frame inserta todas las luces de la escena en una rejilla uniforme
+/// dispersa por hash (cada luz en todas las celdas que toca la caja de su esfera de
+/// alcance, con un conteo + suma prefija para dejar las entradas contiguas por cubeta)
+/// y consulta, para cada objeto con malla, las celdas que cubre su esfera envolvente.
+/// De las candidatas se quedan las \c maxLightsPerObject con mayor intensidad / d^2.
+/// Las luces y las listas se copian a dos SSBO del frame (bindings 1 y 2 del set
+/// global) y el índice de la lista de cada objeto se guarda en
+/// \c GameObject::lightList, que \c BasicRenderer pasa como \c firstInstance para
+/// que \c simple_shader.frag recorra sólo esas luces. La lista 0 es la de la
+/// posición de la cámara y la usan los objetos que no caben en \c MAX_LIT_OBJECTS.
+/// Con la iluminación por sondas activa, los objetos sin \c GameObject::staticGeometry
+/// comparten la lista \c PROBE_LIST, vacía y marcada con \c PROBE_LIT, y se iluminan
+/// con \c ProbeGrid. Las luces horneadas (\c PointLight::baked) se copian detrás de
+/// las dinámicas y sólo se omiten en las listas de la geometría estática, que ya las
+/// lleva en la irradiancia de sus vértices.
+class LightGrid
+{
+public:
+    /// Máximo de luces por lista (debe coincidir con \c simple_shader.frag).
+    static constexpr uint32_t MAX_OBJECT_LIGHTS = 8;
+    /// Enteros por lista: número de luces seguido de sus índices.
+    static constexpr uint32_t LIST_STRIDE = MAX_OBJECT_LIGHTS + 1;
+    /// Máximo de luces de escena copiadas a GPU por frame.
+    static constexpr uint32_t MAX_SCENE_LIGHTS = 4096;
+    /// Máximo de listas por frame (incluida la lista 0 de la cámara).
+    static constexpr uint32_t MAX_LIT_OBJECTS = 16384;
+    /// Bit del contador de una lista: el objeto se ilumina con las sondas de \c ProbeGrid.
+    static constexpr uint32_t PROBE_LIT = 0x80000000u;
+    /// Lista compartida por los objetos iluminados con sondas.
+    static constexpr uint32_t PROBE_LIST = 1;
+
+    /// \brief Crea los SSBO de luces y de listas de cada frame en vuelo.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param framesInFlight Nº de frames en vuelo.
+    /// \param settings Parámetros de la rejilla.
+    LightGrid(VulkanDevice& device, uint32_t framesInFlight, const LightGridSettings& settings = {});
+
+    LightGrid(const LightGrid&) = delete;
+    LightGrid& operator=(const LightGrid&) = delete;
+
+    /// \brief Reconstruye la rejilla y escribe las listas de luces del frame.
+    /// \details Debe llamarse después de mover las luces y de decidir qué objetos se
+    /// dibujan como impostor, y antes de grabar la escena.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Descriptor del SSBO de luces de un frame.
+    /// \param frameIndex Índice de frame en vuelo.
+    VkDescriptorBufferInfo lightsInfo(uint32_t frameIndex) const
+    {
+        return (lightBuffers[frameIndex]->descriptorInfo());
+    }
+
+    /// \brief Descriptor del SSBO de listas de un frame.
+    /// \param frameIndex Índice de frame en vuelo.
+    VkDescriptorBufferInfo listsInfo(uint32_t frameIndex) const
+    {
+        return (listBuffers[frameIndex]->descriptorInfo());
+    }
+
+    /// \brief Cambia el máximo de luces por objeto (p.ej., desde el gobernador de calidad).
+    /// \param count Luces por objeto (se acota a [1, \c MAX_OBJECT_LIGHTS]).
+    void setMaxLightsPerObject(uint32_t count);
+
+    /// \brief Activa la iluminación por sondas de los objetos dinámicos.
+    /// \param enabled Si es \c true, los objetos sin \c staticGeometry usan \c PROBE_LIST.
+    void setProbeLighting(bool enabled)
+    {
+        probeLighting = enabled;
+    }
+
+    /// \brief Parámetros actuales.
+    const LightGridSettings& getSettings() const
+    {
+        return (settings);
+    }
+
+    /// \brief Luces no horneadas del último \c update.
+    /// \details Ocupan las primeras posiciones del SSBO de luces; \c ProbeGrid sólo
+    /// suma éstas a la parte horneada de las sondas.
+    uint32_t getDynamicLightCount() const
+    {
+        return (dynamicLights);
+    }
+
+    /// \brief Estadísticas del último \c update.
+    const LightGridStats& getStats() const
+    {
+        return (stats);
+    }
+
+private:
+    /// \brief Luz insertada en la rejilla.
+    struct GridLight
+    {
+        /// Posición en mundo.
+        glm::vec3 position {};
+        /// Alcance (radio de influencia).
+        float range = 0.0f;
+        /// Intensidad.
+        float intensity = 0.0f;
+        /// Ya está en la irradiancia horneada de la geometría estática.
+        bool baked = false;
+    };
+
+    /// \brief Candidata a entrar en una lista.
+    struct Candidate
+    {
+        /// Índice en \c lights.
+        uint32_t index = 0;
+        /// Influencia estimada.
+        float score = 0.0f;
+    };
+
+    /// \brief Celdas (mínima y máxima) que cubre una esfera.
+    void cellRange(const glm::vec3& center, float radius, glm::ivec3& lo, glm::ivec3& hi) const;
+
+    /// \brief Cubeta de la tabla hash que corresponde a una celda.
+    uint32_t bucketOf(int x, int y, int z) const;
+
+    /// \brief Inserta las luces de \c lights en la tabla hash.
+    void build();
+
+    /// \brief Escribe en \c list las luces con más influencia sobre una esfera.
+    /// \param center Centro de la esfera en mundo.
+    /// \param radius Radio de la esfera.
+    /// \param list Lista de destino (\c LIST_STRIDE enteros).
+    /// \param skipBaked Descarta las luces horneadas (objetos con \c staticGeometry).
+    /// \return Número de luces candidatas evaluadas.
+    uint32_t query(const glm::vec3& center, float radius, uint32_t* list, bool skipBaked = false);
+
+    /// Número de cubetas de la tabla hash (potencia de dos).
+    static constexpr uint32_t BUCKET_COUNT = 4096;
+    /// Celdas que puede cubrir una luz antes de tratarla como global.
+    static constexpr uint32_t MAX_CELLS_PER_LIGHT = 64;
+    /// Celdas que puede cubrir un objeto antes de recorrer todas las luces.
+    static constexpr uint32_t MAX_CELLS_PER_QUERY = 512;
+
+    /// Parámetros de la rejilla.
+    LightGridSettings settings;
+
+    /// SSBO de luces (\c GpuPointLight, \c w de la posición = alcance), uno por frame.
+    std::vector<std::unique_ptr<VulkanBuffer>> lightBuffers;
+    /// SSBO de listas de luces por objeto, uno por frame.
+    std::vector<std::unique_ptr<VulkanBuffer>> listBuffers;
+
+    /// Luces del frame (primero las dinámicas y después las horneadas).
+    std::vector<GridLight> lights;
+    /// Luces no horneadas al principio de \c lights.
+    uint32_t dynamicLights = 0;
+    /// Luces cuyo alcance cubre demasiadas celdas; se evalúan en todas las consultas.
+    std::vector<uint32_t> wideLights;
+    /// Primera entrada de cada cubeta en \c entries (\c BUCKET_COUNT + 1 valores).
+    std::vector<uint32_t> bucketStart;
+    /// Siguiente posición libre de cada cubeta durante el relleno.
+    std::vector<uint32_t> bucketCursor;
+    /// Índices de luz agrupados por cubeta.
+    std::vector<uint32_t> entries;
+    /// Último sello de consulta que visitó cada luz (evita evaluarla dos veces).
+    std::vector<uint32_t> visited;
+    /// Sello de la consulta actual.
+    uint32_t stamp = 0;
+
+    /// Los objetos dinámicos se iluminan con sondas.
+    bool probeLighting = false;
+
+    /// Estadísticas del último \c update.
+    LightGridStats stats {};
+};
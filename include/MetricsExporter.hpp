@@ -0,0 +1,142 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: MetricsExporter.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Perf.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+ /// \brief Copia de las métricas de un frame que se publica hacia el exportador.
+ /// \details Sólo contiene datos planos: el render copia sus valores y el
+ /// exportador calcula percentiles y da formato en su propia hebra.
+struct MetricsSnapshot
+{
+    /// Frames completados desde el arranque.
+    uint64_t frames = 0;
+    /// FPS instantáneos.
+    double fps = 0.0;
+    /// ms de CPU del último frame y media.
+    double cpuFrameMs = 0.0;
+    double cpuFrameMsAvg = 0.0;
+    /// ms de GPU del último frame y media.
+    double gpuFrameMs = 0.0;
+    double gpuFrameMsAvg = 0.0;
+    /// Uso de CPU del sistema y del proceso (%).
+    float cpuUsageSystem = 0.0f;
+    float cpuUsageProcess = 0.0f;
+    /// Últimos ms de CPU y GPU por frame (anillos de \c PerfStats).
+    std::array<float, PerfRing::Count> cpuMsHistory {};
+    std::array<float, PerfRing::Count> gpuMsHistory {};
+    /// ms de CPU y GPU acumulados y frames medidos desde el arranque.
+    double cpuFrameMsTotal = 0.0;
+    uint64_t cpuFrameCount = 0;
+    double gpuFrameMsTotal = 0.0;
+    uint64_t gpuFrameCount = 0;
+    /// Esperas de la swapchain del último frame.
+    FrameBlockingTimes blocking {};
+    /// Frames clasificados por CPU, GPU y presentación.
+    std::array<uint64_t, 3> boundFrames {};
+    /// Estado del streaming (válido si \c hasStreaming).
+    StreamingStats streaming {};
+    bool hasStreaming = false;
+    /// Cómputo asíncrono (válido si \c hasAsyncCompute).
+    AsyncComputeStats asyncCompute {};
+    bool hasAsyncCompute = false;
+    /// Rejilla de luces (válido si \c hasLightGrid).
+    LightGridStats lightGrid {};
+    bool hasLightGrid = false;
+    /// Gobernador de calidad (válido si \c hasQuality).
+    QualityStats quality {};
+    bool hasQuality = false;
+    /// Decisiones del gobernador desde el arranque.
+    uint64_t qualityDecisions = 0;
+};
+
+/// \brief Sirve las métricas de \c Perf en formato de texto de Prometheus por un
+/// socket de dominio UNIX.
+/// \details La hebra de render llama a \c publish una vez por frame: copia las
+/// métricas en uno de tres huecos y lo intercambia con un único \c exchange atómico
+/// (triple búfer), sin bloqueos ni esperas. Una hebra propia, con la prioridad más
+/// baja, acepta conexiones, toma el último hueco publicado del mismo modo y responde
+/// con el texto de exposición; si la petición empieza por \c GET responde además
+/// con una cabecera HTTP, de modo que sirve tanto
+/// <tt>curl --unix-socket PATH http://localhost/metrics</tt> como
+/// <tt>socat - UNIX-CONNECT:PATH</tt>. Sólo está disponible en Linux.
+class MetricsExporter
+{
+public:
+    /// \brief Prepara el exportador (no abre el socket).
+    /// \param socketPath Ruta del socket de dominio UNIX.
+    explicit MetricsExporter(const std::string& socketPath);
+
+    /// \brief Detiene la hebra, cierra el socket y borra su fichero.
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /// \brief Crea el socket y lanza la hebra de servicio.
+    /// \return \c false si el socket no se pudo crear o la plataforma no lo admite.
+    bool start();
+
+    /// \brief Publica las métricas del frame actual. Sin bloqueos (hebra de render).
+    /// \param perf Métricas del renderizador.
+    /// \param frames Frames completados desde el arranque.
+    void publish(const Perf& perf, uint64_t frames);
+
+    /// \brief Peticiones atendidas desde el arranque.
+    uint64_t getScrapeCount() const
+    {
+        return (scrapes.load(std::memory_order_relaxed));
+    }
+
+    /// \brief Da formato de texto de Prometheus a una copia de métricas.
+    /// \param snapshot Métricas a exponer.
+    /// \param scrapeCount Peticiones atendidas (se expone como contador).
+    /// \return Texto de exposición.
+    static std::string format(const MetricsSnapshot& snapshot, uint64_t scrapeCount);
+
+private:
+    /// \brief Bucle de la hebra de servicio.
+    void serve();
+
+    /// \brief Toma el último hueco publicado (lado lector del triple búfer).
+    /// \return Copia más reciente disponible.
+    const MetricsSnapshot& acquire();
+
+    /// Marca de hueco publicado y aún no leído en \c shared.
+    static constexpr uint32_t FRESH = 4;
+    /// Máscara del índice de hueco en \c shared.
+    static constexpr uint32_t SLOT_MASK = 3;
+
+    /// Ruta del socket.
+    std::string path;
+    /// Descriptor del socket de escucha (-1 si no está abierto).
+    int listenFd = -1;
+
+    /// Huecos del triple búfer.
+    std::array<MetricsSnapshot, 3> slots {};
+    /// Hueco que escribe la hebra de render.
+    uint32_t writeSlot = 0;
+    /// Hueco que lee la hebra de servicio.
+    uint32_t readSlot = 1;
+    /// Hueco intermedio (índice y marca \c FRESH).
+    std::atomic<uint32_t> shared {2};
+
+    /// La hebra de servicio debe seguir en marcha.
+    std::atomic<bool> running {false};
+    /// Peticiones atendidas.
+    std::atomic<uint64_t> scrapes {0};
+    /// Hebra de servicio.
+    std::thread thread;
+};
@@ -17,6 +17,12 @@
 
 #include <memory>
 
+namespace tinyobj
+{
+    struct attrib_t;
+    struct shape_t;
+}
+
  /// \brief Malla renderizable: encapsula buffers de vrtices/ndices en Vulkan.
  /// \details Carga/crea los datos de geometra (posiciones, normales, color y UV),
  /// construye \c VkBuffer para vrtices e ndices y expone \c bind()/\c draw()
@@ -37,20 +43,31 @@ public:
         glm::vec3 normal {};
         /// Coordenadas de textura (u,v).
         glm::vec2 uv {};
+        /// Luz horneada (r,g,b) y oclusin ambiental (a) de \c LightBaker en cuatro
+        /// medios flotantes empaquetados (\c setIrradiance); se suma al trmino ambiente
+        /// del shader (por defecto, sin luz horneada ni oclusin: (0, 0, 0, 1)).
+        /// \details Todas las mallas comparten este formato aunque no estn horneadas:
+        /// cuesta 8 bytes por vrtice (52 en total, frente a 44 sin l y 60 con \c vec4)
+        /// a cambio de un nico flujo de vrtices y un nico \c bind por malla.
+        glm::uvec2 irradiance {0u, 0x3C000000u};
 
         /// \brief Descriptores de binding para el pipeline.
         /// \return Vector con la nica entrada de binding usada por este formato.
         static std::vector<VkVertexInputBindingDescription> bindingDescriptions();
 
         /// \brief Descriptores de atributos para el pipeline.
-        /// \return Vector con las descripciones de posicin, color, normal y UV.
+        /// \return Vector con las descripciones de posicin, color, normal, UV e irradiancia.
         static std::vector<VkVertexInputAttributeDescription> attributeDescriptions();
 
+        /// \brief Empaqueta la luz horneada en \c irradiance.
+        /// \param value Luz (r,g,b) y oclusin (a); se redondea a media precisin.
+        void setIrradiance(const glm::vec4& value);
+
         /// \brief Comparacin exacta de vrtices (para eliminar duplicados).
         bool operator==(const Vertex& other) const
         {
             return ((position == other.position) && (color == other.color) &&
-                (normal == other.normal) && (uv == other.uv));
+                (normal == other.normal) && (uv == other.uv) && (irradiance == other.irradiance));
         }
     };
 
@@ -68,12 +85,48 @@ public:
         /// \param filepath Ruta del fichero.
         /// \post \c vertices y \c indices quedan poblados.
         void loadFromFile(const std::string& filepath);
+
+        /// \brief Carga la malla desde el contenido de un OBJ ya ledo (p.ej., con \c AssetIO).
+        /// \details Los materiales (.mtl) no se resuelven; slo se usan posiciones,
+        /// colores, normales y UV, igual que en \c loadFromFile.
+        /// \param data Bytes del fichero OBJ.
+        /// \post \c vertices y \c indices quedan poblados.
+        void loadFromMemory(const std::vector<char>& data);
+
+    private:
+        /// \brief Construye vrtices nicos e ndices a partir de los datos de tinyobjloader.
+        /// \param attrib Atributos (posiciones, colores, normales, UV).
+        /// \param shapes Formas con sus ndices.
+        void fromObj(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes);
     };
 
     /// \brief Crea la malla en GPU a partir de los datos del \c Builder.
     /// \param device Dispositivo lgico Vulkan.
     /// \param builder Datos de vrtices/ndices ya cargados en CPU.
-    Model(VulkanDevice& device, const Builder& builder);
+    /// \param extraVertexUsage Usos adicionales del buffer de vrtices (p.ej.,
+    /// \c VK_BUFFER_USAGE_STORAGE_BUFFER_BIT para que un compute shader lo escriba).
+    /// \param deferUpload Si es \c true no se enva ninguna copia a la cola: los datos quedan
+    /// en buffers de staging hasta que se llame a \c recordUpload (permite crear la malla
+    /// desde hebras de carga sin bloquear la cola de grficos).
+    Model(
+        VulkanDevice& device,
+        const Builder& builder,
+        VkBufferUsageFlags extraVertexUsage = 0,
+        bool deferUpload = false);
+
+    /// \brief Crea la malla sobre un tramo de un buffer de vrtices compartido.
+    /// \details Slo se crea el buffer de ndices: los vrtices no se suben, los escribe
+    /// quien posee \p sharedVertices (p.ej., el skinning de todos los personajes en un
+    /// nico dispatch). \c bind enlaza el buffer en \p vertexOffset.
+    /// \param device Dispositivo lgico Vulkan.
+    /// \param builder Datos de la malla (los vrtices slo se usan para los lmites).
+    /// \param sharedVertices Buffer con uso de vrtices (y \c TRANSFER_SRC para \c readBack).
+    /// \param vertexOffset Bytes hasta el primer vrtice de la malla.
+    Model(
+        VulkanDevice& device,
+        const Builder& builder,
+        std::shared_ptr<VulkanBuffer> sharedVertices,
+        VkDeviceSize vertexOffset);
 
     /// \brief Libera los buffers de GPU asociados a la malla.
     ~Model();
@@ -93,21 +146,93 @@ public:
 
     /// \brief Emite la orden de dibujo (indexed o no) sobre el \c commandBuffer.
     /// \param commandBuffer Command buffer en el que se estn grabando comandos.
-    void draw(VkCommandBuffer commandBuffer);
+    /// \param firstInstance Llega al shader como \c gl_InstanceIndex (p.ej., la lista de luces).
+    void draw(VkCommandBuffer commandBuffer, uint32_t firstInstance = 0);
+
+    /// \brief Graba en \c commandBuffer las copias staging -> GPU pendientes.
+    /// \details Slo tiene efecto si la malla se cre con \c deferUpload. Quien llama debe
+    /// aadir la barrera TRANSFER -> VERTEX_INPUT antes de dibujar y mantener la malla viva
+    /// hasta que el command buffer termine; despus puede llamar a \c releaseStaging.
+    /// \param commandBuffer Command buffer fuera de un render pass.
+    void recordUpload(VkCommandBuffer commandBuffer);
+
+    /// \brief Libera los buffers de staging de una subida diferida ya completada.
+    void releaseStaging();
+
+    /// \brief Copia a la CPU los vrtices e ndices que hay en la GPU.
+    /// \details Sirve tambin para mallas que escribe la GPU (p.ej., skinning).
+    /// Espera a que termine la copia.
+    /// \param builder Salida con los vrtices y los ndices (vacos si no hay).
+    void readBack(Builder& builder);
+
+    /// \brief Indica si quedan datos en staging pendientes de copiar o liberar.
+    bool hasStaging() const
+    {
+        return (vertexStaging != nullptr || indexStaging != nullptr);
+    }
+
+    /// \brief Bytes de memoria de dispositivo ocupados por los buffers de la malla.
+    VkDeviceSize getDeviceBytes() const
+    {
+        return (static_cast<VkDeviceSize>(vertexCount) * sizeof(Vertex) +
+            static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t));
+    }
+
+    /// \brief Buffer de vrtices en GPU.
+    VkBuffer getVertexBuffer() const
+    {
+        return (vertexBuffer->getBuffer());
+    }
+
+    /// \brief Bytes hasta el primer vrtice de la malla en \c getVertexBuffer.
+    VkDeviceSize getVertexOffset() const
+    {
+        return (vertexOffset);
+    }
+
+    /// \brief Nmero de vrtices de la malla.
+    uint32_t getVertexCount() const
+    {
+        return (vertexCount);
+    }
+
+    /// \brief Centro de la esfera envolvente en espacio local.
+    glm::vec3 getBoundsCenter() const
+    {
+        return (boundsCenter);
+    }
+
+    /// \brief Radio de la esfera envolvente en espacio local.
+    float getBoundsRadius() const
+    {
+        return (boundsRadius);
+    }
 
 private:
     /// \brief Crea el \c VkBuffer de vrtices y transfiere los datos desde CPU.
     /// \param vertices Vector de vrtices.
-    void createVertexBuffer(const std::vector<Vertex>& vertices);
+    /// \param extraUsage Usos adicionales del buffer.
+    /// \param deferUpload Conserva el staging en lugar de copiar de inmediato.
+    void createVertexBuffer(
+        const std::vector<Vertex>& vertices,
+        VkBufferUsageFlags extraUsage,
+        bool deferUpload);
 
     /// \brief Crea el \c VkBuffer de ndices y transfiere los datos desde CPU.
     /// \param indices Vector de ndices (tringulos).
-    void createIndexBuffer(const std::vector<uint32_t>& indices);
+    /// \param deferUpload Conserva el staging en lugar de copiar de inmediato.
+    void createIndexBuffer(const std::vector<uint32_t>& indices, bool deferUpload);
+
+    /// \brief Calcula la esfera envolvente (centro de la AABB y distancia mxima).
+    /// \param vertices Vector de vrtices.
+    void computeBounds(const std::vector<Vertex>& vertices);
 
     /// Dispositivo lgico para crear/destruir buffers.
     VulkanDevice& device;
-    /// Buffer de vrtices en GPU.
-    std::unique_ptr<VulkanBuffer> vertexBuffer;
+    /// Buffer de vrtices en GPU (propio o compartido con otras mallas).
+    std::shared_ptr<VulkanBuffer> vertexBuffer;
+    /// Bytes hasta el primer vrtice en \c vertexBuffer.
+    VkDeviceSize vertexOffset = 0;
     /// Nmero de vrtices.
     uint32_t vertexCount = 0;
     /// Indica si hay ndice.
@@ -116,5 +241,13 @@ private:
     std::unique_ptr<VulkanBuffer> indexBuffer;
     /// Nmero de ndices (mltiplo de 3 si son tringulos).
     uint32_t indexCount = 0;
+    /// Staging de vrtices pendiente (slo con subida diferida).
+    std::unique_ptr<VulkanBuffer> vertexStaging;
+    /// Staging de ndices pendiente (slo con subida diferida).
+    std::unique_ptr<VulkanBuffer> indexStaging;
+    /// Centro de la esfera envolvente (espacio local).
+    glm::vec3 boundsCenter {0.0f};
+    /// Radio de la esfera envolvente (espacio local).
+    float boundsRadius = 0.0f;
 };
 
@@ -0,0 +1,235 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: MultiViewPass.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "GraphicsPipeline.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+class LightGrid;
+class ProbeGrid;
+
+ /// \brief Conjunto de vistas que dibuja \c MultiViewPass.
+enum class MultiViewMode : uint32_t
+{
+    /// Sin pase multivista.
+    Off,
+    /// Dos ojos separados \c MultiViewSettings::eyeSeparation en horizontal.
+    Stereo,
+    /// Seis caras de 90 grados alrededor de la cámara (entorno o sombras).
+    Cube
+};
+
+/// \brief Parámetros del pase multivista.
+struct MultiViewSettings
+{
+    /// Vistas a dibujar.
+    MultiViewMode mode = MultiViewMode::Stereo;
+
+    /// Resolución (píxeles por lado) de cada capa del destino.
+    uint32_t size = 512;
+
+    /// Distancia entre ojos en modo estéreo (unidades de mundo).
+    float eyeSeparation = 0.064f;
+
+    /// Plano cercano de las proyecciones.
+    float nearPlane = 0.1f;
+
+    /// Plano lejano de las proyecciones.
+    float farPlane = 100.0f;
+};
+
+/// \brief Estadísticas del último frame del pase multivista.
+struct MultiViewStats
+{
+    /// Vistas dibujadas.
+    uint32_t views = 0;
+
+    /// \c true si se ha usado \c VK_KHR_multiview (una sola grabación).
+    bool multiview = false;
+
+    /// Draw calls grabados (con multivista, uno por objeto visible en alguna vista).
+    uint32_t draws = 0;
+
+    /// Objetos descartados por estar fuera de todas las vistas.
+    uint32_t culled = 0;
+
+    /// Tiempo de CPU de culling y grabación (ms).
+    float recordMs = 0.0f;
+};
+
+/// \brief Dibuja la escena en varias vistas de un destino por capas.
+/// \details Con \c VK_KHR_multiview el render pass se crea con una máscara de
+/// vistas y cada draw se replica en todas las capas: el vertex shader
+/// (\c simple_shader_multiview.vert) toma la matriz de \c GlobalUbo::viewProjections
+/// indexada por \c gl_ViewIndex. El culling se hace una vez contra la unión de los
+/// frustums (un objeto sólo se descarta si queda fuera de todas las vistas), de modo
+/// que N vistas cuestan una única grabación. Sin la característica se recurre a un
+/// render pass por vista, cada uno con su framebuffer de una capa, su UBO y su
+/// propio culling, con los shaders normales. El destino termina en
+/// \c SHADER_READ_ONLY_OPTIMAL para que lo muestreen pases posteriores.
+class MultiViewPass
+{
+public:
+    /// \brief Crea el destino por capas, el render pass, las tuberías y los descriptores.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param globalSetLayout Layout del set global (set 0).
+    /// \param lightGrid Listas de luces por objeto (bindings 1 y 2 del set global).
+    /// \param probeGrid Sondas de irradiancia (binding 3 del set global).
+    /// \param settings Parámetros del pase.
+    MultiViewPass(
+        VulkanDevice& device,
+        DescriptorSetLayout& globalSetLayout,
+        const LightGrid& lightGrid,
+        const ProbeGrid& probeGrid,
+        const MultiViewSettings& settings);
+
+    /// \brief Libera el destino, el render pass y las tuberías.
+    ~MultiViewPass();
+
+    MultiViewPass(const MultiViewPass&) = delete;
+    MultiViewPass& operator=(const MultiViewPass&) = delete;
+
+    /// \brief Graba el pase de todas las vistas en el command buffer del frame.
+    /// \details Debe llamarse fuera del render pass principal y después de
+    /// \c LightGrid::update.
+    /// \param frameInfo Contexto del frame.
+    /// \param sceneUbo UBO del pase principal (luz ambiental y luces puntuales).
+    void render(FrameInfo& frameInfo, const GlobalUbo& sceneUbo);
+
+    /// \brief Número de vistas del modo configurado.
+    uint32_t getViewCount() const
+    {
+        return (viewCount);
+    }
+
+    /// \brief Vista de tipo array (o cubo) del destino de color.
+    VkImageView getColorView() const
+    {
+        return (colorView);
+    }
+
+    /// \brief Estadísticas del último frame.
+    const MultiViewStats& getStats() const
+    {
+        return (stats);
+    }
+
+    /// \brief Nombre legible de un modo.
+    /// \param mode Modo a describir.
+    static const char* modeName(MultiViewMode mode);
+
+private:
+    /// \brief Plano de recorte: \c xyz normal hacia dentro, \c w distancia.
+    using Plane = glm::vec4;
+
+    /// \brief Los seis planos del frustum de una vista.
+    using Frustum = std::array<Plane, 6>;
+
+    /// \brief Crea la imagen de color por capas, la de profundidad y sus vistas.
+    void createTargets();
+
+    /// \brief Crea el render pass (con máscara de vistas si hay multivista) y los framebuffers.
+    void createRenderPass();
+
+    /// \brief Crea el pool, los UBO por vista y los descriptor sets.
+    /// \param globalSetLayout Layout del set global.
+    /// \param lightGrid Origen de los SSBO de luces.
+    /// \param probeGrid Origen del SSBO de sondas.
+    void createDescriptors(
+        DescriptorSetLayout& globalSetLayout, const LightGrid& lightGrid, const ProbeGrid& probeGrid);
+
+    /// \brief Crea el pipeline layout y la tubería del pase.
+    /// \param globalSetLayout Layout del set global.
+    void createPipeline(VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Calcula las matrices de cada vista a partir de la cámara del frame.
+    /// \param camera Cámara activa.
+    /// \param views Salida con las matrices de vista.
+    /// \param projection Salida con la proyección común.
+    void computeViews(const Camera& camera, std::array<glm::mat4, MAX_VIEWS>& views, glm::mat4& projection) const;
+
+    /// \brief Extrae los planos del frustum de una matriz proyección * vista.
+    /// \param viewProjection Matriz a descomponer (profundidad en [0, 1]).
+    /// \return Planos normalizados.
+    static Frustum extractFrustum(const glm::mat4& viewProjection);
+
+    /// \brief Comprueba si una esfera toca un frustum.
+    /// \param frustum Planos de la vista.
+    /// \param center Centro de la esfera en mundo.
+    /// \param radius Radio de la esfera.
+    /// \return \c true si no queda completamente fuera de algún plano.
+    static bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+
+    /// \brief Graba los draws de los objetos indicados.
+    /// \param commandBuffer Command buffer con el render pass activo.
+    /// \param descriptorSet Set global de la vista (o de todas las vistas).
+    /// \param objects Objetos a dibujar.
+    void recordObjects(
+        VkCommandBuffer commandBuffer,
+        VkDescriptorSet descriptorSet,
+        const std::vector<GameObject*>& objects);
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Parámetros del pase.
+    MultiViewSettings settings {};
+
+    /// Vistas del modo configurado.
+    uint32_t viewCount = 1;
+
+    /// Se usa \c VK_KHR_multiview (si no, un render pass por vista).
+    bool useMultiview = false;
+
+    /// Estadísticas del último frame.
+    MultiViewStats stats {};
+
+    /// Imagen de color con una capa por vista.
+    VkImage colorImage = VK_NULL_HANDLE;
+    /// Memoria de la imagen de color.
+    VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+    /// Vista de todas las capas de color (array o cubo).
+    VkImageView colorView = VK_NULL_HANDLE;
+
+    /// Formato de la profundidad.
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    /// Imagen de profundidad con una capa por vista.
+    VkImage depthImage = VK_NULL_HANDLE;
+    /// Memoria de la profundidad.
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+
+    /// Vistas de adjunto (con multivista, una de todas las capas; si no, una por capa).
+    std::vector<VkImageView> colorAttachmentViews;
+    /// Vistas de profundidad, emparejadas con \c colorAttachmentViews.
+    std::vector<VkImageView> depthAttachmentViews;
+    /// Framebuffers, emparejados con \c colorAttachmentViews.
+    std::vector<VkFramebuffer> framebuffers;
+
+    /// Render pass del pase.
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+
+    /// Pool para los sets del pase.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+    /// UBO por frame en vuelo, con una instancia por vista.
+    std::vector<std::unique_ptr<VulkanBuffer>> uboBuffers;
+    /// Sets globales, \c MAX_VIEWS por frame en vuelo.
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    /// Layout de la tubería (set global y push constants de \c BasicRenderer).
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    /// Tubería del pase.
+    std::unique_ptr<GraphicsPipeline> pipeline;
+};
@@ -0,0 +1,164 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ParticleSystem.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "ComputePipeline.hpp"
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "GraphicsPipeline.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+
+ /// \brief Parámetros del emisor de partículas.
+ /// \details Se leen en CPU una vez por frame y se envían como push constants;
+ /// la CPU nunca toca partículas individuales.
+struct ParticleEmitter
+{
+    /// Posición del emisor en espacio de mundo.
+    glm::vec3 position {0.0f, 0.0f, 0.0f};
+    /// Partículas emitidas por segundo.
+    float rate = 20000.0f;
+    /// Velocidad inicial media (el eje -Y es "arriba" en la escena).
+    glm::vec3 velocity {0.0f, -2.5f, 0.0f};
+    /// Dispersión aleatoria de la velocidad inicial.
+    float spread = 1.5f;
+    /// Color RGB de las partículas.
+    glm::vec3 color {1.0f, 0.55f, 0.15f};
+    /// Vida de cada partícula (s).
+    float lifetime = 1.5f;
+    /// Aceleración constante (gravedad).
+    glm::vec3 gravity {0.0f, 4.0f, 0.0f};
+    /// Radio del billboard de cada partícula.
+    float size = 0.01f;
+    /// Coeficiente de rozamiento lineal.
+    float drag = 0.5f;
+};
+
+/// \brief Sistema de partículas residente por completo en GPU.
+/// \details Las partículas viven en SSBOs. Cada frame, \c update graba tres
+/// dispatches de cómputo: \c kickoff (calcula cuántas se emiten y prepara los
+/// argumentos indirectos), \c emit (toma índices de la lista de muertas) y
+/// \c simulate (integra, compacta las vivas en la otra lista del anillo,
+/// escribe su instancia de dibujo en la mitad correspondiente y devuelve las
+/// que expiran a la lista de muertas). \c render dibuja esas instancias con un
+/// único \c vkCmdDrawIndirect de quads instanciados, reutilizando el billboard
+/// de \c point_light.vert. Como el render sólo lee la mitad de su frame, la
+/// simulación del frame siguiente puede ejecutarse en la cola de cómputo
+/// asíncrono a la vez. El coste de CPU es independiente del número de partículas.
+class ParticleSystem
+{
+public:
+    /// \brief Construye el sistema, sus búferes y tuberías.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param renderPass Render pass donde se dibujan las partículas.
+    /// \param globalSetLayout Layout de descriptores global (set 0 en el pase gráfico).
+    /// \param capacity Número máximo de partículas vivas.
+    ParticleSystem(
+        VulkanDevice& device,
+        VkRenderPass renderPass,
+        VkDescriptorSetLayout globalSetLayout,
+        uint32_t capacity = 1u << 20);
+
+    /// \brief Libera recursos asociados.
+    ~ParticleSystem();
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    /// \brief Graba emisión y simulación en el command buffer de cómputo del frame.
+    /// \details Debe llamarse fuera del render pass y antes de \c render. Sólo usa etapas
+    /// válidas en una cola de cómputo; si el cómputo va en el command buffer de gráficos
+    /// añade la barrera hacia el draw indirecto, y si va en la cola asíncrona esa
+    /// dependencia la aporta el semáforo que espera el envío de gráficos.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Dibuja las partículas vivas con un draw indirecto.
+    /// \param frameInfo Contexto del frame con el render pass activo.
+    void render(FrameInfo& frameInfo);
+
+    /// \brief Acceso al emisor para ajustarlo en tiempo de ejecución.
+    ParticleEmitter& getEmitter()
+    {
+        return (emitter);
+    }
+
+    /// \brief Capacidad máxima del sistema.
+    uint32_t getCapacity() const
+    {
+        return (capacity);
+    }
+
+private:
+    /// \brief Crea los SSBOs y sube el estado inicial (todas las partículas muertas).
+    void createBuffers();
+
+    /// \brief Crea el layout, el pool y el descriptor set de los SSBOs.
+    void createDescriptors();
+
+    /// \brief Crea los pipeline layouts de cómputo y de render.
+    /// \param globalSetLayout Layout de descriptores global.
+    void createPipelineLayouts(VkDescriptorSetLayout globalSetLayout);
+
+    /// \brief Crea las tuberías de cómputo y la gráfica.
+    /// \param renderPass Render pass objetivo.
+    void createPipelines(VkRenderPass renderPass);
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Número máximo de partículas.
+    uint32_t capacity;
+
+    /// Parámetros del emisor.
+    ParticleEmitter emitter {};
+
+    /// Fracción de partícula pendiente de emitir entre frames.
+    float emitAccumulator = 0.0f;
+
+    /// Semilla del generador aleatorio de los shaders.
+    uint32_t seed = 0;
+
+    /// Lista viva actual del anillo (0 o 1); la simulación escribe en la otra.
+    uint32_t currentList = 0;
+
+    /// Estado de cada partícula (posición, vida, velocidad, tamaño, color).
+    std::unique_ptr<VulkanBuffer> particleBuffer;
+    /// Índices de partículas libres.
+    std::unique_ptr<VulkanBuffer> deadListBuffer;
+    /// Dos listas de índices vivos (anillo de ping-pong).
+    std::unique_ptr<VulkanBuffer> aliveListBuffer;
+    /// Contadores y argumentos indirectos de dispatch/draw.
+    std::unique_ptr<VulkanBuffer> counterBuffer;
+    /// Instancias de dibujo, una mitad por lista viva.
+    std::unique_ptr<VulkanBuffer> instanceBuffer;
+
+    /// Pool propio para el descriptor set de partículas.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+    /// Layout del set de SSBOs (compartido entre cómputo y render).
+    std::unique_ptr<DescriptorSetLayout> setLayout;
+    /// Descriptor set con los SSBOs.
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    /// Layout de las tuberías de cómputo.
+    VkPipelineLayout computeLayout = VK_NULL_HANDLE;
+    /// Layout de la tubería de render.
+    VkPipelineLayout renderLayout = VK_NULL_HANDLE;
+
+    /// Prepara los argumentos indirectos del frame.
+    std::unique_ptr<ComputePipeline> kickoffPipeline;
+    /// Emite partículas nuevas.
+    std::unique_ptr<ComputePipeline> emitPipeline;
+    /// Integra y compacta las partículas vivas.
+    std::unique_ptr<ComputePipeline> simulatePipeline;
+    /// Dibuja las partículas como billboards instanciados.
+    std::unique_ptr<GraphicsPipeline> renderPipeline;
+};
@@ -8,9 +8,17 @@
 
 #pragma once
 
+#include "ClockCalibration.hpp"
+
 #include <vulkan/vulkan.h>
 #include <array>
 #include <chrono>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct DeviceCapabilities;
 
  /// \brief Buffer circular de valores flotantes para series temporales (FPS/ms).
  /// \details Mantiene una ventana fija de \c Count muestras y permite aadir
@@ -47,6 +55,32 @@ struct PerfRing
     }
 };
 
+/// \brief Tiempo que la CPU pasa bloqueada en las llamadas de la swapchain de un frame.
+struct FrameBlockingTimes
+{
+    /// Espera al fence del frame en vuelo en \c acquireNextImage (ms).
+    float fenceWaitMs = 0.0f;
+    /// \c vkAcquireNextImageKHR (ms).
+    float acquireMs = 0.0f;
+    /// Espera al fence del frame que an usaba la imagen adquirida (ms).
+    float imageFenceMs = 0.0f;
+    /// \c vkQueueSubmit del frame (ms).
+    float submitMs = 0.0f;
+    /// \c vkQueuePresentKHR (ms).
+    float presentMs = 0.0f;
+};
+
+/// \brief Recurso que limita el frame.
+enum class FrameBound : uint32_t
+{
+    /// La CPU apenas espera: el coste est en preparar y grabar el frame.
+    Cpu = 0,
+    /// La CPU espera a fences de frames que la GPU sigue ejecutando.
+    Gpu = 1,
+    /// La CPU espera al motor de presentacin (vsync, cola de imgenes llena).
+    Present = 2
+};
+
 /// \brief Conjunto de mtricas de rendimiento acumuladas y en vivo.
 /// \details Incluye tiempos de frame CPU/GPU (ms), FPS medio, uso de CPU
 /// y anillos histricos para graficado.
@@ -76,8 +110,30 @@ struct PerfStats
     /// Serie temporal de ms GPU por frame.
     PerfRing gpuMsHistory;
 
+    /// ms de CPU acumulados desde el arranque y frames medidos (contadores montonos).
+    double cpuFrameMsTotal = 0.0;
+    uint64_t cpuFrameCount = 0;
+    /// ms de GPU acumulados desde el arranque y frames resueltos (contadores montonos).
+    double gpuFrameMsTotal = 0.0;
+    uint64_t gpuFrameCount = 0;
+
     /// Inicio del frame en CPU.
     std::chrono::high_resolution_clock::time_point cpuTick {};
+
+    /// Esperas de la swapchain del ltimo frame.
+    FrameBlockingTimes blocking {};
+    /// Tiempo entre los finales de los dos ltimos frames (ms).
+    double framePeriodMs = 0.0;
+    /// Parte de \c framePeriodMs no bloqueada en la swapchain (ms).
+    double cpuWorkMs = 0.0;
+    /// Clasificacin del ltimo frame.
+    FrameBound bound = FrameBound::Cpu;
+    /// Frames clasificados en cada categora desde el arranque (ndice = \c FrameBound).
+    std::array<uint64_t, 3> boundFrames {};
+    /// Serie temporal de la clasificacin (0 = CPU, 1 = GPU, 2 = presentacin).
+    PerfRing boundHistory;
+    /// Serie temporal de ms bloqueados en la swapchain por frame.
+    PerfRing blockedMsHistory;
 };
 
 /// \brief Temporizador de GPU basado en consultas de marca de tiempo.
@@ -87,18 +143,27 @@ class GpuTimer
 {
 public:
     /// \brief Inicializa el temporizador de GPU.
+    /// \details Si el dispositivo no admite timestamps en la cola de grficos el
+    /// temporizador queda desactivado y \c resolve nunca devuelve datos.
     /// \param device Dispositivo lgico.
     /// \param framesInFlight N de frames en vuelo.
-    /// \param timestampPeriodNs Periodo de timestamp del dispositivo.
-    void init(VkDevice device, uint32_t framesInFlight, double timestampPeriodNs);
+    /// \param capabilities Perfil del dispositivo (timestamps, reinicio desde CPU).
+    void init(VkDevice device, uint32_t framesInFlight, const DeviceCapabilities& capabilities);
 
     /// \brief Libera el \c VkQueryPool y recursos asociados.
     void destroy();
 
-    /// \brief Registra timestamps de inicio y fin en el \c commandBuffer.
+    /// \brief Reinicia las consultas del frame y escribe el timestamp inicial.
+    /// \details Con \c hostQueryReset el reinicio se hace desde la CPU; si no, se graba
+    /// en \c cb, por lo que debe llamarse fuera de un render pass.
+    /// \param cb Command buffer donde insertar las consultas.
+    /// \param frameIndex ndice de frame en vuelo.
+    void begin(VkCommandBuffer cb, uint32_t frameIndex);
+
+    /// \brief Escribe el timestamp final del frame.
     /// \param cb Command buffer donde insertar las consultas.
     /// \param frameIndex ndice de frame en vuelo.
-    void record(VkCommandBuffer cb, uint32_t frameIndex);
+    void end(VkCommandBuffer cb, uint32_t frameIndex);
 
     /// \brief Lee y resuelve las consultas de \c frameIndex a milisegundos.
     /// \param frameIndex ndice de frame en vuelo a resolver.
@@ -106,6 +171,13 @@ public:
     /// \return \c true si los resultados estaban listos y \c outGpuMs es vlido.
     bool resolve(uint32_t frameIndex, double& outGpuMs);
 
+    /// \brief Timestamps (ticks de dispositivo) de la ltima resolucin de \c frameIndex.
+    /// \param frameIndex ndice de frame en vuelo.
+    /// \param begin Salida: timestamp inicial.
+    /// \param end Salida: timestamp final.
+    /// \return \c false si el frame an no se ha resuelto nunca.
+    bool getTicks(uint32_t frameIndex, uint64_t& begin, uint64_t& end) const;
+
 private:
     /// Dispositivo lgico.
     VkDevice device = VK_NULL_HANDLE;
@@ -115,6 +187,12 @@ private:
     uint32_t queriesPerFrame = 2;
     /// Conversin de ticks a nanosegundos.
     double timestampPeriodNs = 1.0;
+    /// Las consultas se reinician con \c vkResetQueryPool desde la CPU.
+    bool hostReset = false;
+    /// Frames en vuelo cuyas consultas se han escrito al menos una vez.
+    std::vector<bool> written;
+    /// ltimos timestamps resueltos (inicio/fin por frame; 0 = sin resolver).
+    std::vector<uint64_t> ticks;
 };
 
 /// \brief Monitoriza el uso de CPU del sistema y del proceso actual.
@@ -160,6 +238,198 @@ private:
 #endif
 };
 
+/// \brief Fase medida durante el arranque de la aplicacin.
+/// \details Los instantes se expresan en ms relativos al inicio del \c StartupTimeline.
+struct StartupPhase
+{
+    /// Nombre de la fase (p.ej., "device", "pipeline.basic").
+    std::string name;
+    /// Hebra que la ejecut (0 = hebra principal).
+    uint32_t thread = 0;
+    /// Inicio relativo (ms).
+    double startMs = 0.0;
+    /// Fin relativo (ms).
+    double endMs = 0.0;
+};
+
+/// \brief Lnea temporal del arranque hasta el primer frame presentado.
+/// \details Registra las fases de inicializacin (serie o en paralelo) y el instante
+/// en que se completa el primer frame (time-to-first-frame). Se rellena desde la
+/// hebra principal y se consulta desde \c Perf para dibujarla en ImGui.
+class StartupTimeline
+{
+public:
+    /// \brief Aade una fase a la lnea temporal.
+    /// \param name Nombre de la fase.
+    /// \param thread Hebra que la ejecut.
+    /// \param begin Instante de inicio.
+    /// \param end Instante de fin.
+    void addPhase(
+        const std::string& name,
+        uint32_t thread,
+        std::chrono::high_resolution_clock::time_point begin,
+        std::chrono::high_resolution_clock::time_point end);
+
+    /// \brief Marca el final del primer frame. Slo la primera llamada tiene efecto.
+    void markFirstFrame();
+
+    /// \brief Indica si ya se ha registrado el primer frame.
+    bool hasFirstFrame() const
+    {
+        return (firstFrameMs > 0.0);
+    }
+
+    /// \brief Tiempo hasta el primer frame (ms) desde la creacin de la lnea temporal.
+    double timeToFirstFrameMs() const
+    {
+        return (firstFrameMs);
+    }
+
+    /// \brief Origen de tiempos de la lnea temporal.
+    std::chrono::high_resolution_clock::time_point getEpoch() const
+    {
+        return (epoch);
+    }
+
+    /// \brief Fases registradas, en orden de insercin.
+    const std::vector<StartupPhase>& getPhases() const
+    {
+        return (phases);
+    }
+
+    /// \brief Vuelca la lnea temporal en formato texto (una fase por lnea).
+    /// \param out Flujo de salida.
+    void print(std::ostream& out) const;
+
+private:
+    /// Origen de tiempos (construccin de la aplicacin).
+    std::chrono::high_resolution_clock::time_point epoch = std::chrono::high_resolution_clock::now();
+    /// Fases registradas.
+    std::vector<StartupPhase> phases;
+    /// Time-to-first-frame (ms); 0 mientras no se haya presentado ningn frame.
+    double firstFrameMs = 0.0;
+};
+
+/// \brief Estado del streaming de celdas del mundo en el ltimo frame.
+/// \details Lo rellena \c WorldStreamer desde la hebra principal; \c Perf lo guarda por
+/// copia para mostrarlo en el panel.
+struct StreamingStats
+{
+    /// Celdas solicitadas o en carga que an no estn en escena.
+    uint32_t pendingCells = 0;
+    /// Celdas insertadas en escena.
+    uint32_t residentCells = 0;
+    /// Memoria de CPU ocupada por celdas (bytes).
+    uint64_t hostBytes = 0;
+    /// Presupuesto de memoria de CPU (bytes).
+    uint64_t hostBudget = 0;
+    /// Memoria de GPU ocupada por celdas (bytes).
+    uint64_t gpuBytes = 0;
+    /// Presupuesto de memoria de GPU (bytes).
+    uint64_t gpuBudget = 0;
+    /// Throughput de lectura de disco (bytes/s, media del ltimo segundo).
+    double ioBytesPerSecond = 0.0;
+};
+
+/// \brief Solape medido entre el cmputo asncrono y el render.
+/// \details Se compara el intervalo de la cola de cmputo de un frame con el del
+/// render del frame anterior, ambos en timestamps del mismo dispositivo.
+struct AsyncComputeStats
+{
+    /// Hay una cola de cmputo dedicada en uso.
+    bool enabled = false;
+    /// Duracin del envo de cmputo (ms).
+    float computeMs = 0.0f;
+    /// Tiempo en que el cmputo coincidi con el render del frame anterior (ms).
+    float overlapMs = 0.0f;
+    /// Fraccin del cmputo solapada (0..1).
+    float overlapRatio = 0.0f;
+};
+
+/// \brief Coste y resultado de la asignacin de luces por objeto del ltimo frame.
+struct LightGridStats
+{
+    /// Luces insertadas en la rejilla.
+    uint32_t lights = 0;
+    /// Objetos con lista de luces propia.
+    uint32_t objects = 0;
+    /// Luces asignadas por objeto (media).
+    float lightsPerObject = 0.0f;
+    /// Luces candidatas evaluadas por objeto (media).
+    float candidatesPerObject = 0.0f;
+    /// Construccin de la rejilla (ms).
+    float buildMs = 0.0f;
+    /// Consultas y escritura de las listas (ms).
+    float assignMs = 0.0f;
+};
+
+/// \brief Estado del gobernador de calidad en el ltimo frame.
+struct QualityStats
+{
+    /// Nivel de calidad actual (0 = mnimo).
+    uint32_t level = 0;
+    /// Nmero de niveles.
+    uint32_t levelCount = 1;
+    /// Coste del frame usado por el controlador (ms).
+    float frameMs = 0.0f;
+    /// Presupuesto de tiempo de frame (ms).
+    float targetMs = 0.0f;
+    /// Salida del controlador PID (0 = calidad mxima, 1 = mnima).
+    float output = 0.0f;
+    /// Nivel bloqueado.
+    bool locked = false;
+};
+
+/// \brief Cambio de nivel decidido por el gobernador de calidad.
+struct QualityDecision
+{
+    /// Instante de la decisin (s desde el arranque del gobernador).
+    double timeSeconds = 0.0;
+    /// Nivel anterior.
+    uint32_t fromLevel = 0;
+    /// Nivel nuevo.
+    uint32_t toLevel = 0;
+    /// Coste del frame que motiv la decisin (ms).
+    float frameMs = 0.0f;
+    /// Presupuesto de tiempo de frame (ms).
+    float targetMs = 0.0f;
+    /// Salida del controlador PID.
+    float output = 0.0f;
+    /// Multiplicador de distancia de impostores aplicado.
+    float lodBias = 1.0f;
+    /// Luces sombreadas aplicadas.
+    uint32_t maxShadedLights = 0;
+    /// Frames entre reconstrucciones de la UI aplicados.
+    uint32_t uiRefreshInterval = 1;
+};
+
+/// \brief Frame lento detectado por \c HitchDetector.
+struct HitchRecord
+{
+    /// Segundos desde el primer frame observado por el detector.
+    double timeSeconds = 0.0;
+    /// Nmero de frame (\c Perf::getFrameSerial).
+    uint64_t serial = 0;
+    /// Periodo del frame (ms).
+    float frameMs = 0.0f;
+    /// Umbral superado (ms).
+    float thresholdMs = 0.0f;
+    /// Traza que lo contiene (se escribe en segundo plano); vaca si se omiti por el
+    /// lmite de frecuencia.
+    std::string tracePath;
+};
+
+/// \brief Intervalo de un frame en GPU traducido al reloj de la CPU.
+struct GpuFrameSpan
+{
+    /// Nmero de frame (\c Perf::getFrameSerial del frame que lo grab).
+    uint64_t serial = 0;
+    /// Inicio en la GPU (ns de \c steady_clock).
+    double beginNs = 0.0;
+    /// Fin en la GPU (ns de \c steady_clock).
+    double endNs = 0.0;
+};
+
 /// \brief Facade de rendimiento: mide CPU/GPU, mantiene histricos y dibuja overlay ImGui.
 /// \details Orquesta \c GpuTimer y \c CpuUsageMonitor, expone \c stats() para
 /// consulta (lectura) y \c drawImGui() para representar panel de rendimiento.
@@ -169,8 +439,8 @@ public:
     /// \brief Inicializa el subsistema de rendimiento.
     /// \param device Dispositivo lgico Vulkan.
     /// \param framesInFlight N de frames en vuelo.
-    /// \param timestampPeriodNs Periodo de timestamp del dispositivo.
-    void init(VkDevice device, uint32_t framesInFlight, double timestampPeriodNs);
+    /// \param capabilities Perfil del dispositivo.
+    void init(VkDevice device, uint32_t framesInFlight, const DeviceCapabilities& capabilities);
 
     /// \brief Libera recursos asociados.
     void shutdown();
@@ -179,12 +449,29 @@ public:
     void beginCpuFrame();
 
     /// \brief Marca el fin del frame en CPU y actualiza mtricas instantneas.
+    /// \details Clasifica adems el frame como limitado por CPU, GPU o presentacin a
+    /// partir de las esperas de \c setBlockingTimes.
     void endCpuFrame();
 
-    /// \brief Inserta consultas GPU en el \c commandBuffer del frame.
+    /// \brief Registra las esperas de la swapchain del frame en curso.
+    /// \param times Esperas medidas por \c SwapChain.
+    void setBlockingTimes(const FrameBlockingTimes& times)
+    {
+        statsRef.blocking = times;
+    }
+
+    /// \brief Nombre legible de una clasificacin.
+    static const char* boundName(FrameBound bound);
+
+    /// \brief Inserta la consulta GPU de inicio de frame (fuera de un render pass).
     /// \param cb Command buffer actual.
     /// \param frameIndex ndice de frame en vuelo.
-    void recordGpu(VkCommandBuffer cb, uint32_t frameIndex);
+    void beginGpu(VkCommandBuffer cb, uint32_t frameIndex);
+
+    /// \brief Inserta la consulta GPU de fin de frame.
+    /// \param cb Command buffer actual.
+    /// \param frameIndex ndice de frame en vuelo.
+    void endGpu(VkCommandBuffer cb, uint32_t frameIndex);
 
     /// \brief Resuelve las consultas GPU del frame y actualiza medias/histricos.
     /// \param frameIndex ndice de frame en vuelo.
@@ -193,6 +480,35 @@ public:
     /// \brief Actualiza monitores segn periodo de muestreo.
     void tickMonitors();
 
+    /// \brief Timestamps de GPU (ticks) del ltimo frame resuelto en \c frameIndex.
+    /// \param frameIndex ndice de frame en vuelo.
+    /// \param begin Salida: timestamp inicial.
+    /// \param end Salida: timestamp final.
+    /// \return \c false si no hay datos.
+    bool getGpuFrameTicks(uint32_t frameIndex, uint64_t& begin, uint64_t& end) const
+    {
+        return (gpuTimer.getTicks(frameIndex, begin, end));
+    }
+
+    /// \brief Nmero del frame en curso (se incrementa en cada \c beginGpu).
+    uint64_t getFrameSerial() const
+    {
+        return (frameSerial);
+    }
+
+    /// \brief ltimo frame resuelto en GPU, en el reloj de la CPU.
+    /// \return \c nullptr si an no hay frames resueltos o no hay correspondencia de relojes.
+    const GpuFrameSpan* getLastGpuFrame() const
+    {
+        return (hasGpuFrame ? &lastGpuFrame : nullptr);
+    }
+
+    /// \brief Correspondencia entre los relojes de GPU y CPU.
+    const ClockCalibration& getGpuClock() const
+    {
+        return (gpuClock);
+    }
+
     /// \brief Acceso de slo lectura a las estadsticas actuales.
     /// \return Referencia constante a \c PerfStats interno.
     const PerfStats& stats() const 
@@ -204,6 +520,110 @@ public:
     /// \param pOpen Puntero opcional a flag de visibilidad del panel.
     void drawImGui(bool* pOpen = nullptr);
 
+    /// \brief Asocia la lnea temporal de arranque que se mostrar en el panel.
+    /// \param timeline Lnea temporal (puede ser \c nullptr para ocultar la seccin).
+    void setStartupTimeline(const StartupTimeline* timeline)
+    {
+        startup = timeline;
+    }
+
+    /// \brief Actualiza las estadsticas de streaming que se mostrarn en el panel.
+    /// \param stats Estado actual del streaming de celdas.
+    void setStreamingStats(const StreamingStats& stats)
+    {
+        streaming = stats;
+        hasStreaming = true;
+    }
+
+    /// \brief Actualiza el solape medido del cmputo asncrono.
+    /// \param stats ltimo solape medido.
+    void setAsyncComputeStats(const AsyncComputeStats& stats)
+    {
+        asyncCompute = stats;
+        hasAsyncCompute = true;
+
+        if (stats.enabled)
+        {
+            overlapHistory.push(stats.overlapRatio * 100.0f);
+        }
+    }
+
+    /// \brief Actualiza el coste de la asignacin de luces por objeto.
+    /// \param stats Estado de la rejilla de luces en este frame.
+    void setLightGridStats(const LightGridStats& stats)
+    {
+        lightGrid = stats;
+        hasLightGrid = true;
+        lightGridHistory.push(stats.buildMs + stats.assignMs);
+    }
+
+    /// \brief ltimo estado del streaming (\c nullptr si no se ha publicado).
+    const StreamingStats* getStreamingStats() const
+    {
+        return (hasStreaming ? &streaming : nullptr);
+    }
+
+    /// \brief ltimo solape del cmputo asncrono (\c nullptr si no se ha publicado).
+    const AsyncComputeStats* getAsyncComputeStats() const
+    {
+        return (hasAsyncCompute ? &asyncCompute : nullptr);
+    }
+
+    /// \brief ltimo estado de la rejilla de luces (\c nullptr si no se ha publicado).
+    const LightGridStats* getLightGridStats() const
+    {
+        return (hasLightGrid ? &lightGrid : nullptr);
+    }
+
+    /// \brief ltimo estado del gobernador de calidad (\c nullptr si no se ha publicado).
+    const QualityStats* getQualityStats() const
+    {
+        return (hasQuality ? &quality : nullptr);
+    }
+
+    /// \brief Actualiza el estado del gobernador de calidad y su histrico de nivel.
+    /// \param stats Estado del gobernador en este frame.
+    void setQualityStats(const QualityStats& stats);
+
+    /// \brief Aade una decisin del gobernador de calidad al histrico.
+    /// \param decision Cambio de nivel decidido.
+    void recordQualityDecision(const QualityDecision& decision);
+
+    /// \brief Decisiones registradas (las ms recientes al final).
+    const std::deque<QualityDecision>& getQualityDecisions() const
+    {
+        return (qualityDecisions);
+    }
+
+    /// \brief Nmero total de decisiones registradas desde el arranque.
+    uint64_t getQualityDecisionCount() const
+    {
+        return (qualityDecisionCount);
+    }
+
+    /// \brief Registra un frame lento (se muestra como marca en el panel).
+    /// \param hitch Frame detectado.
+    void recordHitch(const HitchRecord& hitch);
+
+    /// \brief ltimos frames lentos (como mucho \c MAX_HITCHES).
+    const std::deque<HitchRecord>& getHitches() const
+    {
+        return (hitches);
+    }
+
+    /// \brief Frames lentos detectados desde el arranque.
+    uint64_t getHitchCount() const
+    {
+        return (hitchCount);
+    }
+
+    /// \brief Asocia el interruptor de bloqueo de calidad que se mostrar en el panel.
+    /// \param lock Bandera de bloqueo (no propiedad; \c nullptr oculta el control).
+    void setQualityLock(bool* lock)
+    {
+        qualityLock = lock;
+    }
+
 private:
     /// Mtricas en vivo e histricos.
     PerfStats statsRef;
@@ -212,6 +632,20 @@ private:
     /// Monitor de uso de CPU.
     CpuUsageMonitor cpuMonitor;
 
+    /// Final del frame anterior (para \c PerfStats::framePeriodMs).
+    std::chrono::high_resolution_clock::time_point lastFrameEnd {};
+
+    /// Traduccin de timestamps de GPU al reloj de la CPU.
+    ClockCalibration gpuClock;
+    /// Nmero del ltimo frame iniciado.
+    uint64_t frameSerial = 0;
+    /// Nmero de frame grabado en cada frame en vuelo.
+    std::vector<uint64_t> slotSerials;
+    /// ltimo frame resuelto en GPU.
+    GpuFrameSpan lastGpuFrame {};
+    /// Indica si \c lastGpuFrame es vlido.
+    bool hasGpuFrame = false;
+
     /// Acumulador para decidir cundo refrescar nmeros mostrados.
     double uiAccumMs = 0.0;
     /// Periodo de refresco de valores mostrados (ms).
@@ -226,4 +660,48 @@ private:
     double dispGpuMsAvg = 0.0;
     float  dispCpuSys = 0.0f;
     float  dispCpuProc = 0.0f;
+
+    /// Lnea temporal de arranque (no propiedad).
+    const StartupTimeline* startup = nullptr;
+
+    /// ltimo estado del streaming de celdas.
+    StreamingStats streaming {};
+    /// Indica si algn sistema ha publicado estadsticas de streaming.
+    bool hasStreaming = false;
+
+    /// ltimo solape medido del cmputo asncrono.
+    AsyncComputeStats asyncCompute {};
+    /// Indica si se ha publicado el estado del cmputo asncrono.
+    bool hasAsyncCompute = false;
+    /// Histrico del porcentaje de cmputo solapado.
+    PerfRing overlapHistory;
+
+    /// ltimo estado de la rejilla de luces.
+    LightGridStats lightGrid {};
+    /// Indica si se ha publicado el estado de la rejilla de luces.
+    bool hasLightGrid = false;
+    /// Histrico del coste total de la rejilla de luces (ms).
+    PerfRing lightGridHistory;
+
+    /// Mximo de decisiones de calidad conservadas.
+    static constexpr size_t MAX_QUALITY_DECISIONS = 64;
+    /// ltimo estado del gobernador de calidad.
+    QualityStats quality {};
+    /// Indica si el gobernador de calidad ha publicado su estado.
+    bool hasQuality = false;
+    /// Histrico del nivel de calidad por frame.
+    PerfRing qualityHistory;
+    /// ltimas decisiones de calidad.
+    std::deque<QualityDecision> qualityDecisions;
+    /// Decisiones registradas desde el arranque.
+    uint64_t qualityDecisionCount = 0;
+    /// Mximo de frames lentos conservados.
+    static constexpr size_t MAX_HITCHES = 16;
+    /// ltimos frames lentos.
+    std::deque<HitchRecord> hitches;
+    /// Frames lentos desde el arranque.
+    uint64_t hitchCount = 0;
+
+    /// Bandera de bloqueo de calidad (no propiedad).
+    bool* qualityLock = nullptr;
 };
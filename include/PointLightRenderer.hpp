@@ -42,6 +42,15 @@ public:
     /// \param ubo Estructura \c GlobalUbo a rellenar/actualizar antes del render.
     void update(FrameInfo& frameInfo, GlobalUbo& ubo);
 
+    /// \brief Limita las luces que se sombrean en los shaders de escena.
+    /// \details Si hay ms luces, \c update conserva en el UBO las ms cercanas a la
+    /// cmara; todas siguen dibujndose como billboard en \c render.
+    /// \param count Nmero mximo de luces (se acota a \c MAX_LIGHTS).
+    void setMaxShadedLights(uint32_t count)
+    {
+        maxShadedLights = count;
+    }
+
     /// \brief Emite los comandos de dibujo de las luces puntuales.
     /// \details Enlaza pipeline, descriptor set global y registra las draw calls necesarias
     /// para representar las luces.
@@ -63,5 +72,7 @@ private:
     std::unique_ptr<GraphicsPipeline> pointLightPipeline;
     /// Layout de pipeline (descriptores/constantes).
     VkPipelineLayout pipelineLayout;
+    /// Nmero mximo de luces sombreadas.
+    uint32_t maxShadedLights = MAX_LIGHTS;
 };
 
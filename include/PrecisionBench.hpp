@@ -0,0 +1,125 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: PrecisionBench.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "BasicRenderer.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+ /// \brief Comparación de las variantes fp32 y fp16 de \c BasicRenderer.
+struct PrecisionBenchResult
+{
+    /// Tiempo de GPU de la escena con shaders fp32 (ms, mediana).
+    float fp32Ms = 0.0f;
+    /// Tiempo de GPU de la escena con shaders fp16 (ms, mediana).
+    float fp16Ms = 0.0f;
+    /// Hay timestamps en la cola de gráficos.
+    bool timed = false;
+    /// El formato de color permite comparar las imágenes (8 bits por canal).
+    bool compared = false;
+    /// Mayor diferencia absoluta en un canal (0..255).
+    uint32_t maxDifference = 0;
+    /// Diferencia absoluta media por canal.
+    double meanDifference = 0.0;
+    /// Relación señal/ruido de pico (dB; infinita si las imágenes son idénticas).
+    double psnr = 0.0;
+    /// Fracción de píxeles con algún canal diferente en más de \c PrecisionBench::TOLERANCE.
+    double differingPixels = 0.0;
+};
+
+/// \brief Renderiza la escena fuera de pantalla con cada variante de precisión de
+/// \c BasicRenderer, mide su tiempo de GPU y compara las imágenes.
+/// \details Usa un render pass compatible con el de la swapchain (mismos formatos),
+/// de modo que sirven las tuberías ya creadas, y el estado del último frame (UBO,
+/// luces y listas por objeto). Sólo debe usarse con el dispositivo inactivo.
+class PrecisionBench
+{
+public:
+    /// Repeticiones de la escena por variante.
+    static constexpr uint32_t ITERATIONS = 32;
+    /// Diferencia por canal (de 255) a partir de la cual un píxel cuenta como distinto.
+    static constexpr uint32_t TOLERANCE = 2;
+
+    /// \brief Crea las imágenes, el render pass, el framebuffer y el búfer de lectura.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param colorFormat Formato de color de la swapchain.
+    /// \param depthFormat Formato de profundidad de la swapchain.
+    /// \param extent Tamaño de la imagen.
+    PrecisionBench(VulkanDevice& device, VkFormat colorFormat, VkFormat depthFormat, VkExtent2D extent);
+
+    /// \brief Libera los recursos.
+    ~PrecisionBench();
+
+    PrecisionBench(const PrecisionBench&) = delete;
+    PrecisionBench& operator=(const PrecisionBench&) = delete;
+
+    /// \brief Renderiza con fp32 y fp16 y compara tiempos e imágenes.
+    /// \details Deja activa en \c renderer la variante que lo estaba al llamar.
+    /// \param renderer Renderizador con variante fp16 disponible.
+    /// \param frameInfo Contexto del último frame (su command buffer no se usa).
+    /// \return Resultado de la comparación.
+    PrecisionBenchResult run(BasicRenderer& renderer, const FrameInfo& frameInfo);
+
+    /// \brief Imprime el resultado en una línea.
+    /// \param result Resultado de \c run.
+    /// \param out Flujo de salida.
+    static void print(const PrecisionBenchResult& result, std::ostream& out);
+
+private:
+    /// \brief Crea el render pass (compatible con el de la swapchain).
+    void createRenderPass();
+
+    /// \brief Crea las imágenes de color y profundidad, sus vistas y el framebuffer.
+    void createTargets();
+
+    /// \brief Renderiza \c ITERATIONS veces con una variante y lee la última imagen.
+    /// \param renderer Renderizador.
+    /// \param frameInfo Contexto del último frame.
+    /// \param halfPrecision Variante a usar.
+    /// \param pixels Salida: imagen leída.
+    /// \return Mediana del tiempo de GPU (ms), o 0 sin timestamps.
+    float renderVariant(
+        BasicRenderer& renderer,
+        const FrameInfo& frameInfo,
+        bool halfPrecision,
+        std::vector<uint8_t>& pixels);
+
+    /// Dispositivo Vulkan.
+    VulkanDevice& device;
+    /// Formato de color.
+    VkFormat colorFormat;
+    /// Formato de profundidad.
+    VkFormat depthFormat;
+    /// Tamaño de la imagen.
+    VkExtent2D extent;
+
+    /// Render pass fuera de pantalla.
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    /// Imagen de color.
+    VkImage colorImage = VK_NULL_HANDLE;
+    /// Memoria de la imagen de color.
+    VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+    /// Vista de la imagen de color.
+    VkImageView colorView = VK_NULL_HANDLE;
+    /// Imagen de profundidad.
+    VkImage depthImage = VK_NULL_HANDLE;
+    /// Memoria de la imagen de profundidad.
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    /// Vista de la imagen de profundidad.
+    VkImageView depthView = VK_NULL_HANDLE;
+    /// Framebuffer fuera de pantalla.
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    /// Búfer visible desde la CPU donde se copia la imagen de color.
+    std::unique_ptr<VulkanBuffer> readback;
+    /// Consultas de timestamp (dos por repetición; nulo si no hay timestamps).
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+};
@@ -0,0 +1,161 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ProbeGrid.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "ComputePipeline.hpp"
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <memory>
+#include <vector>
+
+class LightGrid;
+
+ /// \brief Parámetros de la rejilla de sondas.
+struct ProbeGridSettings
+{
+    /// Sondas por eje.
+    glm::uvec3 resolution {8, 4, 8};
+
+    /// Caja cubierta por la rejilla hasta que se llama a \c ProbeGrid::setBounds.
+    glm::vec3 boundsMin {-2.0f, -1.0f, -2.0f};
+    glm::vec3 boundsMax {2.0f, 1.0f, 2.0f};
+
+    /// Sondas que \c probe_update.comp recalcula en cada frame.
+    uint32_t probesPerFrame = 16;
+};
+
+/// \brief Rejilla de sondas de irradiancia en armónicos esféricos L2.
+/// \details Cada sonda guarda 9 coeficientes RGB de irradiancia (ya convolucionados
+/// con el coseno) en un SSBO de GPU que \c simple_shader.frag lee en el binding 3 del
+/// set global: los objetos que \c LightGrid marca con \c LightGrid::PROBE_LIT mezclan
+/// trilinealmente las 8 sondas que los rodean y evalúan la irradiancia de su normal,
+/// con un coste constante en lugar del bucle de luces. Cada sonda suma una parte
+/// horneada (\c LightBaker::bakeProbes: luces estáticas con sombras y un rebote) y
+/// otra dinámica, las luces del SSBO de \c LightGrid proyectadas sin visibilidad, que
+/// \c update recalcula para \c probesPerFrame sondas por frame en un pase de cómputo.
+class ProbeGrid
+{
+public:
+    /// Coeficientes SH L2 por sonda (debe coincidir con los shaders).
+    static constexpr uint32_t COEFFICIENTS = 9;
+
+    /// \brief Crea los SSBO de las sondas, los descriptores y la tubería de cómputo.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param lightGrid Origen del SSBO de luces de cada frame.
+    /// \param framesInFlight Nº de frames en vuelo.
+    /// \param settings Resolución, caja y sondas por frame.
+    ProbeGrid(
+        VulkanDevice& device,
+        const LightGrid& lightGrid,
+        uint32_t framesInFlight,
+        const ProbeGridSettings& settings = {});
+
+    /// \brief Libera el pipeline layout.
+    ~ProbeGrid();
+
+    ProbeGrid(const ProbeGrid&) = delete;
+    ProbeGrid& operator=(const ProbeGrid&) = delete;
+
+    /// \brief Ajusta la rejilla a una caja: cada sonda queda en el centro de su celda.
+    /// \details La siguiente llamada a \c update recalcula todas las sondas.
+    /// \param boundsMin Esquina mínima en mundo.
+    /// \param boundsMax Esquina máxima en mundo.
+    void setBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+    /// \brief Sustituye la parte horneada de las sondas.
+    /// \details Debe llamarse antes del primer frame (el SSBO no está protegido contra
+    /// lecturas en vuelo).
+    /// \param coefficients \c COEFFICIENTS valores por sonda (ver \c LightBaker::bakeProbes).
+    void setBaked(const std::vector<glm::vec4>& coefficients);
+
+    /// \brief Recalcula las siguientes \c probesPerFrame sondas en el command buffer del frame.
+    /// \details Debe llamarse fuera del render pass, después de \c LightGrid::update y
+    /// antes de dibujar la escena. Tras \c setBounds recalcula todas.
+    /// \param frameInfo Contexto del frame.
+    /// \param lightCount Luces dinámicas al principio del SSBO de \c LightGrid
+    /// (\c LightGrid::getDynamicLightCount); las horneadas ya están en \c setBaked.
+    void update(FrameInfo& frameInfo, uint32_t lightCount);
+
+    /// \brief Descriptor del SSBO de sondas (binding 3 del set global).
+    VkDescriptorBufferInfo probesInfo() const
+    {
+        return (probeBuffer->descriptorInfo());
+    }
+
+    /// \brief Posición de la primera sonda.
+    const glm::vec3& getOrigin() const
+    {
+        return (origin);
+    }
+
+    /// \brief Distancia entre sondas en cada eje.
+    const glm::vec3& getSpacing() const
+    {
+        return (spacing);
+    }
+
+    /// \brief Sondas por eje.
+    const glm::uvec3& getResolution() const
+    {
+        return (settings.resolution);
+    }
+
+    /// \brief Número total de sondas.
+    uint32_t getProbeCount() const
+    {
+        return (probeCount);
+    }
+
+private:
+    /// \brief Crea el layout, el pool y un descriptor set por frame en vuelo.
+    /// \param lightGrid Origen del SSBO de luces.
+    /// \param framesInFlight Nº de frames en vuelo.
+    void createDescriptors(const LightGrid& lightGrid, uint32_t framesInFlight);
+
+    /// \brief Crea el pipeline layout y la tubería de \c probe_update.comp.
+    void createPipeline();
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Parámetros de la rejilla.
+    ProbeGridSettings settings;
+
+    /// Posición de la primera sonda.
+    glm::vec3 origin {};
+    /// Distancia entre sondas.
+    glm::vec3 spacing {};
+    /// Número total de sondas.
+    uint32_t probeCount = 0;
+
+    /// Primera sonda del siguiente \c update.
+    uint32_t cursor = 0;
+    /// Recalcula todas las sondas en el siguiente \c update.
+    bool refreshAll = true;
+
+    /// Cabecera de la rejilla y coeficientes finales (escritos por el cómputo).
+    std::unique_ptr<VulkanBuffer> probeBuffer;
+    /// Coeficientes horneados (visibles por el host).
+    std::unique_ptr<VulkanBuffer> bakedBuffer;
+
+    /// Pool propio para los descriptor sets de la actualización.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+    /// Layout del set de \c probe_update.comp.
+    std::unique_ptr<DescriptorSetLayout> setLayout;
+    /// Descriptor sets por frame en vuelo (cambia el SSBO de luces).
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    /// Pipeline layout de \c probe_update.comp.
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    /// Tubería de actualización.
+    std::unique_ptr<ComputePipeline> updatePipeline;
+};
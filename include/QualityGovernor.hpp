@@ -0,0 +1,143 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: QualityGovernor.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Perf.hpp"
+
+#include <cstdint>
+
+ /// \brief Valores de los parámetros de calidad ajustables en tiempo de ejecución.
+struct QualityKnobs
+{
+    /// Multiplicador de la distancia a partir de la cual un objeto pasa a impostor.
+    float lodBias = 1.0f;
+
+    /// Número máximo de luces puntuales que se sombrean por objeto (el gobernador acota
+    /// \c low y \c high a \c LightGrid::MAX_OBJECT_LIGHTS para que cada nivel sea efectivo).
+    uint32_t maxShadedLights = 8;
+
+    /// Frames entre reconstrucciones de la UI (1 = cada frame).
+    uint32_t uiRefreshInterval = 1;
+};
+
+/// \brief Configuración del \c QualityGovernor.
+struct QualityGovernorSettings
+{
+    /// Presupuesto de tiempo de frame (ms).
+    float targetFrameMs = 1000.0f / 60.0f;
+
+    /// Error relativo dentro del cual no se actúa (banda muerta).
+    float deadband = 0.05f;
+
+    /// Ganancia proporcional.
+    float kp = 0.6f;
+
+    /// Ganancia integral (1/s).
+    float ki = 1.0f;
+
+    /// Ganancia derivativa (s).
+    float kd = 0.02f;
+
+    /// Número de niveles discretos de calidad.
+    uint32_t levels = 8;
+
+    /// Fracción de nivel adicional que debe superar la salida del controlador para
+    /// cambiar de nivel; evita oscilar entre dos niveles vecinos.
+    float levelHysteresis = 0.25f;
+
+    /// Tiempo mínimo entre una decisión y una bajada de calidad (s).
+    float downHoldSeconds = 0.25f;
+
+    /// Tiempo mínimo entre una decisión y una subida de calidad (s); mayor que el de
+    /// bajada para recuperar calidad sólo cuando el margen es estable.
+    float upHoldSeconds = 2.0f;
+
+    /// Parámetros en el nivel más bajo.
+    QualityKnobs low {0.35f, 2, 6};
+
+    /// Parámetros en el nivel más alto.
+    QualityKnobs high {1.0f, 8, 1};
+};
+
+/// \brief Ajusta la calidad para mantener el tiempo de frame dentro de un presupuesto.
+/// \details Cada frame compara el coste del frame (el mayor de las medias de CPU y GPU
+/// de \c Perf) con el presupuesto y un controlador PID calcula una calidad continua en
+/// [0, 1]. Esa calidad se cuantiza en \c levels niveles con histéresis y tiempos mínimos
+/// entre decisiones, y cada nivel interpola los parámetros entre \c low y \c high.
+/// Cada cambio de nivel se registra en \c Perf. Bloqueado, mantiene el nivel actual
+/// (útil para que las mediciones sean comparables).
+class QualityGovernor
+{
+public:
+    /// \brief Crea el gobernador en el nivel máximo de calidad.
+    /// \param settings Configuración del controlador y rangos de los parámetros.
+    explicit QualityGovernor(const QualityGovernorSettings& settings = {});
+
+    /// \brief Actualiza el controlador con las métricas del último frame.
+    /// \param perf Métricas de rendimiento; recibe el estado y las decisiones.
+    /// \param frameTime Duración del último frame (s).
+    /// \return \c true si ha cambiado el nivel de calidad.
+    bool update(Perf& perf, float frameTime);
+
+    /// \brief Bloquea o desbloquea el nivel actual.
+    /// \param lock \c true para mantener el nivel actual.
+    void setLocked(bool lock);
+
+    /// \brief Indica si el nivel está bloqueado.
+    bool isLocked() const
+    {
+        return (locked);
+    }
+
+    /// \brief Nivel actual (0 = calidad mínima).
+    uint32_t getLevel() const
+    {
+        return (level);
+    }
+
+    /// \brief Parámetros correspondientes al nivel actual.
+    const QualityKnobs& getKnobs() const
+    {
+        return (knobs);
+    }
+
+    /// \brief Configuración del gobernador.
+    const QualityGovernorSettings& getSettings() const
+    {
+        return (settings);
+    }
+
+private:
+    /// \brief Recalcula \c knobs a partir de \c level.
+    void applyLevel();
+
+    /// Configuración.
+    QualityGovernorSettings settings;
+
+    /// Parámetros del nivel actual.
+    QualityKnobs knobs {};
+
+    /// Nivel actual.
+    uint32_t level = 0;
+
+    /// Término integral acumulado.
+    float integral = 0.0f;
+
+    /// Error del frame anterior (para el término derivativo).
+    float previousError = 0.0f;
+
+    /// Tiempo desde el arranque del gobernador (s).
+    double elapsed = 0.0;
+
+    /// Instante de la última decisión (s).
+    double lastDecision = 0.0;
+
+    /// Nivel bloqueado.
+    bool locked = false;
+};
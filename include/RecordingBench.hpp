@@ -0,0 +1,189 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: RecordingBench.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "BasicRenderer.hpp"
+
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+ /// \brief Barrido de \c RecordingBench.
+struct RecordingBenchSettings
+{
+    /// Máximo de hebras de grabación (0 = \c std::thread::hardware_concurrency).
+    uint32_t maxWorkers = 0;
+    /// Objetos de la escena sintética en cada punto del barrido.
+    std::vector<uint32_t> objectCounts {1000, 10000, 100000, 1000000};
+    /// Mallas distintas entre las que se reparten los objetos.
+    std::vector<uint32_t> modelCounts {1, 16, 256};
+    /// Repeticiones por punto (se toma la mediana).
+    uint32_t iterations = 5;
+    /// CPUs donde fijar las hebras de grabación (vacío = sin afinidad), como en \c run.
+    std::vector<uint32_t> cpus;
+    /// Objetos de la escena de \c RecordingBench::runVariants.
+    uint32_t variantObjects = 100000;
+    /// Mallas distintas de la escena de \c RecordingBench::runVariants.
+    uint32_t variantModels = 16;
+};
+
+/// \brief Medición de un punto del barrido (medianas, ms).
+struct RecordingBenchSample
+{
+    /// Hebras de grabación.
+    uint32_t workers = 0;
+    /// Objetos de la escena.
+    uint32_t objects = 0;
+    /// Mallas distintas.
+    uint32_t models = 0;
+    /// \c BasicRenderer::prepareRecording en la hebra principal.
+    float prepareMs = 0.0f;
+    /// Grabación de la hebra más lenta (camino crítico).
+    float recordMs = 0.0f;
+    /// Grabación media por hebra.
+    float recordMeanMs = 0.0f;
+    /// Lanzar las hebras y esperar a que terminen, descontada la grabación más lenta.
+    float joinMs = 0.0f;
+    /// Llamada a \c vkCmdExecuteCommands en el command buffer primario.
+    float executeMs = 0.0f;
+    /// Desde \c prepareRecording hasta cerrar el primario.
+    float totalMs = 0.0f;
+    /// \c totalMs con una hebra dividido entre \c totalMs.
+    float speedup = 1.0f;
+    /// \c speedup dividido entre \c workers.
+    float efficiency = 1.0f;
+};
+
+/// \brief Medición de una variante del bucle de grabación (medianas, ms).
+struct RecordVariantSample
+{
+    /// Variante medida.
+    RecordVariant variant {};
+    /// Objetos de la escena.
+    uint32_t objects = 0;
+    /// Objetos que superan el culling (todos sin culling).
+    uint32_t drawn = 0;
+    /// \c BasicRenderer::prepareRecording.
+    float prepareMs = 0.0f;
+    /// Grabación de todos los objetos en una hebra.
+    float recordMs = 0.0f;
+};
+
+/// \brief Caracteriza la grabación multihebra de \c VulkanApplication::run.
+/// \details Para cada combinación de objetos, mallas y hebras construye una escena
+/// sintética (cubos repartidos entre mallas distintas, de modo que cambian los búferes
+/// enlazados) y repite el mismo esquema que el bucle de render: una \c std::thread por
+/// hebra que graba su rango con \c BasicRenderer::recordRange en un secundario propio,
+/// espera a todas y los ejecuta con \c vkCmdExecuteCommands dentro del render pass de la
+/// swapchain. Los command buffers nunca se envían: sólo se mide la CPU, así que el
+/// resultado no depende de la GPU y es comparable entre máquinas (también con lavapipe).
+class RecordingBench
+{
+public:
+    /// \brief Crea los pools y command buffers de hasta \p maxWorkers hebras.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param renderPass Render pass de la swapchain.
+    /// \param framebuffer Framebuffer de la swapchain.
+    /// \param extent Tamaño del framebuffer.
+    /// \param maxWorkers Máximo de hebras (0 = \c std::thread::hardware_concurrency).
+    RecordingBench(
+        VulkanDevice& device,
+        VkRenderPass renderPass,
+        VkFramebuffer framebuffer,
+        VkExtent2D extent,
+        uint32_t maxWorkers);
+
+    /// \brief Libera pools y mallas.
+    ~RecordingBench();
+
+    RecordingBench(const RecordingBench&) = delete;
+    RecordingBench& operator=(const RecordingBench&) = delete;
+
+    /// \brief Ejecuta el barrido.
+    /// \param renderer Renderizador cuya grabación se mide.
+    /// \param globalDescriptorSet Set global enlazado en cada secundario.
+    /// \param settings Puntos del barrido.
+    /// \return Una medición por punto, agrupadas por escena y en orden de hebras.
+    std::vector<RecordingBenchSample> run(
+        BasicRenderer& renderer,
+        VkDescriptorSet globalDescriptorSet,
+        const RecordingBenchSettings& settings);
+
+    /// \brief Compara las variantes del bucle de grabación en una hebra.
+    /// \details Graba la misma escena, vista por una cámara que deja parte fuera del
+    /// frustum, con el bucle genérico y con el especializado para cada combinación de
+    /// culling y omisión de enlaces. Restaura después la variante del renderizador.
+    /// \param renderer Renderizador cuya grabación se mide.
+    /// \param globalDescriptorSet Set global enlazado en el secundario.
+    /// \param settings Escena (\c variantObjects, \c variantModels) y repeticiones.
+    /// \return Una medición por variante, genérica y especializada alternas.
+    std::vector<RecordVariantSample> runVariants(
+        BasicRenderer& renderer,
+        VkDescriptorSet globalDescriptorSet,
+        const RecordingBenchSettings& settings);
+
+    /// \brief Imprime la tabla de escalado y una curva de eficiencia por escena.
+    /// \param samples Resultado de \c run.
+    /// \param out Flujo de salida.
+    static void print(const std::vector<RecordingBenchSample>& samples, std::ostream& out);
+
+    /// \brief Imprime la comparación de variantes.
+    /// \param samples Resultado de \c runVariants.
+    /// \param out Flujo de salida.
+    static void printVariants(const std::vector<RecordVariantSample>& samples, std::ostream& out);
+
+private:
+    /// \brief Recursos de grabación de una hebra.
+    struct Worker
+    {
+        /// Pool propio (los pools no admiten acceso concurrente).
+        VkCommandPool pool = VK_NULL_HANDLE;
+        /// Command buffer secundario.
+        VkCommandBuffer secondary = VK_NULL_HANDLE;
+    };
+
+    /// \brief Crea \p count mallas distintas (cubos de tamaño ligeramente diferente).
+    void createModels(uint32_t count);
+
+    /// \brief Llena \p gameObjects con una rejilla cúbica de \p objectCount objetos
+    /// que se reparten las mallas de \c models.
+    void createScene(uint32_t objectCount, std::unordered_map<unsigned int, GameObject>& gameObjects) const;
+
+    /// \brief Mide una repetición con \p workerCount hebras.
+    /// \param renderer Renderizador.
+    /// \param frameInfo Contexto con la escena sintética.
+    /// \param workerCount Hebras a usar.
+    /// \param cpus CPUs donde fijar las hebras (vacío = sin afinidad).
+    /// \param sample Salida: tiempos de la repetición.
+    void measure(
+        BasicRenderer& renderer,
+        FrameInfo& frameInfo,
+        uint32_t workerCount,
+        const std::vector<uint32_t>& cpus,
+        RecordingBenchSample& sample);
+
+    /// Dispositivo Vulkan.
+    VulkanDevice& device;
+    /// Render pass de la swapchain.
+    VkRenderPass renderPass;
+    /// Framebuffer de la swapchain.
+    VkFramebuffer framebuffer;
+    /// Tamaño del framebuffer.
+    VkExtent2D extent;
+
+    /// Recursos de cada hebra.
+    std::vector<Worker> workers;
+    /// Pool del command buffer primario.
+    VkCommandPool primaryPool = VK_NULL_HANDLE;
+    /// Command buffer primario.
+    VkCommandBuffer primary = VK_NULL_HANDLE;
+    /// Mallas de la escena sintética.
+    std::vector<std::shared_ptr<Model>> models;
+};
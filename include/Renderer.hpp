@@ -42,6 +42,24 @@ public:
         return (swapChain->imageCount());
     }
 
+    /// \brief Formato de color de la swapchain.
+    VkFormat getSwapChainImageFormat() const
+    {
+        return (swapChain->getSwapChainImageFormat());
+    }
+
+    /// \brief Formato de profundidad de la swapchain.
+    VkFormat getSwapChainDepthFormat() const
+    {
+        return (swapChain->getSwapChainDepthFormat());
+    }
+
+    /// \brief Extensión actual de la swapchain.
+    VkExtent2D getSwapChainExtent() const
+    {
+        return (swapChain->getSwapChainExtent());
+    }
+
     /// \brief Devuelve la relación de aspecto del framebuffer actual.
     float getAspectRatio() const
     {
@@ -99,6 +117,15 @@ public:
     /// \brief Finaliza el frame. Cierra el command buffer y presenta.
     void endFrame();
 
+    /// \brief Hace que el envío del frame en curso espere a un semáforo de línea temporal.
+    /// \details Se usa para consumir resultados del cómputo asíncrono; la espera se
+    /// aplica sólo al siguiente \c endFrame.
+    /// \param wait Semáforo, valor y etapas que esperan.
+    void setFrameWait(const TimelineWait& wait)
+    {
+        frameWait = wait;
+    }
+
     /// \brief Inicia el render pass principal sobre el command buffer indicado.
     /// \param commandBuffer Command buffer devuelto por beginFrame.
     void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
@@ -138,6 +165,9 @@ private:
     /// Indica si hay un frame en curso.
     bool isFrameStarted{ false };
 
+    /// Espera adicional para el envío del frame en curso.
+    TimelineWait frameWait {};
+
     /// Subsistema de métricas de rendimiento.
     Perf perf;
 };
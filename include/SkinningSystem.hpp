@@ -0,0 +1,191 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: SkinningSystem.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "Animation.hpp"
+#include "ComputePipeline.hpp"
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "FrameContext.hpp"
+#include "Model.hpp"
+#include "VulkanBuffer.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+ /// \brief Influencias de un vértice sobre el esqueleto (std430, 32 bytes).
+ /// \details Hasta cuatro articulaciones por vértice; los pesos suman 1.
+struct SkinInfluence
+{
+    /// Índices de articulación.
+    glm::uvec4 joints {0u};
+    /// Peso de cada articulación.
+    glm::vec4 weights {0.0f};
+};
+
+/// \brief Personajes animados por esqueleto con skinning en un shader de cómputo.
+/// \details Cada frame la CPU muestrea el clip de todos los personajes en
+/// paralelo (canales SoA, ver \c AnimationSampler) con un conjunto de hebras
+/// persistente y escribe sus paletas de matrices en un búfer visible por el host.
+/// Después, \c update graba un único dispatch de \c skin.comp para todos los
+/// personajes (\c gl_GlobalInvocationID.y es la instancia) que lee la pose de
+/// reposo, las influencias y el desplazamiento de la paleta de cada instancia y
+/// escribe posiciones y normales deformadas en un búfer de vértices compartido;
+/// el \c Model de cada instancia dibuja su tramo de ese búfer. El resultado es geometría
+/// normal para el resto del motor: cualquier pase que dibuje el \c Model
+/// reutiliza los vértices ya deformados sin volver a aplicar el skinning.
+class SkinningSystem
+{
+public:
+    /// \brief Crea el personaje, sus instancias y la tubería de cómputo.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param instanceCount Número de personajes animados.
+    SkinningSystem(VulkanDevice& device, uint32_t instanceCount = 144);
+
+    /// \brief Libera recursos asociados.
+    ~SkinningSystem();
+
+    SkinningSystem(const SkinningSystem&) = delete;
+    SkinningSystem& operator=(const SkinningSystem&) = delete;
+
+    /// \brief Añade un \c GameObject por personaje a la escena.
+    /// \param gameObjects Contenedor de objetos de escena.
+    void populate(std::unordered_map<unsigned int, GameObject>& gameObjects);
+
+    /// \brief Avanza la animación y graba el skinning en el command buffer del frame.
+    /// \details Debe llamarse fuera del render pass y antes de dibujar la escena.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Número de personajes animados.
+    uint32_t getInstanceCount() const
+    {
+        return (instanceCount);
+    }
+
+private:
+    /// \brief Genera la malla, el esqueleto y el clip del personaje.
+    /// \details No hay recursos con skinning en el repositorio, así que el
+    /// personaje es un tentáculo procedural: un tubo a lo largo de -Y con una
+    /// cadena de articulaciones y un clip de ondulación en bucle.
+    void createCharacter();
+
+    /// \brief Crea la pose de reposo, las influencias, las paletas y los modelos.
+    void createBuffers();
+
+    /// \brief Crea el layout, el pool y un descriptor set por frame en vuelo.
+    void createDescriptors();
+
+    /// \brief Crea el pipeline layout y la tubería de \c skin.comp.
+    void createPipeline();
+
+    /// \brief Crea las hebras que evalúan las poses junto a la hebra llamante.
+    void startWorkers();
+
+    /// \brief Muestrea la animación y escribe las paletas del frame en paralelo.
+    /// \param frameIndex Frame en vuelo cuya paleta se escribe.
+    void evaluatePoses(int frameIndex);
+
+    /// \brief Muestrea y escribe las paletas de un tramo de personajes.
+    /// \param begin Primer personaje.
+    /// \param end Personaje siguiente al último.
+    void evaluateRange(uint32_t begin, uint32_t end);
+
+    /// \brief Bucle de una hebra de poses: evalúa su tramo en cada frame.
+    /// \param worker Índice del tramo (el 0 es de la hebra llamante).
+    void workerLoop(uint32_t worker);
+
+    /// Dispositivo lógico para crear recursos.
+    VulkanDevice& vulkanDevice;
+
+    /// Número de personajes.
+    uint32_t instanceCount;
+
+    /// Malla en pose de reposo.
+    Model::Builder bindPose {};
+
+    /// Influencias por vértice de la malla.
+    std::vector<SkinInfluence> influences;
+
+    /// Esqueleto compartido por todas las instancias.
+    Skeleton skeleton {};
+
+    /// Clip compartido por todas las instancias.
+    AnimationClip clip {};
+
+    /// Instante de reproducción de cada personaje (s).
+    std::vector<float> playbackTimes;
+
+    /// Poses muestreadas de todos los personajes (un lote, SoA por articulación).
+    PoseBatch poses {};
+
+    /// Malla deformada de cada personaje (un tramo de \c skinnedVertices).
+    std::vector<std::shared_ptr<Model>> instanceModels;
+
+    /// Vértices deformados de todos los personajes, consecutivos (salida del cómputo).
+    std::shared_ptr<VulkanBuffer> skinnedVertices;
+
+    /// Primera matriz de la paleta de cada personaje (leída por \c skin.comp).
+    std::unique_ptr<VulkanBuffer> paletteOffsetBuffer;
+
+    /// Pose de reposo en GPU (vértices en el formato de \c Model::Vertex).
+    std::unique_ptr<VulkanBuffer> bindPoseBuffer;
+
+    /// Influencias en GPU.
+    std::unique_ptr<VulkanBuffer> influenceBuffer;
+
+    /// Paletas de todos los personajes, una por frame en vuelo (visibles por el host).
+    std::vector<std::unique_ptr<VulkanBuffer>> paletteBuffers;
+
+    /// Pool propio para los descriptor sets de skinning.
+    std::unique_ptr<DescriptorPool> descriptorPool;
+
+    /// Layout del set de skinning.
+    std::unique_ptr<DescriptorSetLayout> setLayout;
+
+    /// Descriptor set de cada frame en vuelo (cambia la paleta).
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    /// Pipeline layout de \c skin.comp.
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+    /// Tubería de skinning.
+    std::unique_ptr<ComputePipeline> skinPipeline;
+
+    /// Hebras de poses (tramos 1..N; el tramo 0 lo evalúa la hebra llamante).
+    std::vector<std::thread> workers;
+
+    /// Personajes por tramo (múltiplo de \c PoseBatch::CACHE_LINE_CHARACTERS).
+    uint32_t chunk = 0;
+
+    /// Protege el estado del frame compartido con las hebras.
+    std::mutex mutex;
+
+    /// Despierta a las hebras cuando hay un frame que evaluar.
+    std::condition_variable wakeUp;
+
+    /// Avisa a \c evaluatePoses cuando todas las hebras han terminado su tramo.
+    std::condition_variable finished;
+
+    /// Número de frame evaluado; las hebras arrancan cuando cambia.
+    uint64_t generation = 0;
+
+    /// Hebras que aún no han terminado el frame actual.
+    uint32_t pending = 0;
+
+    /// Paleta que se escribe en el frame actual.
+    glm::mat4* framePalette = nullptr;
+
+    /// Indica a las hebras que deben terminar.
+    bool stopping = false;
+};
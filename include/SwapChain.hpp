@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "Perf.hpp"
 #include "VulkanDevice.hpp"
 
 #include <vulkan/vulkan.h>
@@ -83,6 +84,12 @@ public:
         return (swapChainImageFormat);
     }
 
+    /// \brief Formato del buffer de profundidad de la swapchain.
+    VkFormat getSwapChainDepthFormat()
+    {
+        return (swapChainDepthFormat);
+    }
+
     /// \brief Extensin actual del rea de presentacin.
     VkExtent2D getSwapChainExtent()
     {
@@ -114,15 +121,29 @@ public:
     VkFormat findDepthFormat();
 
     /// \brief Adquiere el ndice de la siguiente imagen disponible.
+    /// \details Mide la espera al fence del frame en vuelo y la adquisicin; ambas
+    /// reinician \c getBlockingTimes para el nuevo frame.
     /// \param imageIndex Salida con el ndice de imagen adquirido.
     /// \return Resultado de la operacin de adquisicin.
     VkResult acquireNextImage(uint32_t* imageIndex);
 
     /// \brief Enva los command buffers para su ejecucin y presenta la imagen.
+    /// \details Mide la espera al fence de la imagen, el envo y la presentacin.
     /// \param buffers Puntero al command buffer grabado del frame.
     /// \param imageIndex ndice de la imagen que se va a presentar.
+    /// \param extraWait Espera adicional en un semforo de lnea temporal (opcional).
     /// \return Resultado de la operacin de presentacin.
-    VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex);
+    VkResult submitCommandBuffers(
+        const VkCommandBuffer* buffers, 
+        uint32_t* imageIndex, 
+        const TimelineWait* extraWait = nullptr);
+
+    /// \brief Esperas medidas en \c acquireNextImage y \c submitCommandBuffers del
+    /// ltimo frame.
+    const FrameBlockingTimes& getBlockingTimes() const
+    {
+        return (blocking);
+    }
 
     /// \brief Compara los formatos de color y profundidad con otra swapchain.
     /// \param swapChain Otra instancia contra la que se compara.
@@ -229,5 +250,8 @@ private:
 
     /// ndice del frame actual en vuelo.
     size_t currentFrame = 0;
+
+    /// Esperas del frame en curso.
+    FrameBlockingTimes blocking {};
 };
 
@@ -0,0 +1,275 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: Task.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+ /// \brief Corrutina perezosa que produce un valor de tipo \c T.
+ /// \details La corrutina no empieza hasta que otra corrutina hace \c co_await sobre
+ /// ella; al terminar, reanuda directamente a quien la esperaba (transferencia
+ /// simétrica), por lo que una cadena de pasos se ejecuta en la hebra en la que se
+ /// reanudó el último \c co_await. Las excepciones se propagan al que espera.
+ /// Para lanzarla sin esperar a su resultado se usa \c AsyncScheduler::spawn.
+template <typename T = void>
+class Task
+{
+public:
+    struct promise_type;
+
+    /// Manejador de la corrutina asociada.
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /// \brief Reanuda a la corrutina que esperaba al terminar ésta.
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return (false);
+        }
+
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return (continuation ? continuation : std::noop_coroutine());
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    /// \brief Estado compartido entre la corrutina y el objeto \c Task.
+    struct promise_type
+    {
+        /// Valor devuelto con \c co_return.
+        std::optional<T> value;
+
+        /// Excepción no capturada dentro de la corrutina.
+        std::exception_ptr error;
+
+        /// Corrutina a reanudar al terminar.
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object()
+        {
+            return (Task(Handle::from_promise(*this)));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_value(T result)
+        {
+            value.emplace(std::move(result));
+        }
+
+        void unhandled_exception()
+        {
+            error = std::current_exception();
+        }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+
+        return (*this);
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return (false);
+    }
+
+    /// \brief Arranca la corrutina y registra a quien la espera.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return (handle);
+    }
+
+    /// \brief Devuelve el resultado o relanza la excepción de la corrutina.
+    T await_resume()
+    {
+        if (handle.promise().error)
+        {
+            std::rethrow_exception(handle.promise().error);
+        }
+
+        return (std::move(*handle.promise().value));
+    }
+
+private:
+    explicit Task(Handle handle) : handle(handle)
+    {
+    }
+
+    void destroy()
+    {
+        if (handle)
+        {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+
+    /// Corrutina propiedad de este objeto.
+    Handle handle;
+};
+
+/// \brief Especialización para corrutinas que no devuelven valor.
+template <>
+class Task<void>
+{
+public:
+    struct promise_type;
+
+    /// Manejador de la corrutina asociada.
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /// \brief Reanuda a la corrutina que esperaba al terminar ésta.
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return (false);
+        }
+
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return (continuation ? continuation : std::noop_coroutine());
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    /// \brief Estado compartido entre la corrutina y el objeto \c Task.
+    struct promise_type
+    {
+        /// Excepción no capturada dentro de la corrutina.
+        std::exception_ptr error;
+
+        /// Corrutina a reanudar al terminar.
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object()
+        {
+            return (Task(Handle::from_promise(*this)));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception()
+        {
+            error = std::current_exception();
+        }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+
+        return (*this);
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return (false);
+    }
+
+    /// \brief Arranca la corrutina y registra a quien la espera.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return (handle);
+    }
+
+    /// \brief Relanza la excepción de la corrutina, si la hubo.
+    void await_resume() const
+    {
+        if (handle.promise().error)
+        {
+            std::rethrow_exception(handle.promise().error);
+        }
+    }
+
+private:
+    explicit Task(Handle handle) : handle(handle)
+    {
+    }
+
+    void destroy()
+    {
+        if (handle)
+        {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+
+    /// Corrutina propiedad de este objeto.
+    Handle handle;
+};
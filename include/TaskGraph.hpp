@@ -0,0 +1,99 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: TaskGraph.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+ /// \brief Medición de una tarea ejecutada por el \c TaskGraph.
+ /// \details Guarda el nombre, la hebra que la ejecutó y los instantes de inicio/fin
+ /// para poder reconstruir una línea temporal (p.ej., el arranque de la aplicación).
+struct TaskTiming
+{
+    /// Nombre legible de la tarea.
+    std::string name;
+
+    /// Índice de la hebra que la ejecutó (0 = hebra que llamó a \c run).
+    uint32_t worker = 0;
+
+    /// Instante de inicio.
+    std::chrono::high_resolution_clock::time_point begin {};
+
+    /// Instante de finalización.
+    std::chrono::high_resolution_clock::time_point end {};
+};
+
+/// \brief Grafo de tareas con dependencias ejecutado sobre un conjunto de hebras.
+/// \details Cada tarea se registra con \c addTask indicando las tareas de las que
+/// depende; sólo puede depender de tareas añadidas previamente, por lo que el grafo
+/// es acíclico por construcción. \c run lanza las tareas listas en paralelo y
+/// libera a sus dependientes conforme terminan. Si alguna tarea lanza una excepción
+/// no se planifican más tareas y la primera excepción se relanza al terminar \c run.
+class TaskGraph
+{
+public:
+    /// Identificador de tarea devuelto por \c addTask.
+    using TaskId = size_t;
+
+    /// \brief Registra una tarea en el grafo.
+    /// \param name Nombre legible (se usa en las mediciones).
+    /// \param work Trabajo a ejecutar.
+    /// \param dependencies Tareas que deben completarse antes de ésta.
+    /// \param mainThreadOnly Si es \c true sólo la ejecuta la hebra que llama a \c run
+    /// (necesario para llamadas de GLFW que deben hacerse desde la hebra principal).
+    /// \return Identificador de la tarea creada.
+    TaskId addTask(
+        const std::string& name,
+        std::function<void()> work,
+        const std::vector<TaskId>& dependencies = {},
+        bool mainThreadOnly = false);
+
+    /// \brief Ejecuta todas las tareas respetando sus dependencias.
+    /// \details La hebra llamante participa como trabajadora; con \c threadCount igual
+    /// a 1 las tareas se ejecutan en serie en orden topológico.
+    /// \param threadCount Número total de hebras a utilizar (mínimo 1).
+    void run(uint32_t threadCount);
+
+    /// \brief Mediciones de la última ejecución, en orden de finalización.
+    const std::vector<TaskTiming>& getTimings() const
+    {
+        return (timings);
+    }
+
+    /// \brief Número de tareas registradas.
+    size_t size() const
+    {
+        return (tasks.size());
+    }
+
+private:
+    /// \brief Nodo interno del grafo.
+    struct Task
+    {
+        /// Nombre legible.
+        std::string name;
+        /// Trabajo a ejecutar.
+        std::function<void()> work;
+        /// Tareas que esperan a ésta.
+        std::vector<TaskId> dependents;
+        /// Número de dependencias declaradas.
+        uint32_t dependencyCount = 0;
+        /// Restringida a la hebra llamante de \c run.
+        bool mainThreadOnly = false;
+    };
+
+    /// Tareas registradas, indexadas por \c TaskId.
+    std::vector<Task> tasks;
+
+    /// Mediciones de la última ejecución.
+    std::vector<TaskTiming> timings;
+};
@@ -0,0 +1,106 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ThreadTopology.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+ /// \brief Política de asignación de hebras a núcleos.
+enum class AffinityPolicy
+{
+    /// No se fija afinidad: el sistema operativo reparte las hebras.
+    None,
+    /// Hebra principal y de grabación en núcleos de rendimiento de un mismo grupo
+    /// de caché (un hilo por núcleo físico antes de usar SMT); hebras de carga en
+    /// núcleos de eficiencia o en los que queden libres.
+    Performance
+};
+
+/// \brief Descripción de una CPU lógica.
+struct CpuInfo
+{
+    /// Índice de la CPU lógica (el que usa el sistema operativo).
+    uint32_t id = 0;
+    /// Núcleo físico, único en el equipo (compartido por los hilos SMT).
+    uint32_t core = 0;
+    /// Encapsulado.
+    uint32_t package = 0;
+    /// Grupo de caché de último nivel (p.ej., un CCX); primer CPU que lo comparte.
+    uint32_t cacheGroup = 0;
+    /// Capacidad relativa (\c cpu_capacity o frecuencia máxima en kHz; 0 si se desconoce).
+    uint64_t capacity = 0;
+    /// Núcleo de rendimiento (en CPUs híbridas; \c true en las homogéneas).
+    bool performance = true;
+};
+
+/// \brief CPUs asignadas a cada papel de hebra.
+struct ThreadPlan
+{
+    /// Valor de CPU que indica "sin fijar".
+    static constexpr uint32_t ANY_CPU = UINT32_MAX;
+
+    /// Hebra principal (render y envío a la cola).
+    uint32_t render = ANY_CPU;
+    /// CPU de cada hebra de grabación (se recorre de forma cíclica); vacío = sin fijar.
+    std::vector<uint32_t> recording;
+    /// CPUs que comparten las hebras de carga; vacío = sin fijar.
+    std::vector<uint32_t> loaders;
+};
+
+/// \brief Topología de CPUs del equipo y reparto de hebras del motor.
+/// \details En Linux se lee de \c /sys/devices/system/cpu: núcleo y encapsulado de
+/// cada CPU, caché de último nivel compartida (grupos tipo CCX), capacidad o
+/// frecuencia máxima y, en CPUs híbridas de Intel, las listas \c cpu_core y
+/// \c cpu_atom. Sólo se consideran las CPUs permitidas al proceso (cpusets). En
+/// otras plataformas se supone una CPU homogénea de \c hardware_concurrency hilos.
+class ThreadTopology
+{
+public:
+    /// \brief Detecta la topología del equipo.
+    static ThreadTopology detect();
+
+    /// \brief Reparte los papeles de hebra según \c policy.
+    /// \param policy Política a aplicar.
+    /// \param recordingThreads Número de hebras de grabación.
+    /// \return Plan de afinidad (vacío con \c AffinityPolicy::None).
+    ThreadPlan plan(AffinityPolicy policy, uint32_t recordingThreads) const;
+
+    /// \brief Fija la afinidad de la hebra actual.
+    /// \param cpus CPUs permitidas (vacío = no hace nada).
+    /// \return \c true si el sistema aceptó la afinidad.
+    static bool pinCurrentThread(const std::vector<uint32_t>& cpus);
+
+    /// \brief Baja la prioridad de la hebra actual al mínimo (trabajo de fondo).
+    /// \details En Linux usa \c SCHED_IDLE (no requiere privilegios); en Windows,
+    /// \c THREAD_PRIORITY_LOWEST.
+    /// \return \c true si el sistema aceptó el cambio.
+    static bool lowerCurrentThreadPriority();
+
+    /// \brief CPUs detectadas.
+    const std::vector<CpuInfo>& getCpus() const
+    {
+        return (cpus);
+    }
+
+    /// \brief Indica si hay núcleos de rendimiento y de eficiencia.
+    bool isHybrid() const;
+
+    /// \brief Nombre legible de una política.
+    static const char* policyName(AffinityPolicy policy);
+
+    /// \brief Vuelca la topología y el plan en texto.
+    /// \param threadPlan Plan a describir.
+    /// \param out Flujo de salida.
+    void print(const ThreadPlan& threadPlan, std::ostream& out) const;
+
+private:
+    /// CPUs lógicas permitidas al proceso, ordenadas por \c id.
+    std::vector<CpuInfo> cpus;
+};
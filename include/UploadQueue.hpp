@@ -0,0 +1,168 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: UploadQueue.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "AsyncScheduler.hpp"
+#include "VulkanDevice.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ /// \brief Identifica un envío de \c UploadQueue.
+ /// \details Es el valor que alcanzará el semáforo de línea temporal cuando la GPU
+ /// termine el envío; un ticket con valor 0 se considera completado.
+struct UploadTicket
+{
+    uint64_t value = 0;
+};
+
+/// \brief Envíos de transferencia que no bloquean a quien los emite.
+/// \details Cada \c submit graba un command buffer propio, lo envía a la cola de gráficos
+/// señalizando un semáforo de línea temporal con un valor creciente y devuelve el ticket
+/// sin esperar. Una hebra espera al envío más antiguo pendiente (\c vkWaitSemaphores) y,
+/// al completarse, libera su command buffer y los recursos asociados y reanuda en el
+/// \c AsyncScheduler las corrutinas que hacían \c co_await sobre ese ticket.
+/// Si el dispositivo no soporta semáforos de línea temporal se usa un fence por envío.
+class UploadQueue
+{
+public:
+    /// \brief Espera que reanuda la corrutina cuando la GPU completa un ticket.
+    struct WaitAwaiter
+    {
+        UploadQueue& queue;
+        UploadTicket ticket;
+
+        bool await_ready() const noexcept
+        {
+            return (queue.isComplete(ticket));
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            return (queue.addWaiter(ticket, handle));
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    /// \brief Crea el command pool, el semáforo y la hebra de espera.
+    /// \param device Dispositivo Vulkan.
+    /// \param scheduler Planificador en el que se reanudan las corrutinas.
+    UploadQueue(VulkanDevice& device, AsyncScheduler& scheduler);
+
+    /// \brief Espera a los envíos pendientes y libera los recursos.
+    ~UploadQueue();
+
+    UploadQueue(const UploadQueue&) = delete;
+    UploadQueue& operator=(const UploadQueue&) = delete;
+
+    /// \brief Graba y envía un command buffer de transferencia sin esperar a la GPU.
+    /// \param record Función que graba los comandos.
+    /// \param keepAlive Recurso que debe vivir hasta que la GPU termine (p.ej., staging).
+    /// \return Ticket del envío.
+    UploadTicket submit(
+        const std::function<void(VkCommandBuffer)>& record,
+        std::shared_ptr<void> keepAlive = nullptr);
+
+    /// \brief Indica si la GPU ha completado el envío del ticket.
+    bool isComplete(UploadTicket ticket) const
+    {
+        return (completed.load(std::memory_order_acquire) >= ticket.value);
+    }
+
+    /// \brief \c co_await suspende la corrutina hasta que la GPU completa el ticket.
+    /// \param ticket Ticket devuelto por \c submit.
+    WaitAwaiter wait(UploadTicket ticket)
+    {
+        return (WaitAwaiter {*this, ticket});
+    }
+
+    /// \brief Bloquea hasta que se completan todos los envíos.
+    void waitIdle();
+
+private:
+    /// \brief Envío pendiente de completarse en la GPU.
+    struct Submission
+    {
+        /// Valor del semáforo al terminar.
+        uint64_t value = 0;
+        /// Command buffer grabado.
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        /// Fence del envío (sólo sin semáforos de línea temporal).
+        VkFence fence = VK_NULL_HANDLE;
+        /// Recursos que deben vivir hasta el final del envío.
+        std::shared_ptr<void> keepAlive;
+    };
+
+    /// \brief Corrutina suspendida a la espera de un valor del semáforo.
+    struct Waiter
+    {
+        uint64_t value = 0;
+        std::coroutine_handle<> handle;
+    };
+
+    /// \brief Registra una corrutina a la espera de un ticket.
+    /// \return \c false si el ticket ya se completó (la corrutina no se suspende).
+    bool addWaiter(UploadTicket ticket, std::coroutine_handle<> handle);
+
+    /// \brief Bucle de la hebra que espera a la GPU.
+    void waitLoop();
+
+    /// Dispositivo Vulkan.
+    VulkanDevice& device;
+
+    /// Planificador en el que se reanudan las corrutinas.
+    AsyncScheduler& scheduler;
+
+    /// Command pool propio (el principal pertenece a la hebra del frame).
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+
+    /// Semáforo de línea temporal (nulo si el dispositivo no lo soporta).
+    VkSemaphore timeline = VK_NULL_HANDLE;
+
+    /// Serializa la grabación y el envío (el pool no admite acceso concurrente).
+    std::mutex poolMutex;
+
+    /// Protege los envíos pendientes y las corrutinas en espera.
+    std::mutex mutex;
+
+    /// Despierta a la hebra de espera.
+    std::condition_variable wakeUp;
+
+    /// Avisa a \c waitIdle cuando no quedan envíos.
+    std::condition_variable drained;
+
+    /// Envíos pendientes, en orden de valor.
+    std::deque<Submission> pending;
+
+    /// Corrutinas en espera.
+    std::vector<Waiter> waiters;
+
+    /// Último valor asignado.
+    uint64_t lastValue = 0;
+
+    /// Último valor completado.
+    std::atomic<uint64_t> completed {0};
+
+    /// Indica a la hebra de espera que debe terminar.
+    bool stopping = false;
+
+    /// Hebra que espera a la GPU.
+    std::thread waiterThread;
+};
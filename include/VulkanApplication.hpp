@@ -9,29 +9,148 @@
 #pragma once
 
 #include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
 #include "VulkanDevice.hpp"
+#include "VulkanBuffer.hpp"
 #include "GameObject.hpp"
 #include "Renderer.hpp"
 #include "Window.hpp"
 #include "EditorUI.hpp"
+#include "HitchDetector.hpp"
+#include "LightBaker.hpp"
+#include "MultiViewPass.hpp"
+#include "Perf.hpp"
+#include "ProbeGrid.hpp"
+#include "QualityGovernor.hpp"
+#include "ThreadTopology.hpp"
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
- /// \brief Punto de entrada de alto nivel de la aplicacin Vulkan.
- /// \details Orquesta la inicializacin de los subsistemas principales
- /// (dispositivo, renderizador, pool de descriptores y UI), gestiona la
- /// creacin/carga de objetos de escena y ejecuta el bucle principal de
- /// render hasta el cierre de la ventana. Se encarga tambin de la
- /// liberacin ordenada de recursos al finalizar.
+class AsyncCompute;
+class BasicRenderer;
+class ClipmapTerrain;
+class ImpostorSystem;
+class LightGrid;
+class MetricsExporter;
+class PointLightSystem;
+class ParticleSystem;
+class SkinningSystem;
+class WorldStreamer;
+
+ /// \brief Opciones de ejecucin recibidas por lnea de comandos.
+struct ApplicationOptions
+{
+    /// Crea la ventana oculta (sin interaccin del usuario).
+    bool headless = false;
+
+    /// Mide el tiempo hasta el primer frame, imprime la lnea temporal de
+    /// arranque y termina. Implica \c headless.
+    bool benchStartup = false;
+
+    /// Ejecuta el grafo de arranque en una nica hebra (referencia para comparar).
+    bool serialStartup = false;
+
+    /// Poltica de afinidad de las hebras principal, de grabacin y de carga.
+    AffinityPolicy affinity = AffinityPolicy::Performance;
+
+    /// Si es mayor que 0, mide ese nmero de frames, imprime la topologa de
+    /// hebras y la media, desviacin y percentiles del tiempo de frame, y termina.
+    /// Implica \c headless.
+    uint32_t benchFrames = 0;
+
+    /// Si es mayor que 0, mide la escalabilidad de la grabacin multihebra con escenas
+    /// de hasta ese nmero de objetos, imprime la tabla y termina. Implica \c headless.
+    uint32_t benchRecordingObjects = 0;
+
+    /// Mantiene fijo el nivel de calidad (para que las mediciones sean comparables).
+    bool lockQuality = false;
+
+    /// Presupuesto de tiempo de frame del gobernador de calidad (ms).
+    float frameBudgetMs = 1000.0f / 60.0f;
+
+    /// Usa la cola de cmputo dedicada si existe (\c false fuerza el cmputo en serie).
+    bool asyncCompute = true;
+
+    /// Usa los shaders de media precisin si el dispositivo los admite.
+    bool halfPrecision = true;
+
+    /// Descarta en la grabacin los objetos fuera del frustum de la cmara.
+    bool frustumCulling = false;
+
+    /// Vistas adicionales dibujadas cada frame en un destino fuera de pantalla.
+    MultiViewMode multiView = MultiViewMode::Off;
+
+    /// Si no est vaca, guarda ah la captura del primer frame tras el calentamiento
+    /// y termina. Implica \c headless.
+    std::string capturePath;
+
+    /// Si no est vaca, reproduce esa captura \c replayIterations veces, imprime los
+    /// tiempos de grabacin y envo y termina. Implica \c headless.
+    std::string replayPath;
+
+    /// Repeticiones de \c replayPath.
+    uint32_t replayIterations = 1000;
+
+    /// Si no est vaca, sirve las mtricas de \c Perf en formato Prometheus por un
+    /// socket de dominio UNIX en esa ruta.
+    std::string metricsSocket;
+
+    /// Si no est vaca, escribe ah una traza conjunta CPU/GPU (Chrome Trace Event)
+    /// de \c traceFrames frames tras el calentamiento.
+    std::string tracePath;
+
+    /// Frames de \c tracePath.
+    uint32_t traceFrames = 300;
+
+    /// Detecta frames lentos y vuelca la traza de los segundos que los rodean.
+    bool hitchDetection = true;
+
+    /// Umbral, ventana y directorio de \c hitchDetection.
+    HitchSettings hitch {};
+
+    /// Hornea al arrancar las luces en los vrtices de la geometra esttica.
+    bool bakeLighting = false;
+
+    /// Oclusin ambiental, rebote, muestras y hebras de \c bakeLighting.
+    LightBakeSettings bake {};
+
+    /// Ilumina los objetos dinmicos con una rejilla de sondas SH en lugar de sus luces.
+    bool probeLighting = false;
+
+    /// Resolucin y sondas por frame de \c probeLighting.
+    ProbeGridSettings probes {};
+};
+
+/// \brief Command pool y command buffers secundarios de una hebra de grabacin.
+struct RecordingWorker
+{
+    /// Pool propio de la hebra (los pools no admiten acceso concurrente).
+    VkCommandPool pool {VK_NULL_HANDLE};
+
+    /// Un command buffer secundario por frame en vuelo.
+    std::vector<VkCommandBuffer> secondary;
+};
+
+/// \brief Punto de entrada de alto nivel de la aplicacin Vulkan.
+/// \details Orquesta la inicializacin de los subsistemas principales
+/// (dispositivo, renderizador, pool de descriptores y UI), gestiona la
+/// creacin/carga de objetos de escena y ejecuta el bucle principal de
+/// render hasta el cierre de la ventana. Se encarga tambin de la
+/// liberacin ordenada de recursos al finalizar.
+/// El arranque se expresa como un \c TaskGraph: una vez creado el dispositivo,
+/// la lectura de shaders, el parseo de OBJ, la compilacin de tuberas y las
+/// fuentes de ImGui se ejecutan en paralelo, y cada fase queda registrada en
+/// un \c StartupTimeline.
 class VulkanApplication
 {
 public:
-    /// \brief Construye la aplicacin y prepara los componentes bsicos.
-    /// \details No inicia el bucle de ejecucin. La inicializacin
-    /// completa se realiza en \c run .
-    VulkanApplication();
+    /// \brief Construye la aplicacin e inicializa todos los subsistemas.
+    /// \details Ejecuta el grafo de arranque. No inicia el bucle de ejecucin.
+    /// \param options Opciones de ejecucin.
+    explicit VulkanApplication(const ApplicationOptions& options = {});
 
     /// \brief Libera los recursos administrados por la aplicacin.
     ~VulkanApplication();
@@ -40,17 +159,53 @@ public:
     VulkanApplication& operator=(const VulkanApplication&) = delete;
 
     /// \brief Ejecuta la aplicacin.
-    /// \details Lleva a cabo la inicializacin restante, entra en el
-    /// bucle principal de render y procesa eventos hasta que el usuario
-    /// cierra la ventana. Al salir, sincroniza y limpia recursos.
+    /// \details Entra en el bucle principal de render y procesa eventos hasta
+    /// que el usuario cierra la ventana (o tras el primer frame con
+    /// \c benchStartup, o tras \c benchFrames frames medidos). La hebra principal
+    /// y las de grabacin se fijan a las CPUs de \c threadPlan. Al salir,
+    /// sincroniza y limpia recursos.
     void run();
 
 private:
+    /// \brief Crea el pool, los UBO, el layout y los descriptor sets globales.
+    void createGlobalDescriptors();
+
+    /// \brief Crea un command pool y sus command buffers secundarios por hebra de grabacin.
+    void createRecordingWorkers();
+
     /// \brief Carga y registra los \c GameObject de la escena.
     /// \details Construye la geometra y las luces necesarias para
     /// validar el motor, aadindolas al contenedor \c gameObjects .
     void loadGameObjects();
 
+    /// \brief Hornea las luces de la escena en la geometra esttica.
+    /// \details Lee de la GPU las mallas marcadas con \c staticGeometry, hornea con
+    /// \c LightBaker la luz de todas las luces puntuales (que quedan fijas y slo iluminan
+    /// en ejecucin a los objetos dinmicos) y sustituye cada malla por una copia con la
+    /// irradiancia horneada.
+    /// Con \c probeLighting hornea tambin la parte esttica de las sondas.
+    void bakeStaticLighting();
+
+    /// \brief Ajusta la rejilla de sondas a la caja de la geometra esttica.
+    /// \details Lee de la GPU los vrtices de los objetos con \c staticGeometry; si no
+    /// hay ninguno se mantiene la caja de \c ProbeGridSettings.
+    void fitProbeGrid();
+
+    /// \brief Aplica a los sistemas de render los parmetros del nivel de calidad actual.
+    void applyQualityKnobs();
+
+    /// \brief Opciones de ejecucin.
+    ApplicationOptions options;
+
+    /// \brief Lnea temporal de arranque (su origen es la construccin de la aplicacin).
+    StartupTimeline startupTimeline;
+
+    /// \brief Topologa de CPUs del equipo.
+    ThreadTopology threadTopology;
+
+    /// \brief CPUs asignadas a cada papel de hebra segn \c options.affinity.
+    ThreadPlan threadPlan;
+
     /// \brief Interfaz de usuario basada en Dear ImGui.
     EditorUI editorUI;
 
@@ -65,6 +220,66 @@ private:
 
     /// \brief Contenedor de objetos de escena indexados por identificador.
     std::unordered_map<unsigned int, GameObject> gameObjects;
+
+    /// \brief Modelos cargados durante el arranque, indexados por ruta.
+    std::unordered_map<std::string, std::shared_ptr<Model>> models;
+
+    /// \brief Bferes uniformes globales, uno por frame en vuelo.
+    std::vector<std::unique_ptr<VulkanBuffer>> uboBuffers;
+
+    /// \brief Layout del conjunto de descriptores global.
+    std::unique_ptr<DescriptorSetLayout> globalSetLayout;
+
+    /// \brief Conjuntos de descriptores globales, uno por frame en vuelo.
+    std::vector<VkDescriptorSet> globalDescriptorSets;
+
+    /// \brief Sistema de render de la geometra de escena.
+    std::unique_ptr<BasicRenderer> basicRenderer;
+
+    /// \brief Sistema de render de las luces puntuales.
+    std::unique_ptr<PointLightSystem> pointLightSystem;
+
+    /// \brief Sistema de partculas simulado en GPU.
+    std::unique_ptr<ParticleSystem> particleSystem;
+
+    /// \brief Envos de los pases de cmputo a la cola de cmputo asncrono.
+    std::unique_ptr<AsyncCompute> asyncCompute;
+
+    /// \brief Personajes animados con skinning en cmputo.
+    std::unique_ptr<SkinningSystem> skinningSystem;
+
+    /// \brief Terreno de clipmaps centrado en la cmara.
+    std::unique_ptr<ClipmapTerrain> terrain;
+
+    /// \brief Listas de luces por objeto a partir de una rejilla hash.
+    std::unique_ptr<LightGrid> lightGrid;
+
+    /// \brief Sondas de irradiancia para los objetos dinmicos.
+    std::unique_ptr<ProbeGrid> probeGrid;
+
+    /// \brief Sustitucin de objetos lejanos por impostores.
+    std::unique_ptr<ImpostorSystem> impostorSystem;
+
+    /// \brief Pase multivista (estreo o cubo); nulo si no se ha pedido.
+    std::unique_ptr<MultiViewPass> multiViewPass;
+
+    /// \brief Carga y descarga de celdas del mundo alrededor de la cmara.
+    std::unique_ptr<WorldStreamer> worldStreamer;
+
+    /// \brief Exportador de mtricas en vivo; nulo si no se ha pedido.
+    std::unique_ptr<MetricsExporter> metricsExporter;
+
+    /// \brief Recursos de grabacin de cada hebra.
+    std::vector<RecordingWorker> workers;
+
+    /// Ajusta la calidad segn el presupuesto de tiempo de frame.
+    QualityGovernor qualityGovernor;
+
+    /// Interruptor de bloqueo del gobernador (editable desde el panel Performance).
+    bool qualityLocked = false;
+
+    /// Distancia de cambio a impostor configurada (antes de aplicar el LOD bias).
+    float impostorSwitchDistance = 0.0f;
 };
 
 
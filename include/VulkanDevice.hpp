@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include "DeviceCapabilities.hpp"
 #include "Window.hpp"
 
+#include <atomic>
+#include <mutex>
 #include <vector>
 
  /// \brief Capacidades y formatos de la swapchain para un dispositivo fsico.
@@ -21,15 +24,31 @@ struct SwapChainSupportDetails
     std::vector<VkPresentModeKHR> presentModes;
 };
 
+/// \brief Espera en un semforo de lnea temporal que se aade a un envo.
+/// \details La usan las colas que producen datos para el frame (p.ej., el cmputo
+/// asncrono) para que el envo de grficos espere slo en las etapas que los consumen.
+struct TimelineWait
+{
+    /// Semforo de lnea temporal (nulo = sin espera).
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    /// Valor que debe alcanzar el semforo.
+    uint64_t value = 0;
+    /// Etapas del envo que esperan al semforo.
+    VkPipelineStageFlags stages = 0;
+};
+
 /// \brief ndices de familias de colas relevantes para la aplicacin.
 /// \details Se almacenan los ndices de cola de grficos y de presentacin 
-/// y si han sido localizados.
+/// y si han sido localizados. La familia de cmputo slo se rellena si existe
+/// una dedicada (sin grficos), que es la que permite solapar cmputo y render.
 struct QueueFamilyIndices
 {
     uint32_t graphicsFamily;
     uint32_t presentFamily;
+    uint32_t computeFamily = 0;
     bool hasGraphicsFamily = false;
     bool hasPresentFamily = false;
+    bool hasComputeFamily = false;
 
     /// \brief Devuelve el ndice de la familia de colas de grficos.
     uint32_t GetGraphicsFamily() const
@@ -117,12 +136,26 @@ public:
         return presentQueue;
     }
 
-    /// \brief Consulta y devuelve el soporte de swapchain del dispositivo fsico actual.
-    SwapChainSupportDetails getSwapChainSupportDetails() const
+    /// \brief Indica si hay una cola de cmputo dedicada utilizable en paralelo.
+    /// \details Requiere una familia slo de cmputo y semforos de lnea temporal
+    /// para sincronizarla con la cola de grficos.
+    bool hasAsyncCompute() const
     {
-        return querySwapChainSupport(physicalDevice);
+        return (queueFamilies.hasComputeFamily && capabilities.timelineSemaphore);
     }
 
+    /// \brief Devuelve la cola de cmputo asncrono (nula si \c hasAsyncCompute es falso).
+    VkQueue getComputeQueue() const
+    {
+        return (computeQueue);
+    }
+
+    /// \brief Devuelve el soporte de swapchain del dispositivo fsico actual.
+    /// \details Formatos y modos de presentacin se consultan una vez al elegir el
+    /// dispositivo; slo las capacidades de la surface (que cambian con el tamao de
+    /// la ventana) se vuelven a consultar en cada llamada.
+    SwapChainSupportDetails getSwapChainSupportDetails() const;
+
     /// \brief Busca un tipo de memoria de dispositivo que cumpla las propiedades requeridas.
     /// \param typeFilter Mscara de tipos aceptables.
     /// \param properties Propiedades de memoria requeridas.
@@ -130,10 +163,31 @@ public:
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 
     /// \brief Devuelve los ndices de familias de colas relevantes
-    /// para el dispositivo fsico actual.
-    QueueFamilyIndices getQueueFamilyIndices() const
+    /// para el dispositivo fsico actual (consultados al elegir el dispositivo).
+    const QueueFamilyIndices& getQueueFamilyIndices() const
+    {
+        return (queueFamilies);
+    }
+
+    /// \brief Devuelve el perfil de capacidades del dispositivo.
+    /// \details Todas las caractersticas marcadas estn habilitadas en el dispositivo lgico.
+    const DeviceCapabilities& getCapabilities() const
+    {
+        return (capabilities);
+    }
+
+    /// \brief Asignaciones de memoria de dispositivo hechas desde el arranque.
+    /// \details Cuenta las de \c createBuffer y \c createImageWithInfo, por las que pasan
+    /// todas las asignaciones del motor. Se puede leer desde cualquier hebra.
+    uint64_t getAllocationCount() const
     {
-        return findQueueFamilies(physicalDevice);
+        return (allocationCount.load(std::memory_order_relaxed));
+    }
+
+    /// \brief Bytes de memoria de dispositivo asignados desde el arranque.
+    uint64_t getAllocatedBytes() const
+    {
+        return (allocatedBytes.load(std::memory_order_relaxed));
     }
 
     /// \brief Elige un formato soportado a partir de candidatos y caractersticas requeridas.
@@ -147,6 +201,9 @@ public:
         VkFormatFeatureFlags features) const;
 
     /// \brief Crea un VkBuffer y asigna su memoria en el dispositivo.
+    /// \details Con cmputo asncrono los bferes de almacenamiento se comparten entre
+    /// las familias de grficos y de cmputo (\c VK_SHARING_MODE_CONCURRENT), de modo
+    /// que no hacen falta transferencias de propiedad entre colas.
     /// \param size Tamao del bfer.
     /// \param usage Flags de uso del bfer.
     /// \param properties Propiedades de la memoria requerida.
@@ -171,7 +228,38 @@ public:
     /// \param srcBuffer Origen.
     /// \param dstBuffer Destino.
     /// \param size Tamao de la copia.
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+    /// \param srcOffset Desplazamiento en el origen.
+    /// \param dstOffset Desplazamiento en el destino.
+    void copyBuffer(
+        VkBuffer srcBuffer,
+        VkBuffer dstBuffer,
+        VkDeviceSize size,
+        VkDeviceSize srcOffset = 0,
+        VkDeviceSize dstOffset = 0);
+
+    /// \brief Enva trabajo a la cola de grficos serializando el acceso a la cola.
+    /// \details Vulkan exige sincronizacin externa de \c VkQueue; todas las hebras que
+    /// envan trabajo (frame, subidas asncronas, comandos de un solo uso) pasan por aqu.
+    /// \param submitCount Nmero de estructuras de envo.
+    /// \param submits Estructuras de envo.
+    /// \param fence Fence a sealizar al terminar (puede ser \c VK_NULL_HANDLE).
+    /// \return Resultado de \c vkQueueSubmit.
+    VkResult submitGraphics(uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence);
+
+    /// \brief Enva trabajo a la cola de cmputo asncrono serializando su acceso.
+    /// \param submitCount Nmero de estructuras de envo.
+    /// \param submits Estructuras de envo.
+    /// \param fence Fence a sealizar al terminar (puede ser \c VK_NULL_HANDLE).
+    /// \return Resultado de \c vkQueueSubmit.
+    VkResult submitCompute(uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence);
+
+    /// \brief Presenta una imagen serializando el acceso a la cola de presentacin.
+    /// \param presentInfo Informacin de presentacin.
+    /// \return Resultado de \c vkQueuePresentKHR.
+    VkResult present(const VkPresentInfoKHR& presentInfo);
+
+    /// \brief Espera a que el dispositivo quede inactivo sin competir con otros envos.
+    void waitIdle();
 
     /// \brief Copia datos desde un bfer a una imagen.
     /// \param buffer Bfer origen.
@@ -279,6 +367,34 @@ private:
     /// Cola de presentacin.
     VkQueue presentQueue;
 
+    /// Cola de cmputo asncrono.
+    VkQueue computeQueue = VK_NULL_HANDLE;
+
+    /// Serializa los comandos de un solo uso (pool principal y cola de grficos),
+    /// que pueden emitirse desde varias hebras durante el arranque.
+    std::mutex singleUseMutex;
+
+    /// Serializa el acceso a las colas de grficos y presentacin.
+    std::mutex queueMutex;
+
+    /// Serializa el acceso a la cola de cmputo asncrono.
+    std::mutex computeQueueMutex;
+
+    /// Asignaciones de memoria desde el arranque (las mallas se crean en varias hebras).
+    std::atomic<uint64_t> allocationCount {0};
+
+    /// Bytes asignados desde el arranque.
+    std::atomic<uint64_t> allocatedBytes {0};
+
+    /// Familias de colas del dispositivo fsico seleccionado.
+    QueueFamilyIndices queueFamilies {};
+
+    /// Formatos y modos de presentacin soportados por la surface.
+    SwapChainSupportDetails swapChainSupport {};
+
+    /// Perfil de capacidades del dispositivo fsico seleccionado.
+    DeviceCapabilities capabilities {};
+
     /// Lista de validation layers solicitados.
     const std::vector<const char*> validationLayers = {"VK_LAYER_KHRONOS_validation"};
 
@@ -25,7 +25,8 @@ public:
     /// \param w Anchura inicial en pxeles.
     /// \param h Altura inicial en pxeles.
     /// \param name Ttulo de la ventana.
-    Window(int w, int h, std::string name);
+    /// \param visible Si es \c false la ventana se crea oculta (ejecuciones sin interfaz).
+    Window(int w, int h, std::string name, bool visible = true);
 
     /// \brief Destruye la ventana y libera los recursos asociados de GLFW.
     ~Window();
@@ -98,6 +99,9 @@ private:
     /// Ttulo de la ventana mostrado por el sistema.
     std::string windowName;
 
+    /// Indica si la ventana se muestra al crearse.
+    bool visible = true;
+
     /// Puntero nativo a la ventana de GLFW.
     GLFWwindow* window;
 };
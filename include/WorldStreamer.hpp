@@ -0,0 +1,301 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: WorldStreamer.hpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "FrameContext.hpp"
+#include "Model.hpp"
+#include "Perf.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+ /// \brief Parámetros del streaming de celdas del mundo.
+struct WorldStreamerSettings
+{
+    /// Carpeta con los ficheros \c cell_X_Z.chunk (relativa al ejecutable).
+    std::string directory = "../world";
+
+    /// Lado de cada celda en el plano XZ (unidades de mundo).
+    float cellSize = 16.0f;
+
+    /// Radio alrededor de la posición prevista dentro del cual se cargan celdas.
+    float loadRadius = 40.0f;
+
+    /// Radio a partir del cual se descargan celdas residentes; mayor que
+    /// \c loadRadius para que una celda en el borde no se cargue y descargue cada frame.
+    float unloadRadius = 56.0f;
+
+    /// Segundos de anticipación con los que se extrapola la posición según la velocidad.
+    float lookAheadSeconds = 1.5f;
+
+    /// Presupuesto de memoria de CPU (datos parseados y staging pendientes).
+    uint64_t hostBudget = 64ull * 1024 * 1024;
+
+    /// Presupuesto de memoria de GPU (vértices e índices de celdas residentes y en vuelo).
+    uint64_t gpuBudget = 128ull * 1024 * 1024;
+
+    /// Máximo de celdas insertadas en escena por frame (acota el trabajo del frame).
+    uint32_t maxInsertionsPerFrame = 2;
+
+    /// Máximo de celdas solicitadas a las hebras de carga a la vez.
+    uint32_t maxInFlight = 8;
+
+    /// Hebras de carga.
+    uint32_t workerCount = 2;
+
+    /// CPUs a las que se fijan las hebras de carga (vacío = sin fijar).
+    std::vector<uint32_t> workerCpus;
+};
+
+/// \brief Carga y descarga asíncrona de celdas del mundo alrededor de la cámara.
+/// \details El plano XZ se divide en celdas de \c cellSize; cada una se describe
+/// en un fichero de texto con una línea <tt>object ruta.obj tx ty tz rx ry rz sx sy sz</tt>
+/// por objeto. Si el fichero no existe se genera un conjunto de rocas procedurales
+/// apoyadas sobre \c groundHeight, de forma que el mundo es ilimitado aunque no haya
+/// datos en disco. Cada frame se priorizan las celdas por distancia, favoreciendo las
+/// que están en la dirección de la velocidad, y se encargan a las hebras de carga, que
+/// leen el fichero, parsean los OBJ y crean las mallas con subida diferida (sin tocar
+/// la cola de gráficos). La hebra principal inserta como mucho
+/// \c maxInsertionsPerFrame celdas por frame grabando sus copias en el command
+/// buffer del frame, de modo que la inserción nunca bloquea. Las celdas que quedan
+/// más allá de \c unloadRadius, o las menos prioritarias cuando se excede un
+/// presupuesto, se retiran de escena y sus mallas se destruyen
+/// \c SwapChain::MAX_FRAMES_IN_FLIGHT frames después, cuando ningún command buffer
+/// en vuelo puede referenciarlas.
+class WorldStreamer
+{
+public:
+    /// Función que devuelve la altura (Y) del suelo en un punto del plano XZ.
+    using GroundFunction = std::function<float(float, float)>;
+
+    /// \brief Lanza las hebras de carga.
+    /// \param device Dispositivo lógico Vulkan.
+    /// \param groundHeight Altura del suelo (debe poder llamarse desde cualquier hebra).
+    /// \param settings Parámetros del streaming.
+    WorldStreamer(
+        VulkanDevice& device,
+        GroundFunction groundHeight,
+        const WorldStreamerSettings& settings = {});
+
+    /// \brief Detiene las hebras de carga y libera las celdas.
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    /// \brief Planifica cargas y descargas e inserta las celdas ya cargadas.
+    /// \details Debe llamarse fuera del render pass y antes de grabar la escena:
+    /// añade y elimina entradas de \c frameInfo.gameObjects y graba en
+    /// \c frameInfo.commandBuffer las copias de las mallas insertadas.
+    /// \param frameInfo Contexto del frame.
+    void update(FrameInfo& frameInfo);
+
+    /// \brief Estado del streaming tras el último \c update.
+    const StreamingStats& getStats() const
+    {
+        return (stats);
+    }
+
+    /// \brief Acceso a los parámetros para ajustarlos en tiempo de ejecución.
+    /// \details \c directory, \c cellSize, \c workerCount y \c workerCpus sólo se leen al construir.
+    WorldStreamerSettings& getSettings()
+    {
+        return (settings);
+    }
+
+private:
+    /// Clave de celda: coordenadas enteras (x, z) empaquetadas.
+    using CellKey = uint64_t;
+
+    /// \brief Instancia de una malla dentro de una celda.
+    struct Placement
+    {
+        /// Índice en \c CellPayload::models.
+        uint32_t modelIndex = 0;
+        /// Transformación del objeto.
+        Transform transform {};
+        /// Color del objeto.
+        glm::vec3 color {1.0f};
+    };
+
+    /// \brief Resultado de cargar una celda en una hebra de carga.
+    struct CellPayload
+    {
+        /// Celda cargada.
+        CellKey key = 0;
+        /// Mallas creadas con subida diferida.
+        std::vector<std::shared_ptr<Model>> models;
+        /// Objetos de la celda.
+        std::vector<Placement> placements;
+        /// Bytes de CPU retenidos hasta liberar el staging.
+        uint64_t hostBytes = 0;
+        /// Bytes de GPU de las mallas.
+        uint64_t gpuBytes = 0;
+    };
+
+    /// \brief Estado de una celda conocida por la hebra principal.
+    struct Cell
+    {
+        /// \c true cuando sus objetos están en escena.
+        bool resident = false;
+        /// Prioridad del último frame (menor = más urgente).
+        float priority = 0.0f;
+        /// Datos cargados a la espera de inserción.
+        std::unique_ptr<CellPayload> payload;
+        /// Mallas en escena.
+        std::vector<std::shared_ptr<Model>> models;
+        /// Identificadores de los \c GameObject insertados.
+        std::vector<unsigned int> objectIds;
+        /// Bytes de GPU ocupados.
+        uint64_t gpuBytes = 0;
+    };
+
+    /// \brief Mallas pendientes de liberar cuando la GPU deje de usarlas.
+    struct Retired
+    {
+        /// Frame en el que se retiraron.
+        uint64_t frame = 0;
+        /// Mallas a destruir (o cuyo staging liberar si \c stagingOnly).
+        std::vector<std::shared_ptr<Model>> models;
+        /// Sólo liberar el staging; las mallas siguen en escena.
+        bool stagingOnly = false;
+        /// Bytes de CPU que se liberan.
+        uint64_t hostBytes = 0;
+    };
+
+    /// \brief Bucle de una hebra de carga.
+    void workerLoop();
+
+    /// \brief Carga una celda desde disco (o la genera) y crea sus mallas.
+    /// \param key Celda a cargar.
+    /// \return Datos listos para insertar.
+    std::unique_ptr<CellPayload> loadCell(CellKey key);
+
+    /// \brief Genera las rocas procedurales de una celda sin fichero.
+    /// \param key Celda a generar.
+    /// \param builders Salida con la malla de roca.
+    /// \param placements Salida con las instancias.
+    void generateCell(CellKey key, std::vector<Model::Builder>& builders, std::vector<Placement>& placements) const;
+
+    /// \brief Inserta en escena una celda cargada y graba la subida de sus mallas.
+    /// \param cell Estado de la celda (con \c payload).
+    /// \param frameInfo Contexto del frame.
+    void insertCell(Cell& cell, FrameInfo& frameInfo);
+
+    /// \brief Descarta los datos cargados y aún no insertados de una celda.
+    /// \details Sus mallas no se han usado en ningún command buffer, así que se
+    /// destruyen de inmediato.
+    /// \param cell Celda con \c payload.
+    void discardPayload(Cell& cell);
+
+    /// \brief Retira de escena una celda residente y programa la destrucción de sus mallas.
+    /// \param cell Celda a retirar.
+    /// \param frameInfo Contexto del frame.
+    void evictCell(Cell& cell, FrameInfo& frameInfo);
+
+    /// \brief Empaqueta coordenadas de celda.
+    static CellKey makeKey(int32_t x, int32_t z)
+    {
+        return ((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z));
+    }
+
+    /// \brief Coordenada X de una clave.
+    static int32_t keyX(CellKey key)
+    {
+        return (static_cast<int32_t>(static_cast<uint32_t>(key >> 32)));
+    }
+
+    /// \brief Coordenada Z de una clave.
+    static int32_t keyZ(CellKey key)
+    {
+        return (static_cast<int32_t>(static_cast<uint32_t>(key & 0xffffffffu)));
+    }
+
+    /// Dispositivo lógico para crear las mallas.
+    VulkanDevice& vulkanDevice;
+
+    /// Altura del suelo para la generación procedural.
+    GroundFunction groundHeight;
+
+    /// Parámetros del streaming.
+    WorldStreamerSettings settings {};
+
+    /// Celdas solicitadas o residentes (sólo hebra principal).
+    std::unordered_map<CellKey, Cell> cells;
+
+    /// Mallas retiradas a la espera de que la GPU termine con ellas.
+    std::deque<Retired> retired;
+
+    /// Contador de frames de \c update.
+    uint64_t frameCounter = 0;
+
+    /// Posición de la cámara en el frame anterior.
+    glm::vec3 lastPosition {0.0f};
+
+    /// Velocidad suavizada de la cámara.
+    glm::vec3 velocity {0.0f};
+
+    /// Indica si \c lastPosition es válida.
+    bool hasLastPosition = false;
+
+    /// Bytes de CPU retenidos por celdas en vuelo, pendientes o con staging.
+    uint64_t hostBytes = 0;
+
+    /// Bytes de GPU de celdas residentes y cargadas pendientes de insertar.
+    uint64_t gpuBytes = 0;
+
+    /// Media de bytes de GPU por celda cargada (estimación para nuevas solicitudes).
+    uint64_t averageCellBytes = 0;
+
+    /// Celdas cargadas hasta ahora (para \c averageCellBytes).
+    uint64_t loadedCellCount = 0;
+
+    /// Celdas encargadas a las hebras y aún no devueltas.
+    uint32_t inFlight = 0;
+
+    /// Estadísticas publicadas.
+    StreamingStats stats {};
+
+    /// Inicio de la ventana de medida del throughput de I/O.
+    std::chrono::steady_clock::time_point ioWindowStart = std::chrono::steady_clock::now();
+
+    /// Bytes leídos de disco por las hebras de carga (acumulado).
+    std::atomic<uint64_t> ioBytes {0};
+
+    /// Valor de \c ioBytes al inicio de la ventana.
+    uint64_t ioWindowBytes = 0;
+
+    /// Protege \c requests, \c completed y \c stopping.
+    std::mutex queueMutex;
+
+    /// Despierta a las hebras cuando hay solicitudes o hay que parar.
+    std::condition_variable queueCondition;
+
+    /// Celdas solicitadas, en orden de prioridad.
+    std::deque<CellKey> requests;
+
+    /// Celdas cargadas por las hebras.
+    std::vector<std::unique_ptr<CellPayload>> completed;
+
+    /// Indica a las hebras que deben terminar.
+    bool stopping = false;
+
+    /// Hebras de carga.
+    std::vector<std::thread> workers;
+};
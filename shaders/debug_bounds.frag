@@ -0,0 +1,12 @@
+#version 450
+
+// Input from vertex shader
+layout(location = 0) in vec3 inColor;
+
+// Output to framebuffer
+layout(location = 0) out vec4 outColor;
+
+void main() 
+{
+    outColor = vec4(inColor, 1.0);
+}
@@ -0,0 +1,38 @@
+#version 450
+
+// No vertex buffer: the 24 vertices of the 12 edges of a unit cube come from
+// gl_VertexIndex (VK_PRIMITIVE_TOPOLOGY_LINE_LIST)
+const vec3 CORNERS[8] = vec3[](
+    vec3(-1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0), vec3(1.0, 1.0, -1.0), vec3(-1.0, 1.0, -1.0),
+    vec3(-1.0, -1.0, 1.0), vec3(1.0, -1.0, 1.0), vec3(1.0, 1.0, 1.0), vec3(-1.0, 1.0, 1.0));
+
+const uint EDGES[24] = uint[](
+    0, 1, 1, 2, 2, 3, 3, 0,
+    4, 5, 5, 6, 6, 7, 7, 4,
+    0, 4, 1, 5, 2, 6, 3, 7);
+
+// Output to fragment shader
+layout(location = 0) out vec3 outColor;
+
+// Global uniform buffer (only the camera is used)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+} ubo;
+
+// Push constants: modelMatrix maps the unit cube onto the bounds, the last column
+// of normalMatrix carries the colour
+layout(push_constant) uniform PushConstants 
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+} push;
+
+void main() 
+{
+    vec3 corner = CORNERS[EDGES[gl_VertexIndex]];
+    gl_Position = ubo.projection * ubo.view * push.modelMatrix * vec4(corner, 1.0);
+    outColor = push.normalMatrix[3].rgb;
+}
@@ -0,0 +1,93 @@
+#version 450
+
+// Inputs from vertex shader (same interface as simple_shader.frag)
+layout(location = 0) in vec3 inColor;
+layout(location = 1) in vec3 worldPos;
+layout(location = 2) in vec3 worldNormal;
+layout(location = 3) flat in uint lightList;
+
+// Output to framebuffer
+layout(location = 0) out vec4 outColor;
+
+// Point light definition
+struct PointLight 
+{
+    vec4 position; // xyz = light position, w = range
+    vec4 color;    // rgb = color, a = intensity
+};
+
+// Number of uints per light list: count + up to 8 light indices (LightGrid::LIST_STRIDE)
+const uint LIGHT_LIST_STRIDE = 9;
+
+// Set in a list's count when the object is lit by the probe grid (LightGrid::PROBE_LIT)
+const uint PROBE_LIT = 0x80000000u;
+
+// Lights a list can hold; the heatmap saturates here
+const float MAX_LIGHTS = 8.0;
+
+// Global uniform buffer (scene-wide data)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// All scene lights of this frame
+layout(std430, set = 0, binding = 1) readonly buffer SceneLights 
+{
+    PointLight lights[];
+} sceneLights;
+
+// Per-object light lists built on the CPU by LightGrid
+layout(std430, set = 0, binding = 2) readonly buffer LightLists 
+{
+    uint entries[];
+} lightLists;
+
+// Blue -> cyan -> green -> yellow -> red
+vec3 heat(float t)
+{
+    t = clamp(t, 0.0, 1.0);
+    return clamp(vec3(1.5) - abs(4.0 * t - vec3(3.0, 2.0, 1.0)), 0.0, 1.0);
+}
+
+void main() 
+{
+    uint listBase = lightList * LIGHT_LIST_STRIDE;
+    uint header = lightLists.entries[listBase];
+    uint lightCount = header & ~PROBE_LIT;
+
+    // Lights evaluated by simple_shader.frag vs lights that actually reach this pixel
+    uint inRange = 0;
+
+    for (uint i = 0; i < lightCount; ++i) 
+    {
+        PointLight light = sceneLights.lights[lightLists.entries[listBase + 1 + i]];
+        vec3 toLight = light.position.xyz - worldPos;
+
+        if (dot(toLight, toLight) < light.position.w * light.position.w)
+        {
+            inRange += 1;
+        }
+    }
+
+    // Hue = evaluated lights; darker where most of them are wasted (out of range)
+    vec3 color = (lightCount == 0) ? vec3(0.05) : heat(float(lightCount) / MAX_LIGHTS);
+
+    // Probe-lit objects pay a constant cost: shown in violet
+    if ((header & PROBE_LIT) != 0u)
+    {
+        color = vec3(0.55, 0.3, 0.9);
+    }
+    float useful = (lightCount == 0) ? 1.0 : 0.35 + 0.65 * float(inRange) / float(lightCount);
+
+    // Keep the shape readable with a simple facing term
+    vec3 viewDir = normalize(ubo.invView[3].xyz - worldPos);
+    float facing = 0.6 + 0.4 * abs(dot(normalize(worldNormal), viewDir));
+
+    outColor = vec4(color * useful * facing, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 450
+
+// Inputs from vertex shader (same interface as simple_shader.frag)
+layout(location = 0) in vec3 inColor;
+layout(location = 1) in vec3 worldPos;
+layout(location = 2) in vec3 worldNormal;
+layout(location = 3) flat in uint lightList;
+
+// Output to framebuffer
+layout(location = 0) out vec4 outColor;
+
+// Global uniform buffer (only the camera is used)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+} ubo;
+
+// Push constants (per-object data); the last column of normalMatrix is unused by
+// the lighting shaders and carries the debug colour of the draw
+layout(push_constant) uniform PushConstants 
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+} push;
+
+void main() 
+{
+    vec3 viewDir = normalize(ubo.invView[3].xyz - worldPos);
+    float facing = 0.45 + 0.55 * abs(dot(normalize(worldNormal), viewDir));
+
+    outColor = vec4(push.normalMatrix[3].rgb * facing, 1.0);
+}
@@ -0,0 +1,13 @@
+#version 450
+
+// Output to framebuffer (additive blending, one increment per shaded fragment)
+layout(location = 0) out vec4 outColor;
+
+// Contribution of one layer: red saturates after ~8 layers, green after ~16 and
+// blue after ~50, so the image goes red -> orange -> yellow -> white
+const vec3 LAYER = vec3(0.12, 0.06, 0.02);
+
+void main() 
+{
+    outColor = vec4(LAYER, 1.0);
+}
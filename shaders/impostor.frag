@@ -0,0 +1,20 @@
+#version 450
+
+layout(location = 0) in vec2 atlasUV;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 2, binding = 0) uniform sampler2D atlas;
+
+void main()
+{
+    vec4 texel = texture(atlas, atlasUV);
+
+    // Cut-out instead of blending: impostors stay order independent
+    if (texel.a < 0.5)
+    {
+        discard;
+    }
+
+    outColor = vec4(texel.rgb, 1.0);
+}
@@ -0,0 +1,109 @@
+#version 450
+
+// Camera-facing impostor quad, generated from the vertex index like the
+// point light billboard. The atlas view closest to the camera direction
+// (in the object's local space) is selected per instance.
+
+const vec2 OFFSETS[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2(-1.0,  1.0),
+    vec2( 1.0, -1.0),
+    vec2( 1.0, -1.0),
+    vec2(-1.0,  1.0),
+    vec2( 1.0,  1.0)
+);
+
+// Views per side of the octahedral atlas (must match ImpostorSystem::GRID)
+const int GRID = 8;
+
+layout(location = 0) out vec2 atlasUV;
+
+struct PointLight
+{
+    vec4 position;
+    vec4 color;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+struct ImpostorInstance
+{
+    vec4 centerRadius; // World-space bounding sphere
+    vec4 axisX;        // Object rotation (world-space local axes)
+    vec4 axisY;
+    vec4 axisZ;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Instances
+{
+    ImpostorInstance instances[];
+};
+
+vec2 signNotZero(vec2 v)
+{
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit direction to [0, 1]^2 (octahedral mapping, z pole)
+vec2 octEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 p = n.xy;
+
+    if (n.z < 0.0)
+    {
+        p = (1.0 - abs(p.yx)) * signNotZero(p);
+    }
+
+    return p * 0.5 + 0.5;
+}
+
+vec3 octDecode(vec2 uv)
+{
+    vec2 f = uv * 2.0 - 1.0;
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// Same basis used when baking (-Y is up)
+void viewBasis(vec3 direction, out vec3 right, out vec3 up)
+{
+    vec3 upHint = abs(direction.y) > 0.99 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, -1.0, 0.0);
+    right = normalize(cross(upHint, direction));
+    up = cross(direction, right);
+}
+
+void main()
+{
+    ImpostorInstance instance = instances[gl_InstanceIndex];
+    vec3 center = instance.centerRadius.xyz;
+    float radius = instance.centerRadius.w;
+    mat3 rotation = mat3(instance.axisX.xyz, instance.axisY.xyz, instance.axisZ.xyz);
+
+    vec3 toCamera = normalize(ubo.invView[3].xyz - center);
+    vec3 localDirection = transpose(rotation) * toCamera;
+
+    ivec2 cell = clamp(ivec2(octEncode(localDirection) * float(GRID)), ivec2(0), ivec2(GRID - 1));
+    vec3 frameDirection = octDecode((vec2(cell) + 0.5) / float(GRID));
+
+    vec3 right;
+    vec3 up;
+    viewBasis(frameDirection, right, up);
+
+    vec2 offset = OFFSETS[gl_VertexIndex];
+    vec3 worldPos = center + radius * (offset.x * (rotation * right) - offset.y * (rotation * up));
+
+    atlasUV = (vec2(cell) + offset * 0.5 + 0.5) / float(GRID);
+    gl_Position = ubo.projection * ubo.view * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,36 @@
+#version 450
+
+// Renders one orthographic view of a model into its cell of the impostor atlas.
+// The viewport selects the cell; this shader only projects onto the view plane.
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inUV;
+
+layout(location = 0) out vec3 outColor;
+
+layout(push_constant) uniform Push
+{
+    vec4 centerRadius; // Bounding sphere in model space
+    vec4 right;        // View plane axes (see viewBasis in impostor.vert)
+    vec4 up;
+    vec4 direction;    // From the model towards the viewer
+} push;
+
+void main()
+{
+    vec3 offset = inPosition - push.centerRadius.xyz;
+    float radius = push.centerRadius.w;
+
+    // Image rows grow downwards, so "up" maps to negative NDC y
+    float x = dot(offset, push.right.xyz) / radius;
+    float y = -dot(offset, push.up.xyz) / radius;
+    float depth = 0.5 - 0.5 * dot(offset, push.direction.xyz) / radius;
+
+    gl_Position = vec4(x, y, depth, 1.0);
+
+    // Head-light shading so every view is lit the same way
+    float facing = max(dot(normalize(inNormal), push.direction.xyz), 0.0);
+    outColor = inColor * (0.35 + 0.65 * facing);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+// Input from vertex shader
+layout(location = 0) in vec2 fragOffset;
+layout(location = 1) in vec4 fragColor;
+
+// Final output color
+layout(location = 0) out vec4 outColor;
+
+// Constant for cosine falloff
+const float PI = 3.14159265;
+
+void main() 
+{
+    // Compute distance from quad center (in screen-space)
+    float offsetDist = length(fragOffset);
+
+    // Discard fragments outside the unit circle (soft quad boundary)
+    if (offsetDist >= 1.0) {
+        discard;
+    }
+
+    // Cosine-based smooth radial falloff (range: 1.0 to 0.0)
+    float falloff = 0.5 * (cos(offsetDist * PI) + 1.0);
+
+    // Additive blending: alpha scales the contribution
+    outColor = vec4(fragColor.rgb, fragColor.a * falloff);
+}
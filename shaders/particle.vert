@@ -0,0 +1,82 @@
+#version 450
+
+// Predefined screen-space offsets to form a quad
+const vec2 OFFSETS[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2(-1.0,  1.0),
+    vec2( 1.0, -1.0),
+    vec2( 1.0, -1.0),
+    vec2(-1.0,  1.0),
+    vec2( 1.0,  1.0)
+);
+
+// Output to fragment shader
+layout(location = 0) out vec2 fragOffset;
+layout(location = 1) out vec4 fragColor;
+
+// Point light data structure
+struct PointLight 
+{
+    vec4 position; // xyz = world position
+    vec4 color;    // rgb = color, a = intensity
+};
+
+// Global uniform buffer
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor; // rgb + intensity (w)
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// Draw instances written by the simulation pass, one half per alive list
+struct Instance
+{
+    vec4 positionSize; // xyz = position, w = size
+    vec4 color;        // rgb = color, a = opacity
+};
+
+layout(std430, set = 1, binding = 4) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+// Per-frame parameters (only currentList and capacity are used here)
+layout(push_constant) uniform PushConstants
+{
+    vec4 emitterPosition;
+    vec4 emitterVelocity;
+    vec4 color;
+    vec4 gravity;
+    float deltaTime;
+    uint emitCount;
+    uint seed;
+    uint currentList;
+    uint capacity;
+} push;
+
+void main() 
+{
+    // One instance per alive particle, compacted by the simulation pass
+    Instance particle = instances[push.currentList * push.capacity + gl_InstanceIndex];
+
+    fragOffset = OFFSETS[gl_VertexIndex];
+
+    // Opacity already fades out over the particle lifetime
+    fragColor = particle.color;
+
+    // Extract right and up vectors from view matrix (camera orientation)
+    vec3 cameraRight = vec3(ubo.view[0][0], ubo.view[1][0], ubo.view[2][0]);
+    vec3 cameraUp    = vec3(ubo.view[0][1], ubo.view[1][1], ubo.view[2][1]);
+
+    float size = particle.positionSize.w;
+    vec3 worldPos = particle.positionSize.xyz 
+                    + size * fragOffset.x * cameraRight 
+                    + size * fragOffset.y * cameraUp;
+
+    // Transform to clip space
+    gl_Position = ubo.projection * ubo.view * vec4(worldPos, 1.0);
+}
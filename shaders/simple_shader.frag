@@ -4,6 +4,8 @@
 layout(location = 0) in vec3 inColor;
 layout(location = 1) in vec3 worldPos;
 layout(location = 2) in vec3 worldNormal;
+layout(location = 3) flat in uint lightList;
+layout(location = 4) in vec4 inIrradiance; // Baked static light (rgb) and ambient occlusion (a)
 
 // Output to framebuffer
 layout(location = 0) out vec4 outColor;
@@ -11,10 +13,19 @@ layout(location = 0) out vec4 outColor;
 // Point light definition
 struct PointLight 
 {
-    vec4 position; // xyz = light position, w = unused
+    vec4 position; // xyz = light position, w = range (in the light grid buffer)
     vec4 color;    // rgb = color, a = intensity
 };
 
+// Number of uints per light list: count + up to 8 light indices (LightGrid::LIST_STRIDE)
+const uint LIGHT_LIST_STRIDE = 9;
+
+// Set in a list's count when the object is lit by the probe grid (LightGrid::PROBE_LIT)
+const uint PROBE_LIT = 0x80000000u;
+
+// L2 SH coefficients per probe (ProbeGrid::COEFFICIENTS)
+const uint PROBE_COEFFICIENTS = 9;
+
 // Global uniform buffer (scene-wide data)
 layout(set = 0, binding = 0) uniform GlobalUbo 
 {
@@ -26,6 +37,27 @@ layout(set = 0, binding = 0) uniform GlobalUbo
     int numLights;
 } ubo;
 
+// All scene lights of this frame
+layout(std430, set = 0, binding = 1) readonly buffer SceneLights 
+{
+    PointLight lights[];
+} sceneLights;
+
+// Per-object light lists built on the CPU by LightGrid
+layout(std430, set = 0, binding = 2) readonly buffer LightLists 
+{
+    uint entries[];
+} lightLists;
+
+// L2 SH irradiance probes written by probe_update.comp (ProbeGrid)
+layout(std430, set = 0, binding = 3) readonly buffer Probes 
+{
+    vec4 origin;      // xyz = first probe
+    vec4 spacing;     // xyz = distance between probes
+    uvec4 resolution; // xyz = probes per axis
+    vec4 coefficients[];
+} probes;
+
 // Push constants (per-object data)
 layout(push_constant) uniform PushConstants 
 {
@@ -33,13 +65,54 @@ layout(push_constant) uniform PushConstants
     mat4 normalMatrix;
 } push;
 
+// Irradiance from the probe grid: the 9 coefficients of the 8 surrounding probes are
+// blended trilinearly and evaluated once for the normal
+vec3 sampleProbes(vec3 position, vec3 n)
+{
+    uvec3 resolution = probes.resolution.xyz;
+    vec3 cell = clamp((position - probes.origin.xyz) / probes.spacing.xyz, vec3(0.0), vec3(resolution - 1u));
+    uvec3 base = min(uvec3(cell), resolution - 2u);
+    vec3 f = cell - vec3(base);
+
+    vec3 sh[PROBE_COEFFICIENTS];
+
+    for (uint k = 0; k < PROBE_COEFFICIENTS; ++k)
+    {
+        sh[k] = vec3(0.0);
+    }
+
+    for (uint corner = 0; corner < 8; ++corner)
+    {
+        uvec3 offset = uvec3(corner & 1u, (corner >> 1) & 1u, corner >> 2);
+        vec3 weights = mix(1.0 - f, f, vec3(offset));
+        uvec3 probe = base + offset;
+        uint first = (probe.x + resolution.x * (probe.y + resolution.y * probe.z)) * PROBE_COEFFICIENTS;
+
+        for (uint k = 0; k < PROBE_COEFFICIENTS; ++k)
+        {
+            sh[k] += probes.coefficients[first + k].rgb * (weights.x * weights.y * weights.z);
+        }
+    }
+
+    // Same basis as probe_update.comp and LightBaker
+    vec3 irradiance = sh[0] * 0.282095
+        + sh[1] * (0.488603 * n.y) + sh[2] * (0.488603 * n.z) + sh[3] * (0.488603 * n.x)
+        + sh[4] * (1.092548 * n.x * n.y) + sh[5] * (1.092548 * n.y * n.z)
+        + sh[6] * (0.315392 * (3.0 * n.z * n.z - 1.0)) + sh[7] * (1.092548 * n.x * n.z)
+        + sh[8] * (0.546274 * (n.x * n.x - n.y * n.y));
+
+    // L2 ringing can go slightly negative away from the lights
+    return max(irradiance, vec3(0.0));
+}
+
 void main() 
 {
     // Compute ambient lighting component
     vec3 ambient = ubo.ambientLightColor.rgb * ubo.ambientLightColor.a;
 
-    // Initialize diffuse and specular lighting
-    vec3 diffuse = ambient;
+    // Initialize diffuse and specular lighting; baked light adds to the ambient
+    // term so dynamic lights below are not scaled by it (zero on unbaked meshes)
+    vec3 diffuse = ambient * inIrradiance.a + inIrradiance.rgb;
     vec3 specular = vec3(0.0);
 
     // Normalize the surface normal in world space
@@ -51,18 +124,31 @@ void main()
     // Direction from fragment to camera
     vec3 viewDir = normalize(cameraPos - worldPos);
 
-    // Loop through all active point lights
-    for (int i = 0; i < ubo.numLights; ++i) 
+    // Loop through the lights assigned to this object
+    uint listBase = lightList * LIGHT_LIST_STRIDE;
+    uint lightCount = lightLists.entries[listBase];
+
+    // Probe-lit objects take all their lighting from the grid instead of the loop
+    if ((lightCount & PROBE_LIT) != 0u)
+    {
+        diffuse += sampleProbes(worldPos, normal);
+        lightCount &= ~PROBE_LIT;
+    }
+
+    for (uint i = 0; i < lightCount; ++i) 
     {
-        PointLight light = ubo.pointLights[i];
+        PointLight light = sceneLights.lights[lightLists.entries[listBase + 1 + i]];
 
         // Vector from fragment to light
         vec3 lightDir = light.position.xyz - worldPos;
         float distanceSq = dot(lightDir, lightDir);
         lightDir = normalize(lightDir);
 
-        // Attenuation factor (inverse-square falloff)
-        float attenuation = 1.0 / distanceSq;
+        // Inverse-square falloff windowed to reach zero at the light's range, so
+        // lights left out of the list never leave a visible edge
+        float ratio = distanceSq / (light.position.w * light.position.w);
+        float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+        float attenuation = window * window / distanceSq;
 
         // Compute diffuse intensity
         float NdotL = max(dot(normal, lightDir), 0.0);
@@ -5,11 +5,14 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec2 inUV; // UV is unused but preserved
+layout(location = 4) in vec4 inIrradiance; // Baked static light (rgb) and ambient occlusion (a)
 
 // Outputs to fragment shader
 layout(location = 0) out vec3 outColor;
 layout(location = 1) out vec3 worldPosition;
 layout(location = 2) out vec3 worldNormal;
+layout(location = 3) flat out uint lightList; // Per-object light list (firstInstance)
+layout(location = 4) out vec4 outIrradiance;
 
 // Light data structure
 struct PointLight 
@@ -50,5 +53,9 @@ void main()
     // Pass world-space position and vertex color to fragment shader
     worldPosition = worldPos.xyz;
     outColor = inColor;
+    outIrradiance = inIrradiance;
+
+    // The renderer passes the object's light list index as firstInstance
+    lightList = uint(gl_InstanceIndex);
 }
 
@@ -0,0 +1,179 @@
+#version 450
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#extension GL_EXT_shader_16bit_storage : require
+
+// Half-precision variant of simple_shader.frag: the lighting math runs in fp16
+// (needs shaderFloat16). World positions and squared distances stay in fp32,
+// since they overflow half precision beyond ~256 units.
+
+// Inputs from vertex shader
+layout(location = 0) in f16vec3 inColor;
+layout(location = 1) in vec3 worldPos;
+layout(location = 2) in f16vec3 worldNormal;
+layout(location = 3) flat in uint lightList;
+layout(location = 4) in vec4 inIrradiance; // Baked light stays fp32 like the probes, clamped below
+
+// Output to framebuffer
+layout(location = 0) out vec4 outColor;
+
+// Point light definition
+struct PointLight 
+{
+    vec4 position; // xyz = light position, w = range (in the light grid buffer)
+    vec4 color;    // rgb = color, a = intensity
+};
+
+// Number of uints per light list: count + up to 8 light indices (LightGrid::LIST_STRIDE)
+const uint LIGHT_LIST_STRIDE = 9;
+
+// Set in a list's count when the object is lit by the probe grid (LightGrid::PROBE_LIT)
+const uint PROBE_LIT = 0x80000000u;
+
+// L2 SH coefficients per probe (ProbeGrid::COEFFICIENTS)
+const uint PROBE_COEFFICIENTS = 9;
+
+// Largest light intensity handed to fp16 math (keeps sums away from the fp16 limit)
+const float MAX_HALF_INTENSITY = 1024.0;
+
+// Global uniform buffer (scene-wide data)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;     // rgb = color, a = intensity
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// All scene lights of this frame
+layout(std430, set = 0, binding = 1) readonly buffer SceneLights 
+{
+    PointLight lights[];
+} sceneLights;
+
+// Per-object light lists built on the CPU by LightGrid
+layout(std430, set = 0, binding = 2) readonly buffer LightLists 
+{
+    uint entries[];
+} lightLists;
+
+// L2 SH irradiance probes written by probe_update.comp (ProbeGrid)
+layout(std430, set = 0, binding = 3) readonly buffer Probes 
+{
+    vec4 origin;      // xyz = first probe
+    vec4 spacing;     // xyz = distance between probes
+    uvec4 resolution; // xyz = probes per axis
+    vec4 coefficients[];
+} probes;
+
+// Push constants (per-object data)
+layout(push_constant) uniform PushConstants 
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+} push;
+
+// Irradiance from the probe grid (fp32, as in simple_shader.frag): the 9 coefficients of the 8 surrounding probes are
+// blended trilinearly and evaluated once for the normal
+vec3 sampleProbes(vec3 position, vec3 n)
+{
+    uvec3 resolution = probes.resolution.xyz;
+    vec3 cell = clamp((position - probes.origin.xyz) / probes.spacing.xyz, vec3(0.0), vec3(resolution - 1u));
+    uvec3 base = min(uvec3(cell), resolution - 2u);
+    vec3 f = cell - vec3(base);
+
+    vec3 sh[PROBE_COEFFICIENTS];
+
+    for (uint k = 0; k < PROBE_COEFFICIENTS; ++k)
+    {
+        sh[k] = vec3(0.0);
+    }
+
+    for (uint corner = 0; corner < 8; ++corner)
+    {
+        uvec3 offset = uvec3(corner & 1u, (corner >> 1) & 1u, corner >> 2);
+        vec3 weights = mix(1.0 - f, f, vec3(offset));
+        uvec3 probe = base + offset;
+        uint first = (probe.x + resolution.x * (probe.y + resolution.y * probe.z)) * PROBE_COEFFICIENTS;
+
+        for (uint k = 0; k < PROBE_COEFFICIENTS; ++k)
+        {
+            sh[k] += probes.coefficients[first + k].rgb * (weights.x * weights.y * weights.z);
+        }
+    }
+
+    // Same basis as probe_update.comp and LightBaker
+    vec3 irradiance = sh[0] * 0.282095
+        + sh[1] * (0.488603 * n.y) + sh[2] * (0.488603 * n.z) + sh[3] * (0.488603 * n.x)
+        + sh[4] * (1.092548 * n.x * n.y) + sh[5] * (1.092548 * n.y * n.z)
+        + sh[6] * (0.315392 * (3.0 * n.z * n.z - 1.0)) + sh[7] * (1.092548 * n.x * n.z)
+        + sh[8] * (0.546274 * (n.x * n.x - n.y * n.y));
+
+    // L2 ringing can go slightly negative away from the lights
+    return max(irradiance, vec3(0.0));
+}
+
+void main() 
+{
+    // Compute ambient lighting component
+    f16vec3 ambient = f16vec3(ubo.ambientLightColor.rgb * ubo.ambientLightColor.a);
+
+    // Initialize diffuse and specular lighting; baked light adds to the ambient
+    // term so dynamic lights below are not scaled by it (zero on unbaked meshes)
+    f16vec3 diffuse = ambient * float16_t(inIrradiance.a) + 
+        f16vec3(min(inIrradiance.rgb, vec3(MAX_HALF_INTENSITY)));
+    f16vec3 specular = f16vec3(0.0);
+
+    // Normalize the surface normal in world space
+    f16vec3 normal = normalize(worldNormal);
+
+    // Reconstruct camera position from inverse view matrix
+    vec3 cameraPos = ubo.invView[3].xyz;
+
+    // Direction from fragment to camera
+    f16vec3 viewDir = f16vec3(normalize(cameraPos - worldPos));
+
+    // Loop through the lights assigned to this object
+    uint listBase = lightList * LIGHT_LIST_STRIDE;
+    uint lightCount = lightLists.entries[listBase];
+
+    // Probe-lit objects take all their lighting from the grid instead of the loop
+    if ((lightCount & PROBE_LIT) != 0u)
+    {
+        diffuse += f16vec3(min(sampleProbes(worldPos, vec3(normal)), vec3(MAX_HALF_INTENSITY)));
+        lightCount &= ~PROBE_LIT;
+    }
+
+    for (uint i = 0; i < lightCount; ++i) 
+    {
+        PointLight light = sceneLights.lights[lightLists.entries[listBase + 1 + i]];
+
+        // Vector from fragment to light (fp32)
+        vec3 toLight = light.position.xyz - worldPos;
+        float distanceSq = dot(toLight, toLight);
+        f16vec3 lightDir = f16vec3(toLight * inversesqrt(distanceSq));
+
+        // Windowed inverse-square falloff, as in simple_shader.frag
+        float ratio = distanceSq / (light.position.w * light.position.w);
+        float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+        float attenuation = window * window / distanceSq;
+
+        // Compute diffuse intensity
+        float16_t NdotL = max(dot(normal, lightDir), float16_t(0.0));
+        f16vec3 lightIntensity = 
+            f16vec3(light.color.rgb * min(light.color.a * attenuation, MAX_HALF_INTENSITY));
+        diffuse += lightIntensity * NdotL;
+
+        // Compute Blinn-Phong specular term
+        f16vec3 halfVector = normalize(lightDir + viewDir);
+        float16_t NdotH = max(dot(normal, halfVector), float16_t(0.0));
+        float16_t shininess = float16_t(512.0); // High shininess = tight specular highlight
+        float16_t specFactor = pow(NdotH, shininess);
+        specular += lightIntensity * specFactor;
+    }
+
+    // Combine lighting contributions with the fragment's base color
+    f16vec3 finalColor = diffuse * inColor + specular * inColor;
+    outColor = vec4(finalColor, 1.0);
+}
@@ -0,0 +1,65 @@
+#version 450
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#extension GL_EXT_shader_16bit_storage : require
+
+// Half-precision variant of simple_shader.vert: color and normal varyings are
+// passed as fp16 (needs storageInputOutput16). Positions stay in fp32.
+
+// Input vertex attributes (from vertex buffer)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inUV; // UV is unused but preserved
+layout(location = 4) in vec4 inIrradiance; // Baked static light (rgb) and ambient occlusion (a)
+
+// Outputs to fragment shader
+layout(location = 0) out f16vec3 outColor;
+layout(location = 1) out vec3 worldPosition;
+layout(location = 2) out f16vec3 worldNormal;
+layout(location = 3) flat out uint lightList; // Per-object light list (firstInstance)
+layout(location = 4) out vec4 outIrradiance;
+
+// Light data structure
+struct PointLight 
+{
+    vec4 position; // xyz = position, w = unused
+    vec4 color;    // rgb = color, a = intensity or unused
+};
+
+// Global uniform buffer object (shared data)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// Push constants (object-specific data)
+layout(push_constant) uniform PushConstants 
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+} push;
+
+void main() 
+{
+    // Transform vertex position to world space
+    vec4 worldPos = push.modelMatrix * vec4(inPosition, 1.0);
+    
+    // Final vertex position in clip space
+    gl_Position = ubo.projection * ubo.view * worldPos;
+
+    // Pass transformed world-space normal to fragment shader
+    worldNormal = f16vec3(normalize(mat3(push.normalMatrix) * inNormal));
+
+    // Pass world-space position and vertex color to fragment shader
+    worldPosition = worldPos.xyz;
+    outColor = f16vec3(inColor);
+    outIrradiance = inIrradiance;
+
+    // The renderer passes the object's light list index as firstInstance
+    lightList = uint(gl_InstanceIndex);
+}
@@ -0,0 +1,69 @@
+#version 450
+#extension GL_EXT_multiview : require
+
+// Multiview variant of simple_shader.vert: every draw is broadcast to all views
+// in the render pass view mask and gl_ViewIndex selects the view matrix.
+
+// Input vertex attributes (from vertex buffer)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inUV; // UV is unused but preserved
+layout(location = 4) in vec4 inIrradiance; // Baked static light (rgb) and ambient occlusion (a)
+
+// Outputs to fragment shader
+layout(location = 0) out vec3 outColor;
+layout(location = 1) out vec3 worldPosition;
+layout(location = 2) out vec3 worldNormal;
+layout(location = 3) flat out uint lightList; // Per-object light list (firstInstance)
+layout(location = 4) out vec4 outIrradiance;
+
+// Maximum number of views (MAX_VIEWS in FrameContext.hpp)
+const int MAX_VIEWS = 6;
+
+// Light data structure
+struct PointLight 
+{
+    vec4 position; // xyz = position, w = unused
+    vec4 color;    // rgb = color, a = intensity or unused
+};
+
+// Global uniform buffer object (shared data)
+layout(set = 0, binding = 0) uniform GlobalUbo 
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+    uint viewCount;
+    mat4 viewProjections[MAX_VIEWS]; // projection * view of each view
+} ubo;
+
+// Push constants (object-specific data)
+layout(push_constant) uniform PushConstants 
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+} push;
+
+void main() 
+{
+    // Transform vertex position to world space
+    vec4 worldPos = push.modelMatrix * vec4(inPosition, 1.0);
+    
+    // Clip space position for the view being rendered
+    gl_Position = ubo.viewProjections[gl_ViewIndex] * worldPos;
+
+    // Pass transformed world-space normal to fragment shader
+    worldNormal = normalize(mat3(push.normalMatrix) * inNormal);
+
+    // Pass world-space position and vertex color to fragment shader
+    worldPosition = worldPos.xyz;
+    outColor = inColor;
+    outIrradiance = inIrradiance;
+
+    // The renderer passes the object's light list index as firstInstance
+    lightList = uint(gl_InstanceIndex);
+}
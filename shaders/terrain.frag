@@ -0,0 +1,52 @@
+#version 450
+
+// Inputs from vertex shader
+layout(location = 0) in vec3 worldPosition;
+layout(location = 1) in vec3 worldNormal;
+layout(location = 2) in float terrainHeight;
+
+// Output to framebuffer
+layout(location = 0) out vec4 outColor;
+
+struct PointLight
+{
+    vec4 position;
+    vec4 color;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// Direction towards the sun (-Y is up)
+const vec3 SUN_DIRECTION = normalize(vec3(0.4, -1.0, 0.3));
+
+void main()
+{
+    vec3 normal = normalize(worldNormal);
+
+    // Grass on flat ground, rock on steep slopes, snow on the peaks
+    float flatness = -normal.y;
+    vec3 grass = vec3(0.22, 0.40, 0.16);
+    vec3 rock = vec3(0.42, 0.38, 0.34);
+    vec3 snow = vec3(0.92, 0.93, 0.95);
+
+    vec3 albedo = mix(rock, grass, smoothstep(0.75, 0.9, flatness));
+    albedo = mix(albedo, snow, smoothstep(6.5, 7.5, terrainHeight) * smoothstep(0.6, 0.8, flatness));
+
+    vec3 ambient = ubo.ambientLightColor.rgb * ubo.ambientLightColor.a;
+    float sun = max(dot(normal, SUN_DIRECTION), 0.0);
+
+    // Fade into a flat horizon color with distance to hide the far clip
+    float distanceToCamera = length(ubo.invView[3].xyz - worldPosition);
+    float fog = smoothstep(40.0, 95.0, distanceToCamera);
+
+    vec3 color = albedo * (ambient + vec3(sun));
+    outColor = vec4(mix(color, vec3(0.55, 0.62, 0.70), fog), 1.0);
+}
@@ -0,0 +1,109 @@
+#version 450
+
+// Geometry clipmap terrain: the shared grid is placed at one level and the
+// height is fetched from that level's toroidal region of the height buffer.
+
+// Grid coordinates in [0, LEVEL_CELLS]
+layout(location = 0) in vec2 inGrid;
+
+// Outputs to fragment shader
+layout(location = 0) out vec3 worldPosition;
+layout(location = 1) out vec3 worldNormal;
+layout(location = 2) out float terrainHeight;
+
+struct PointLight
+{
+    vec4 position;
+    vec4 color;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo
+{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    int numLights;
+} ubo;
+
+// One LEVEL_SAMPLES x LEVEL_SAMPLES region per level (must match ClipmapTerrain)
+layout(std430, set = 1, binding = 0) readonly buffer Heights
+{
+    float heights[];
+};
+
+layout(push_constant) uniform Push
+{
+    ivec2 origin;       // Lattice index of grid vertex (0, 0) at this level
+    ivec2 coarseOrigin; // Origin of the next coarser level
+    float spacing;      // World distance between samples at this level
+    float baseLevel;    // World Y of height 0 (-Y is up)
+    uint level;
+    uint hasCoarser;
+} push;
+
+const int LEVEL_CELLS = 128;
+const int LEVEL_SAMPLES = LEVEL_CELLS + 1;
+
+// Positive modulo (GLSL % is undefined for negative operands)
+int wrap(int value)
+{
+    return value - LEVEL_SAMPLES * int(floor(float(value) / float(LEVEL_SAMPLES)));
+}
+
+float fetchHeight(uint level, ivec2 lattice)
+{
+    uint regionOffset = level * uint(LEVEL_SAMPLES * LEVEL_SAMPLES);
+    return heights[regionOffset + uint(wrap(lattice.y) * LEVEL_SAMPLES + wrap(lattice.x))];
+}
+
+void main()
+{
+    ivec2 grid = ivec2(inGrid);
+    ivec2 lattice = push.origin + grid;
+
+    float height = fetchHeight(push.level, lattice);
+
+    if (push.hasCoarser != 0u)
+    {
+        // Blend towards the coarser level near the outer border so that odd
+        // vertices land exactly on the coarse edges (no cracks between levels).
+        vec2 centered = abs(vec2(grid) - vec2(LEVEL_CELLS / 2)) / float(LEVEL_CELLS / 2);
+        float alpha = clamp((max(centered.x, centered.y) - 0.75) / 0.2, 0.0, 1.0);
+
+        ivec2 coarse = lattice >> 1;
+        ivec2 odd = lattice & 1;
+
+        float h00 = fetchHeight(push.level + 1u, coarse);
+        float h10 = fetchHeight(push.level + 1u, coarse + ivec2(odd.x, 0));
+        float h01 = fetchHeight(push.level + 1u, coarse + ivec2(0, odd.y));
+        float h11 = fetchHeight(push.level + 1u, coarse + odd);
+
+        float coarseHeight = mix(
+            mix(h00, h10, 0.5 * float(odd.x)),
+            mix(h01, h11, 0.5 * float(odd.x)),
+            0.5 * float(odd.y));
+
+        height = mix(height, coarseHeight, alpha);
+    }
+
+    // One-sided differences on the border keep every fetch inside the region
+    ivec2 left = ivec2(max(grid.x - 1, 0), grid.y);
+    ivec2 right = ivec2(min(grid.x + 1, LEVEL_CELLS), grid.y);
+    ivec2 back = ivec2(grid.x, max(grid.y - 1, 0));
+    ivec2 front = ivec2(grid.x, min(grid.y + 1, LEVEL_CELLS));
+
+    float dhdx = (fetchHeight(push.level, push.origin + right) - fetchHeight(push.level, push.origin + left)) /
+        (float(right.x - left.x) * push.spacing);
+    float dhdz = (fetchHeight(push.level, push.origin + front) - fetchHeight(push.level, push.origin + back)) /
+        (float(front.y - back.y) * push.spacing);
+
+    vec3 position = vec3(float(lattice.x) * push.spacing, push.baseLevel - height, float(lattice.y) * push.spacing);
+
+    gl_Position = ubo.projection * ubo.view * vec4(position, 1.0);
+
+    worldPosition = position;
+    worldNormal = normalize(vec3(-dhdx, -1.0, -dhdz));
+    terrainHeight = height;
+}
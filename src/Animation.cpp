@@ -0,0 +1,286 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: Animation.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "Animation.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VULKANAPI_ANIMATION_SSE 1
+#include <emmintrin.h>
+#endif
+
+ /// \brief Redimensiona todos los canales.
+ /// \param joints Número de articulaciones.
+ /// \param characters Número de personajes.
+void PoseBatch::resize(uint32_t joints, uint32_t characters)
+{
+    jointCount = joints;
+    characterCount = characters;
+    characterStride = (characters + CACHE_LINE_CHARACTERS - 1) / CACHE_LINE_CHARACTERS * CACHE_LINE_CHARACTERS;
+
+    const size_t size = size_t(joints) * characterStride;
+    tx.resize(size);
+    ty.resize(size);
+    tz.resize(size);
+    rx.resize(size);
+    ry.resize(size);
+    rz.resize(size);
+    rw.resize(size);
+}
+
+/// \brief Claves que rodean a un instante del clip.
+/// \param clip Clip de origen.
+/// \param duration Duración del bucle (> 0).
+/// \param time Instante (s), se lleva al bucle.
+/// \param a Salida: desplazamiento de la primera clave.
+/// \param b Salida: desplazamiento de la segunda clave.
+/// \return Factor de interpolación en [0, 1].
+static float clipKeys(const AnimationClip& clip, float duration, float time, size_t& a, size_t& b)
+{
+    time = std::fmod(time, duration);
+
+    if (time < 0.0f)
+    {
+        time += duration;
+    }
+
+    const float keyPosition = time * clip.sampleRate;
+    const uint32_t key0 = static_cast<uint32_t>(keyPosition) % clip.keyCount;
+    const uint32_t key1 = (key0 + 1) % clip.keyCount;
+
+    a = size_t(key0) * clip.jointCount;
+    b = size_t(key1) * clip.jointCount;
+
+    return (keyPosition - std::floor(keyPosition));
+}
+
+/// \brief Interpola todas las articulaciones de un personaje entre dos claves (versión escalar).
+/// \param clip Clip de origen.
+/// \param a Desplazamiento de la primera clave.
+/// \param b Desplazamiento de la segunda clave.
+/// \param alpha Factor de interpolación en [0, 1].
+/// \param character Personaje del lote.
+/// \param poses Lote de salida.
+static void blendScalar(
+    const AnimationClip& clip,
+    size_t a,
+    size_t b,
+    float alpha,
+    uint32_t character,
+    PoseBatch& poses)
+{
+    for (uint32_t j = 0; j < clip.jointCount; ++j)
+    {
+        const size_t o = poses.index(j, character);
+
+        poses.tx[o] = clip.tx[a + j] + (clip.tx[b + j] - clip.tx[a + j]) * alpha;
+        poses.ty[o] = clip.ty[a + j] + (clip.ty[b + j] - clip.ty[a + j]) * alpha;
+        poses.tz[o] = clip.tz[a + j] + (clip.tz[b + j] - clip.tz[a + j]) * alpha;
+
+        float bx = clip.rx[b + j];
+        float by = clip.ry[b + j];
+        float bz = clip.rz[b + j];
+        float bw = clip.rw[b + j];
+
+        // Camino corto: q y -q representan la misma rotación.
+        const float dot = clip.rx[a + j] * bx + clip.ry[a + j] * by + clip.rz[a + j] * bz + clip.rw[a + j] * bw;
+
+        if (dot < 0.0f)
+        {
+            bx = -bx;
+            by = -by;
+            bz = -bz;
+            bw = -bw;
+        }
+
+        const float x = clip.rx[a + j] + (bx - clip.rx[a + j]) * alpha;
+        const float y = clip.ry[a + j] + (by - clip.ry[a + j]) * alpha;
+        const float z = clip.rz[a + j] + (bz - clip.rz[a + j]) * alpha;
+        const float w = clip.rw[a + j] + (bw - clip.rw[a + j]) * alpha;
+        const float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+
+        poses.rx[o] = x * inverseLength;
+        poses.ry[o] = y * inverseLength;
+        poses.rz[o] = z * inverseLength;
+        poses.rw[o] = w * inverseLength;
+    }
+}
+
+#ifdef VULKANAPI_ANIMATION_SSE
+/// \brief Interpolación lineal de cuatro carriles.
+static inline __m128 lerp4(__m128 a, __m128 b, __m128 alpha)
+{
+    return (_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), alpha)));
+}
+
+/// \brief Carga una articulación de cuatro personajes (cada uno en su clave del clip).
+/// \param channel Canal del clip.
+/// \param keys Desplazamiento de la clave de cada personaje.
+/// \param joint Articulación.
+static inline __m128 gather4(const std::vector<float>& channel, const size_t* keys, uint32_t joint)
+{
+    return (_mm_setr_ps(
+        channel[keys[0] + joint], channel[keys[1] + joint],
+        channel[keys[2] + joint], channel[keys[3] + joint]));
+}
+
+/// \brief Interpola todas las articulaciones de cuatro personajes con SSE (un carril por personaje).
+/// \param clip Clip de origen.
+/// \param a Desplazamiento de la primera clave de cada personaje.
+/// \param b Desplazamiento de la segunda clave de cada personaje.
+/// \param t Factor de interpolación de cada personaje.
+/// \param character Primer personaje del grupo.
+/// \param poses Lote de salida.
+static void blendSse(
+    const AnimationClip& clip,
+    const size_t* a,
+    const size_t* b,
+    __m128 t,
+    uint32_t character,
+    PoseBatch& poses)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (uint32_t j = 0; j < clip.jointCount; ++j)
+    {
+        const size_t o = poses.index(j, character);
+
+        _mm_storeu_ps(&poses.tx[o], lerp4(gather4(clip.tx, a, j), gather4(clip.tx, b, j), t));
+        _mm_storeu_ps(&poses.ty[o], lerp4(gather4(clip.ty, a, j), gather4(clip.ty, b, j), t));
+        _mm_storeu_ps(&poses.tz[o], lerp4(gather4(clip.tz, a, j), gather4(clip.tz, b, j), t));
+
+        const __m128 ax = gather4(clip.rx, a, j);
+        const __m128 ay = gather4(clip.ry, a, j);
+        const __m128 az = gather4(clip.rz, a, j);
+        const __m128 aw = gather4(clip.rw, a, j);
+        __m128 bx = gather4(clip.rx, b, j);
+        __m128 by = gather4(clip.ry, b, j);
+        __m128 bz = gather4(clip.rz, b, j);
+        __m128 bw = gather4(clip.rw, b, j);
+
+        const __m128 dot = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+            _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+
+        // Camino corto: invierte el signo de b en los carriles con producto escalar negativo.
+        const __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signBit);
+        bx = _mm_xor_ps(bx, flip);
+        by = _mm_xor_ps(by, flip);
+        bz = _mm_xor_ps(bz, flip);
+        bw = _mm_xor_ps(bw, flip);
+
+        const __m128 x = lerp4(ax, bx, t);
+        const __m128 y = lerp4(ay, by, t);
+        const __m128 z = lerp4(az, bz, t);
+        const __m128 w = lerp4(aw, bw, t);
+
+        const __m128 lengthSquared = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+            _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+        const __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+
+        _mm_storeu_ps(&poses.rx[o], _mm_mul_ps(x, inverseLength));
+        _mm_storeu_ps(&poses.ry[o], _mm_mul_ps(y, inverseLength));
+        _mm_storeu_ps(&poses.rz[o], _mm_mul_ps(z, inverseLength));
+        _mm_storeu_ps(&poses.rw[o], _mm_mul_ps(w, inverseLength));
+    }
+}
+#endif
+
+/// \brief Muestrea un clip para los personajes [begin, end) de un lote.
+/// \details Interpola linealmente traslaciones y hace nlerp de rotaciones entre
+/// las dos claves que rodean a cada instante. Con SSE cada carril es un personaje
+/// distinto en la misma articulación, así que los grupos de cuatro personajes
+/// llenan los registros sea cual sea el número de articulaciones; el resto del
+/// tramo se hace en escalar. Sólo se escriben los personajes del tramo, así que
+/// varias hebras pueden muestrear tramos disjuntos del mismo lote.
+/// \param clip Clip a muestrear.
+/// \param times Instante (s) de cada personaje del lote.
+/// \param begin Primer personaje.
+/// \param end Personaje final (excluido).
+/// \param poses Salida (ya dimensionada con \c clip.jointCount articulaciones).
+void AnimationSampler::sampleBatch(
+    const AnimationClip& clip,
+    const float* times,
+    uint32_t begin,
+    uint32_t end,
+    PoseBatch& poses)
+{
+    const float duration = clip.duration();
+
+    if (clip.keyCount == 0 || duration <= 0.0f)
+    {
+        return;
+    }
+
+    uint32_t i = begin;
+
+#ifdef VULKANAPI_ANIMATION_SSE
+    for (; i + 4 <= end; i += 4)
+    {
+        size_t a[4];
+        size_t b[4];
+        float alpha[4];
+
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            alpha[lane] = clipKeys(clip, duration, times[i + lane], a[lane], b[lane]);
+        }
+
+        blendSse(clip, a, b, _mm_loadu_ps(alpha), i, poses);
+    }
+#endif
+
+    for (; i < end; ++i)
+    {
+        size_t a = 0;
+        size_t b = 0;
+        const float alpha = clipKeys(clip, duration, times[i], a, b);
+
+        blendScalar(clip, a, b, alpha, i, poses);
+    }
+}
+
+/// \brief Resuelve la jerarquía y produce las matrices de skinning.
+/// \param skeleton Esqueleto (padres antes que hijos).
+/// \param poses Lote de poses locales muestreadas.
+/// \param character Personaje del lote.
+/// \param skinMatrices Salida: \c jointCount matrices (modelo * inversa de reposo).
+void AnimationSampler::computeSkinMatrices(
+    const Skeleton& skeleton,
+    const PoseBatch& poses,
+    uint32_t character,
+    glm::mat4* skinMatrices)
+{
+    const uint32_t jointCount = skeleton.jointCount();
+
+    // Primera pasada: transformaciones de modelo (el padre ya está resuelto).
+    for (uint32_t j = 0; j < jointCount; ++j)
+    {
+        const size_t o = poses.index(j, character);
+        const glm::quat rotation(poses.rw[o], poses.rx[o], poses.ry[o], poses.rz[o]);
+
+        glm::mat4 local = glm::mat4_cast(rotation);
+        local[3] = glm::vec4(poses.tx[o], poses.ty[o], poses.tz[o], 1.0f);
+
+        const int32_t parent = skeleton.parents[j];
+        skinMatrices[j] = (parent >= 0) ? skinMatrices[parent] * local : local;
+    }
+
+    // Segunda pasada: paleta final.
+    for (uint32_t j = 0; j < jointCount; ++j)
+    {
+        skinMatrices[j] = skinMatrices[j] * skeleton.inverseBind[j];
+    }
+}
@@ -0,0 +1,622 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AssetIO.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "AssetIO.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<liburing.h>)
+#define VULKANAPI_IO_URING 1
+#endif
+#endif
+
+#ifdef VULKANAPI_IO_URING
+#include <liburing.h>
+#endif
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+/// \brief Espera a que terminen todas las lecturas (y sus callbacks).
+/// \details Lanza \c std::runtime_error con el primer error si alguna falló.
+void AssetBatch::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]
+    {
+        return (remaining == 0);
+    });
+
+    if (!firstError.empty())
+    {
+        throw std::runtime_error("💥[Vulkan API] " + firstError);
+    }
+}
+
+/// \brief Indica si ya han terminado todas las lecturas.
+bool AssetBatch::isDone()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return (remaining == 0);
+}
+
+/// \brief Marca una lectura como terminada.
+/// \param error Mensaje de error (vacío si tuvo éxito).
+void AssetBatch::complete(const std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!error.empty() && firstError.empty())
+    {
+        firstError = error;
+    }
+
+    remaining -= 1;
+
+    if (remaining == 0)
+    {
+        done.notify_all();
+    }
+}
+
+/// \brief Crea la cola de E/S y sus hebras.
+/// \param preferred Implementación preferida; si no está disponible se usa \c ThreadPool.
+/// \param threadCount Hebras del \c ThreadPool.
+/// \param queueDepth Lecturas en vuelo con io_uring.
+AssetIO::AssetIO(AssetIOBackend preferred, uint32_t threadCount, uint32_t queueDepth)
+    : queueDepth {std::max(1u, queueDepth)}
+{
+#ifdef VULKANAPI_IO_URING
+    if (preferred == AssetIOBackend::IoUring)
+    {
+        ring = new io_uring {};
+
+        // Puede fallar en kernels antiguos o con io_uring deshabilitado (p.ej., contenedores).
+        if (io_uring_queue_init(this->queueDepth, ring, 0) == 0)
+        {
+            backend = AssetIOBackend::IoUring;
+            threads.emplace_back(&AssetIO::ringLoop, this);
+
+            return;
+        }
+
+        delete ring;
+        ring = nullptr;
+    }
+#else
+    (void)preferred;
+#endif
+
+    backend = AssetIOBackend::ThreadPool;
+
+    for (uint32_t i = 0; i < std::max(1u, threadCount); ++i)
+    {
+        threads.emplace_back(&AssetIO::poolLoop, this);
+    }
+}
+
+/// \brief Detiene las hebras; las peticiones no iniciadas terminan con error.
+AssetIO::~AssetIO()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (Job& job : jobs)
+    {
+        AssetReadResult result {};
+        result.path = job.request.path;
+        result.error = "Asset I/O stopped before reading " + job.request.path + ".";
+        finish(job, result);
+    }
+
+#ifdef VULKANAPI_IO_URING
+    if (ring)
+    {
+        io_uring_queue_exit(ring);
+        delete ring;
+    }
+#endif
+}
+
+/// \brief Encola un lote de lecturas.
+/// \param requests Peticiones del lote.
+/// \return Lote sobre el que esperar.
+std::shared_ptr<AssetBatch> AssetIO::submit(std::vector<AssetReadRequest> requests)
+{
+    std::shared_ptr<AssetBatch> batch = std::make_shared<AssetBatch>();
+    batch->remaining = requests.size();
+
+    if (requests.empty())
+    {
+        return (batch);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (AssetReadRequest& request : requests)
+        {
+            jobs.push_back({std::move(request), batch});
+        }
+    }
+
+    wakeUp.notify_all();
+
+    return (batch);
+}
+
+/// \brief Nombre legible de una implementación.
+const char* AssetIO::backendName(AssetIOBackend backend)
+{
+    return ((backend == AssetIOBackend::IoUring) ? "io_uring" : "thread-pool");
+}
+
+/// \brief Entrega el resultado de una petición y la marca como terminada.
+/// \param job Petición terminada.
+/// \param result Resultado (se mueve al callback).
+void AssetIO::finish(Job& job, AssetReadResult& result)
+{
+    const std::string error = result.ok ? std::string() : result.error;
+
+    if (job.request.onComplete)
+    {
+        job.request.onComplete(result);
+    }
+
+    job.batch->complete(error);
+}
+
+/// \brief Bucle de una hebra del \c ThreadPool.
+void AssetIO::poolLoop()
+{
+    std::vector<char> discard;
+
+    while (true)
+    {
+        Job job {};
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this]
+            {
+                return (stopping || !jobs.empty());
+            });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        AssetReadResult result {};
+        result.path = job.request.path;
+
+        std::ifstream file(job.request.path, std::ios::binary | std::ios::ate);
+
+        if (!file)
+        {
+            result.error = "Failed to open file: " + job.request.path + ".";
+            finish(job, result);
+            continue;
+        }
+
+        result.size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        char* target = static_cast<char*>(job.request.destination);
+
+        if (!target)
+        {
+            result.data.resize(result.size);
+            target = result.data.data();
+        }
+        else if (job.request.capacity < result.size)
+        {
+            result.error = "Destination too small for " + job.request.path + ".";
+            finish(job, result);
+            continue;
+        }
+
+        uint64_t offset = 0;
+
+        while (offset < result.size && file)
+        {
+            const uint64_t length = std::min(CHUNK_SIZE, result.size - offset);
+            file.read(target + offset, static_cast<std::streamsize>(length));
+            offset += static_cast<uint64_t>(file.gcount());
+            readCount += 1;
+        }
+
+        bytesRead += offset;
+        result.ok = (offset == result.size);
+
+        if (!result.ok)
+        {
+            result.error = "Short read on " + job.request.path + ".";
+        }
+
+        finish(job, result);
+    }
+}
+
+#ifdef VULKANAPI_IO_URING
+
+/// \brief Fichero en lectura por el anillo de io_uring.
+struct RingFile
+{
+    /// Descriptor abierto.
+    int fd = -1;
+    /// Memoria destino.
+    char* target = nullptr;
+    /// Bytes ya enviados a la cola.
+    uint64_t submitted = 0;
+    /// Bloques enviados y no terminados.
+    uint32_t outstanding = 0;
+    /// Indica que alguna lectura ha fallado.
+    bool failed = false;
+};
+
+/// \brief Bloque en vuelo (se asocia a su SQE como \c user_data).
+struct RingChunk
+{
+    /// Índice del fichero en la tabla de la hebra.
+    size_t file = 0;
+    /// Desplazamiento dentro del fichero.
+    uint64_t offset = 0;
+    /// Bytes pendientes del bloque.
+    uint32_t length = 0;
+};
+
+#endif
+
+/// \brief Bucle de la hebra que gestiona el anillo de io_uring.
+/// \details Abre los ficheros de las peticiones nuevas, reparte cada uno en bloques
+/// de \c CHUNK_SIZE y mantiene hasta \c queueDepth bloques en vuelo. Las lecturas
+/// cortas se reenvían por el resto del bloque. Cuando no hay nada en vuelo espera
+/// nuevas peticiones en \c wakeUp; si no, en la cola de finalización.
+void AssetIO::ringLoop()
+{
+#ifdef VULKANAPI_IO_URING
+    struct Active
+    {
+        Job job;
+        AssetReadResult result;
+        RingFile file;
+    };
+
+    std::vector<std::unique_ptr<Active>> active;
+    std::deque<size_t> toSubmit;
+    std::deque<RingChunk> retries;
+    uint32_t inFlight = 0;
+
+    auto finishFile = [&](size_t index)
+    {
+        Active& entry = *active[index];
+        ::close(entry.file.fd);
+
+        entry.result.ok = !entry.file.failed;
+        finish(entry.job, entry.result);
+        active[index].reset();
+
+        // Un fichero fallido puede seguir en la cola de envío.
+        toSubmit.erase(std::remove(toSubmit.begin(), toSubmit.end(), index), toSubmit.end());
+    };
+
+    while (true)
+    {
+        std::deque<Job> incoming;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (inFlight == 0 && toSubmit.empty() && retries.empty())
+            {
+                wakeUp.wait(lock, [this]
+                {
+                    return (stopping || !jobs.empty());
+                });
+            }
+
+            // Al parar se terminan los ficheros ya abiertos; el resto falla en el destructor.
+            if (stopping && inFlight == 0 && toSubmit.empty() && retries.empty())
+            {
+                return;
+            }
+
+            if (!stopping)
+            {
+                incoming.swap(jobs);
+            }
+        }
+
+        for (Job& job : incoming)
+        {
+            std::unique_ptr<Active> entry = std::make_unique<Active>();
+            entry->job = std::move(job);
+            entry->result.path = entry->job.request.path;
+            entry->file.fd = ::open(entry->job.request.path.c_str(), O_RDONLY | O_CLOEXEC);
+
+            struct stat info {};
+
+            if (entry->file.fd < 0 || ::fstat(entry->file.fd, &info) != 0)
+            {
+                if (entry->file.fd >= 0)
+                {
+                    ::close(entry->file.fd);
+                }
+
+                entry->result.error = "Failed to open file: " + entry->job.request.path + ".";
+                finish(entry->job, entry->result);
+                continue;
+            }
+
+            entry->result.size = static_cast<uint64_t>(info.st_size);
+            entry->file.target = static_cast<char*>(entry->job.request.destination);
+
+            if (!entry->file.target)
+            {
+                entry->result.data.resize(entry->result.size);
+                entry->file.target = entry->result.data.data();
+            }
+            else if (entry->job.request.capacity < entry->result.size)
+            {
+                ::close(entry->file.fd);
+                entry->result.error = "Destination too small for " + entry->job.request.path + ".";
+                finish(entry->job, entry->result);
+                continue;
+            }
+
+            // Reutiliza huecos de la tabla para que los índices de los bloques sigan siendo válidos.
+            std::vector<std::unique_ptr<Active>>::iterator slot =
+                std::find(active.begin(), active.end(), nullptr);
+            size_t index = static_cast<size_t>(slot - active.begin());
+
+            if (slot == active.end())
+            {
+                active.push_back(std::move(entry));
+            }
+            else
+            {
+                *slot = std::move(entry);
+            }
+
+            if (active[index]->result.size == 0)
+            {
+                finishFile(index);
+                continue;
+            }
+
+            toSubmit.push_back(index);
+        }
+
+        auto enqueue = [&](const RingChunk& chunk) -> bool
+        {
+            io_uring_sqe* sqe = io_uring_get_sqe(ring);
+
+            if (!sqe)
+            {
+                return (false);
+            }
+
+            RingFile& file = active[chunk.file]->file;
+            io_uring_prep_read(sqe, file.fd, file.target + chunk.offset, chunk.length, chunk.offset);
+            io_uring_sqe_set_data(sqe, new RingChunk(chunk));
+            inFlight += 1;
+
+            return (true);
+        };
+
+        while (!retries.empty() && inFlight < queueDepth && enqueue(retries.front()))
+        {
+            retries.pop_front();
+        }
+
+        while (!toSubmit.empty() && inFlight < queueDepth)
+        {
+            const size_t index = toSubmit.front();
+            RingFile& file = active[index]->file;
+            const uint64_t size = active[index]->result.size;
+
+            if (file.failed)
+            {
+                toSubmit.pop_front();
+                continue;
+            }
+
+            RingChunk chunk {};
+            chunk.file = index;
+            chunk.offset = file.submitted;
+            chunk.length = static_cast<uint32_t>(std::min(CHUNK_SIZE, size - file.submitted));
+
+            if (!enqueue(chunk))
+            {
+                break;
+            }
+
+            file.submitted += chunk.length;
+            file.outstanding += 1;
+
+            if (file.submitted == size)
+            {
+                toSubmit.pop_front();
+            }
+        }
+
+        io_uring_submit(ring);
+
+        if (inFlight == 0)
+        {
+            continue;
+        }
+
+        io_uring_cqe* cqe = nullptr;
+
+        if (io_uring_wait_cqe(ring, &cqe) != 0)
+        {
+            continue;
+        }
+
+        do
+        {
+            std::unique_ptr<RingChunk> chunk(static_cast<RingChunk*>(io_uring_cqe_get_data(cqe)));
+            const int res = cqe->res;
+            io_uring_cqe_seen(ring, cqe);
+            inFlight -= 1;
+
+            Active& entry = *active[chunk->file];
+
+            if (res <= 0)
+            {
+                entry.file.failed = true;
+                entry.result.error = "Read failed on " + entry.job.request.path + ": " +
+                    ((res < 0) ? std::strerror(-res) : "unexpected end of file") + ".";
+            }
+            else
+            {
+                bytesRead += static_cast<uint64_t>(res);
+                readCount += 1;
+
+                if (static_cast<uint32_t>(res) < chunk->length && !entry.file.failed)
+                {
+                    // Lectura corta: se reenvía el resto del bloque.
+                    chunk->offset += static_cast<uint64_t>(res);
+                    chunk->length -= static_cast<uint32_t>(res);
+                    retries.push_back(*chunk);
+                    continue;
+                }
+            }
+
+            entry.file.outstanding -= 1;
+
+            const bool allSubmitted = (entry.file.submitted == entry.result.size);
+
+            if (entry.file.outstanding == 0 && (entry.file.failed || allSubmitted))
+            {
+                finishFile(chunk->file);
+            }
+        }
+        while (io_uring_peek_cqe(ring, &cqe) == 0);
+    }
+#endif
+}
+
+/// \brief Mide MB/s e IOPS leyendo todos los ficheros de \c directories.
+/// \details Lee los ficheros en un único bloque de memoria (como lo haría
+/// una subida a staging) con cada implementación disponible. En Linux se
+/// pide al kernel que descarte sus páginas en caché antes de cada pasada.
+/// \param directories Carpetas a recorrer recursivamente.
+/// \param out Flujo donde se escribe el informe.
+void AssetIO::benchmark(const std::vector<std::string>& directories, std::ostream& out)
+{
+    std::vector<std::string> paths;
+    std::vector<uint64_t> offsets;
+    uint64_t totalBytes = 0;
+
+    for (const std::string& directory : directories)
+    {
+        std::error_code error;
+
+        if (!std::filesystem::is_directory(directory, error))
+        {
+            continue;
+        }
+
+        for (const std::filesystem::directory_entry& entry :
+            std::filesystem::recursive_directory_iterator(directory, error))
+        {
+            if (entry.is_regular_file(error))
+            {
+                paths.push_back(entry.path().string());
+                offsets.push_back(totalBytes);
+                totalBytes += static_cast<uint64_t>(entry.file_size(error));
+            }
+        }
+    }
+
+    out << "[io] " << paths.size() << " files, " << std::fixed << std::setprecision(2) <<
+        double(totalBytes) / (1024.0 * 1024.0) << " MiB\n";
+
+    if (paths.empty())
+    {
+        return;
+    }
+
+    // Un único bloque de destino, como el staging de una carga de nivel.
+    std::vector<char> arena(static_cast<size_t>(totalBytes));
+
+    for (AssetIOBackend preferred : {AssetIOBackend::ThreadPool, AssetIOBackend::IoUring})
+    {
+        AssetIO io(preferred, std::max(2u, std::thread::hardware_concurrency()));
+
+        if (io.getBackend() != preferred)
+        {
+            out << "[io] " << std::left << std::setw(12) << backendName(preferred) << "unavailable\n";
+            continue;
+        }
+
+#ifdef __linux__
+        for (const std::string& path : paths)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+            if (fd >= 0)
+            {
+                ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                ::close(fd);
+            }
+        }
+#endif
+
+        std::vector<AssetReadRequest> requests(paths.size());
+
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            const uint64_t end = (i + 1 < paths.size()) ? offsets[i + 1] : totalBytes;
+
+            requests[i].path = paths[i];
+            requests[i].destination = arena.data() + offsets[i];
+            requests[i].capacity = end - offsets[i];
+        }
+
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        std::shared_ptr<AssetBatch> batch = io.submit(std::move(requests));
+        batch->wait();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        out << "[io] " << std::left << std::setw(12) << backendName(preferred) <<
+            std::right << std::setw(10) << double(io.getBytesRead()) / (1024.0 * 1024.0) / seconds << " MiB/s" <<
+            std::setw(12) << double(io.getReadCount()) / seconds << " IOPS" <<
+            std::setw(10) << seconds * 1000.0 << " ms\n";
+    }
+}
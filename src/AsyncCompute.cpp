@@ -0,0 +1,266 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AsyncCompute.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "AsyncCompute.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+/// \brief Crea el command pool, los command buffers, el semáforo y las consultas.
+/// \param device Dispositivo Vulkan.
+/// \param framesInFlight Número de frames en vuelo.
+/// \param allowed Permite usar la cola dedicada (\c false fuerza el camino en serie).
+AsyncCompute::AsyncCompute(VulkanDevice& device, uint32_t framesInFlight, bool allowed)
+    : device(device), framesInFlight(framesInFlight)
+{
+    if (!device.hasAsyncCompute())
+    {
+        std::cout << "[Vulkan API] No dedicated compute queue: compute passes run on the graphics queue." << std::endl;
+        return;
+    }
+
+    if (!allowed)
+    {
+        std::cout << "[Vulkan API] Async compute disabled: compute passes run on the graphics queue." << std::endl;
+        return;
+    }
+
+    enabled = true;
+    stats.enabled = true;
+
+    const uint32_t family = device.getQueueFamilyIndices().computeFamily;
+
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = family;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+    if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create compute command pool.");
+    }
+
+    commandBuffers.resize(framesInFlight);
+    frameValues.assign(framesInFlight, 0);
+
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = framesInFlight;
+
+    if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, commandBuffers.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to allocate compute command buffers.");
+    }
+
+    VkSemaphoreTypeCreateInfo typeInfo {};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &timeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create compute timeline semaphore.");
+    }
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+
+    const DeviceCapabilities& capabilities = device.getCapabilities();
+
+    if (capabilities.timestamps && families[family].timestampValidBits > 0)
+    {
+        VkQueryPoolCreateInfo queryInfo {};
+        queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryInfo.queryCount = 2 * framesInFlight;
+
+        if (vkCreateQueryPool(device.getDevice(), &queryInfo, nullptr, &queryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create compute query pool.");
+        }
+
+        hostReset = capabilities.hostQueryReset;
+        timestampPeriodNs = capabilities.timestampPeriod;
+    }
+
+    std::cout << "[Vulkan API] Async compute on queue family " << family << '.' << std::endl;
+}
+
+/// \brief Libera los recursos (la cola debe estar inactiva).
+AsyncCompute::~AsyncCompute()
+{
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(device.getDevice(), queryPool, nullptr);
+    }
+
+    if (timeline != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(device.getDevice(), timeline, nullptr);
+    }
+
+    if (commandPool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(device.getDevice(), commandPool, nullptr);
+    }
+}
+
+/// \brief Empieza a grabar el cómputo del frame.
+/// \details Antes de reutilizar el command buffer mide el solape de su envío
+/// anterior con el render del frame que lo precedió.
+/// \param frameIndex Índice de frame en vuelo.
+/// \param perf Métricas con los timestamps de los frames de gráficos.
+/// \return Command buffer de cómputo, o \c VK_NULL_HANDLE si no hay cola dedicada.
+VkCommandBuffer AsyncCompute::begin(uint32_t frameIndex, const Perf& perf)
+{
+    if (!enabled)
+    {
+        return (VK_NULL_HANDLE);
+    }
+
+    // El render de este frame en vuelo esperó a su cómputo y su fence ya se ha
+    // esperado, así que normalmente el semáforo ya ha alcanzado el valor.
+    if (frameValues[frameIndex] > 0)
+    {
+        VkSemaphoreWaitInfo waitInfo {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline;
+        waitInfo.pValues = &frameValues[frameIndex];
+
+        vkWaitSemaphores(device.getDevice(), &waitInfo, UINT64_MAX);
+        measureOverlap(frameIndex, perf);
+    }
+
+    VkCommandBuffer commandBuffer = commandBuffers[frameIndex];
+
+    VkCommandBufferBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to begin recording compute command buffer.");
+    }
+
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        const uint32_t base = 2 * frameIndex;
+
+        if (hostReset)
+        {
+            vkResetQueryPool(device.getDevice(), queryPool, base, 2);
+        }
+        else
+        {
+            vkCmdResetQueryPool(commandBuffer, queryPool, base, 2);
+        }
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, base);
+    }
+
+    return (commandBuffer);
+}
+
+/// \brief Cierra y envía el cómputo del frame.
+/// \param frameIndex Índice de frame en vuelo.
+/// \return Espera que el envío de gráficos del frame debe añadir.
+TimelineWait AsyncCompute::submit(uint32_t frameIndex)
+{
+    VkCommandBuffer commandBuffer = commandBuffers[frameIndex];
+
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 2 * frameIndex + 1);
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to record compute command buffer.");
+    }
+
+    const uint64_t value = lastValue + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
+    VkSubmitInfo submitInfo {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline;
+
+    if (device.submitCompute(1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to submit compute command buffer.");
+    }
+
+    lastValue = value;
+    frameValues[frameIndex] = value;
+
+    // Los resultados se consumen como argumentos indirectos y en los vertex shaders;
+    // el resto del frame de gráficos no espera al cómputo.
+    TimelineWait wait {};
+    wait.semaphore = timeline;
+    wait.value = value;
+    wait.stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    return (wait);
+}
+
+/// \brief Lee los timestamps del envío anterior de \c frameIndex y actualiza \c stats.
+/// \param frameIndex Índice de frame en vuelo.
+/// \param perf Métricas con los timestamps de los frames de gráficos.
+void AsyncCompute::measureOverlap(uint32_t frameIndex, const Perf& perf)
+{
+    if (queryPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    uint64_t compute[2] = {};
+
+    if (vkGetQueryPoolResults(
+        device.getDevice(), queryPool, 2 * frameIndex, 2,
+        sizeof(compute), compute, sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    stats.computeMs = static_cast<float>(double(compute[1] - compute[0]) * timestampPeriodNs / 1.0e6);
+
+    // Render del frame anterior: resuelto por Perf al empezar ese frame en vuelo.
+    const uint32_t previous = (frameIndex + framesInFlight - 1) % framesInFlight;
+    uint64_t graphicsBegin = 0;
+    uint64_t graphicsEnd = 0;
+
+    if (!perf.getGpuFrameTicks(previous, graphicsBegin, graphicsEnd))
+    {
+        return;
+    }
+
+    const uint64_t overlapBegin = std::max(compute[0], graphicsBegin);
+    const uint64_t overlapEnd = std::min(compute[1], graphicsEnd);
+    const uint64_t overlapTicks = (overlapEnd > overlapBegin) ? overlapEnd - overlapBegin : 0;
+
+    stats.overlapMs = static_cast<float>(double(overlapTicks) * timestampPeriodNs / 1.0e6);
+    stats.overlapRatio = (compute[1] > compute[0]) ? float(double(overlapTicks) / double(compute[1] - compute[0])) : 0.0f;
+}
@@ -0,0 +1,207 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: AsyncScheduler.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "AsyncScheduler.hpp"
+#include "ThreadTopology.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+/// \brief Corrutina sin dueño que ejecuta una tarea lanzada con \c spawn.
+/// \details Empieza de inmediato y libera su marco al terminar.
+struct AsyncScheduler::Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/// \brief Solicita la lectura a \c AssetIO; el callback reanuda la corrutina.
+/// \param handle Corrutina suspendida.
+void AsyncScheduler::ReadAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    AssetReadRequest request {};
+    request.path = path;
+    request.onComplete = [this, handle](AssetReadResult& read)
+    {
+        result = std::move(read);
+        scheduler.post(handle);
+    };
+
+    std::vector<AssetReadRequest> requests;
+    requests.push_back(std::move(request));
+    io.submit(std::move(requests));
+}
+
+/// \brief Devuelve el contenido leído o lanza si la lectura falló.
+std::vector<char> AsyncScheduler::ReadAwaiter::await_resume()
+{
+    if (!result.ok)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to read '" + path + "': " + result.error);
+    }
+
+    return (std::move(result.data));
+}
+
+/// \brief Crea las hebras trabajadoras.
+/// \param workerCount Número de hebras (mínimo 1).
+/// \param cpus CPUs a las que fijar las hebras (vacío = sin afinidad).
+AsyncScheduler::AsyncScheduler(uint32_t workerCount, std::vector<uint32_t> cpus) : cpus(std::move(cpus))
+{
+    const uint32_t count = (workerCount > 0) ? workerCount : 1;
+    workers.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        workers.emplace_back(&AsyncScheduler::workerLoop, this);
+    }
+}
+
+/// \brief Detiene las hebras. Las tareas lanzadas deben haber terminado (\c waitIdle).
+AsyncScheduler::~AsyncScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/// \brief Encola una corrutina suspendida para que la reanude una hebra trabajadora.
+/// \param handle Corrutina a reanudar.
+void AsyncScheduler::post(std::coroutine_handle<> handle)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(handle);
+    }
+
+    wakeUp.notify_one();
+}
+
+/// \brief Lanza una tarea sin esperar a su resultado.
+/// \param task Tarea a ejecutar.
+void AsyncScheduler::spawn(Task<void> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outstanding += 1;
+    }
+
+    run(*this, std::move(task));
+}
+
+/// \brief Bloquea hasta que terminan todas las tareas lanzadas con \c spawn.
+void AsyncScheduler::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [&] { return (outstanding == 0); });
+
+    if (failure)
+    {
+        std::exception_ptr error = std::exchange(failure, nullptr);
+        std::rethrow_exception(error);
+    }
+}
+
+/// \brief Cuerpo de las tareas lanzadas con \c spawn.
+/// \details El primer \c co_await lleva la tarea a una hebra trabajadora para que
+/// \c spawn no ejecute trabajo en la hebra llamante. La tarea se destruye antes de
+/// avisar a \c waitIdle, de modo que sus recursos ya están liberados cuando retorna.
+AsyncScheduler::Detached AsyncScheduler::run(AsyncScheduler& scheduler, Task<void> task)
+{
+    std::exception_ptr error;
+
+    co_await scheduler.schedule();
+
+    try
+    {
+        Task<void> body = std::move(task);
+        co_await body;
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    scheduler.finish(error);
+}
+
+/// \brief Registra el final de una tarea lanzada.
+/// \param error Excepción producida por la tarea (nula si terminó bien).
+void AsyncScheduler::finish(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (error && !failure)
+    {
+        failure = error;
+    }
+
+    outstanding -= 1;
+
+    if (outstanding == 0)
+    {
+        idle.notify_all();
+    }
+}
+
+/// \brief Bucle de las hebras trabajadoras.
+void AsyncScheduler::workerLoop()
+{
+    ThreadTopology::pinCurrentThread(cpus);
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        wakeUp.wait(lock, [&] { return (stopping || !ready.empty()); });
+
+        if (ready.empty())
+        {
+            return;
+        }
+
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+    }
+}
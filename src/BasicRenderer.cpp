@@ -8,6 +8,10 @@
 
 #include "BasicRenderer.hpp"
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
 
  /// \brief Datos enviados por push constants a los shaders.
@@ -18,6 +22,23 @@ struct PushConstantData
     glm::mat4 normalMatrix {1.0f};
 };
 
+/// \brief Opciones del bucle de grabación fijadas en compilación.
+template <bool Culling, bool BindElision, bool DebugColor>
+struct StaticRecordPolicy
+{
+    static constexpr bool culling = Culling;
+    static constexpr bool bindElision = BindElision;
+    static constexpr bool debugColor = DebugColor;
+};
+
+/// \brief Las mismas opciones leídas en tiempo de ejecución (referencia de las mediciones).
+struct DynamicRecordPolicy
+{
+    bool culling = false;
+    bool bindElision = false;
+    bool debugColor = false;
+};
+
 /// \brief Construye el renderizador básico y prepara los objetos de estado de pipeline.
 /// \details Inicializa el \c VkPipelineLayout y el \c GraphicsPipeline necesarios para
 /// dibujar en el \c VkRenderPass indicado. No toma propiedad de \c device.
@@ -28,7 +49,7 @@ BasicRenderer::BasicRenderer(
     VulkanDevice& device,
     VkRenderPass renderPass,
     VkDescriptorSetLayout globalDescriptorSetLayout)
-    : device{device}
+    : device{device}, renderPass{renderPass}
 {
     createPipelineLayout(globalDescriptorSetLayout);
     createGraphicsPipeline(renderPass);
@@ -71,6 +92,7 @@ void BasicRenderer::createPipelineLayout(VkDescriptorSetLayout globalDescriptorS
 }
 
 /// \brief Crea el \c GraphicsPipeline asociado al \c renderPass.
+/// \details También crea la variante fp16 si el dispositivo la admite.
 /// \param renderPass Render pass donde se usará este pipeline.
 /// \pre Requiere que \c pipelineLayout haya sido creado.
 void BasicRenderer::createGraphicsPipeline(VkRenderPass renderPass)
@@ -88,106 +110,432 @@ void BasicRenderer::createGraphicsPipeline(VkRenderPass renderPass)
         "shaders/simple_shader.vert.spv",
         "shaders/simple_shader.frag.spv",
         configInfo);
+
+    if (device.getCapabilities().halfPrecisionShading())
+    {
+        halfPipeline = std::make_unique<GraphicsPipeline>(
+            device,
+            "shaders/simple_shader_fp16.vert.spv",
+            "shaders/simple_shader_fp16.frag.spv",
+            configInfo);
+
+        useHalfPrecision = true;
+    }
 }
 
 /// \brief Renderiza la escena para el frame actual.
-/// \details Enlaza el pipeline, configura los descriptor sets globales
-/// y emite las draw calls sobre los objetos disponibles en \c frameInfo.
+/// \details Prepara la grabación y graba todos los objetos en el command buffer
+/// principal de \c frameInfo (camino de una sola hebra).
 /// \param frameInfo Contexto del frame (command buffer, descriptor set, cámara, etc.).
 void BasicRenderer::render(FrameInfo& frameInfo)
 {
-    pipeline->bind(frameInfo.commandBuffer);
+    prepareRecording(frameInfo);
+    recordRange(frameInfo, frameInfo.commandBuffer, 0, drawList.size());
+}
 
-    vkCmdBindDescriptorSets(
-        frameInfo.commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelineLayout,
-        0,
-        1,
-        &frameInfo.globalDescriptorSet,
-        0,
-        nullptr);
+/// \brief Prepara la grabación del frame.
+/// \details Reúne una sola vez los objetos con malla que no sustituye un impostor
+/// (ordenados por malla si se omiten enlaces redundantes), extrae el frustum de la
+/// cámara si hay culling y elige el bucle de grabación de la variante y la
+/// visualización activas. Debe llamarse desde la hebra principal antes de
+/// repartir \c recordRange entre hebras.
+/// \param frameInfo Contexto del frame.
+void BasicRenderer::prepareRecording(FrameInfo& frameInfo)
+{
+    drawList.clear();
+    drawList.reserve(frameInfo.gameObjects.size());
 
     for (std::pair<const unsigned int, GameObject>& entry : frameInfo.gameObjects)
     {
         GameObject& object = entry.second;
 
-        if (object.model == nullptr)
+        if (object.model != nullptr && !object.drawAsImpostor)
         {
-            continue;
+            drawList.push_back(&object);
         }
+    }
 
-        PushConstantData push {};
-        push.modelMatrix = object.transform.matrix();
-        push.normalMatrix = object.transform.normalMatrix();
+    if (recordVariant.bindElision)
+    {
+        std::sort(drawList.begin(), drawList.end(), [](const GameObject* a, const GameObject* b)
+        {
+            return (a->model.get() < b->model.get());
+        });
+    }
 
-        vkCmdPushConstants(
-            frameInfo.commandBuffer,
-            pipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-            0,
-            sizeof(PushConstantData),
-            &push);
+    if (recordVariant.culling)
+    {
+        frustum = extractFrustum(frameInfo.camera.getProjectionMatrix() * frameInfo.camera.getViewMatrix());
+    }
+
+    const bool debugColor = (debugView == DebugView::Lod);
 
-        object.model->bind(frameInfo.commandBuffer);
-        object.model->draw(frameInfo.commandBuffer);
+    if (!recordVariant.specialized)
+    {
+        recordLoop = &BasicRenderer::recordGeneric;
+        return;
     }
+
+    // Índice = culling | bindElision << 1 | debugColor << 2.
+    static const RecordLoop SPECIALIZED[8] =
+    {
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<false, false, false>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<true, false, false>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<false, true, false>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<true, true, false>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<false, false, true>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<true, false, true>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<false, true, true>>,
+        &BasicRenderer::recordSpecialized<StaticRecordPolicy<true, true, true>>
+    };
+
+    recordLoop = SPECIALIZED[
+        uint32_t(recordVariant.culling) | uint32_t(recordVariant.bindElision) << 1 | uint32_t(debugColor) << 2];
 }
 
-/// \brief Renderiza la escena para el frame actual.
-/// \details Enlaza el pipeline, configura los descriptor sets globales
-/// y emite las draw calls sobre los objetos disponibles en \c frameInfo.
-/// \param frameInfo Contexto del frame (command buffer, descriptor set, cámara, etc.).
-void BasicRenderer::recordRange(
+/// \brief Graba draw calls de un rango [begin, end) de objetos en un command buffer 
+/// ya iniciado.
+/// \param frameInfo Contexto del frame.
+/// \param cbSec Command buffer secundario ya comenzado con inheritance correcto.
+/// \param begin Índice inicial (incluido) dentro de la lista preparada.
+/// \param end   Índice final (excluido).
+/// \return Draws grabados (menos que el rango si hay culling).
+/// \pre \c prepareRecording se ha llamado en este frame.
+uint32_t BasicRenderer::recordRange(
     FrameInfo& frameInfo, 
     VkCommandBuffer cbSec, 
     size_t begin, 
     size_t end)
 {
-    pipeline->bind(cbSec);
+    activePipeline().bind(cbSec);
 
     vkCmdBindDescriptorSets(
         cbSec, VK_PIPELINE_BIND_POINT_GRAPHICS,
         pipelineLayout, 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
 
-    std::vector<std::pair<unsigned, GameObject*>> view; view.reserve(frameInfo.gameObjects.size());
-    
-    for (auto& go : frameInfo.gameObjects)
+    end = std::min(end, drawList.size());
+    begin = std::min(begin, end);
+
+    return ((this->*recordLoop)(cbSec, begin, end));
+}
+
+/// \brief Bucle de grabación de un rango de \c drawList.
+/// \details Las opciones de \p policy son constantes en las instancias de
+/// \c StaticRecordPolicy, así que el compilador elimina las ramas que no aplican
+/// y cada variante queda como un bucle propio sin comprobaciones por objeto.
+/// \param policy Opciones del bucle.
+/// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+/// \param begin Índice inicial (incluido).
+/// \param end Índice final (excluido).
+/// \return Draws grabados.
+template <typename Policy>
+uint32_t BasicRenderer::recordObjects(const Policy& policy, VkCommandBuffer commandBuffer, size_t begin, size_t end)
+{
+    const Model* boundModel = nullptr;
+    uint32_t draws = 0;
+
+    for (size_t i = begin; i < end; ++i)
     {
-        view.push_back({go.first, &go.second});
+        GameObject& object = *drawList[i];
+
+        PushConstantData push {};
+        push.modelMatrix = object.transform.matrix();
+
+        if (policy.culling)
+        {
+            const glm::mat4& transform = push.modelMatrix;
+            const glm::vec3 center = glm::vec3(transform * glm::vec4(object.model->getBoundsCenter(), 1.0f));
+            const float scale = std::max({
+                glm::length(glm::vec3(transform[0])),
+                glm::length(glm::vec3(transform[1])),
+                glm::length(glm::vec3(transform[2]))});
+
+            if (!sphereInFrustum(frustum, center, object.model->getBoundsRadius() * scale))
+            {
+                continue;
+            }
+        }
+
+        push.normalMatrix = object.transform.normalMatrix();
+
+        if (policy.debugColor)
+        {
+            writeDebugColor(object, push.normalMatrix);
+        }
+
+        vkCmdPushConstants(
+            commandBuffer, pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, sizeof(PushConstantData), &push);
+
+        if (!policy.bindElision || object.model.get() != boundModel)
+        {
+            object.model->bind(commandBuffer);
+            boundModel = object.model.get();
+        }
+
+        object.model->draw(commandBuffer, object.lightList);
+        draws += 1;
     }
 
-    if (begin > view.size())
+    return (draws);
+}
+
+/// \brief Bucle especializado para las opciones de \p Policy.
+/// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+/// \param begin Índice inicial (incluido).
+/// \param end Índice final (excluido).
+/// \return Draws grabados.
+template <typename Policy>
+uint32_t BasicRenderer::recordSpecialized(VkCommandBuffer commandBuffer, size_t begin, size_t end)
+{
+    return (recordObjects(Policy {}, commandBuffer, begin, end));
+}
+
+/// \brief Bucle genérico: las opciones se comprueban en cada objeto.
+/// \param commandBuffer Command buffer con el pipeline y el set global enlazados.
+/// \param begin Índice inicial (incluido).
+/// \param end Índice final (excluido).
+/// \return Draws grabados.
+uint32_t BasicRenderer::recordGeneric(VkCommandBuffer commandBuffer, size_t begin, size_t end)
+{
+    DynamicRecordPolicy policy {};
+    policy.culling = recordVariant.culling;
+    policy.bindElision = recordVariant.bindElision;
+    policy.debugColor = (debugView == DebugView::Lod);
+
+    return (recordObjects(policy, commandBuffer, begin, end));
+}
+
+/// \brief Extrae los planos del frustum de una matriz proyección * vista.
+/// \param viewProjection Matriz a descomponer (profundidad en [0, 1]).
+/// \return Planos normalizados (\c xyz normal hacia dentro, \c w distancia).
+BasicRenderer::Frustum BasicRenderer::extractFrustum(const glm::mat4& viewProjection)
+{
+    auto row = [&viewProjection](int i)
     {
-        begin = view.size();
+        return (glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]});
+    };
+
+    const glm::vec4 r0 = row(0);
+    const glm::vec4 r1 = row(1);
+    const glm::vec4 r2 = row(2);
+    const glm::vec4 r3 = row(3);
+
+    Frustum planes = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2};
+
+    for (glm::vec4& plane : planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
     }
 
-    if (end > view.size()) 
+    return (planes);
+}
+
+/// \brief Comprueba si una esfera toca el frustum.
+/// \param planes Planos del frustum.
+/// \param center Centro de la esfera en mundo.
+/// \param radius Radio de la esfera.
+/// \return \c true si no queda completamente fuera de algún plano.
+bool BasicRenderer::sphereInFrustum(const Frustum& planes, const glm::vec3& center, float radius)
+{
+    for (const glm::vec4& plane : planes)
     {
-        end = view.size();
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+        {
+            return (false);
+        }
     }
 
-    for (size_t i = begin; i < end; ++i)
+    return (true);
+}
+
+/// \brief Selecciona la visualización de depuración de los siguientes draws.
+/// \details Crea la tubería de la variante la primera vez que se pide, de modo
+/// que las que no se usan no cuestan ni memoria ni tiempo de arranque. Debe
+/// llamarse desde la hebra principal, antes de grabar el frame.
+/// \param view Visualización a usar.
+void BasicRenderer::setDebugView(DebugView view)
+{
+    debugView = view;
+    debugPipeline = nullptr;
+
+    if (view == DebugView::Off || view == DebugView::Bounds)
     {
-        GameObject& object = *view[i].second;
+        return;
+    }
+
+    std::unique_ptr<GraphicsPipeline>& variant = debugPipelines[static_cast<uint32_t>(view)];
+
+    if (variant == nullptr)
+    {
+        variant = createDebugPipeline(view);
+    }
+
+    debugPipeline = variant.get();
+}
+
+/// \brief Crea la tubería de una visualización de depuración.
+/// \param view Visualización (distinta de \c Off y \c Bounds).
+/// \return Tubería creada.
+std::unique_ptr<GraphicsPipeline> BasicRenderer::createDebugPipeline(DebugView view)
+{
+    PipelineConfig configInfo {};
+    GraphicsPipeline::defaultConfig(configInfo);
+    configInfo.renderPass = renderPass;
+    configInfo.layout = pipelineLayout;
+
+    const char* fragmentPath = "shaders/debug_lod.frag.spv";
+
+    if (view == DebugView::Overdraw)
+    {
+        // Mezcla aditiva con la prueba de profundidad normal: cada fragmento que la
+        // pasa (y por tanto se sombrea) suma una capa, en el orden real de los draws.
+        GraphicsPipeline::enableAlphaBlending(configInfo);
+        configInfo.colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        configInfo.colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        fragmentPath = "shaders/debug_overdraw.frag.spv";
+    }
+    else if (view == DebugView::LightCount)
+    {
+        fragmentPath = "shaders/debug_light_count.frag.spv";
+    }
+
+    return (std::make_unique<GraphicsPipeline>(
+        device,
+        "shaders/simple_shader.vert.spv",
+        fragmentPath,
+        configInfo));
+}
+
+/// \brief Dibuja las cajas envolventes de los objetos con malla.
+/// \details Sólo hace algo con \c DebugView::Bounds; debe grabarse dentro del
+/// render pass principal, después de la geometría. Con culling, las mallas que
+/// quedan fuera del frustum de \c prepareRecording se marcan aparte.
+/// \param frameInfo Contexto del frame.
+void BasicRenderer::renderBounds(FrameInfo& frameInfo)
+{
+    if (debugView != DebugView::Bounds)
+    {
+        return;
+    }
+
+    if (boundsPipeline == nullptr)
+    {
+        PipelineConfig configInfo {};
+        GraphicsPipeline::defaultConfig(configInfo);
+        configInfo.inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        configInfo.depthStencil.depthWriteEnable = VK_FALSE;
+        configInfo.attributes.clear();
+        configInfo.bindings.clear();
+        configInfo.renderPass = renderPass;
+        configInfo.layout = pipelineLayout;
+
+        boundsPipeline = std::make_unique<GraphicsPipeline>(
+            device,
+            "shaders/debug_bounds.vert.spv",
+            "shaders/debug_bounds.frag.spv",
+            configInfo);
+    }
+
+    boundsPipeline->bind(frameInfo.commandBuffer);
 
-        if (!object.model)
+    vkCmdBindDescriptorSets(
+        frameInfo.commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipelineLayout,
+        0,
+        1,
+        &frameInfo.globalDescriptorSet,
+        0,
+        nullptr);
+
+    for (std::pair<const unsigned int, GameObject>& entry : frameInfo.gameObjects)
+    {
+        GameObject& object = entry.second;
+
+        if (object.model == nullptr)
         {
             continue;
         }
 
+        // Cubo unidad llevado a la esfera envolvente en espacio local del objeto.
+        const glm::mat4 transform = object.transform.matrix();
+        const float radius = std::max(object.model->getBoundsRadius(), 1e-4f);
+        glm::mat4 bounds = glm::translate(transform, object.model->getBoundsCenter());
+
+        // Misma prueba que recordLoop, con el frustum extraído en prepareRecording.
+        bool culled = false;
+
+        if (recordVariant.culling && !object.drawAsImpostor)
+        {
+            const glm::vec3 center = glm::vec3(transform * glm::vec4(object.model->getBoundsCenter(), 1.0f));
+            const float scale = std::max({
+                glm::length(glm::vec3(transform[0])),
+                glm::length(glm::vec3(transform[1])),
+                glm::length(glm::vec3(transform[2]))});
+
+            culled = !sphereInFrustum(frustum, center, object.model->getBoundsRadius() * scale);
+        }
+
         PushConstantData push {};
-        push.modelMatrix = object.transform.matrix();
-        push.normalMatrix = object.transform.normalMatrix();
+        push.modelMatrix = glm::scale(bounds, glm::vec3(radius));
+
+        if (culled)
+        {
+            push.normalMatrix[3] = glm::vec4(1.0f, 0.2f, 0.2f, 1.0f);
+        }
+        else
+        {
+            push.normalMatrix[3] = object.drawAsImpostor ?
+                glm::vec4(1.0f, 0.85f, 0.1f, 1.0f) : glm::vec4(0.2f, 1.0f, 0.3f, 1.0f);
+        }
 
         vkCmdPushConstants(
-            cbSec, pipelineLayout,
+            frameInfo.commandBuffer,
+            pipelineLayout,
             VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-            0, sizeof(PushConstantData), &push);
+            0,
+            sizeof(PushConstantData),
+            &push);
 
-        object.model->bind(cbSec);
-        object.model->draw(cbSec);
+        vkCmdDraw(frameInfo.commandBuffer, 24, 1, 0, 0);
     }
 }
 
+/// \brief Escribe el color de depuración de un draw en las push constants.
+/// \param object Objeto a dibujar.
+/// \param normalMatrix Matriz de normales del draw (su última columna no la
+/// usan los shaders de iluminación).
+void BasicRenderer::writeDebugColor(const GameObject& object, glm::mat4& normalMatrix) const
+{
+    // Tono estable por malla: las instancias de un mismo modelo comparten color.
+    const size_t hash = std::hash<const Model*> {}(object.model.get());
+    const float hue = float((hash * 0x9E3779B97F4A7C15ull) >> 40) / float(1 << 24);
+
+    const glm::vec3 rgb = glm::clamp(
+        glm::abs(glm::fract(glm::vec3(hue) + glm::vec3(1.0f, 2.0f / 3.0f, 1.0f / 3.0f)) * 6.0f - 3.0f) - 1.0f,
+        0.0f,
+        1.0f);
+
+    normalMatrix[3] = glm::vec4(glm::mix(glm::vec3(1.0f), rgb, 0.7f), 1.0f);
+}
 
+/// \brief Nombre legible de una visualización.
+/// \param view Visualización a describir.
+const char* BasicRenderer::debugViewName(DebugView view)
+{
+    switch (view)
+    {
+        case DebugView::Overdraw:
+            return ("Overdraw");
+        case DebugView::LightCount:
+            return ("Light count");
+        case DebugView::Lod:
+            return ("LOD / mesh");
+        case DebugView::Bounds:
+            return ("Bounds");
+        default:
+            return ("Off");
+    }
+}
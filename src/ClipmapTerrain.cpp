@@ -0,0 +1,535 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ClipmapTerrain.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ClipmapTerrain.hpp"
+#include "DescriptorWriter.hpp"
+#include "SwapChain.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+/// \brief Push constants del terreno (deben coincidir con \c terrain.vert).
+struct TerrainPushConstants
+{
+    /// Origen del nivel en índices de su rejilla.
+    glm::ivec2 origin {0, 0};
+    /// Origen del nivel más grueso (para la transición).
+    glm::ivec2 coarseOrigin {0, 0};
+    /// Espaciado del nivel (unidades de mundo).
+    float spacing = 1.0f;
+    /// Altura de referencia (Y de mundo).
+    float baseLevel = 0.0f;
+    /// Índice del nivel.
+    uint32_t level = 0;
+    /// 1 si existe un nivel más grueso con el que fundir el borde.
+    uint32_t hasCoarser = 0;
+};
+
+/// \brief Hash entero 2D a [0, 1).
+static float latticeHash(int32_t x, int32_t z)
+{
+    uint32_t h = static_cast<uint32_t>(x) * 374761393u + static_cast<uint32_t>(z) * 668265263u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+
+    return (static_cast<float>(h) * (1.0f / 4294967296.0f));
+}
+
+/// \brief Ruido de valor con interpolación suavizada.
+static float valueNoise(float x, float z)
+{
+    const float fx = std::floor(x);
+    const float fz = std::floor(z);
+    const int32_t ix = static_cast<int32_t>(fx);
+    const int32_t iz = static_cast<int32_t>(fz);
+
+    float tx = x - fx;
+    float tz = z - fz;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+
+    const float h00 = latticeHash(ix, iz);
+    const float h10 = latticeHash(ix + 1, iz);
+    const float h01 = latticeHash(ix, iz + 1);
+    const float h11 = latticeHash(ix + 1, iz + 1);
+
+    const float h0 = h00 + (h10 - h00) * tx;
+    const float h1 = h01 + (h11 - h01) * tx;
+
+    return (h0 + (h1 - h0) * tz);
+}
+
+/// \brief Construye la rejilla, los búferes de alturas y la tubería.
+/// \param device Dispositivo lógico Vulkan.
+/// \param renderPass Render pass donde se dibuja el terreno.
+/// \param globalSetLayout Layout de descriptores global (set 0).
+ClipmapTerrain::ClipmapTerrain(
+    VulkanDevice& device,
+    VkRenderPass renderPass,
+    VkDescriptorSetLayout globalSetLayout)
+    : vulkanDevice{device}
+{
+    createGrid();
+    createHeightBuffers();
+    createPipelineLayout(globalSetLayout);
+    createPipeline(renderPass);
+}
+
+/// \brief Libera recursos asociados.
+ClipmapTerrain::~ClipmapTerrain()
+{
+    vkDestroyPipelineLayout(vulkanDevice.getDevice(), pipelineLayout, nullptr);
+}
+
+/// \brief Altura del terreno (hacia "arriba", -Y) en un punto del plano XZ.
+/// \details Función procedural determinista; alrededor del origen es plana
+/// para no interferir con la escena existente.
+/// \param x Coordenada X de mundo.
+/// \param z Coordenada Z de mundo.
+/// \return Altura sobre \c baseLevel.
+float ClipmapTerrain::heightAt(float x, float z)
+{
+    float height = 0.0f;
+    float amplitude = 6.0f;
+    float frequency = 1.0f / 48.0f;
+
+    for (int octave = 0; octave < 5; ++octave)
+    {
+        height += amplitude * valueNoise(x * frequency, z * frequency);
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    const float distance = std::sqrt(x * x + z * z);
+    const float t = std::clamp((distance - 6.0f) / 18.0f, 0.0f, 1.0f);
+
+    return (height * t * t * (3.0f - 2.0f * t));
+}
+
+/// \brief Crea la rejilla compartida y las variantes de índices.
+void ClipmapTerrain::createGrid()
+{
+    std::vector<glm::vec2> vertices;
+    vertices.reserve(LEVEL_SAMPLES * LEVEL_SAMPLES);
+
+    for (int z = 0; z < LEVEL_SAMPLES; ++z)
+    {
+        for (int x = 0; x < LEVEL_SAMPLES; ++x)
+        {
+            vertices.emplace_back(static_cast<float>(x), static_cast<float>(z));
+        }
+    }
+
+    std::vector<uint32_t> indices;
+
+    auto addCell = [&](int x, int z)
+    {
+        const uint32_t a = static_cast<uint32_t>(z * LEVEL_SAMPLES + x);
+        const uint32_t b = a + 1;
+        const uint32_t c = a + LEVEL_SAMPLES;
+        const uint32_t d = c + 1;
+
+        indices.insert(indices.end(), {a, c, b, b, c, d});
+    };
+
+    fullRange.first = 0;
+
+    for (int z = 0; z < LEVEL_CELLS; ++z)
+    {
+        for (int x = 0; x < LEVEL_CELLS; ++x)
+        {
+            addCell(x, z);
+        }
+    }
+
+    fullRange.count = static_cast<uint32_t>(indices.size());
+
+    // El hueco del nivel fino mide LEVEL_CELLS/2 celdas y empieza a LEVEL_CELLS/4 +-1.
+    const int holeSize = LEVEL_CELLS / 2;
+
+    for (int variantZ = 0; variantZ < 3; ++variantZ)
+    {
+        for (int variantX = 0; variantX < 3; ++variantX)
+        {
+            const int holeX = LEVEL_CELLS / 4 - 1 + variantX;
+            const int holeZ = LEVEL_CELLS / 4 - 1 + variantZ;
+
+            IndexRange& range = ringRanges[variantZ * 3 + variantX];
+            range.first = static_cast<uint32_t>(indices.size());
+
+            for (int z = 0; z < LEVEL_CELLS; ++z)
+            {
+                for (int x = 0; x < LEVEL_CELLS; ++x)
+                {
+                    const bool insideHole =
+                        x >= holeX && x < holeX + holeSize &&
+                        z >= holeZ && z < holeZ + holeSize;
+
+                    if (!insideHole)
+                    {
+                        addCell(x, z);
+                    }
+                }
+            }
+
+            range.count = static_cast<uint32_t>(indices.size()) - range.first;
+        }
+    }
+
+    gridBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(glm::vec2),
+        static_cast<uint32_t>(vertices.size()),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VulkanBuffer gridStaging{
+        vulkanDevice,
+        sizeof(glm::vec2),
+        static_cast<uint32_t>(vertices.size()),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+    gridStaging.map();
+    gridStaging.writeToBuffer(vertices.data());
+
+    vulkanDevice.copyBuffer(
+        gridStaging.getBuffer(),
+        gridBuffer->getBuffer(),
+        sizeof(glm::vec2) * vertices.size());
+
+    indexBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(uint32_t),
+        static_cast<uint32_t>(indices.size()),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VulkanBuffer indexStaging{
+        vulkanDevice,
+        sizeof(uint32_t),
+        static_cast<uint32_t>(indices.size()),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+    indexStaging.map();
+    indexStaging.writeToBuffer(indices.data());
+
+    vulkanDevice.copyBuffer(
+        indexStaging.getBuffer(),
+        indexBuffer->getBuffer(),
+        sizeof(uint32_t) * indices.size());
+}
+
+/// \brief Crea el SSBO de alturas, los staging por frame y su descriptor set.
+void ClipmapTerrain::createHeightBuffers()
+{
+    const uint32_t sampleCount = LEVEL_COUNT * LEVEL_SAMPLES * LEVEL_SAMPLES;
+
+    heightBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(float),
+        sampleCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // Cada staging admite el peor caso (todos los niveles completos, p.ej. en el primer frame).
+    stagingBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+
+    for (std::unique_ptr<VulkanBuffer>& staging : stagingBuffers)
+    {
+        staging = std::make_unique<VulkanBuffer>(
+            vulkanDevice,
+            sizeof(float),
+            sampleCount,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        staging->map();
+    }
+
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings =
+    {
+        {
+            0,
+            VkDescriptorSetLayoutBinding
+            {
+                0,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                nullptr
+            }
+        }
+    };
+
+    setLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, bindings);
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(vulkanDevice, 1, 0, poolSizes);
+
+    VkDescriptorBufferInfo heightInfo = heightBuffer->descriptorInfo();
+
+    DescriptorWriter(*setLayout, *descriptorPool)
+        .writeBuffer(0, &heightInfo)
+        .build(descriptorSet);
+}
+
+/// \brief Crea el pipeline layout.
+/// \param globalSetLayout Layout de descriptores global.
+void ClipmapTerrain::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(TerrainPushConstants);
+
+    std::vector<VkDescriptorSetLayout> sets{globalSetLayout, setLayout->get()};
+
+    VkPipelineLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(sets.size());
+    layoutInfo.pSetLayouts = sets.data();
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &layoutInfo,
+        nullptr,
+        &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+}
+
+/// \brief Crea la tubería gráfica del terreno.
+/// \param renderPass Render pass objetivo.
+void ClipmapTerrain::createPipeline(VkRenderPass renderPass)
+{
+    PipelineConfig pipelineConfig {};
+    GraphicsPipeline::defaultConfig(pipelineConfig);
+
+    pipelineConfig.bindings = {{0, sizeof(glm::vec2), VK_VERTEX_INPUT_RATE_VERTEX}};
+    pipelineConfig.attributes = {{0, 0, VK_FORMAT_R32G32_SFLOAT, 0}};
+    pipelineConfig.renderPass = renderPass;
+    pipelineConfig.layout = pipelineLayout;
+
+    pipeline = std::make_unique<GraphicsPipeline>(
+        vulkanDevice,
+        "shaders/terrain.vert.spv",
+        "shaders/terrain.frag.spv",
+        pipelineConfig);
+}
+
+/// \brief Origen ajustado de un nivel para la posición de cámara dada.
+/// \details Se ajusta al doble del espaciado del nivel para que el nivel fino
+/// quede siempre alineado con los vértices del grueso.
+/// \param level Índice de nivel.
+/// \param cameraPosition Posición de la cámara en mundo.
+glm::ivec2 ClipmapTerrain::levelOrigin(uint32_t level, const glm::vec3& cameraPosition) const
+{
+    const float snap = 2.0f * BASE_SPACING * static_cast<float>(1u << level);
+
+    return (glm::ivec2(
+        2 * static_cast<int>(std::floor(cameraPosition.x / snap + 0.5f)) - LEVEL_CELLS / 2,
+        2 * static_cast<int>(std::floor(cameraPosition.z / snap + 0.5f)) - LEVEL_CELLS / 2));
+}
+
+/// \brief Genera en staging las muestras que faltan de un nivel y sus copias.
+/// \param level Índice de nivel.
+/// \param origin Nuevo origen del nivel.
+/// \param staging Memoria mapeada del staging del frame.
+/// \param written Muestras ya escritas en \c staging (se actualiza).
+void ClipmapTerrain::streamLevel(
+    uint32_t level,
+    const glm::ivec2& origin,
+    float* staging,
+    uint32_t& written)
+{
+    Level& state = levels[level];
+
+    if (state.resident && state.origin == origin)
+    {
+        return;
+    }
+
+    const float spacing = BASE_SPACING * static_cast<float>(1u << level);
+    const VkDeviceSize levelOffset = VkDeviceSize(level) * LEVEL_SAMPLES * LEVEL_SAMPLES;
+
+    auto isResident = [&](int x, int z)
+    {
+        return state.resident &&
+            x >= state.origin.x && x <= state.origin.x + LEVEL_CELLS &&
+            z >= state.origin.y && z <= state.origin.y + LEVEL_CELLS;
+    };
+
+    // Direccionamiento toroidal: la muestra (x, z) siempre ocupa la misma celda de la región.
+    auto wrap = [](int value)
+    {
+        const int remainder = value % LEVEL_SAMPLES;
+        return (remainder < 0) ? remainder + LEVEL_SAMPLES : remainder;
+    };
+
+    for (int z = origin.y; z <= origin.y + LEVEL_CELLS; ++z)
+    {
+        for (int x = origin.x; x <= origin.x + LEVEL_CELLS; ++x)
+        {
+            if (isResident(x, z))
+            {
+                continue;
+            }
+
+            staging[written] = heightAt(static_cast<float>(x) * spacing, static_cast<float>(z) * spacing);
+
+            const VkDeviceSize source = VkDeviceSize(written) * sizeof(float);
+            const VkDeviceSize destination =
+                (levelOffset + VkDeviceSize(wrap(z)) * LEVEL_SAMPLES + wrap(x)) * sizeof(float);
+
+            // Las filas nuevas son contiguas: se fusionan en una sola copia.
+            if (!copyRegions.empty() &&
+                copyRegions.back().srcOffset + copyRegions.back().size == source &&
+                copyRegions.back().dstOffset + copyRegions.back().size == destination)
+            {
+                copyRegions.back().size += sizeof(float);
+            }
+            else
+            {
+                copyRegions.push_back({source, destination, sizeof(float)});
+            }
+
+            written += 1;
+        }
+    }
+
+    state.origin = origin;
+    state.resident = true;
+}
+
+/// \brief Recentra los niveles en la cámara y graba la subida de las regiones nuevas.
+/// \details Debe llamarse fuera del render pass y antes de \c render.
+/// \param frameInfo Contexto del frame.
+void ClipmapTerrain::update(FrameInfo& frameInfo)
+{
+    const glm::vec3 cameraPosition = frameInfo.camera.getPosition();
+    VulkanBuffer& staging = *stagingBuffers[frameInfo.frameIndex];
+    float* stagingData = static_cast<float*>(staging.getMappedMemory());
+
+    copyRegions.clear();
+    uint32_t written = 0;
+
+    for (uint32_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        streamLevel(level, levelOrigin(level, cameraPosition), stagingData, written);
+    }
+
+    streamedSamples = written;
+
+    if (copyRegions.empty())
+    {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+    // Los draws de frames anteriores deben haber terminado de leer las alturas.
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    vkCmdCopyBuffer(
+        commandBuffer,
+        staging.getBuffer(),
+        heightBuffer->getBuffer(),
+        static_cast<uint32_t>(copyRegions.size()),
+        copyRegions.data());
+
+    VkMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+/// \brief Dibuja todos los niveles (un draw indexado por nivel).
+/// \param frameInfo Contexto del frame con el render pass activo.
+void ClipmapTerrain::render(FrameInfo& frameInfo)
+{
+    VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+    pipeline->bind(commandBuffer);
+
+    VkDescriptorSet sets[] = {frameInfo.globalDescriptorSet, descriptorSet};
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipelineLayout,
+        0,
+        2,
+        sets,
+        0,
+        nullptr);
+
+    VkBuffer buffers[] = {gridBuffer->getBuffer()};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+    for (uint32_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        TerrainPushConstants push {};
+        push.origin = levels[level].origin;
+        push.spacing = BASE_SPACING * static_cast<float>(1u << level);
+        push.baseLevel = baseLevel;
+        push.level = level;
+        push.hasCoarser = (level + 1 < LEVEL_COUNT) ? 1u : 0u;
+
+        if (push.hasCoarser)
+        {
+            push.coarseOrigin = levels[level + 1].origin;
+        }
+
+        IndexRange range = fullRange;
+
+        if (level > 0)
+        {
+            // El origen del nivel fino es par: su esquina cae sobre un vértice del grueso.
+            const glm::ivec2 hole = levels[level - 1].origin / 2 - levels[level].origin;
+            const glm::ivec2 variant = hole - glm::ivec2(LEVEL_CELLS / 4 - 1);
+
+            assert(variant.x >= 0 && variant.x < 3 && variant.y >= 0 && variant.y < 3 &&
+                "💥[Vulkan API] Clipmap level is not nested in its parent.");
+
+            range = ringRanges[variant.y * 3 + variant.x];
+        }
+
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT,
+            0,
+            sizeof(TerrainPushConstants),
+            &push);
+
+        vkCmdDrawIndexed(commandBuffer, range.count, 1, range.first, 0, 0);
+    }
+}
@@ -0,0 +1,124 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ClockCalibration.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ClockCalibration.hpp"
+#include "DeviceCapabilities.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+/// \brief Elige el método según el perfil del dispositivo.
+/// \param dev Dispositivo lógico.
+/// \param capabilities Perfil del dispositivo (timestamps, extensión calibrada).
+void ClockCalibration::init(VkDevice dev, const DeviceCapabilities& capabilities)
+{
+    device = dev;
+    periodNs = capabilities.timestampPeriod;
+    domain = capabilities.timestamps ? ClockDomain::Estimated : ClockDomain::None;
+
+    if (!capabilities.timestamps || !capabilities.calibratedTimestamps)
+    {
+        return;
+    }
+
+    // steady_clock es CLOCK_MONOTONIC en Linux y QueryPerformanceCounter en Windows.
+#if defined(__linux__)
+    hostDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#elif defined(_WIN32)
+    LARGE_INTEGER frequency {};
+    QueryPerformanceFrequency(&frequency);
+    hostDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+    hostTickNs = 1.0e9 / double(frequency.QuadPart);
+#else
+    return;
+#endif
+
+    getCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+        vkGetDeviceProcAddr(device, "vkGetCalibratedTimestampsEXT"));
+
+    if (getCalibratedTimestamps && sampleCalibrated())
+    {
+        domain = ClockDomain::Calibrated;
+    }
+    else
+    {
+        std::cout << "[Vulkan API] Calibrated timestamps rejected: estimating the GPU clock offset." << std::endl;
+        getCalibratedTimestamps = nullptr;
+    }
+}
+
+/// \brief Toma una pareja de muestras calibradas.
+/// \return \c false si el driver rechaza la consulta.
+bool ClockCalibration::sampleCalibrated()
+{
+    VkCalibratedTimestampInfoEXT infos[2] {};
+    infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[1].timeDomain = hostDomain;
+
+    uint64_t timestamps[2] = {};
+    uint64_t maxDeviation = 0;
+
+    if (getCalibratedTimestamps(device, 2, infos, timestamps, &maxDeviation) != VK_SUCCESS)
+    {
+        return (false);
+    }
+
+    offsetNs = double(timestamps[1]) * hostTickNs - double(timestamps[0]) * periodNs;
+    deviationNs = double(maxDeviation);
+    hasOffset = true;
+
+    return (true);
+}
+
+/// \brief Actualiza el desfase con el último frame resuelto.
+/// \param gpuEndTick Timestamp final del frame (ticks de dispositivo).
+/// \param observed Instante en que la CPU vio el frame terminado.
+void ClockCalibration::update(uint64_t gpuEndTick, std::chrono::steady_clock::time_point observed)
+{
+    if (domain == ClockDomain::Calibrated)
+    {
+        // Una muestra por frame compensa la deriva entre ambos relojes.
+        sampleCalibrated();
+        return;
+    }
+
+    if (domain != ClockDomain::Estimated)
+    {
+        return;
+    }
+
+    candidates[candidateHead] = hostNs(observed) - double(gpuEndTick) * periodNs;
+    candidateHead = (candidateHead + 1) % ESTIMATE_WINDOW;
+    candidateCount = std::min(candidateCount + 1, ESTIMATE_WINDOW);
+
+    offsetNs = *std::min_element(candidates.begin(), candidates.begin() + candidateCount);
+    hasOffset = true;
+}
+
+/// \brief Nombre legible de un método.
+const char* ClockCalibration::domainName(ClockDomain domain)
+{
+    switch (domain)
+    {
+        case ClockDomain::Calibrated:
+            return ("calibrated");
+
+        case ClockDomain::Estimated:
+            return ("estimated");
+
+        default:
+            return ("none");
+    }
+}
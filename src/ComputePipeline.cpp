@@ -0,0 +1,71 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ComputePipeline.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ComputePipeline.hpp"
+#include "GraphicsPipeline.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+ /// \brief Construye la tubería de cómputo.
+ /// \param device Dispositivo lógico Vulkan.
+ /// \param computePath Ruta del shader de cómputo en SPIR-V (.spv).
+ /// \param layout Pipeline layout (descriptores/constantes) compatible con el shader.
+ComputePipeline::ComputePipeline(
+    VulkanDevice& device,
+    const std::string& computePath,
+    VkPipelineLayout layout)
+    : device{ device }
+{
+    assert(layout != VK_NULL_HANDLE && "💥[Vulkan API] No pipeline layout provided.");
+
+    std::vector<char> code = GraphicsPipeline::loadShader(computePath);
+
+    VkShaderModuleCreateInfo moduleInfo {};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    if (vkCreateShaderModule(device.getDevice(), &moduleInfo, nullptr, &computeModule) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create shader module.");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = layout;
+
+    if (vkCreateComputePipelines(
+        device.getDevice(),
+        VK_NULL_HANDLE,
+        1,
+        &pipelineInfo,
+        nullptr,
+        &pipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create compute pipeline.");
+    }
+}
+
+/// \brief Destruye la \c VkPipeline y el módulo de shader.
+ComputePipeline::~ComputePipeline()
+{
+    vkDestroyShaderModule(device.getDevice(), computeModule, nullptr);
+    vkDestroyPipeline(device.getDevice(), pipeline, nullptr);
+}
+
+/// \brief Enlaza la tubería al \c commandBuffer activo.
+/// \param commandBuffer Command buffer.
+void ComputePipeline::bind(VkCommandBuffer commandBuffer)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+}
@@ -0,0 +1,220 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: DeviceCapabilities.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "DeviceCapabilities.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+/// \brief Inicializa los \c sType y enlaza las estructuras disponibles en \p apiVersion.
+/// \param apiVersion Versión de Vulkan efectiva.
+/// \param features Estructura raíz.
+/// \param vulkan11 Características de Vulkan 1.1.
+/// \param vulkan12 Características de Vulkan 1.2.
+/// \param vulkan13 Características de Vulkan 1.3.
+static void linkFeatureStructs(
+    uint32_t apiVersion,
+    VkPhysicalDeviceFeatures2& features,
+    VkPhysicalDeviceVulkan11Features& vulkan11,
+    VkPhysicalDeviceVulkan12Features& vulkan12,
+    VkPhysicalDeviceVulkan13Features& vulkan13)
+{
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    vulkan11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    vulkan12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    // Las estructuras VkPhysicalDeviceVulkan1XFeatures sólo son válidas a partir de 1.2.
+    if (apiVersion >= VK_API_VERSION_1_2)
+    {
+        features.pNext = &vulkan11;
+        vulkan11.pNext = &vulkan12;
+
+        if (apiVersion >= VK_API_VERSION_1_3)
+        {
+            vulkan12.pNext = &vulkan13;
+        }
+    }
+}
+
+/// \brief Consulta las capacidades de un dispositivo físico.
+/// \param physicalDevice Dispositivo físico.
+/// \param instanceVersion Versión de Vulkan solicitada al crear la instancia.
+/// \return Perfil con las características soportadas.
+DeviceCapabilities DeviceCapabilities::query(VkPhysicalDevice physicalDevice, uint32_t instanceVersion)
+{
+    DeviceCapabilities capabilities {};
+
+    VkPhysicalDeviceProperties properties {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    capabilities.apiVersion = std::min(properties.apiVersion, instanceVersion);
+    capabilities.timestamps = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+    capabilities.timestampPeriod = properties.limits.timestampPeriod;
+    capabilities.maxDrawIndirectCount = properties.limits.maxDrawIndirectCount;
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+
+    for (const VkExtensionProperties& extension : extensions)
+    {
+        if (std::strcmp(extension.extensionName, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0)
+        {
+            capabilities.calibratedTimestamps = true;
+        }
+    }
+
+    VkPhysicalDeviceFeatures2 features {};
+    VkPhysicalDeviceVulkan11Features vulkan11 {};
+    VkPhysicalDeviceVulkan12Features vulkan12 {};
+    VkPhysicalDeviceVulkan13Features vulkan13 {};
+    linkFeatureStructs(capabilities.apiVersion, features, vulkan11, vulkan12, vulkan13);
+
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    const VkPhysicalDeviceFeatures& core = features.features;
+    capabilities.samplerAnisotropy = core.samplerAnisotropy == VK_TRUE;
+    capabilities.multiDrawIndirect = core.multiDrawIndirect == VK_TRUE;
+    capabilities.drawIndirectFirstInstance = core.drawIndirectFirstInstance == VK_TRUE;
+    capabilities.fillModeNonSolid = core.fillModeNonSolid == VK_TRUE;
+    capabilities.shaderInt16 = core.shaderInt16 == VK_TRUE;
+    capabilities.pipelineStatisticsQuery = core.pipelineStatisticsQuery == VK_TRUE;
+
+    if (capabilities.apiVersion >= VK_API_VERSION_1_2)
+    {
+        capabilities.storageBuffer16BitAccess = vulkan11.storageBuffer16BitAccess == VK_TRUE;
+        capabilities.uniformAndStorageBuffer16BitAccess = vulkan11.uniformAndStorageBuffer16BitAccess == VK_TRUE;
+        capabilities.storageInputOutput16 = vulkan11.storageInputOutput16 == VK_TRUE;
+        capabilities.shaderDrawParameters = vulkan11.shaderDrawParameters == VK_TRUE;
+        capabilities.multiview = vulkan11.multiview == VK_TRUE;
+
+        capabilities.timelineSemaphore = vulkan12.timelineSemaphore == VK_TRUE;
+        capabilities.drawIndirectCount = vulkan12.drawIndirectCount == VK_TRUE;
+        capabilities.hostQueryReset = vulkan12.hostQueryReset == VK_TRUE;
+        capabilities.descriptorIndexing = vulkan12.descriptorIndexing == VK_TRUE &&
+            vulkan12.runtimeDescriptorArray == VK_TRUE &&
+            vulkan12.descriptorBindingPartiallyBound == VK_TRUE &&
+            vulkan12.descriptorBindingVariableDescriptorCount == VK_TRUE &&
+            vulkan12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+        capabilities.shaderFloat16 = vulkan12.shaderFloat16 == VK_TRUE;
+        capabilities.shaderInt8 = vulkan12.shaderInt8 == VK_TRUE;
+        capabilities.storageBuffer8BitAccess = vulkan12.storageBuffer8BitAccess == VK_TRUE;
+        capabilities.bufferDeviceAddress = vulkan12.bufferDeviceAddress == VK_TRUE;
+        capabilities.scalarBlockLayout = vulkan12.scalarBlockLayout == VK_TRUE;
+    }
+
+    if (capabilities.apiVersion >= VK_API_VERSION_1_3)
+    {
+        capabilities.synchronization2 = vulkan13.synchronization2 == VK_TRUE;
+        capabilities.dynamicRendering = vulkan13.dynamicRendering == VK_TRUE;
+        capabilities.maintenance4 = vulkan13.maintenance4 == VK_TRUE;
+    }
+
+    return (capabilities);
+}
+
+/// \brief Imprime el perfil y, para cada característica ausente, el camino alternativo.
+/// \param out Flujo de salida.
+void DeviceCapabilities::print(std::ostream& out) const
+{
+    struct Entry
+    {
+        const char* name;
+        bool enabled;
+        const char* fallback;
+    };
+
+    const Entry entries[] =
+    {
+        {"samplerAnisotropy", samplerAnisotropy, nullptr},
+        {"multiDrawIndirect", multiDrawIndirect, "one indirect draw per call"},
+        {"drawIndirectFirstInstance", drawIndirectFirstInstance, nullptr},
+        {"fillModeNonSolid", fillModeNonSolid, "no wireframe debug views"},
+        {"shaderInt16", shaderInt16, nullptr},
+        {"pipelineStatisticsQuery", pipelineStatisticsQuery, nullptr},
+        {"storageBuffer16BitAccess", storageBuffer16BitAccess, "32-bit storage layouts"},
+        {"uniformAndStorageBuffer16BitAccess", uniformAndStorageBuffer16BitAccess, nullptr},
+        {"storageInputOutput16", storageInputOutput16, "32-bit varyings (fp32 shading path)"},
+        {"shaderDrawParameters", shaderDrawParameters, nullptr},
+        {"multiview", multiview, "one pass per view"},
+        {"timelineSemaphore", timelineSemaphore, "per-submit upload fences, no async compute"},
+        {"drawIndirectCount", drawIndirectCount, "CPU-side draw counts"},
+        {"hostQueryReset", hostQueryReset, "queries reset in the command buffer"},
+        {"descriptorIndexing", descriptorIndexing, "fixed-size descriptor sets"},
+        {"shaderFloat16", shaderFloat16, "32-bit shader arithmetic (fp32 shading path)"},
+        {"shaderInt8", shaderInt8, nullptr},
+        {"storageBuffer8BitAccess", storageBuffer8BitAccess, nullptr},
+        {"bufferDeviceAddress", bufferDeviceAddress, nullptr},
+        {"scalarBlockLayout", scalarBlockLayout, nullptr},
+        {"synchronization2", synchronization2, "vkCmdPipelineBarrier"},
+        {"dynamicRendering", dynamicRendering, "render pass objects"},
+        {"maintenance4", maintenance4, nullptr},
+        {"timestamps", timestamps, "no GPU frame times"},
+        {"calibratedTimestamps", calibratedTimestamps, "GPU clock offset estimated on the CPU"}
+    };
+
+    out << "[Vulkan API] Device profile: Vulkan " << VK_API_VERSION_MAJOR(apiVersion) << '.'
+        << VK_API_VERSION_MINOR(apiVersion) << ", maxDrawIndirectCount " << maxDrawIndirectCount << '\n';
+
+    for (const Entry& entry : entries)
+    {
+        out << "  " << std::left << std::setw(36) << entry.name << (entry.enabled ? "on" : "off");
+
+        if (!entry.enabled && entry.fallback)
+        {
+            out << " (fallback: " << entry.fallback << ')';
+        }
+
+        out << '\n';
+    }
+}
+
+/// \brief Rellena y enlaza las estructuras según el perfil.
+/// \param capabilities Características soportadas (todas se habilitan).
+DeviceFeatureChain::DeviceFeatureChain(const DeviceCapabilities& capabilities)
+{
+    linkFeatureStructs(capabilities.apiVersion, features, vulkan11, vulkan12, vulkan13);
+
+    VkPhysicalDeviceFeatures& core = features.features;
+    core.samplerAnisotropy = capabilities.samplerAnisotropy;
+    core.multiDrawIndirect = capabilities.multiDrawIndirect;
+    core.drawIndirectFirstInstance = capabilities.drawIndirectFirstInstance;
+    core.fillModeNonSolid = capabilities.fillModeNonSolid;
+    core.shaderInt16 = capabilities.shaderInt16;
+    core.pipelineStatisticsQuery = capabilities.pipelineStatisticsQuery;
+
+    vulkan11.storageBuffer16BitAccess = capabilities.storageBuffer16BitAccess;
+    vulkan11.uniformAndStorageBuffer16BitAccess = capabilities.uniformAndStorageBuffer16BitAccess;
+    vulkan11.storageInputOutput16 = capabilities.storageInputOutput16;
+    vulkan11.shaderDrawParameters = capabilities.shaderDrawParameters;
+    vulkan11.multiview = capabilities.multiview;
+
+    vulkan12.timelineSemaphore = capabilities.timelineSemaphore;
+    vulkan12.drawIndirectCount = capabilities.drawIndirectCount;
+    vulkan12.hostQueryReset = capabilities.hostQueryReset;
+    vulkan12.descriptorIndexing = capabilities.descriptorIndexing;
+    vulkan12.runtimeDescriptorArray = capabilities.descriptorIndexing;
+    vulkan12.descriptorBindingPartiallyBound = capabilities.descriptorIndexing;
+    vulkan12.descriptorBindingVariableDescriptorCount = capabilities.descriptorIndexing;
+    vulkan12.shaderSampledImageArrayNonUniformIndexing = capabilities.descriptorIndexing;
+    vulkan12.shaderFloat16 = capabilities.shaderFloat16;
+    vulkan12.shaderInt8 = capabilities.shaderInt8;
+    vulkan12.storageBuffer8BitAccess = capabilities.storageBuffer8BitAccess;
+    vulkan12.bufferDeviceAddress = capabilities.bufferDeviceAddress;
+    vulkan12.scalarBlockLayout = capabilities.scalarBlockLayout;
+
+    vulkan13.synchronization2 = capabilities.synchronization2;
+    vulkan13.dynamicRendering = capabilities.dynamicRendering;
+    vulkan13.maintenance4 = capabilities.maintenance4;
+}
@@ -7,12 +7,14 @@
  */
 
 #include "EditorUI.hpp"
+#include "BasicRenderer.hpp"
 #include "Perf.hpp"
 #include <glm/gtc/type_ptr.hpp>
 #include <stdexcept>
 
- /// \brief Constructor por defecto.
-EditorUI::EditorUI()
+ /// \brief Constructor.
+ /// \param visible Si es \c false la ventana se crea oculta (modo headless).
+EditorUI::EditorUI(bool visible) : window{WIDTH, HEIGHT, "Vulkan API", visible}
 {
 }
 
@@ -21,9 +23,28 @@ EditorUI::~EditorUI()
 {
 }
 
-/// \brief Inicializa el backend de ImGui para Vulkan y GLFW.
-/// \details Crea contexto ImGui, configura estilo, inicializa \c ImGui_ImplGlfw
-/// y \c ImGui_ImplVulkan y crea un descriptor pool propio para UI.
+/// \brief Crea el contexto de ImGui, aplica el estilo e inicializa \c ImGui_ImplGlfw.
+/// \details Debe llamarse desde la hebra principal (GLFW) antes de \c buildFonts e \c init.
+void EditorUI::createContext()
+{
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGui::StyleColorsDark();
+
+    ImGui_ImplGlfw_InitForVulkan(this->window.getGLFWwindow(), true);
+}
+
+/// \brief Carga las fuentes del atlas de ImGui.
+/// \details No depende de Vulkan, por lo que puede ejecutarse en una hebra
+/// de trabajo mientras se crea la swapchain.
+void EditorUI::buildFonts()
+{
+    ImGui::GetIO().Fonts->AddFontDefault();
+}
+
+/// \brief Inicializa el backend de ImGui para Vulkan.
+/// \details Crea un descriptor pool propio para UI e inicializa \c ImGui_ImplVulkan.
+/// Requiere haber llamado antes a \c createContext.
 /// \param instance Instancia de Vulkan.
 /// \param physicalDevice Dispositivo fsico empleado por la aplicacin.
 /// \param device Dispositivo lgico (VkDevice).
@@ -39,12 +60,6 @@ void EditorUI::init(VkInstance instance,
     VkRenderPass renderPass,
     uint32_t imageCount)
 {
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGui::StyleColorsDark();
-
-    ImGui_ImplGlfw_InitForVulkan(this->window.getGLFWwindow(), true);
-
     createDescriptorPool(device);
 
     ImGui_ImplVulkan_InitInfo init_info = {};
@@ -54,6 +69,7 @@ void EditorUI::init(VkInstance instance,
     init_info.QueueFamily = graphicsQueueFamily;
     init_info.Queue = graphicsQueue;
     init_info.DescriptorPool = descriptorPool;
+    init_info.RenderPass = renderPass;
     init_info.MinImageCount = imageCount;
     init_info.ImageCount = imageCount;
 
@@ -95,9 +111,18 @@ void EditorUI::createDescriptorPool(VkDevice device)
 /// \brief Comienza un frame de ImGui.
 /// \details Llama a \c ImGui_ImplVulkan_NewFrame, \c ImGui_ImplGlfw_NewFrame
 /// y \c ImGui::NewFrame(). Debe invocarse una vez por frame antes de
-/// construir los paneles.
+/// construir los paneles. En los frames que no toca reconstruir la UI
+/// (ver \c setRefreshInterval) no hace nada.
 void EditorUI::beginFrame()
 {
+    rebuildFrame = (frameCounter % refreshInterval == 0) || ImGui::GetDrawData() == nullptr;
+    frameCounter += 1;
+
+    if (!rebuildFrame)
+    {
+        return;
+    }
+
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -108,6 +133,11 @@ void EditorUI::beginFrame()
 /// \param gameObjects Contenedor de objetos de escena a inspeccionar/editar.
 void EditorUI::drawGameObjects(std::unordered_map<unsigned int, GameObject>& gameObjects)
 {
+    if (!rebuildFrame)
+    {
+        return;
+    }
+
     ImGui::Begin("Objetos de Escena");
 
     for (std::pair<const unsigned int, GameObject>& entry : gameObjects) {
@@ -129,6 +159,20 @@ void EditorUI::drawGameObjects(std::unordered_map<unsigned int, GameObject>& gam
 
     ImGui::End();
 
+    ImGui::Begin("Vista de depuracion");
+
+    for (uint32_t i = 0; i <= static_cast<uint32_t>(DebugView::Bounds); ++i)
+    {
+        const DebugView view = static_cast<DebugView>(i);
+
+        if (ImGui::RadioButton(BasicRenderer::debugViewName(view), debugView == view))
+        {
+            debugView = view;
+        }
+    }
+
+    ImGui::End();
+
     if (perf)
     {
         perf->drawImGui();
@@ -141,8 +185,15 @@ void EditorUI::drawGameObjects(std::unordered_map<unsigned int, GameObject>& gam
 /// \param commandBuffer Command buffer actual (en un render pass activo).
 void EditorUI::endFrame(VkCommandBuffer commandBuffer)
 {
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+    if (rebuildFrame)
+    {
+        ImGui::Render();
+    }
+
+    if (ImDrawData* drawData = ImGui::GetDrawData())
+    {
+        ImGui_ImplVulkan_RenderDrawData(drawData, commandBuffer);
+    }
 }
 
 /// \brief Libera los recursos del backend de ImGui y su descriptor pool.
@@ -0,0 +1,217 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameCapture.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "FrameCapture.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+ /// \brief Cabecera del fichero de captura.
+ /// \details Los tamaños permiten rechazar capturas hechas con otra disposición de
+ /// las estructuras (se escriben tal cual están en memoria).
+struct FrameCaptureHeader
+{
+    uint32_t magic = FrameCapture::MAGIC;
+    uint32_t version = FrameCapture::VERSION;
+    uint32_t uboSize = sizeof(GlobalUbo);
+    uint32_t vertexSize = sizeof(Model::Vertex);
+    uint32_t objectSize = sizeof(CapturedObject);
+    uint32_t halfPrecision = 0;
+    uint32_t modelCount = 0;
+    uint32_t objectCount = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<GlobalUbo>, "GlobalUbo is written as raw bytes.");
+static_assert(std::is_trivially_copyable_v<CapturedObject>, "CapturedObject is written as raw bytes.");
+
+/// \brief Escribe un bloque de bytes (el estado del flujo se comprueba al final).
+template <typename T>
+static void writeRaw(std::ofstream& file, const T* data, size_t count)
+{
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+/// \brief Lee un bloque de bytes; lanza si el fichero se acaba antes.
+template <typename T>
+static void readRaw(std::ifstream& file, T* data, size_t count)
+{
+    file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Truncated frame capture.");
+    }
+}
+
+/// \brief Captura el estado de un frame ya actualizado.
+/// \details Debe llamarse con el dispositivo inactivo (lee las mallas de la GPU).
+/// Omite los objetos dibujados como impostor, que no graba \c BasicRenderer.
+/// \param frameInfo Contexto del frame (objetos y listas de luces ya calculadas).
+/// \param ubo UBO global del frame.
+/// \param halfPrecision Variante de shaders activa en \c BasicRenderer.
+/// \return Captura en memoria.
+FrameCapture FrameCapture::capture(const FrameInfo& frameInfo, const GlobalUbo& ubo, bool halfPrecision)
+{
+    FrameCapture result;
+    result.ubo = ubo;
+    result.halfPrecision = halfPrecision;
+
+    std::unordered_map<const Model*, uint32_t> modelIndices;
+
+    for (const auto& entry : frameInfo.gameObjects)
+    {
+        const GameObject& object = entry.second;
+        const bool drawsMesh = object.model && !object.drawAsImpostor;
+
+        if (!drawsMesh && object.light == nullptr)
+        {
+            continue;
+        }
+
+        CapturedObject captured {};
+        captured.model = NO_MODEL;
+        captured.color = object.color;
+        captured.transform = object.transform;
+        captured.staticGeometry = object.staticGeometry ? 1 : 0;
+
+        if (object.light != nullptr)
+        {
+            captured.hasLight = 1;
+            captured.lightIntensity = object.light->intensity;
+            captured.lightBaked = object.light->baked ? 1 : 0;
+        }
+
+        if (drawsMesh)
+        {
+            auto found = modelIndices.find(object.model.get());
+
+            if (found == modelIndices.end())
+            {
+                found = modelIndices.emplace(object.model.get(), static_cast<uint32_t>(result.models.size())).first;
+                result.models.emplace_back();
+                object.model->readBack(result.models.back());
+            }
+
+            captured.model = found->second;
+        }
+
+        result.objects.push_back(captured);
+    }
+
+    return (result);
+}
+
+/// \brief Guarda la captura en un fichero binario.
+/// \param path Ruta del fichero.
+void FrameCapture::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create frame capture: " + path);
+    }
+
+    FrameCaptureHeader header {};
+    header.halfPrecision = halfPrecision ? 1 : 0;
+    header.modelCount = static_cast<uint32_t>(models.size());
+    header.objectCount = static_cast<uint32_t>(objects.size());
+
+    writeRaw(file, &header, 1);
+    writeRaw(file, &ubo, 1);
+
+    for (const Model::Builder& model : models)
+    {
+        const uint32_t counts[2] =
+        {
+            static_cast<uint32_t>(model.vertices.size()),
+            static_cast<uint32_t>(model.indices.size())
+        };
+
+        writeRaw(file, counts, 2);
+        writeRaw(file, model.vertices.data(), model.vertices.size());
+        writeRaw(file, model.indices.data(), model.indices.size());
+    }
+
+    writeRaw(file, objects.data(), objects.size());
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to write frame capture: " + path);
+    }
+}
+
+/// \brief Carga una captura guardada con \c save.
+/// \param path Ruta del fichero.
+/// \return Captura en memoria.
+FrameCapture FrameCapture::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to open frame capture: " + path);
+    }
+
+    FrameCaptureHeader header {};
+    readRaw(file, &header, 1);
+
+    const FrameCaptureHeader expected {};
+
+    if (header.magic != expected.magic || header.version != expected.version ||
+        header.uboSize != expected.uboSize || header.vertexSize != expected.vertexSize ||
+        header.objectSize != expected.objectSize)
+    {
+        throw std::runtime_error("💥[Vulkan API] Incompatible frame capture: " + path);
+    }
+
+    FrameCapture result;
+    result.halfPrecision = header.halfPrecision != 0;
+    readRaw(file, &result.ubo, 1);
+
+    result.models.resize(header.modelCount);
+
+    for (Model::Builder& model : result.models)
+    {
+        uint32_t counts[2] = {0, 0};
+        readRaw(file, counts, 2);
+
+        model.vertices.resize(counts[0]);
+        model.indices.resize(counts[1]);
+        readRaw(file, model.vertices.data(), model.vertices.size());
+        readRaw(file, model.indices.data(), model.indices.size());
+    }
+
+    result.objects.resize(header.objectCount);
+    readRaw(file, result.objects.data(), result.objects.size());
+
+    for (const CapturedObject& object : result.objects)
+    {
+        if (object.model != NO_MODEL && object.model >= header.modelCount)
+        {
+            throw std::runtime_error("💥[Vulkan API] Invalid model index in frame capture: " + path);
+        }
+    }
+
+    return (result);
+}
+
+/// \brief Número de draws de \c BasicRenderer en la captura.
+uint32_t FrameCapture::getDrawCount() const
+{
+    uint32_t draws = 0;
+
+    for (const CapturedObject& object : objects)
+    {
+        draws += (object.model != NO_MODEL) ? 1 : 0;
+    }
+
+    return (draws);
+}
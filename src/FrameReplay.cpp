@@ -0,0 +1,415 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameReplay.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "FrameReplay.hpp"
+#include "BasicRenderer.hpp"
+#include "LightGrid.hpp"
+#include "Perf.hpp"
+#include "PointLightRenderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+ /// \brief Percentil de una muestra (ordena \c samples).
+ /// \param samples Muestras.
+ /// \param fraction Percentil en [0, 1].
+static float percentile(std::vector<float>& samples, float fraction)
+{
+    if (samples.empty())
+    {
+        return (0.0f);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const size_t index = std::min(samples.size() - 1, size_t(fraction * float(samples.size())));
+
+    return (samples[index]);
+}
+
+/// \brief Reconstruye la escena y crea el destino fuera de pantalla.
+/// \param device Dispositivo lógico Vulkan.
+/// \param capture Captura a reproducir.
+/// \param colorFormat Formato de color de la swapchain.
+/// \param depthFormat Formato de profundidad de la swapchain.
+/// \param extent Tamaño de la imagen.
+FrameReplay::FrameReplay(
+    VulkanDevice& device,
+    const FrameCapture& capture,
+    VkFormat colorFormat,
+    VkFormat depthFormat,
+    VkExtent2D extent)
+    : device{device},
+    ubo{capture.getUbo()},
+    halfPrecision{capture.isHalfPrecision()},
+    colorFormat{colorFormat},
+    depthFormat{depthFormat},
+    extent{extent}
+{
+    std::vector<std::shared_ptr<Model>> models;
+    models.reserve(capture.getModels().size());
+
+    for (const Model::Builder& builder : capture.getModels())
+    {
+        models.push_back(std::make_shared<Model>(device, builder));
+    }
+
+    for (const CapturedObject& captured : capture.getObjects())
+    {
+        GameObject object = GameObject::create();
+        object.color = captured.color;
+        object.transform = captured.transform;
+        object.staticGeometry = captured.staticGeometry != 0;
+
+        if (captured.model != FrameCapture::NO_MODEL)
+        {
+            object.model = models[captured.model];
+        }
+
+        if (captured.hasLight != 0)
+        {
+            object.light = std::make_unique<PointLight>();
+            object.light->intensity = captured.lightIntensity;
+            object.light->baked = captured.lightBaked != 0;
+        }
+
+        const unsigned int id = object.getId();
+        gameObjects.emplace(id, std::move(object));
+    }
+
+    createTarget();
+
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = device.getQueueFamilyIndices().GetGraphicsFamily();
+
+    if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay command pool.");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to allocate replay command buffer.");
+    }
+
+    VkFenceCreateInfo fenceInfo {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(device.getDevice(), &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay fence.");
+    }
+}
+
+/// \brief Libera la escena reconstruida y los recursos de render.
+FrameReplay::~FrameReplay()
+{
+    const VkDevice vkDevice = device.getDevice();
+
+    vkDestroyFence(vkDevice, fence, nullptr);
+    vkDestroyCommandPool(vkDevice, commandPool, nullptr);
+    vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+    vkDestroyImageView(vkDevice, colorView, nullptr);
+    vkDestroyImage(vkDevice, colorImage, nullptr);
+    vkFreeMemory(vkDevice, colorMemory, nullptr);
+    vkDestroyImageView(vkDevice, depthView, nullptr);
+    vkDestroyImage(vkDevice, depthImage, nullptr);
+    vkFreeMemory(vkDevice, depthMemory, nullptr);
+    vkDestroyRenderPass(vkDevice, renderPass, nullptr);
+}
+
+/// \brief Crea el render pass, las imágenes y el framebuffer.
+/// \details El render pass tiene los mismos adjuntos y formatos que el de la
+/// swapchain (es compatible con sus tuberías); el color no se presenta, así que
+/// termina en \c COLOR_ATTACHMENT_OPTIMAL.
+void FrameReplay::createTarget()
+{
+    VkAttachmentDescription colorAttachment {};
+    colorAttachment.format = colorFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkAttachmentDescription depthAttachment {};
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkSubpassDependency dependency {};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+
+    dependency.dstStageMask = dependency.srcStageMask;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+    VkRenderPassCreateInfo renderPassInfo {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+
+    if (vkCreateRenderPass(device.getDevice(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay render pass.");
+    }
+
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {extent.width, extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = colorFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImage, colorMemory);
+
+    imageInfo.format = depthFormat;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthMemory);
+
+    VkImageViewCreateInfo viewInfo {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = colorImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = colorFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &colorView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay color view.");
+    }
+
+    viewInfo.image = depthImage;
+    viewInfo.format = depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &depthView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay depth view.");
+    }
+
+    std::array<VkImageView, 2> views = {colorView, depthView};
+
+    VkFramebufferCreateInfo framebufferInfo {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+    framebufferInfo.pAttachments = views.data();
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    if (vkCreateFramebuffer(device.getDevice(), &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create replay framebuffer.");
+    }
+}
+
+/// \brief Reproduce la captura \c iterations veces.
+/// \param basicRenderer Renderizador de la geometría.
+/// \param pointLightSystem Renderizador de las luces.
+/// \param lightGrid Listas de luces por objeto (se recalculan una vez).
+/// \param uboBuffer UBO global enlazado en \c globalDescriptorSet.
+/// \param globalDescriptorSet Set global del frame 0.
+/// \param iterations Repeticiones a medir.
+/// \return Tiempos medidos.
+FrameReplayResult FrameReplay::run(
+    BasicRenderer& basicRenderer,
+    PointLightSystem& pointLightSystem,
+    LightGrid& lightGrid,
+    VulkanBuffer& uboBuffer,
+    VkDescriptorSet globalDescriptorSet,
+    uint32_t iterations)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    // La cámara sólo se usa para ordenar luces y para la lista de luces de la cámara;
+    // los shaders leen las matrices del UBO capturado.
+    Camera camera;
+    camera.lookAtDirection(glm::vec3(ubo.inverseView[3]), glm::vec3(ubo.inverseView[2]));
+
+    FrameInfo frameInfo{0, 0.0f, commandBuffer, camera, globalDescriptorSet, gameObjects};
+
+    lightGrid.update(frameInfo);
+    uboBuffer.writeToBuffer(&ubo);
+    uboBuffer.flush();
+
+    const bool previousHalfPrecision = basicRenderer.isHalfPrecision();
+    basicRenderer.setHalfPrecision(halfPrecision);
+
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = {0.01f, 0.01f, 0.01f, 1.0f};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    beginInfo.renderPass = renderPass;
+    beginInfo.framebuffer = framebuffer;
+    beginInfo.renderArea.extent = extent;
+    beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    beginInfo.pClearValues = clearValues.data();
+
+    VkViewport viewport {0.0f, 0.0f, float(extent.width), float(extent.height), 0.0f, 1.0f};
+    VkRect2D scissor {{0, 0}, extent};
+
+    VkCommandBufferBeginInfo commandBeginInfo {};
+    commandBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    commandBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkSubmitInfo submitInfo {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    // Un único par de timestamps: cada repetición espera a su fence antes de reutilizarlo.
+    GpuTimer gpuTimer;
+    gpuTimer.init(device.getDevice(), 1, device.getCapabilities());
+
+    std::vector<float> recordMs;
+    std::vector<float> submitMs;
+    std::vector<float> waitMs;
+    std::vector<float> gpuMs;
+    recordMs.reserve(iterations);
+    submitMs.reserve(iterations);
+    waitMs.reserve(iterations);
+    gpuMs.reserve(iterations);
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        const Clock::time_point recordStart = Clock::now();
+
+        vkResetCommandBuffer(commandBuffer, 0);
+        vkBeginCommandBuffer(commandBuffer, &commandBeginInfo);
+        gpuTimer.begin(commandBuffer, 0);
+        vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        basicRenderer.render(frameInfo);
+        pointLightSystem.render(frameInfo);
+
+        vkCmdEndRenderPass(commandBuffer);
+        gpuTimer.end(commandBuffer, 0);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to record replay command buffer.");
+        }
+
+        const Clock::time_point submitStart = Clock::now();
+
+        if (device.submitGraphics(1, &submitInfo, fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to submit replay command buffer.");
+        }
+
+        const Clock::time_point waitStart = Clock::now();
+
+        vkWaitForFences(device.getDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(device.getDevice(), 1, &fence);
+
+        const Clock::time_point end = Clock::now();
+
+        recordMs.push_back(std::chrono::duration<float, std::milli>(submitStart - recordStart).count());
+        submitMs.push_back(std::chrono::duration<float, std::milli>(waitStart - submitStart).count());
+        waitMs.push_back(std::chrono::duration<float, std::milli>(end - waitStart).count());
+
+        double iterationGpuMs = 0.0;
+
+        if (gpuTimer.resolve(0, iterationGpuMs))
+        {
+            gpuMs.push_back(static_cast<float>(iterationGpuMs));
+        }
+    }
+
+    gpuTimer.destroy();
+
+    basicRenderer.setHalfPrecision(previousHalfPrecision);
+
+    FrameReplayResult result {};
+    result.iterations = iterations;
+
+    for (const auto& entry : gameObjects)
+    {
+        result.draws += (entry.second.model != nullptr) ? 1 : 0;
+        result.lights += (entry.second.light != nullptr) ? 1 : 0;
+    }
+
+    result.recordMs = percentile(recordMs, 0.5f);
+    result.recordP99Ms = percentile(recordMs, 0.99f);
+    result.submitMs = percentile(submitMs, 0.5f);
+    result.submitP99Ms = percentile(submitMs, 0.99f);
+    result.fenceWaitMs = percentile(waitMs, 0.5f);
+    result.gpuTimed = !gpuMs.empty();
+    result.gpuMs = percentile(gpuMs, 0.5f);
+    result.gpuP99Ms = percentile(gpuMs, 0.99f);
+
+    return (result);
+}
+
+/// \brief Imprime el resultado en una línea.
+/// \param result Resultado de \c run.
+/// \param out Flujo de salida.
+void FrameReplay::print(const FrameReplayResult& result, std::ostream& out)
+{
+    out << std::fixed << std::setprecision(3)
+        << "[replay] " << result.iterations << " iterations, "
+        << result.draws << " draws, " << result.lights << " lights, record p50 "
+        << result.recordMs << " ms p99 " << result.recordP99Ms << " ms, submit p50 "
+        << result.submitMs << " ms p99 " << result.submitP99Ms << " ms, fence wait p50 "
+        << result.fenceWaitMs << " ms, ";
+
+    if (result.gpuTimed)
+    {
+        out << "gpu p50 " << result.gpuMs << " ms p99 " << result.gpuP99Ms << " ms\n";
+    }
+    else
+    {
+        out << "gpu n/a (no timestamps)\n";
+    }
+}
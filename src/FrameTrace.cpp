@@ -0,0 +1,231 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: FrameTrace.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "FrameTrace.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+/// Identificadores de pista (\c tid) en la traza.
+static constexpr uint32_t CPU_TRACK = 1;
+static constexpr uint32_t GPU_TRACK = 2;
+
+/// \brief Percentil de una lista de valores ordenada.
+static double percentile(const std::vector<double>& sorted, double quantile)
+{
+    if (sorted.empty())
+    {
+        return (0.0);
+    }
+
+    const size_t index = static_cast<size_t>(quantile * static_cast<double>(sorted.size() - 1) + 0.5);
+
+    return (sorted[std::min(index, sorted.size() - 1)]);
+}
+
+/// \brief Escribe un evento completo (\c ph "X") con su frame como argumento.
+static void writeSpan(
+    std::ofstream& file,
+    const char* name,
+    uint32_t track,
+    uint64_t serial,
+    double beginNs,
+    double endNs,
+    double originNs)
+{
+    file << ",\n{\"name\":\"" << name << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track
+        << ",\"ts\":" << (beginNs - originNs) / 1000.0
+        << ",\"dur\":" << std::max(endNs - beginNs, 0.0) / 1000.0
+        << ",\"args\":{\"frame\":" << serial << "}}";
+}
+
+/// \brief Prepara una traza de \p frameCount frames.
+FrameTrace::FrameTrace(uint32_t frameCount) : capacity(std::max(frameCount, 1u))
+{
+    frames.reserve(capacity);
+}
+
+/// \brief Añade las fases de CPU de un frame (se ignora si la traza ya está llena).
+/// \param serial Número de frame.
+/// \param marks Instantes de las fases.
+/// \param counters Contadores del frame.
+void FrameTrace::addFrame(uint64_t serial, const FrameTraceMarks& marks, const TraceCounters& counters)
+{
+    if (frames.size() < capacity)
+    {
+        frames.push_back(makeFrame(serial, marks, counters));
+    }
+}
+
+/// \brief Construye un frame de la traza.
+/// \param serial Número de frame.
+/// \param marks Instantes de las fases.
+/// \param counters Contadores del frame.
+TraceFrame FrameTrace::makeFrame(uint64_t serial, const FrameTraceMarks& marks, const TraceCounters& counters)
+{
+    TraceFrame frame {};
+    frame.serial = serial;
+    frame.acquireNs = ClockCalibration::hostNs(marks.acquire);
+    frame.updateNs = ClockCalibration::hostNs(marks.update);
+    frame.recordNs = ClockCalibration::hostNs(marks.record);
+    frame.submitNs = ClockCalibration::hostNs(marks.submit);
+    frame.endNs = ClockCalibration::hostNs(marks.end);
+    frame.counters = counters;
+
+    return (frame);
+}
+
+/// \brief Asocia el intervalo de GPU a su frame (se ignora si no está en la traza).
+/// \param span Intervalo traducido al reloj de la CPU.
+void FrameTrace::addGpuFrame(const GpuFrameSpan& span)
+{
+    attachGpuFrame(frames, span);
+}
+
+/// \brief Indica si se han grabado todos los frames y sus intervalos de GPU.
+bool FrameTrace::isComplete() const
+{
+    return (frames.size() >= capacity && frames.back().hasGpu);
+}
+
+/// \brief Escribe la traza en formato Chrome Trace Event (JSON).
+/// \param path Ruta del fichero.
+void FrameTrace::write(const std::string& path) const
+{
+    writeFrames(path, frames);
+}
+
+/// \brief Escribe frames en formato Chrome Trace Event (JSON).
+/// \param path Ruta del fichero.
+/// \param frames Frames a escribir, en orden.
+/// \param hitch Frame lento a marcar (opcional).
+void FrameTrace::writeFrames(
+    const std::string& path,
+    const std::vector<TraceFrame>& frames,
+    const HitchRecord* hitch)
+{
+    std::ofstream file(path, std::ios::trunc);
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to open trace file: " + path);
+    }
+
+    const double originNs = frames.empty() ? 0.0 : frames.front().acquireNs;
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << CPU_TRACK
+        << ",\"args\":{\"name\":\"CPU render thread\"}}";
+    file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU_TRACK
+        << ",\"args\":{\"name\":\"GPU graphics queue\"}}";
+
+    for (const TraceFrame& frame : frames)
+    {
+        writeSpan(file, "acquire", CPU_TRACK, frame.serial, frame.acquireNs, frame.updateNs, originNs);
+        writeSpan(file, "update", CPU_TRACK, frame.serial, frame.updateNs, frame.recordNs, originNs);
+        writeSpan(file, "record", CPU_TRACK, frame.serial, frame.recordNs, frame.submitNs, originNs);
+        writeSpan(file, "submit+present", CPU_TRACK, frame.serial, frame.submitNs, frame.endNs, originNs);
+
+        const TraceCounters& counters = frame.counters;
+        const double ts = (frame.endNs - originNs) / 1000.0;
+
+        file << ",\n{\"name\":\"frame ms\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+            << ",\"args\":{\"cpu\":" << counters.cpuFrameMs << ",\"gpu\":" << counters.gpuFrameMs
+            << ",\"blocked\":" << counters.blockedMs << "}}";
+        file << ",\n{\"name\":\"subsystems ms\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+            << ",\"args\":{\"async compute\":" << counters.asyncComputeMs
+            << ",\"light grid\":" << counters.lightGridMs << "}}";
+        file << ",\n{\"name\":\"pending cells\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+            << ",\"args\":{\"cells\":" << counters.pendingCells << "}}";
+
+        if (counters.allocations > 0)
+        {
+            file << ",\n{\"name\":\"allocation\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":"
+                << CPU_TRACK << ",\"ts\":" << ts << ",\"args\":{\"count\":" << counters.allocations
+                << ",\"bytes\":" << counters.allocatedBytes << "}}";
+        }
+
+        if (hitch && hitch->serial == frame.serial)
+        {
+            file << ",\n{\"name\":\"hitch\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":"
+                << CPU_TRACK << ",\"ts\":" << ts << ",\"args\":{\"frame ms\":" << hitch->frameMs
+                << ",\"threshold ms\":" << hitch->thresholdMs << "}}";
+        }
+
+        if (!frame.hasGpu)
+        {
+            continue;
+        }
+
+        writeSpan(file, "gpu frame", GPU_TRACK, frame.serial, frame.gpu.beginNs, frame.gpu.endNs, originNs);
+
+        // Flecha del envío al inicio en GPU: la longitud es la latencia de cola.
+        file << ",\n{\"name\":\"queue\",\"cat\":\"frame\",\"ph\":\"s\",\"id\":" << frame.serial
+            << ",\"pid\":1,\"tid\":" << CPU_TRACK << ",\"ts\":" << (frame.submitNs - originNs) / 1000.0 << '}';
+        file << ",\n{\"name\":\"queue\",\"cat\":\"frame\",\"ph\":\"f\",\"bp\":\"e\",\"id\":" << frame.serial
+            << ",\"pid\":1,\"tid\":" << GPU_TRACK << ",\"ts\":" << (frame.gpu.beginNs - originNs) / 1000.0 << '}';
+    }
+
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to write trace file: " + path);
+    }
+}
+
+/// \brief Imprime latencia de cola, burbujas y método de calibración.
+/// \param clock Correspondencia de relojes usada.
+/// \param out Flujo de salida.
+void FrameTrace::print(const ClockCalibration& clock, std::ostream& out) const
+{
+    std::vector<double> latencyMs;
+    double busyNs = 0.0;
+    double bubbleNs = 0.0;
+    const TraceFrame* previous = nullptr;
+
+    for (const TraceFrame& frame : frames)
+    {
+        if (!frame.hasGpu)
+        {
+            previous = nullptr;
+            continue;
+        }
+
+        // En modo estimado el inicio en GPU puede quedar ligeramente antes del envío.
+        latencyMs.push_back(std::max(frame.gpu.beginNs - frame.submitNs, 0.0) / 1.0e6);
+        busyNs += frame.gpu.endNs - frame.gpu.beginNs;
+
+        if (previous && frame.serial == previous->serial + 1)
+        {
+            bubbleNs += std::max(frame.gpu.beginNs - previous->gpu.endNs, 0.0);
+        }
+
+        previous = &frame;
+    }
+
+    std::sort(latencyMs.begin(), latencyMs.end());
+
+    const double spanNs = busyNs + bubbleNs;
+
+    out << std::fixed << std::setprecision(3) << "[timeline] clock "
+        << ClockCalibration::domainName(clock.getDomain());
+
+    if (clock.getDomain() == ClockDomain::Calibrated)
+    {
+        out << " (deviation " << clock.getDeviationNs() / 1000.0 << " us)";
+    }
+
+    out << ", " << latencyMs.size() << " frames, queue latency p50 " << percentile(latencyMs, 0.5)
+        << " ms / p99 " << percentile(latencyMs, 0.99) << " ms, GPU idle between frames "
+        << std::setprecision(1) << (spanNs > 0.0 ? 100.0 * bubbleNs / spanNs : 0.0) << "%\n";
+}
@@ -10,6 +10,13 @@
 #include "Model.hpp"
 
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+/// Caché de shaders precargados (ruta -> SPIR-V), compartida por todas las tuberías.
+static std::unordered_map<std::string, std::vector<char>> shaderCache;
+/// Protege \c shaderCache frente a precargas concurrentes.
+static std::mutex shaderCacheMutex;
 
  /// \brief Construye la tubería gráfica a partir de rutas de shaders y configuración.
  /// \param device Dispositivo lógico Vulkan.
@@ -57,6 +64,43 @@ std::vector<char> GraphicsPipeline::readFile(const std::string& path)
     return (buffer);
 }
 
+/// \brief Lee un shader SPIR-V y lo guarda en la caché compartida.
+/// \details Permite adelantar la lectura de disco (p.ej., desde una hebra del
+/// arranque) antes de construir la tubería. Es seguro llamarla concurrentemente.
+/// \param path Ruta del shader (misma que se pasará al constructor).
+void GraphicsPipeline::preloadShader(const std::string& path)
+{
+    storeShader(path, readFile(path));
+}
+
+/// \brief Guarda en la caché compartida un shader leído por otra vía (p.ej., \c AssetIO).
+/// \details Es seguro llamarla concurrentemente.
+/// \param path Ruta del shader (misma que se pasará al constructor).
+/// \param code Bytecode SPIR-V.
+void GraphicsPipeline::storeShader(const std::string& path, std::vector<char> code)
+{
+    std::lock_guard<std::mutex> lock(shaderCacheMutex);
+    shaderCache[path] = std::move(code);
+}
+
+/// \brief Devuelve el código de un shader, desde la caché si fue precargado.
+/// \param path Ruta del shader.
+/// \return Bytecode SPIR-V.
+std::vector<char> GraphicsPipeline::loadShader(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(shaderCacheMutex);
+        auto it = shaderCache.find(path);
+
+        if (it != shaderCache.end())
+        {
+            return (it->second);
+        }
+    }
+
+    return (readFile(path));
+}
+
 /// \brief Crea la \c VkPipeline con los módulos de shader y el \c PipelineConfig.
 /// \param vertexPath Ruta del shader de vértices.
 /// \param fragmentPath Ruta del shader de fragmentos.
@@ -69,8 +113,8 @@ void GraphicsPipeline::create(
     assert(config.layout != VK_NULL_HANDLE && "💥[Vulkan API] No pipeline layout provided.");
     assert(config.renderPass != VK_NULL_HANDLE && "💥[Vulkan API] No render pass provided.");
 
-    auto vertexCode = readFile(vertexPath);
-    auto fragmentCode = readFile(fragmentPath);
+    auto vertexCode = loadShader(vertexPath);
+    auto fragmentCode = loadShader(fragmentPath);
 
     createShader(vertexCode, &vertexModule);
     createShader(fragmentCode, &fragmentModule);
@@ -0,0 +1,220 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: HitchDetector.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "HitchDetector.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+
+/// Nanosegundos por segundo.
+static constexpr double NS_PER_SECOND = 1.0e9;
+
+/// \brief Prepara el detector.
+/// \param settings Umbral, ventana y límite de frecuencia.
+HitchDetector::HitchDetector(const HitchSettings& settings) : settings(settings)
+{
+    writer = std::thread(&HitchDetector::writerLoop, this);
+}
+
+/// \brief Vuelca el frame lento pendiente, termina de escribir las trazas encoladas y
+/// detiene la hebra de escritura.
+/// \details Un frame lento cuya ventana posterior aún no se había completado se vuelca
+/// con los frames registrados hasta el cierre.
+HitchDetector::~HitchDetector()
+{
+    if (hasPending)
+    {
+        dump();
+        hasPending = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+}
+
+/// \brief Añade un frame terminado y comprueba si es lento.
+/// \param serial Número de frame.
+/// \param marks Instantes de sus fases.
+/// \param counters Contadores del frame.
+/// \param records Salida: frames lentos volcados, omitidos o incluidos en la traza
+/// de otro (se vacía en cada llamada).
+/// \return \c true si \p records contiene algún frame lento nuevo.
+bool HitchDetector::addFrame(
+    uint64_t serial,
+    const FrameTraceMarks& marks,
+    const TraceCounters& counters,
+    std::vector<HitchRecord>& records)
+{
+    records.clear();
+
+    const TraceFrame frame = FrameTrace::makeFrame(serial, marks, counters);
+    const double previousEndNs = frames.empty() ? 0.0 : frames.back().endNs;
+
+    if (frames.empty())
+    {
+        startNs = frame.endNs;
+    }
+
+    frames.push_back(frame);
+
+    const double keepNs = double(settings.windowSeconds + settings.afterSeconds) * NS_PER_SECOND;
+
+    while (frames.size() > MAX_FRAMES || (frames.size() > 1 && frames.front().endNs < frame.endNs - keepNs))
+    {
+        frames.pop_front();
+    }
+
+    if (settings.thresholdMs > 0.0f)
+    {
+        thresholdMs = settings.thresholdMs;
+    }
+    else if (frames.size() >= MIN_FRAMES)
+    {
+        periods.clear();
+
+        for (size_t i = 1; i < frames.size(); ++i)
+        {
+            periods.push_back(float((frames[i].endNs - frames[i - 1].endNs) / 1.0e6));
+        }
+
+        std::nth_element(periods.begin(), periods.begin() + periods.size() / 2, periods.end());
+        thresholdMs = std::max(settings.relativeThreshold * periods[periods.size() / 2], settings.minimumMs);
+    }
+    else
+    {
+        thresholdMs = 0.0f;
+    }
+
+    // La ventana del pendiente se cierra antes de mirar este frame: si también es lento,
+    // ya entra en el límite de frecuencia del volcado recién encolado.
+    if (hasPending && frame.endNs >= pendingEndNs + double(settings.afterSeconds) * NS_PER_SECOND)
+    {
+        dump();
+        lastDumpNs = frame.endNs;
+        hasPending = false;
+
+        records.push_back(pending);
+    }
+
+    const float periodMs = float((frame.endNs - previousEndNs) / 1.0e6);
+
+    if (previousEndNs > 0.0 && thresholdMs > 0.0f && periodMs > thresholdMs)
+    {
+        HitchRecord hitch {};
+        hitch.timeSeconds = (frame.endNs - startNs) / NS_PER_SECOND;
+        hitch.serial = serial;
+        hitch.frameMs = periodMs;
+        hitch.thresholdMs = thresholdMs;
+
+        const bool coolingDown = lastDumpNs >= 0.0 &&
+            frame.endNs - lastDumpNs < double(settings.cooldownSeconds) * NS_PER_SECOND;
+
+        if (hasPending)
+        {
+            // Dentro de la ventana posterior de otro: aparece en su traza.
+            hitch.tracePath = pending.tracePath;
+            records.push_back(hitch);
+        }
+        else if (coolingDown)
+        {
+            records.push_back(hitch);
+        }
+        else
+        {
+            pending = hitch;
+            pending.tracePath = tracePathOf(hitch);
+            pendingEndNs = frame.endNs;
+            hasPending = true;
+        }
+    }
+
+    return (!records.empty());
+}
+
+/// \brief Ruta de la traza de un frame lento.
+std::string HitchDetector::tracePathOf(const HitchRecord& hitch) const
+{
+    return ((std::filesystem::path(settings.directory) /
+        ("hitch_" + std::to_string(hitch.serial) + ".json")).string());
+}
+
+/// \brief Copia la ventana alrededor de \c pending y la encola para escribirla.
+/// \details En la hebra de render sólo se copian los frames; la serialización y la
+/// escritura a disco se hacen en \c writerLoop.
+void HitchDetector::dump()
+{
+    const double fromNs = pendingEndNs - double(settings.windowSeconds) * NS_PER_SECOND;
+
+    DumpJob job {};
+    job.path = pending.tracePath;
+    job.hitch = pending;
+    job.window.reserve(frames.size());
+
+    for (const TraceFrame& frame : frames)
+    {
+        if (frame.endNs >= fromNs)
+        {
+            job.window.push_back(frame);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+
+    wakeUp.notify_one();
+}
+
+/// \brief Bucle de la hebra de escritura.
+/// \details Al detenerse vacía antes la cola, de modo que no se pierde ninguna traza.
+void HitchDetector::writerLoop()
+{
+    for (;;)
+    {
+        DumpJob job {};
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            wakeUp.wait(lock, [this]
+            {
+                return (stopping || !jobs.empty());
+            });
+
+            if (jobs.empty())
+            {
+                return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        // Un volcado fallido (disco lleno, directorio inexistente) no debe detener el render.
+        try
+        {
+            FrameTrace::writeFrames(job.path, job.window, &job.hitch);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << "[hitch] " << error.what() << '\n';
+        }
+    }
+}
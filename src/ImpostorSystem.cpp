@@ -0,0 +1,719 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ImpostorSystem.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ImpostorSystem.hpp"
+#include "DescriptorWriter.hpp"
+#include "SwapChain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+/// \brief Instancia de impostor en el SSBO (std430, 64 bytes).
+struct ImpostorInstance
+{
+    /// xyz = centro de la esfera envolvente en mundo, w = radio en mundo.
+    glm::vec4 centerRadius {};
+    /// Ejes locales del objeto en mundo (columnas de la rotación, sin escala).
+    glm::vec4 axisX {};
+    glm::vec4 axisY {};
+    glm::vec4 axisZ {};
+};
+
+/// \brief Push constants del horneado (deben coincidir con \c impostor_bake.vert).
+struct ImpostorBakePushConstants
+{
+    /// xyz = centro de la esfera envolvente (local), w = radio.
+    glm::vec4 centerRadius {};
+    /// Eje horizontal de la vista.
+    glm::vec4 right {};
+    /// Eje vertical de la vista ("arriba" de la imagen).
+    glm::vec4 up {};
+    /// Dirección desde el objeto hacia el observador.
+    glm::vec4 direction {};
+};
+
+/// \brief Decodifica una coordenada octaédrica en [0, 1]^2 a una dirección unitaria.
+/// \details Debe coincidir con \c octDecode de \c impostor.vert.
+static glm::vec3 octDecode(glm::vec2 uv)
+{
+    const glm::vec2 f = uv * 2.0f - 1.0f;
+    glm::vec3 n {f.x, f.y, 1.0f - std::abs(f.x) - std::abs(f.y)};
+
+    const float t = std::max(-n.z, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+
+    return (glm::normalize(n));
+}
+
+/// \brief Base de la vista que mira hacia \c direction.
+/// \details Debe coincidir con \c viewBasis de los shaders de impostores.
+static void viewBasis(const glm::vec3& direction, glm::vec3& right, glm::vec3& up)
+{
+    const glm::vec3 upHint = (std::abs(direction.y) > 0.99f) ?
+        glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, -1.0f, 0.0f);
+
+    right = glm::normalize(glm::cross(upHint, direction));
+    up = glm::cross(direction, right);
+}
+
+/// \brief Crea el render pass de horneado, las tuberías y los búferes de instancias.
+/// \param device Dispositivo lógico Vulkan.
+/// \param renderPass Render pass donde se dibujan los impostores.
+/// \param globalSetLayout Layout de descriptores global (set 0).
+ImpostorSystem::ImpostorSystem(
+    VulkanDevice& device,
+    VkRenderPass renderPass,
+    VkDescriptorSetLayout globalSetLayout)
+    : vulkanDevice{device}
+{
+    createBakeTargets();
+    createDescriptors();
+    createPipelineLayouts(globalSetLayout);
+    createPipelines(renderPass);
+}
+
+/// \brief Libera atlas, tuberías y recursos asociados.
+ImpostorSystem::~ImpostorSystem()
+{
+    VkDevice device = vulkanDevice.getDevice();
+
+    for (auto& entry : atlases)
+    {
+        destroyAtlas(*entry.second);
+    }
+
+    vkDestroyPipelineLayout(device, bakeLayout, nullptr);
+    vkDestroyPipelineLayout(device, renderLayout, nullptr);
+    vkDestroySampler(device, sampler, nullptr);
+    vkDestroyRenderPass(device, bakeRenderPass, nullptr);
+    vkDestroyImageView(device, depthView, nullptr);
+    vkDestroyImage(device, depthImage, nullptr);
+    vkFreeMemory(device, depthMemory, nullptr);
+}
+
+/// \brief Crea el render pass de horneado y la imagen de profundidad compartida.
+void ImpostorSystem::createBakeTargets()
+{
+    depthFormat = vulkanDevice.findSupportedFormat(
+        {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+    VkAttachmentDescription colorAttachment {};
+    colorAttachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkAttachmentDescription depthAttachment {};
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    std::array<VkSubpassDependency, 2> dependencies {};
+
+    // Entrada: lecturas previas del atlas (re-horneado) y la profundidad compartida
+    // del horneado anterior.
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // Salida: el atlas se muestrea en el pase principal del mismo frame.
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+
+    VkRenderPassCreateInfo renderPassInfo {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(
+        vulkanDevice.getDevice(),
+        &renderPassInfo,
+        nullptr,
+        &bakeRenderPass) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create render pass.");
+    }
+
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {ATLAS_SIZE, ATLAS_SIZE, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = depthFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    vulkanDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthMemory);
+
+    VkImageViewCreateInfo viewInfo {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = depthImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(vulkanDevice.getDevice(), &viewInfo, nullptr, &depthView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create texture image view.");
+    }
+}
+
+/// \brief Crea el sampler, los layouts, el pool y los búferes de instancias.
+void ImpostorSystem::createDescriptors()
+{
+    VkSamplerCreateInfo samplerInfo {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+
+    if (vkCreateSampler(vulkanDevice.getDevice(), &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create texture sampler.");
+    }
+
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> instanceBindings =
+    {
+        {
+            0,
+            VkDescriptorSetLayoutBinding
+            {
+                0,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                nullptr
+            }
+        }
+    };
+
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> atlasBindings =
+    {
+        {
+            0,
+            VkDescriptorSetLayoutBinding
+            {
+                0,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                1,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
+            }
+        }
+    };
+
+    instanceSetLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, instanceBindings);
+    atlasSetLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, atlasBindings);
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, SwapChain::MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_ATLASES}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(
+        vulkanDevice,
+        SwapChain::MAX_FRAMES_IN_FLIGHT + MAX_ATLASES,
+        0,
+        poolSizes);
+
+    instanceBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    instanceSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+
+    for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        instanceBuffers[i] = std::make_unique<VulkanBuffer>(
+            vulkanDevice,
+            sizeof(ImpostorInstance),
+            MAX_INSTANCES,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        instanceBuffers[i]->map();
+
+        VkDescriptorBufferInfo bufferInfo = instanceBuffers[i]->descriptorInfo();
+
+        DescriptorWriter(*instanceSetLayout, *descriptorPool)
+            .writeBuffer(0, &bufferInfo)
+            .build(instanceSets[i]);
+    }
+}
+
+/// \brief Crea los pipeline layouts de horneado y de render.
+/// \param globalSetLayout Layout de descriptores global.
+void ImpostorSystem::createPipelineLayouts(VkDescriptorSetLayout globalSetLayout)
+{
+    VkPushConstantRange bakeRange {};
+    bakeRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    bakeRange.offset = 0;
+    bakeRange.size = sizeof(ImpostorBakePushConstants);
+
+    VkPipelineLayoutCreateInfo bakeInfo {};
+    bakeInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    bakeInfo.setLayoutCount = 0;
+    bakeInfo.pSetLayouts = nullptr;
+    bakeInfo.pushConstantRangeCount = 1;
+    bakeInfo.pPushConstantRanges = &bakeRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &bakeInfo,
+        nullptr,
+        &bakeLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+
+    std::vector<VkDescriptorSetLayout> renderSets
+    {
+        globalSetLayout,
+        instanceSetLayout->get(),
+        atlasSetLayout->get()
+    };
+
+    VkPipelineLayoutCreateInfo renderInfo {};
+    renderInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    renderInfo.setLayoutCount = static_cast<uint32_t>(renderSets.size());
+    renderInfo.pSetLayouts = renderSets.data();
+    renderInfo.pushConstantRangeCount = 0;
+    renderInfo.pPushConstantRanges = nullptr;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &renderInfo,
+        nullptr,
+        &renderLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+}
+
+/// \brief Crea las tuberías de horneado y de render.
+/// \param renderPass Render pass donde se dibujan los impostores.
+void ImpostorSystem::createPipelines(VkRenderPass renderPass)
+{
+    PipelineConfig bakeConfig {};
+    GraphicsPipeline::defaultConfig(bakeConfig);
+    bakeConfig.renderPass = bakeRenderPass;
+    bakeConfig.layout = bakeLayout;
+
+    bakePipeline = std::make_unique<GraphicsPipeline>(
+        vulkanDevice,
+        "shaders/impostor_bake.vert.spv",
+        "shaders/impostor_bake.frag.spv",
+        bakeConfig);
+
+    PipelineConfig renderConfig {};
+    GraphicsPipeline::defaultConfig(renderConfig);
+    renderConfig.attributes.clear();
+    renderConfig.bindings.clear();
+    renderConfig.renderPass = renderPass;
+    renderConfig.layout = renderLayout;
+
+    renderPipeline = std::make_unique<GraphicsPipeline>(
+        vulkanDevice,
+        "shaders/impostor.vert.spv",
+        "shaders/impostor.frag.spv",
+        renderConfig);
+}
+
+/// \brief Devuelve el atlas de un modelo, creándolo (sin hornear) si no existe.
+/// \param model Modelo a buscar.
+/// \return Atlas o \c nullptr si se ha alcanzado \c MAX_ATLASES.
+ImpostorSystem::Atlas* ImpostorSystem::findOrCreateAtlas(const std::shared_ptr<Model>& model)
+{
+    auto found = atlases.find(model.get());
+
+    if (found != atlases.end())
+    {
+        return (found->second.get());
+    }
+
+    if (atlases.size() >= MAX_ATLASES)
+    {
+        return (nullptr);
+    }
+
+    std::unique_ptr<Atlas> atlas = std::make_unique<Atlas>();
+    atlas->model = model;
+
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {ATLAS_SIZE, ATLAS_SIZE, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    vulkanDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, atlas->image, atlas->memory);
+
+    VkImageViewCreateInfo viewInfo {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = atlas->image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(vulkanDevice.getDevice(), &viewInfo, nullptr, &atlas->view) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create texture image view.");
+    }
+
+    std::array<VkImageView, 2> attachments = {atlas->view, depthView};
+
+    VkFramebufferCreateInfo framebufferInfo {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = bakeRenderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments = attachments.data();
+    framebufferInfo.width = ATLAS_SIZE;
+    framebufferInfo.height = ATLAS_SIZE;
+    framebufferInfo.layers = 1;
+
+    if (vkCreateFramebuffer(
+        vulkanDevice.getDevice(),
+        &framebufferInfo,
+        nullptr,
+        &atlas->framebuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create framebuffer.");
+    }
+
+    VkDescriptorImageInfo atlasInfo {};
+    atlasInfo.sampler = sampler;
+    atlasInfo.imageView = atlas->view;
+    atlasInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    DescriptorWriter(*atlasSetLayout, *descriptorPool)
+        .writeImage(0, &atlasInfo)
+        .build(atlas->descriptorSet);
+
+    Atlas* result = atlas.get();
+    atlases.emplace(model.get(), std::move(atlas));
+
+    return (result);
+}
+
+/// \brief Graba el horneado de las \c GRID x \c GRID vistas de un atlas.
+/// \param commandBuffer Command buffer del frame (fuera de render pass).
+/// \param atlas Atlas destino.
+void ImpostorSystem::bakeAtlas(VkCommandBuffer commandBuffer, Atlas& atlas)
+{
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = {0.0f, 0.0f, 0.0f, 0.0f};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    beginInfo.renderPass = bakeRenderPass;
+    beginInfo.framebuffer = atlas.framebuffer;
+    beginInfo.renderArea.offset = {0, 0};
+    beginInfo.renderArea.extent = {ATLAS_SIZE, ATLAS_SIZE};
+    beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    beginInfo.pClearValues = clearValues.data();
+
+    vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    bakePipeline->bind(commandBuffer);
+    atlas.model->bind(commandBuffer);
+
+    const uint32_t cellSize = ATLAS_SIZE / GRID;
+    const float radius = std::max(atlas.model->getBoundsRadius(), 1e-4f);
+
+    ImpostorBakePushConstants push {};
+    push.centerRadius = glm::vec4(atlas.model->getBoundsCenter(), radius);
+
+    for (uint32_t cellY = 0; cellY < GRID; ++cellY)
+    {
+        for (uint32_t cellX = 0; cellX < GRID; ++cellX)
+        {
+            const glm::vec2 uv
+            {
+                (static_cast<float>(cellX) + 0.5f) / static_cast<float>(GRID),
+                (static_cast<float>(cellY) + 0.5f) / static_cast<float>(GRID)
+            };
+
+            const glm::vec3 direction = octDecode(uv);
+            glm::vec3 right {};
+            glm::vec3 up {};
+            viewBasis(direction, right, up);
+
+            push.right = glm::vec4(right, 0.0f);
+            push.up = glm::vec4(up, 0.0f);
+            push.direction = glm::vec4(direction, 0.0f);
+
+            VkViewport viewport {};
+            viewport.x = static_cast<float>(cellX * cellSize);
+            viewport.y = static_cast<float>(cellY * cellSize);
+            viewport.width = static_cast<float>(cellSize);
+            viewport.height = static_cast<float>(cellSize);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+
+            VkRect2D scissor {};
+            scissor.offset = {static_cast<int32_t>(cellX * cellSize), static_cast<int32_t>(cellY * cellSize)};
+            scissor.extent = {cellSize, cellSize};
+
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+            vkCmdPushConstants(
+                commandBuffer,
+                bakeLayout,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                0,
+                sizeof(ImpostorBakePushConstants),
+                &push);
+
+            atlas.model->draw(commandBuffer);
+        }
+    }
+
+    vkCmdEndRenderPass(commandBuffer);
+
+    atlas.baked = true;
+}
+
+/// \brief Libera los objetos Vulkan de un atlas.
+/// \param atlas Atlas a destruir.
+void ImpostorSystem::destroyAtlas(Atlas& atlas)
+{
+    VkDevice device = vulkanDevice.getDevice();
+
+    vkDestroyFramebuffer(device, atlas.framebuffer, nullptr);
+    vkDestroyImageView(device, atlas.view, nullptr);
+    vkDestroyImage(device, atlas.image, nullptr);
+    vkFreeMemory(device, atlas.memory, nullptr);
+}
+
+/// \brief Fuerza a volver a hornear el atlas de un modelo la próxima vez que se use.
+/// \param model Modelo cuyo atlas ha quedado obsoleto.
+void ImpostorSystem::invalidate(const Model* model)
+{
+    auto found = atlases.find(model);
+
+    if (found != atlases.end())
+    {
+        found->second->baked = false;
+    }
+}
+
+/// \brief Decide qué objetos se dibujan como impostor y hornea los atlas pendientes.
+/// \details Debe llamarse fuera del render pass y antes de grabar la escena.
+/// \param frameInfo Contexto del frame.
+void ImpostorSystem::update(FrameInfo& frameInfo)
+{
+    const glm::vec3 cameraPosition = frameInfo.camera.getPosition();
+    const float enterDistance = settings.switchDistance;
+    const float exitDistance = settings.switchDistance * (1.0f - settings.hysteresis);
+
+    std::vector<std::pair<Atlas*, ImpostorInstance>> visible;
+
+    for (auto& entry : atlases)
+    {
+        entry.second->instanceCount = 0;
+    }
+
+    size_t tracked = 0;
+
+    for (auto& entry : frameInfo.gameObjects)
+    {
+        GameObject& object = entry.second;
+        object.drawAsImpostor = false;
+
+        if (!object.model || !object.allowImpostor)
+        {
+            continue;
+        }
+
+        const glm::mat4 transform = object.transform.matrix();
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(object.model->getBoundsCenter(), 1.0f));
+        const float distance = glm::length(center - cameraPosition);
+        tracked += 1;
+
+        // Histéresis: se entra en el umbral y se sale bastante más cerca.
+        bool& isImpostor = impostorState[entry.first];
+        isImpostor = isImpostor ? (distance > exitDistance) : (distance > enterDistance);
+
+        if (!isImpostor || visible.size() >= MAX_INSTANCES)
+        {
+            continue;
+        }
+
+        Atlas* atlas = findOrCreateAtlas(object.model);
+
+        if (atlas == nullptr)
+        {
+            continue;
+        }
+
+        const glm::vec3 axisX {transform[0]};
+        const glm::vec3 axisY {transform[1]};
+        const glm::vec3 axisZ {transform[2]};
+        const float scale = std::max({glm::length(axisX), glm::length(axisY), glm::length(axisZ)});
+
+        ImpostorInstance instance {};
+        instance.centerRadius = glm::vec4(center, object.model->getBoundsRadius() * scale);
+        instance.axisX = glm::vec4(glm::normalize(axisX), 0.0f);
+        instance.axisY = glm::vec4(glm::normalize(axisY), 0.0f);
+        instance.axisZ = glm::vec4(glm::normalize(axisZ), 0.0f);
+
+        visible.emplace_back(atlas, instance);
+        atlas->instanceCount += 1;
+        object.drawAsImpostor = true;
+    }
+
+    impostorCount = static_cast<uint32_t>(visible.size());
+
+    // Quedan estados de objetos descargados (celdas del streaming) o que ya no admiten
+    // impostor: sólo se recorre el mapa cuando tiene más entradas que las vistas.
+    if (impostorState.size() > tracked)
+    {
+        std::erase_if(impostorState, [&frameInfo](const std::pair<const unsigned int, bool>& state)
+        {
+            const auto found = frameInfo.gameObjects.find(state.first);
+
+            return (found == frameInfo.gameObjects.end() ||
+                !found->second.model || !found->second.allowImpostor);
+        });
+    }
+
+    // Rangos contiguos por atlas para un draw instanciado por atlas.
+    uint32_t firstInstance = 0;
+
+    for (auto& entry : atlases)
+    {
+        Atlas& atlas = *entry.second;
+        atlas.firstInstance = firstInstance;
+        firstInstance += atlas.instanceCount;
+
+        if (atlas.instanceCount > 0 && !atlas.baked)
+        {
+            bakeAtlas(frameInfo.commandBuffer, atlas);
+        }
+
+        atlas.instanceCount = 0;
+    }
+
+    ImpostorInstance* instances =
+        static_cast<ImpostorInstance*>(instanceBuffers[frameInfo.frameIndex]->getMappedMemory());
+
+    for (const std::pair<Atlas*, ImpostorInstance>& item : visible)
+    {
+        instances[item.first->firstInstance + item.first->instanceCount] = item.second;
+        item.first->instanceCount += 1;
+    }
+}
+
+/// \brief Dibuja los impostores del frame (un draw instanciado por atlas).
+/// \param frameInfo Contexto del frame con el render pass activo.
+void ImpostorSystem::render(FrameInfo& frameInfo)
+{
+    if (impostorCount == 0)
+    {
+        return;
+    }
+
+    renderPipeline->bind(frameInfo.commandBuffer);
+
+    VkDescriptorSet sets[] = {frameInfo.globalDescriptorSet, instanceSets[frameInfo.frameIndex]};
+
+    vkCmdBindDescriptorSets(
+        frameInfo.commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        renderLayout,
+        0,
+        2,
+        sets,
+        0,
+        nullptr);
+
+    for (auto& entry : atlases)
+    {
+        const Atlas& atlas = *entry.second;
+
+        if (atlas.instanceCount == 0)
+        {
+            continue;
+        }
+
+        vkCmdBindDescriptorSets(
+            frameInfo.commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            renderLayout,
+            2,
+            1,
+            &atlas.descriptorSet,
+            0,
+            nullptr);
+
+        vkCmdDraw(frameInfo.commandBuffer, 6, atlas.instanceCount, 0, atlas.firstInstance);
+    }
+}
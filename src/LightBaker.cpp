@@ -0,0 +1,762 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: LightBaker.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "LightBaker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+/// Distancia máxima de los rayos de rebote.
+static constexpr float BOUNCE_DISTANCE = 1e30f;
+/// Profundidad máxima de la pila de recorrido de la BVH.
+static constexpr uint32_t TRAVERSAL_STACK = 64;
+/// Intervalo entre informes de progreso.
+static constexpr std::chrono::milliseconds PROGRESS_INTERVAL {250};
+/// Incremento mínimo (en %) para volver a informar del progreso.
+static constexpr uint32_t PROGRESS_STEP = 10;
+
+/// \brief Hash PCG de 32 bits; genera la secuencia aleatoria de cada vértice.
+static uint32_t pcgHash(uint32_t value)
+{
+    const uint32_t state = value * 747796405u + 2891336453u;
+    const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+
+    return ((word >> 22u) ^ word);
+}
+
+/// \brief Siguiente número aleatorio en [0,1).
+static float nextRandom(uint32_t& state)
+{
+    state = pcgHash(state);
+
+    return (static_cast<float>(state >> 8) * (1.0f / 16777216.0f));
+}
+
+/// \brief Dirección con distribución de coseno sobre el hemisferio de \p normal.
+static glm::vec3 cosineSample(const glm::vec3& normal, uint32_t& state)
+{
+    // Base ortonormal sin ramas (Duff et al. 2017).
+    const float sign = std::copysign(1.0f, normal.z);
+    const float a = -1.0f / (sign + normal.z);
+    const float b = normal.x * normal.y * a;
+    const glm::vec3 tangent {1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x};
+    const glm::vec3 bitangent {b, sign + normal.y * normal.y * a, -normal.y};
+
+    const float phi = 6.28318531f * nextRandom(state);
+    const float r2 = nextRandom(state);
+    const float r = std::sqrt(r2);
+
+    return (glm::normalize(
+        tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi)) + normal * std::sqrt(1.0f - r2)));
+}
+
+/// \brief Base de armónicos esféricos reales hasta L2 en la dirección \p d.
+/// \details Mismo orden y constantes que \c sampleProbes en \c simple_shader.frag.
+static void shBasis(const glm::vec3& d, float* y)
+{
+    y[0] = 0.282095f;
+    y[1] = 0.488603f * d.y;
+    y[2] = 0.488603f * d.z;
+    y[3] = 0.488603f * d.x;
+    y[4] = 1.092548f * d.x * d.y;
+    y[5] = 1.092548f * d.y * d.z;
+    y[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+    y[7] = 1.092548f * d.x * d.z;
+    y[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+}
+
+/// \brief Test rayo-caja (slabs).
+/// \return Distancia de entrada, o infinito si el rayo no alcanza la caja antes de \p tMax.
+static float intersectBox(
+    const glm::vec3& origin, const glm::vec3& inverseDirection,
+    const glm::vec3& boundsMin, const glm::vec3& boundsMax, float tMax)
+{
+    const glm::vec3 t0 = (boundsMin - origin) * inverseDirection;
+    const glm::vec3 t1 = (boundsMax - origin) * inverseDirection;
+    const glm::vec3 entry = glm::min(t0, t1);
+    const glm::vec3 leave = glm::max(t0, t1);
+
+    const float enter = std::max(std::max(entry.x, entry.y), std::max(entry.z, 0.0f));
+    const float exit = std::min(std::min(leave.x, leave.y), std::min(leave.z, tMax));
+
+    return ((enter <= exit) ? enter : std::numeric_limits<float>::infinity());
+}
+
+/// \brief Prepara el horneador.
+/// \param settings Muestras, rebote y hebras.
+LightBaker::LightBaker(const LightBakeSettings& settings) : settings(settings)
+{
+}
+
+/// \brief Añade una luz estática.
+/// \param light Luz a hornear.
+void LightBaker::addLight(const BakeLight& light)
+{
+    lights.push_back(light);
+}
+
+/// \brief Hornea la iluminación de \p targets en la irradiancia de sus vértices.
+/// \details Todas las mallas bloquean la luz y la reciben. Se guarda la irradiancia
+/// E de las luces horneadas en \c rgb y la oclusión ambiental en \c a;
+/// \c simple_shader.frag calcula <tt>albedo * (ambiente * AO + E + luces dinámicas)</tt>,
+/// así que las luces dinámicas se suman sin quedar escaladas por lo horneado. El
+/// color de los vértices (el albedo) no cambia.
+/// \param targets Mallas estáticas (se modifican).
+/// \param progress Flujo donde se informa del avance.
+/// \return Estadísticas del horneado.
+const LightBakeStats& LightBaker::bake(std::vector<BakeTarget>& targets, std::ostream& progress)
+{
+    using Clock = std::chrono::steady_clock;
+
+    stats = {};
+    stats.lights = static_cast<uint32_t>(lights.size());
+
+    // Vértices en mundo de todas las mallas; sus colores son el albedo del rebote.
+    struct BakeVertex
+    {
+        glm::vec3 position {};
+        glm::vec3 normal {};
+        Model::Vertex* target = nullptr;
+    };
+
+    std::vector<BakeVertex> vertices;
+    triangles.clear();
+
+    const Clock::time_point buildStart = Clock::now();
+
+    for (BakeTarget& target : targets)
+    {
+        const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(target.transform)));
+        std::vector<Model::Vertex>& source = target.builder->vertices;
+        const size_t first = vertices.size();
+
+        for (Model::Vertex& vertex : source)
+        {
+            BakeVertex baked {};
+            baked.position = glm::vec3(target.transform * glm::vec4(vertex.position, 1.0f));
+            baked.normal = normalMatrix * vertex.normal;
+            baked.target = &vertex;
+
+            const float length = glm::length(baked.normal);
+            baked.normal = (length > 0.0f) ? baked.normal / length : glm::vec3(0.0f, -1.0f, 0.0f);
+
+            vertices.push_back(baked);
+        }
+
+        const std::vector<uint32_t>& indices = target.builder->indices;
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const BakeVertex& a = vertices[first + indices[i]];
+            const BakeVertex& b = vertices[first + indices[i + 1]];
+            const BakeVertex& c = vertices[first + indices[i + 2]];
+
+            Triangle triangle {};
+            triangle.v0 = a.position;
+            triangle.edge1 = b.position - a.position;
+            triangle.edge2 = c.position - a.position;
+            triangle.albedo = (a.target->color + b.target->color + c.target->color) / 3.0f;
+
+            triangles.push_back(triangle);
+        }
+    }
+
+    buildBvh();
+
+    stats.vertices = static_cast<uint32_t>(vertices.size());
+    stats.triangles = static_cast<uint32_t>(triangles.size());
+    stats.nodes = static_cast<uint32_t>(nodes.size());
+    stats.buildMs = std::chrono::duration<float, std::milli>(Clock::now() - buildStart).count();
+
+    if (vertices.empty())
+    {
+        return (stats);
+    }
+
+    // Desplazamiento de los rayos proporcional al tamaño de la escena.
+    if (!nodes.empty())
+    {
+        rayEpsilon = std::max(1e-5f, 1e-4f * glm::length(nodes[0].boundsMax - nodes[0].boundsMin));
+    }
+
+    const Clock::time_point bakeStart = Clock::now();
+
+    stats.rays += parallelFor(static_cast<uint32_t>(vertices.size()), CHUNK_VERTICES, "vertices", progress,
+        [&](uint32_t i, uint64_t& rays)
+    {
+        const BakeVertex& vertex = vertices[i];
+        vertex.target->setIrradiance(bakeVertex(vertex.position, vertex.normal, pcgHash(i), rays));
+    });
+
+    stats.bakeMs = std::chrono::duration<float, std::milli>(Clock::now() - bakeStart).count();
+
+    return (stats);
+}
+
+/// \brief Hornea la irradiancia de una rejilla de sondas en armónicos esféricos L2.
+/// \details Debe llamarse después de \c bake, cuya BVH y luces reutiliza. Cada sonda
+/// proyecta en SH la luz directa de las luces visibles (con rayos de sombra) y la
+/// reflejada por la geometría estática (muestras uniformes sobre la esfera, con
+/// <tt>albedo * E</tt> en el punto alcanzado), y la convoluciona con el coseno.
+/// \param origin Posición de la primera sonda.
+/// \param spacing Distancia entre sondas en cada eje.
+/// \param resolution Sondas por eje.
+/// \param coefficients Salida: \c PROBE_COEFFICIENTS por sonda (RGB en xyz), con el
+/// índice <tt>x + resolution.x * (y + resolution.y * z)</tt>.
+/// \param progress Flujo donde se informa del avance.
+/// \return Estadísticas del horneado.
+const LightBakeStats& LightBaker::bakeProbes(
+    const glm::vec3& origin,
+    const glm::vec3& spacing,
+    const glm::uvec3& resolution,
+    std::vector<glm::vec4>& coefficients,
+    std::ostream& progress)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const uint32_t probeCount = resolution.x * resolution.y * resolution.z;
+    coefficients.assign(size_t(probeCount) * PROBE_COEFFICIENTS, glm::vec4(0.0f));
+
+    stats.probes = probeCount;
+
+    const Clock::time_point start = Clock::now();
+
+    stats.rays += parallelFor(probeCount, CHUNK_PROBES, "probes", progress, [&](uint32_t probe, uint64_t& rays)
+    {
+        const glm::uvec3 cell {
+            probe % resolution.x, (probe / resolution.x) % resolution.y, probe / (resolution.x * resolution.y)};
+        const glm::vec3 position = origin + spacing * glm::vec3(cell);
+
+        glm::vec3 sh[PROBE_COEFFICIENTS] {};
+        float basis[PROBE_COEFFICIENTS];
+
+        // Luces visibles desde la sonda: deltas de radiancia.
+        for (const BakeLight& light : lights)
+        {
+            const glm::vec3 toLight = light.position - position;
+            const float distanceSq = glm::dot(toLight, toLight);
+            const float rangeSq = light.range * light.range;
+
+            if (distanceSq >= rangeSq || distanceSq <= 0.0f)
+            {
+                continue;
+            }
+
+            const float distance = std::sqrt(distanceSq);
+            const glm::vec3 direction = toLight / distance;
+
+            rays += 1;
+
+            if (trace(position, direction, distance - rayEpsilon, nullptr))
+            {
+                continue;
+            }
+
+            const float ratio = distanceSq / rangeSq;
+            const float window = std::clamp(1.0f - ratio * ratio, 0.0f, 1.0f);
+            const glm::vec3 radiance = light.color * (light.intensity * window * window / distanceSq);
+
+            shBasis(direction, basis);
+
+            for (uint32_t k = 0; k < PROBE_COEFFICIENTS; ++k)
+            {
+                sh[k] += radiance * basis[k];
+            }
+        }
+
+        // Un rebote en la geometría estática. Con muestras uniformes el estimador de
+        // (1/pi) * integral de L * Y es (4 / N) * suma de L * Y.
+        if (settings.probeSamples > 0)
+        {
+            uint32_t state = pcgHash(probe ^ 0x9e3779b9u);
+            const float weight = 4.0f / static_cast<float>(settings.probeSamples);
+
+            for (uint32_t s = 0; s < settings.probeSamples; ++s)
+            {
+                const float z = 1.0f - 2.0f * nextRandom(state);
+                const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                const float phi = 6.28318531f * nextRandom(state);
+                const glm::vec3 direction {r * std::cos(phi), r * std::sin(phi), z};
+
+                Hit hit {};
+                rays += 1;
+
+                if (!trace(position, direction, BOUNCE_DISTANCE, &hit))
+                {
+                    continue;
+                }
+
+                const Triangle& triangle = triangles[hit.triangle];
+                glm::vec3 hitNormal = glm::normalize(glm::cross(triangle.edge1, triangle.edge2));
+
+                if (glm::dot(hitNormal, direction) > 0.0f)
+                {
+                    hitNormal = -hitNormal;
+                }
+
+                const glm::vec3 hitPoint = position + direction * hit.t + hitNormal * rayEpsilon;
+                const glm::vec3 radiance = triangle.albedo * directLight(hitPoint, hitNormal, rays);
+
+                shBasis(direction, basis);
+
+                for (uint32_t k = 0; k < PROBE_COEFFICIENTS; ++k)
+                {
+                    sh[k] += radiance * (basis[k] * weight);
+                }
+            }
+        }
+
+        // Convolución con el coseno recortado (Ramamoorthi y Hanrahan 2001).
+        glm::vec4* out = coefficients.data() + size_t(probe) * PROBE_COEFFICIENTS;
+
+        for (uint32_t k = 0; k < PROBE_COEFFICIENTS; ++k)
+        {
+            const float band = (k == 0) ? 3.14159265f : (k < 4) ? 2.09439510f : 0.78539816f;
+            out[k] = glm::vec4(sh[k] * band, 0.0f);
+        }
+    });
+
+    stats.probeMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+    return (stats);
+}
+
+/// \brief Imprime las estadísticas (incluidos rayos por segundo).
+/// \param stats Resultado de \c bake (y \c bakeProbes).
+/// \param out Flujo de salida.
+void LightBaker::print(const LightBakeStats& stats, std::ostream& out)
+{
+    const double seconds = (stats.bakeMs + stats.probeMs) / 1000.0;
+    const double raysPerSecond = (seconds > 0.0) ? static_cast<double>(stats.rays) / seconds : 0.0;
+
+    out << "[bake] " << stats.vertices << " vertices, " << stats.triangles << " triangles, "
+        << stats.nodes << " BVH nodes, " << stats.lights << " lights, " << stats.threads << " threads\n";
+
+    out << std::fixed << std::setprecision(2)
+        << "[bake] BVH " << stats.buildMs << " ms, bake " << stats.bakeMs << " ms, ";
+
+    if (stats.probes > 0)
+    {
+        out << stats.probes << " probes " << stats.probeMs << " ms, ";
+    }
+
+    out << stats.rays << " rays (" << raysPerSecond / 1e6 << " Mrays/s)\n";
+}
+
+/// \brief Reparte \p count elementos entre las hebras en tareas de \p chunk.
+/// \details Las hebras toman tareas de un contador atómico; la hebra llamante sólo
+/// informa del avance cada \c PROGRESS_STEP %.
+/// \param count Elementos a procesar.
+/// \param chunk Elementos por tarea.
+/// \param label Nombre de la fase en los mensajes de avance.
+/// \param progress Flujo donde se informa del avance.
+/// \param work Trabajo de un elemento; recibe su índice y el contador de rayos de la hebra.
+/// \return Rayos lanzados en total.
+uint64_t LightBaker::parallelFor(
+    uint32_t count,
+    uint32_t chunk,
+    const char* label,
+    std::ostream& progress,
+    const std::function<void(uint32_t, uint64_t&)>& work)
+{
+    const uint32_t threadCount = std::max(1u,
+        (settings.threads != 0) ? settings.threads : std::thread::hardware_concurrency());
+    const uint32_t chunkCount = (count + chunk - 1) / chunk;
+
+    stats.threads = threadCount;
+
+    std::atomic<uint32_t> nextChunk {0};
+    std::atomic<uint32_t> done {0};
+    std::vector<uint64_t> rays(threadCount, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+
+    for (uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            uint64_t traced = 0;
+
+            for (uint32_t task = nextChunk++; task < chunkCount; task = nextChunk++)
+            {
+                const uint32_t begin = task * chunk;
+                const uint32_t end = std::min(count, begin + chunk);
+
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    work(i, traced);
+                }
+
+                done += end - begin;
+            }
+
+            rays[t] = traced;
+        });
+    }
+
+    uint32_t reported = 0;
+
+    while (done.load() < count)
+    {
+        std::this_thread::sleep_for(PROGRESS_INTERVAL);
+
+        const uint32_t percent = static_cast<uint32_t>(uint64_t(done.load()) * 100 / count);
+
+        if (percent >= reported + PROGRESS_STEP && percent < 100)
+        {
+            reported = percent - percent % PROGRESS_STEP;
+            progress << "[bake] " << label << ' ' << std::setw(3) << reported << "%\n" << std::flush;
+        }
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    progress << "[bake] " << label << " 100%\n";
+
+    uint64_t total = 0;
+
+    for (uint64_t traced : rays)
+    {
+        total += traced;
+    }
+
+    return (total);
+}
+
+/// \brief Construye la BVH sobre \c triangles.
+void LightBaker::buildBvh()
+{
+    nodes.clear();
+
+    if (triangles.empty())
+    {
+        return;
+    }
+
+    std::vector<glm::vec3> centroids(triangles.size());
+    std::vector<uint32_t> order(triangles.size());
+
+    for (size_t i = 0; i < triangles.size(); ++i)
+    {
+        const Triangle& triangle = triangles[i];
+        centroids[i] = triangle.v0 + (triangle.edge1 + triangle.edge2) / 3.0f;
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    nodes.reserve(2 * triangles.size());
+
+    Node root {};
+    root.leftOrFirst = 0;
+    root.count = static_cast<uint32_t>(triangles.size());
+    nodes.push_back(root);
+
+    subdivide(0, centroids, order);
+
+    // Los triángulos de cada hoja quedan contiguos.
+    std::vector<Triangle> sorted;
+    sorted.reserve(triangles.size());
+
+    for (uint32_t index : order)
+    {
+        sorted.push_back(triangles[index]);
+    }
+
+    triangles = std::move(sorted);
+}
+
+/// \brief Subdivide un nodo y, recursivamente, sus hijos.
+/// \param index Nodo a subdividir (ya con su rango de \p order).
+/// \param centroids Centroides de los triángulos.
+/// \param order Índices de los triángulos, que se reordenan por hojas.
+void LightBaker::subdivide(uint32_t index, const std::vector<glm::vec3>& centroids, std::vector<uint32_t>& order)
+{
+    const uint32_t first = nodes[index].leftOrFirst;
+    const uint32_t count = nodes[index].count;
+
+    glm::vec3 boundsMin {std::numeric_limits<float>::max()};
+    glm::vec3 boundsMax {-std::numeric_limits<float>::max()};
+    glm::vec3 centroidMin = boundsMin;
+    glm::vec3 centroidMax = boundsMax;
+
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const Triangle& triangle = triangles[order[i]];
+
+        for (const glm::vec3& corner : {triangle.v0, triangle.v0 + triangle.edge1, triangle.v0 + triangle.edge2})
+        {
+            boundsMin = glm::min(boundsMin, corner);
+            boundsMax = glm::max(boundsMax, corner);
+        }
+
+        centroidMin = glm::min(centroidMin, centroids[order[i]]);
+        centroidMax = glm::max(centroidMax, centroids[order[i]]);
+    }
+
+    nodes[index].boundsMin = boundsMin;
+    nodes[index].boundsMax = boundsMax;
+
+    const glm::vec3 extent = centroidMax - centroidMin;
+    const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z) ? 1 : 2;
+
+    // Hoja si hay pocos triángulos o todos comparten centroide.
+    if (count <= LEAF_TRIANGLES || extent[axis] <= 0.0f)
+    {
+        return;
+    }
+
+    const uint32_t half = count / 2;
+
+    std::nth_element(
+        order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+        [&](uint32_t a, uint32_t b)
+        {
+            return (centroids[a][axis] < centroids[b][axis]);
+        });
+
+    const uint32_t left = static_cast<uint32_t>(nodes.size());
+
+    Node leftNode {};
+    leftNode.leftOrFirst = first;
+    leftNode.count = half;
+
+    Node rightNode {};
+    rightNode.leftOrFirst = first + half;
+    rightNode.count = count - half;
+
+    nodes.push_back(leftNode);
+    nodes.push_back(rightNode);
+
+    nodes[index].leftOrFirst = left;
+    nodes[index].count = 0;
+
+    subdivide(left, centroids, order);
+    subdivide(left + 1, centroids, order);
+}
+
+/// \brief Recorre la BVH con un rayo.
+/// \param origin Origen del rayo.
+/// \param direction Dirección (normalizada).
+/// \param tMax Distancia máxima.
+/// \param hit Salida de la intersección más cercana; si es nulo basta con la primera.
+/// \return \c true si el rayo alcanza algún triángulo antes de \p tMax.
+bool LightBaker::trace(const glm::vec3& origin, const glm::vec3& direction, float tMax, Hit* hit) const
+{
+    if (nodes.empty())
+    {
+        return (false);
+    }
+
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    bool found = false;
+
+    uint32_t stack[TRAVERSAL_STACK];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = nodes[stack[--top]];
+
+        if (intersectBox(origin, inverseDirection, node.boundsMin, node.boundsMax, tMax) ==
+            std::numeric_limits<float>::infinity())
+        {
+            continue;
+        }
+
+        if (node.count == 0)
+        {
+            // El hijo más cercano se visita primero para acotar antes tMax.
+            uint32_t nearChild = node.leftOrFirst;
+            uint32_t farChild = node.leftOrFirst + 1;
+
+            const float nearT = intersectBox(
+                origin, inverseDirection, nodes[nearChild].boundsMin, nodes[nearChild].boundsMax, tMax);
+            const float farT = intersectBox(
+                origin, inverseDirection, nodes[farChild].boundsMin, nodes[farChild].boundsMax, tMax);
+
+            if (farT < nearT)
+            {
+                std::swap(nearChild, farChild);
+            }
+
+            stack[top++] = farChild;
+            stack[top++] = nearChild;
+            continue;
+        }
+
+        for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i)
+        {
+            // Möller-Trumbore.
+            const Triangle& triangle = triangles[i];
+            const glm::vec3 p = glm::cross(direction, triangle.edge2);
+            const float determinant = glm::dot(triangle.edge1, p);
+
+            if (std::abs(determinant) < 1e-12f)
+            {
+                continue;
+            }
+
+            const float inverse = 1.0f / determinant;
+            const glm::vec3 s = origin - triangle.v0;
+            const float u = glm::dot(s, p) * inverse;
+
+            if (u < 0.0f || u > 1.0f)
+            {
+                continue;
+            }
+
+            const glm::vec3 q = glm::cross(s, triangle.edge1);
+            const float v = glm::dot(direction, q) * inverse;
+
+            if (v < 0.0f || u + v > 1.0f)
+            {
+                continue;
+            }
+
+            const float t = glm::dot(triangle.edge2, q) * inverse;
+
+            if (t <= 0.0f || t >= tMax)
+            {
+                continue;
+            }
+
+            if (hit == nullptr)
+            {
+                return (true);
+            }
+
+            tMax = t;
+            hit->t = t;
+            hit->triangle = i;
+            found = true;
+        }
+    }
+
+    return (found);
+}
+
+/// \brief Irradiancia directa de las luces estáticas, con rayos de sombra.
+/// \param position Punto en mundo.
+/// \param normal Normal en mundo (normalizada).
+/// \param rays Contador de rayos de la hebra.
+/// \return Irradiancia (misma escala que \c simple_shader.frag).
+glm::vec3 LightBaker::directLight(const glm::vec3& position, const glm::vec3& normal, uint64_t& rays) const
+{
+    glm::vec3 irradiance {0.0f};
+    const glm::vec3 origin = position + normal * rayEpsilon;
+
+    for (const BakeLight& light : lights)
+    {
+        const glm::vec3 toLight = light.position - position;
+        const float distanceSq = glm::dot(toLight, toLight);
+        const float rangeSq = light.range * light.range;
+
+        if (distanceSq >= rangeSq || distanceSq <= 0.0f)
+        {
+            continue;
+        }
+
+        const float distance = std::sqrt(distanceSq);
+        const glm::vec3 direction = toLight / distance;
+        const float NdotL = glm::dot(normal, direction);
+
+        if (NdotL <= 0.0f)
+        {
+            continue;
+        }
+
+        rays += 1;
+
+        if (trace(origin, direction, distance - rayEpsilon, nullptr))
+        {
+            continue;
+        }
+
+        // Misma atenuación que simple_shader.frag.
+        const float ratio = distanceSq / rangeSq;
+        const float window = std::clamp(1.0f - ratio * ratio, 0.0f, 1.0f);
+        const float attenuation = window * window / distanceSq;
+
+        irradiance += light.color * (light.intensity * attenuation * NdotL);
+    }
+
+    return (irradiance);
+}
+
+/// \brief Irradiancia que se guarda en un vértice.
+/// \param position Punto en mundo.
+/// \param normal Normal en mundo (normalizada).
+/// \param seed Semilla del vértice (resultado reproducible).
+/// \param rays Contador de rayos de la hebra.
+/// \return Irradiancia E (\c rgb) y oclusión ambiental (\c a).
+glm::vec4 LightBaker::bakeVertex(const glm::vec3& position, const glm::vec3& normal, uint32_t seed, uint64_t& rays) const
+{
+    uint32_t state = seed;
+    const glm::vec3 origin = position + normal * rayEpsilon;
+
+    float occlusion = 1.0f;
+
+    if (settings.ambientOcclusion && settings.aoSamples > 0)
+    {
+        uint32_t open = 0;
+
+        for (uint32_t s = 0; s < settings.aoSamples; ++s)
+        {
+            if (!trace(origin, cosineSample(normal, state), settings.aoDistance, nullptr))
+            {
+                open += 1;
+            }
+        }
+
+        rays += settings.aoSamples;
+        occlusion = static_cast<float>(open) / static_cast<float>(settings.aoSamples);
+    }
+
+    glm::vec3 irradiance = directLight(position, normal, rays);
+
+    if (settings.bounce && settings.bounceSamples > 0)
+    {
+        // Con muestras de coseno la irradiancia reflejada por superficies lambertianas es
+        // la media de albedo * E en los puntos alcanzados.
+        glm::vec3 indirect {0.0f};
+
+        for (uint32_t s = 0; s < settings.bounceSamples; ++s)
+        {
+            const glm::vec3 direction = cosineSample(normal, state);
+            Hit hit {};
+
+            if (!trace(origin, direction, BOUNCE_DISTANCE, &hit))
+            {
+                continue;
+            }
+
+            const Triangle& triangle = triangles[hit.triangle];
+            glm::vec3 hitNormal = glm::normalize(glm::cross(triangle.edge1, triangle.edge2));
+
+            if (glm::dot(hitNormal, direction) > 0.0f)
+            {
+                hitNormal = -hitNormal;
+            }
+
+            indirect += triangle.albedo * directLight(origin + direction * hit.t, hitNormal, rays);
+        }
+
+        rays += settings.bounceSamples;
+        irradiance += indirect / static_cast<float>(settings.bounceSamples);
+    }
+
+    return (glm::vec4(irradiance, occlusion));
+}
@@ -0,0 +1,372 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: LightGrid.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "LightGrid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/// Distancia mínima al cuadrado al puntuar una luz: las que quedan dentro de la esfera
+/// del objeto no deben tener influencia infinita.
+static constexpr float MIN_SCORE_DISTANCE_SQ = 0.01f;
+
+/// \brief Número de celdas entre dos esquinas (inclusive).
+static uint64_t cellsBetween(const glm::ivec3& lo, const glm::ivec3& hi)
+{
+    return (uint64_t(int64_t(hi.x) - lo.x + 1) *
+        uint64_t(int64_t(hi.y) - lo.y + 1) *
+        uint64_t(int64_t(hi.z) - lo.z + 1));
+}
+
+/// \brief Crea los SSBO de luces y de listas de cada frame en vuelo.
+/// \param device Dispositivo lógico Vulkan.
+/// \param framesInFlight Nº de frames en vuelo.
+/// \param settings Parámetros de la rejilla.
+LightGrid::LightGrid(VulkanDevice& device, uint32_t framesInFlight, const LightGridSettings& settings)
+    : settings{settings}
+{
+    setMaxLightsPerObject(settings.maxLightsPerObject);
+
+    lightBuffers.resize(framesInFlight);
+    listBuffers.resize(framesInFlight);
+
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        lightBuffers[i] = std::make_unique<VulkanBuffer>(
+            device,
+            sizeof(GpuPointLight),
+            MAX_SCENE_LIGHTS,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        lightBuffers[i]->map();
+
+        listBuffers[i] = std::make_unique<VulkanBuffer>(
+            device,
+            sizeof(uint32_t) * LIST_STRIDE,
+            MAX_LIT_OBJECTS,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        listBuffers[i]->map();
+    }
+
+    bucketStart.resize(BUCKET_COUNT + 1);
+    bucketCursor.resize(BUCKET_COUNT);
+}
+
+/// \brief Cambia el máximo de luces por objeto (p.ej., desde el gobernador de calidad).
+/// \param count Luces por objeto (se acota a [1, \c MAX_OBJECT_LIGHTS]).
+void LightGrid::setMaxLightsPerObject(uint32_t count)
+{
+    settings.maxLightsPerObject = std::clamp(count, 1u, MAX_OBJECT_LIGHTS);
+}
+
+/// \brief Celdas (mínima y máxima) que cubre una esfera.
+void LightGrid::cellRange(const glm::vec3& center, float radius, glm::ivec3& lo, glm::ivec3& hi) const
+{
+    const float inverseCell = 1.0f / settings.cellSize;
+
+    lo = glm::ivec3(glm::floor((center - glm::vec3(radius)) * inverseCell));
+    hi = glm::ivec3(glm::floor((center + glm::vec3(radius)) * inverseCell));
+}
+
+/// \brief Cubeta de la tabla hash que corresponde a una celda.
+uint32_t LightGrid::bucketOf(int x, int y, int z) const
+{
+    const uint32_t hash = 
+        (uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u) ^ (uint32_t(z) * 83492791u);
+
+    return (hash & (BUCKET_COUNT - 1));
+}
+
+/// \brief Inserta las luces de \c lights en la tabla hash.
+/// \details Dos pasadas: la primera cuenta las entradas de cada cubeta y la segunda
+/// las coloca tras la suma prefija, de modo que no hay listas enlazadas ni reservas
+/// por celda. Varias celdas pueden caer en la misma cubeta; \c query descarta las
+/// repeticiones con \c visited y las luces lejanas por distancia.
+void LightGrid::build()
+{
+    std::fill(bucketStart.begin(), bucketStart.end(), 0u);
+    wideLights.clear();
+
+    glm::ivec3 lo;
+    glm::ivec3 hi;
+
+    for (uint32_t i = 0; i < lights.size(); ++i)
+    {
+        cellRange(lights[i].position, lights[i].range, lo, hi);
+
+        if (cellsBetween(lo, hi) > MAX_CELLS_PER_LIGHT)
+        {
+            wideLights.push_back(i);
+            continue;
+        }
+
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            for (int y = lo.y; y <= hi.y; ++y)
+            {
+                for (int x = lo.x; x <= hi.x; ++x)
+                {
+                    bucketStart[bucketOf(x, y, z) + 1] += 1;
+                }
+            }
+        }
+    }
+
+    for (uint32_t b = 1; b <= BUCKET_COUNT; ++b)
+    {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+
+    entries.resize(bucketStart[BUCKET_COUNT]);
+    std::copy(bucketStart.begin(), bucketStart.end() - 1, bucketCursor.begin());
+
+    for (uint32_t i = 0; i < lights.size(); ++i)
+    {
+        cellRange(lights[i].position, lights[i].range, lo, hi);
+
+        if (cellsBetween(lo, hi) > MAX_CELLS_PER_LIGHT)
+        {
+            continue;
+        }
+
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            for (int y = lo.y; y <= hi.y; ++y)
+            {
+                for (int x = lo.x; x <= hi.x; ++x)
+                {
+                    entries[bucketCursor[bucketOf(x, y, z)]++] = i;
+                }
+            }
+        }
+    }
+
+    visited.assign(lights.size(), 0u);
+    stamp = 0;
+}
+
+/// \brief Escribe en \c list las luces con más influencia sobre una esfera.
+/// \param center Centro de la esfera en mundo.
+/// \param radius Radio de la esfera.
+/// \param list Lista de destino (\c LIST_STRIDE enteros).
+/// \param skipBaked Descarta las luces horneadas (objetos con \c staticGeometry).
+/// \return Número de luces candidatas evaluadas.
+uint32_t LightGrid::query(const glm::vec3& center, float radius, uint32_t* list, bool skipBaked)
+{
+    stamp += 1;
+
+    Candidate best[MAX_OBJECT_LIGHTS];
+    const uint32_t maxCount = settings.maxLightsPerObject;
+    uint32_t count = 0;
+    uint32_t evaluated = 0;
+
+    auto consider = [&](uint32_t index)
+    {
+        if (visited[index] == stamp)
+        {
+            return;
+        }
+
+        visited[index] = stamp;
+        evaluated += 1;
+
+        const GridLight& light = lights[index];
+
+        if (skipBaked && light.baked)
+        {
+            return;
+        }
+
+        const float distance = std::max(glm::length(light.position - center) - radius, 0.0f);
+
+        if (distance >= light.range)
+        {
+            return;
+        }
+
+        const float score = light.intensity / std::max(distance * distance, MIN_SCORE_DISTANCE_SQ);
+
+        if (count == maxCount && score <= best[count - 1].score)
+        {
+            return;
+        }
+
+        // Inserción ordenada de mayor a menor influencia (N es pequeño).
+        uint32_t slot = (count < maxCount) ? count++ : count - 1;
+
+        while (slot > 0 && best[slot - 1].score < score)
+        {
+            best[slot] = best[slot - 1];
+            slot -= 1;
+        }
+
+        best[slot] = Candidate{index, score};
+    };
+
+    glm::ivec3 lo;
+    glm::ivec3 hi;
+    cellRange(center, radius, lo, hi);
+
+    if (cellsBetween(lo, hi) > MAX_CELLS_PER_QUERY)
+    {
+        for (uint32_t i = 0; i < lights.size(); ++i)
+        {
+            consider(i);
+        }
+    }
+    else
+    {
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            for (int y = lo.y; y <= hi.y; ++y)
+            {
+                for (int x = lo.x; x <= hi.x; ++x)
+                {
+                    const uint32_t bucket = bucketOf(x, y, z);
+
+                    for (uint32_t e = bucketStart[bucket]; e < bucketStart[bucket + 1]; ++e)
+                    {
+                        consider(entries[e]);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t index : wideLights)
+        {
+            consider(index);
+        }
+    }
+
+    list[0] = count;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        list[1 + i] = best[i].index;
+    }
+
+    return (evaluated);
+}
+
+/// \brief Reconstruye la rejilla y escribe las listas de luces del frame.
+/// \details Debe llamarse después de mover las luces y de decidir qué objetos se
+/// dibujan como impostor, y antes de grabar la escena.
+/// \param frameInfo Contexto del frame.
+void LightGrid::update(FrameInfo& frameInfo)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const Clock::time_point buildStart = Clock::now();
+
+    GpuPointLight* gpuLights = 
+        static_cast<GpuPointLight*>(lightBuffers[frameInfo.frameIndex]->getMappedMemory());
+
+    lights.clear();
+
+    // Dos pasadas: las dinámicas primero para que ProbeGrid pueda quedarse sólo con ellas.
+    for (const bool baked : {false, true})
+    {
+        for (std::pair<const unsigned int, GameObject>& kv : frameInfo.gameObjects)
+        {
+            const GameObject& obj = kv.second;
+
+            if (obj.light == nullptr || obj.light->baked != baked || lights.size() == MAX_SCENE_LIGHTS)
+            {
+                continue;
+            }
+
+            GridLight light {};
+            light.position = obj.transform.translation;
+            light.intensity = std::max(obj.light->intensity, 0.0f);
+            light.range = std::sqrt(light.intensity / settings.influenceCutoff);
+            light.baked = baked;
+
+            gpuLights[lights.size()].position = glm::vec4(light.position, light.range);
+            gpuLights[lights.size()].color = glm::vec4(obj.color, light.intensity);
+
+            lights.push_back(light);
+        }
+
+        if (!baked)
+        {
+            dynamicLights = static_cast<uint32_t>(lights.size());
+        }
+    }
+
+    build();
+
+    const Clock::time_point assignStart = Clock::now();
+
+    uint32_t* lists = static_cast<uint32_t*>(listBuffers[frameInfo.frameIndex]->getMappedMemory());
+
+    // Lista 0: la de la cámara, para los objetos que no caben.
+    query(frameInfo.camera.getPosition(), 0.0f, lists);
+
+    // Lista 1: sin luces, sólo la marca de las sondas.
+    if (probeLighting)
+    {
+        std::fill_n(lists + size_t(PROBE_LIST) * LIST_STRIDE, LIST_STRIDE, 0u);
+        lists[size_t(PROBE_LIST) * LIST_STRIDE] = PROBE_LIT;
+    }
+
+    const uint32_t firstSlot = probeLighting ? PROBE_LIST + 1 : 1;
+    uint32_t slot = firstSlot;
+    uint64_t assigned = 0;
+    uint64_t candidates = 0;
+
+    for (std::pair<const unsigned int, GameObject>& kv : frameInfo.gameObjects)
+    {
+        GameObject& obj = kv.second;
+        obj.lightList = 0;
+
+        if (!obj.model || obj.drawAsImpostor)
+        {
+            continue;
+        }
+
+        if (probeLighting && !obj.staticGeometry)
+        {
+            obj.lightList = PROBE_LIST;
+            continue;
+        }
+
+        if (slot == MAX_LIT_OBJECTS)
+        {
+            continue;
+        }
+
+        const glm::mat4 transform = obj.transform.matrix();
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(obj.model->getBoundsCenter(), 1.0f));
+        const float scale = std::max({
+            glm::length(glm::vec3(transform[0])),
+            glm::length(glm::vec3(transform[1])),
+            glm::length(glm::vec3(transform[2]))});
+
+        uint32_t* list = lists + size_t(slot) * LIST_STRIDE;
+        // La geometría estática ya tiene las luces horneadas en sus vértices.
+        candidates += query(center, obj.model->getBoundsRadius() * scale, list, obj.staticGeometry);
+        assigned += list[0];
+
+        obj.lightList = slot;
+        slot += 1;
+    }
+
+    const Clock::time_point end = Clock::now();
+    const uint32_t objects = slot - firstSlot;
+
+    stats.lights = static_cast<uint32_t>(lights.size());
+    stats.objects = objects;
+    stats.lightsPerObject = objects ? float(double(assigned) / objects) : 0.0f;
+    stats.candidatesPerObject = objects ? float(double(candidates) / objects) : 0.0f;
+    stats.buildMs = std::chrono::duration<float, std::milli>(assignStart - buildStart).count();
+    stats.assignMs = std::chrono::duration<float, std::milli>(end - assignStart).count();
+}
@@ -0,0 +1,396 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: MetricsExporter.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "MetricsExporter.hpp"
+#include "ThreadTopology.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/// Espera máxima de \c poll antes de revisar si hay que detenerse (ms).
+static constexpr int ACCEPT_POLL_MS = 100;
+/// Espera máxima a que el cliente envíe su petición (ms).
+static constexpr int REQUEST_POLL_MS = 50;
+/// Cola de conexiones pendientes del socket de escucha.
+static constexpr int LISTEN_BACKLOG = 4;
+
+/// \brief Percentil de las muestras no nulas de un histórico.
+/// \param samples Muestras ordenadas de menor a mayor.
+/// \param quantile Cuantil en [0, 1].
+static float percentile(const std::vector<float>& samples, double quantile)
+{
+    if (samples.empty())
+    {
+        return (0.0f);
+    }
+
+    const size_t index = static_cast<size_t>(quantile * static_cast<double>(samples.size() - 1) + 0.5);
+
+    return (samples[std::min(index, samples.size() - 1)]);
+}
+
+/// \brief Escribe la cabecera \c HELP/TYPE de una métrica.
+static void writeHeader(std::ostringstream& out, const char* name, const char* type, const char* help)
+{
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << ' ' << type << '\n';
+}
+
+/// \brief Escribe los percentiles, la suma y el número de muestras de un histórico de ms por frame.
+/// \details Los percentiles son de la ventana del histórico; la suma y el número son
+/// los totales desde el arranque, monótonos como exige un \c summary para \c rate().
+static void writeQuantiles(
+    std::ostringstream& out,
+    const char* source,
+    const std::array<float, PerfRing::Count>& history,
+    double totalMs,
+    uint64_t count)
+{
+    std::vector<float> samples;
+    samples.reserve(history.size());
+
+    for (float sample : history)
+    {
+        if (sample > 0.0f)
+        {
+            samples.push_back(sample);
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    for (double quantile : {0.5, 0.9, 0.99})
+    {
+        out << "vulkanapi_frame_ms{source=\"" << source << "\",quantile=\"" << quantile << "\"} "
+            << percentile(samples, quantile) << '\n';
+    }
+
+    out << "vulkanapi_frame_ms_sum{source=\"" << source << "\"} " << totalMs << '\n';
+    out << "vulkanapi_frame_ms_count{source=\"" << source << "\"} " << count << '\n';
+}
+
+/// \brief Prepara el exportador (no abre el socket).
+/// \param socketPath Ruta del socket de dominio UNIX.
+MetricsExporter::MetricsExporter(const std::string& socketPath) : path(socketPath)
+{
+}
+
+/// \brief Detiene la hebra, cierra el socket y borra su fichero.
+MetricsExporter::~MetricsExporter()
+{
+    running.store(false, std::memory_order_relaxed);
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+#ifdef __linux__
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        unlink(path.c_str());
+    }
+#endif
+}
+
+/// \brief Crea el socket y lanza la hebra de servicio.
+/// \return \c false si el socket no se pudo crear o la plataforma no lo admite.
+bool MetricsExporter::start()
+{
+#ifdef __linux__
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "[metrics] invalid socket path '" << path << "'\n";
+        return (false);
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (listenFd < 0)
+    {
+        std::cerr << "[metrics] socket() failed: " << std::strerror(errno) << '\n';
+        return (false);
+    }
+
+    unlink(path.c_str());
+
+    if (bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, LISTEN_BACKLOG) != 0)
+    {
+        std::cerr << "[metrics] cannot listen on '" << path << "': " << std::strerror(errno) << '\n';
+        close(listenFd);
+        listenFd = -1;
+        return (false);
+    }
+
+    running.store(true, std::memory_order_relaxed);
+    thread = std::thread(&MetricsExporter::serve, this);
+
+    std::cout << "[metrics] serving on unix:" << path << '\n';
+
+    return (true);
+#else
+    std::cerr << "[metrics] UNIX socket export not available on this platform\n";
+
+    return (false);
+#endif
+}
+
+/// \brief Publica las métricas del frame actual. Sin bloqueos (hebra de render).
+/// \param perf Métricas del renderizador.
+/// \param frames Frames completados desde el arranque.
+void MetricsExporter::publish(const Perf& perf, uint64_t frames)
+{
+    const PerfStats& stats = perf.stats();
+    MetricsSnapshot& snapshot = slots[writeSlot];
+
+    snapshot.frames = frames;
+    snapshot.fps = stats.fps;
+    snapshot.cpuFrameMs = stats.cpuFrameMs;
+    snapshot.cpuFrameMsAvg = stats.cpuFrameMsAvg;
+    snapshot.gpuFrameMs = stats.gpuFrameMs;
+    snapshot.gpuFrameMsAvg = stats.gpuFrameMsAvg;
+    snapshot.cpuUsageSystem = stats.cpuUsageSystem;
+    snapshot.cpuUsageProcess = stats.cpuUsageProcess;
+    snapshot.cpuMsHistory = stats.cpuMsHistory.data;
+    snapshot.gpuMsHistory = stats.gpuMsHistory.data;
+    snapshot.cpuFrameMsTotal = stats.cpuFrameMsTotal;
+    snapshot.cpuFrameCount = stats.cpuFrameCount;
+    snapshot.gpuFrameMsTotal = stats.gpuFrameMsTotal;
+    snapshot.gpuFrameCount = stats.gpuFrameCount;
+    snapshot.blocking = stats.blocking;
+    snapshot.boundFrames = stats.boundFrames;
+
+    const StreamingStats* streaming = perf.getStreamingStats();
+    snapshot.hasStreaming = (streaming != nullptr);
+    snapshot.streaming = streaming ? *streaming : StreamingStats {};
+
+    const AsyncComputeStats* asyncCompute = perf.getAsyncComputeStats();
+    snapshot.hasAsyncCompute = (asyncCompute != nullptr);
+    snapshot.asyncCompute = asyncCompute ? *asyncCompute : AsyncComputeStats {};
+
+    const LightGridStats* lightGrid = perf.getLightGridStats();
+    snapshot.hasLightGrid = (lightGrid != nullptr);
+    snapshot.lightGrid = lightGrid ? *lightGrid : LightGridStats {};
+
+    const QualityStats* quality = perf.getQualityStats();
+    snapshot.hasQuality = (quality != nullptr);
+    snapshot.quality = quality ? *quality : QualityStats {};
+    snapshot.qualityDecisions = perf.getQualityDecisionCount();
+
+    writeSlot = shared.exchange(writeSlot | FRESH, std::memory_order_acq_rel) & SLOT_MASK;
+}
+
+/// \brief Toma el último hueco publicado (lado lector del triple búfer).
+/// \return Copia más reciente disponible.
+const MetricsSnapshot& MetricsExporter::acquire()
+{
+    if (shared.load(std::memory_order_relaxed) & FRESH)
+    {
+        readSlot = shared.exchange(readSlot, std::memory_order_acq_rel) & SLOT_MASK;
+    }
+
+    return (slots[readSlot]);
+}
+
+/// \brief Bucle de la hebra de servicio.
+void MetricsExporter::serve()
+{
+#ifdef __linux__
+    if (!ThreadTopology::lowerCurrentThreadPriority())
+    {
+        std::cerr << "[metrics] could not lower exporter thread priority\n";
+    }
+
+    pollfd listener {};
+    listener.fd = listenFd;
+    listener.events = POLLIN;
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        listener.revents = 0;
+
+        if (poll(&listener, 1, ACCEPT_POLL_MS) <= 0 || !(listener.revents & POLLIN))
+        {
+            continue;
+        }
+
+        const int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if (client < 0)
+        {
+            continue;
+        }
+
+        // Una petición HTTP llega en cuanto conecta el cliente; un cliente de
+        // texto plano (socat, nc) puede no enviar nada.
+        char request[256] {};
+        pollfd incoming {};
+        incoming.fd = client;
+        incoming.events = POLLIN;
+
+        ssize_t received = 0;
+
+        if (poll(&incoming, 1, REQUEST_POLL_MS) > 0 && (incoming.revents & POLLIN))
+        {
+            received = recv(client, request, sizeof(request) - 1, 0);
+        }
+
+        const uint64_t scrapeCount = scrapes.fetch_add(1, std::memory_order_relaxed) + 1;
+        const std::string body = format(acquire(), scrapeCount);
+
+        std::string response;
+
+        if (received >= 4 && std::strncmp(request, "GET ", 4) == 0)
+        {
+            response = "HTTP/1.0 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                "Connection: close\r\n\r\n";
+        }
+
+        response += body;
+
+        size_t sent = 0;
+
+        while (sent < response.size())
+        {
+            const ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+
+            if (written <= 0)
+            {
+                break;
+            }
+
+            sent += static_cast<size_t>(written);
+        }
+
+        close(client);
+    }
+#endif
+}
+
+/// \brief Da formato de texto de Prometheus a una copia de métricas.
+/// \param snapshot Métricas a exponer.
+/// \param scrapeCount Peticiones atendidas (se expone como contador).
+/// \return Texto de exposición.
+std::string MetricsExporter::format(const MetricsSnapshot& snapshot, uint64_t scrapeCount)
+{
+    std::ostringstream out;
+
+    writeHeader(out, "vulkanapi_frames_total", "counter", "Frames completed since startup.");
+    out << "vulkanapi_frames_total " << snapshot.frames << '\n';
+
+    writeHeader(out, "vulkanapi_fps", "gauge", "Instantaneous frames per second.");
+    out << "vulkanapi_fps " << snapshot.fps << '\n';
+
+    writeHeader(out, "vulkanapi_cpu_frame_ms", "gauge", "CPU time of the last frame in milliseconds.");
+    out << "vulkanapi_cpu_frame_ms " << snapshot.cpuFrameMs << '\n';
+    writeHeader(out, "vulkanapi_cpu_frame_ms_avg", "gauge", "Smoothed CPU frame time in milliseconds.");
+    out << "vulkanapi_cpu_frame_ms_avg " << snapshot.cpuFrameMsAvg << '\n';
+
+    writeHeader(out, "vulkanapi_gpu_frame_ms", "gauge", "GPU time of the last resolved frame in milliseconds.");
+    out << "vulkanapi_gpu_frame_ms " << snapshot.gpuFrameMs << '\n';
+    writeHeader(out, "vulkanapi_gpu_frame_ms_avg", "gauge", "Smoothed GPU frame time in milliseconds.");
+    out << "vulkanapi_gpu_frame_ms_avg " << snapshot.gpuFrameMsAvg << '\n';
+
+    writeHeader(out, "vulkanapi_frame_ms", "summary", "Frame time quantiles over the recent history window; sum and count since startup.");
+    writeQuantiles(out, "cpu", snapshot.cpuMsHistory, snapshot.cpuFrameMsTotal, snapshot.cpuFrameCount);
+    writeQuantiles(out, "gpu", snapshot.gpuMsHistory, snapshot.gpuFrameMsTotal, snapshot.gpuFrameCount);
+
+    writeHeader(out, "vulkanapi_cpu_usage_percent", "gauge", "CPU usage of the system and of this process.");
+    out << "vulkanapi_cpu_usage_percent{scope=\"system\"} " << snapshot.cpuUsageSystem << '\n';
+    out << "vulkanapi_cpu_usage_percent{scope=\"process\"} " << snapshot.cpuUsageProcess << '\n';
+
+    writeHeader(out, "vulkanapi_swapchain_wait_ms", "gauge", "Time blocked in swap chain calls during the last frame.");
+    out << "vulkanapi_swapchain_wait_ms{call=\"fence\"} " << snapshot.blocking.fenceWaitMs << '\n';
+    out << "vulkanapi_swapchain_wait_ms{call=\"acquire\"} " << snapshot.blocking.acquireMs << '\n';
+    out << "vulkanapi_swapchain_wait_ms{call=\"image_fence\"} " << snapshot.blocking.imageFenceMs << '\n';
+    out << "vulkanapi_swapchain_wait_ms{call=\"submit\"} " << snapshot.blocking.submitMs << '\n';
+    out << "vulkanapi_swapchain_wait_ms{call=\"present\"} " << snapshot.blocking.presentMs << '\n';
+
+    writeHeader(out, "vulkanapi_frames_bound_total", "counter", "Frames classified by the resource that limited them.");
+
+    static constexpr const char* BOUND_LABELS[] = {"cpu", "gpu", "present"};
+
+    for (size_t bound = 0; bound < snapshot.boundFrames.size(); ++bound)
+    {
+        out << "vulkanapi_frames_bound_total{bound=\"" << BOUND_LABELS[bound] << "\"} "
+            << snapshot.boundFrames[bound] << '\n';
+    }
+
+    if (snapshot.hasStreaming)
+    {
+        const StreamingStats& streaming = snapshot.streaming;
+
+        writeHeader(out, "vulkanapi_streaming_cells", "gauge", "World cells by streaming state.");
+        out << "vulkanapi_streaming_cells{state=\"pending\"} " << streaming.pendingCells << '\n';
+        out << "vulkanapi_streaming_cells{state=\"resident\"} " << streaming.residentCells << '\n';
+
+        writeHeader(out, "vulkanapi_streaming_memory_bytes", "gauge", "Memory used by resident cells.");
+        out << "vulkanapi_streaming_memory_bytes{heap=\"host\"} " << streaming.hostBytes << '\n';
+        out << "vulkanapi_streaming_memory_bytes{heap=\"gpu\"} " << streaming.gpuBytes << '\n';
+
+        writeHeader(out, "vulkanapi_streaming_budget_bytes", "gauge", "Memory budget for resident cells.");
+        out << "vulkanapi_streaming_budget_bytes{heap=\"host\"} " << streaming.hostBudget << '\n';
+        out << "vulkanapi_streaming_budget_bytes{heap=\"gpu\"} " << streaming.gpuBudget << '\n';
+
+        writeHeader(out, "vulkanapi_streaming_io_bytes_per_second", "gauge", "Cell read throughput.");
+        out << "vulkanapi_streaming_io_bytes_per_second " << streaming.ioBytesPerSecond << '\n';
+    }
+
+    if (snapshot.hasAsyncCompute)
+    {
+        writeHeader(out, "vulkanapi_async_compute_ms", "gauge", "GPU time of the async compute work.");
+        out << "vulkanapi_async_compute_ms " << snapshot.asyncCompute.computeMs << '\n';
+
+        writeHeader(out, "vulkanapi_async_compute_overlap_ratio", "gauge", "Fraction of compute overlapped with graphics.");
+        out << "vulkanapi_async_compute_overlap_ratio " << snapshot.asyncCompute.overlapRatio << '\n';
+    }
+
+    if (snapshot.hasLightGrid)
+    {
+        writeHeader(out, "vulkanapi_light_grid_ms", "gauge", "CPU time of the light grid by phase.");
+        out << "vulkanapi_light_grid_ms{phase=\"build\"} " << snapshot.lightGrid.buildMs << '\n';
+        out << "vulkanapi_light_grid_ms{phase=\"assign\"} " << snapshot.lightGrid.assignMs << '\n';
+
+        writeHeader(out, "vulkanapi_light_grid_lights", "gauge", "Lights inserted in the grid.");
+        out << "vulkanapi_light_grid_lights " << snapshot.lightGrid.lights << '\n';
+    }
+
+    if (snapshot.hasQuality)
+    {
+        writeHeader(out, "vulkanapi_quality_level", "gauge", "Current level of the quality governor.");
+        out << "vulkanapi_quality_level " << snapshot.quality.level << '\n';
+
+        writeHeader(out, "vulkanapi_quality_decisions_total", "counter", "Quality level changes since startup.");
+        out << "vulkanapi_quality_decisions_total " << snapshot.qualityDecisions << '\n';
+    }
+
+    writeHeader(out, "vulkanapi_metrics_scrapes_total", "counter", "Requests served by the metrics exporter.");
+    out << "vulkanapi_metrics_scrapes_total " << scrapeCount << '\n';
+
+    return (out.str());
+}
@@ -13,6 +13,10 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
  /// \brief Combina múltiples valores de hash en una sola semilla.
  /// \details Utiliza una mezcla inspirada en hash_combine de Boost para reducir colisiones
  /// y distribuir mejor los valores. Útil para especializaciones de std::hash
@@ -33,7 +37,7 @@ struct std::hash<Model::Vertex>
     size_t operator()(Model::Vertex const& vertex) const
     {
         size_t seed = 0;
-        hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
+        hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv, vertex.irradiance);
 
         return (seed);
     }
@@ -42,11 +46,43 @@ struct std::hash<Model::Vertex>
 /// \brief Crea la malla en GPU a partir de los datos del \c Builder.
 /// \param device Dispositivo lógico Vulkan.
 /// \param builder Datos de vértices/índices ya cargados en CPU.
-Model::Model(VulkanDevice& device, const Model::Builder& builder)
+/// \param extraVertexUsage Usos adicionales del buffer de vértices (p.ej.,
+/// \c VK_BUFFER_USAGE_STORAGE_BUFFER_BIT para que un compute shader lo escriba).
+/// \param deferUpload Si es \c true no se envía ninguna copia a la cola: los datos quedan
+/// en buffers de staging hasta que se llame a \c recordUpload (permite crear la malla
+/// desde hebras de carga sin bloquear la cola de gráficos).
+Model::Model(
+    VulkanDevice& device,
+    const Model::Builder& builder,
+    VkBufferUsageFlags extraVertexUsage,
+    bool deferUpload)
     : device {device}
 {
-    createVertexBuffer(builder.vertices);
-    createIndexBuffer(builder.indices);
+    createVertexBuffer(builder.vertices, extraVertexUsage, deferUpload);
+    createIndexBuffer(builder.indices, deferUpload);
+    computeBounds(builder.vertices);
+}
+
+/// \brief Crea la malla sobre un tramo de un buffer de vértices compartido.
+/// \details Sólo se crea el buffer de índices: los vértices no se suben, los escribe
+/// quien posee \p sharedVertices (p.ej., el skinning de todos los personajes en un
+/// único dispatch). \c bind enlaza el buffer en \p vertexOffset.
+/// \param device Dispositivo lógico Vulkan.
+/// \param builder Datos de la malla (los vértices sólo se usan para los límites).
+/// \param sharedVertices Buffer con uso de vértices (y \c TRANSFER_SRC para \c readBack).
+/// \param vertexOffset Bytes hasta el primer vértice de la malla.
+Model::Model(
+    VulkanDevice& device,
+    const Builder& builder,
+    std::shared_ptr<VulkanBuffer> sharedVertices,
+    VkDeviceSize vertexOffset)
+    : device {device}, vertexBuffer {std::move(sharedVertices)}, vertexOffset {vertexOffset}
+{
+    vertexCount = static_cast<uint32_t>(builder.vertices.size());
+    assert(vertexCount >= 3 && "💥[Vulkan API] Vertex count must be at least 3.");
+
+    createIndexBuffer(builder.indices, false);
+    computeBounds(builder.vertices);
 }
 
 /// \brief Libera los buffers de GPU asociados a la malla.
@@ -65,7 +101,12 @@ std::unique_ptr<Model> Model::fromFile(VulkanDevice& device, const std::string&
 
 /// \brief Crea el \c VkBuffer de vértices y transfiere los datos desde CPU.
 /// \param vertices Vector de vértices.
-void Model::createVertexBuffer(const std::vector<Vertex>& vertices)
+/// \param extraUsage Usos adicionales del buffer.
+/// \param deferUpload Conserva el staging en lugar de copiar de inmediato.
+void Model::createVertexBuffer(
+    const std::vector<Vertex>& vertices,
+    VkBufferUsageFlags extraUsage,
+    bool deferUpload)
 {
     vertexCount = static_cast<uint32_t>(vertices.size());
     assert(vertexCount >= 3 && "💥[Vulkan API] Vertex count must be at least 3.");
@@ -73,29 +114,59 @@ void Model::createVertexBuffer(const std::vector<Vertex>& vertices)
     VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
     uint32_t vertexSize = sizeof(vertices[0]);
 
-    VulkanBuffer stagingBuffer{
+    std::unique_ptr<VulkanBuffer> stagingBuffer = std::make_unique<VulkanBuffer>(
         device,
         vertexSize,
         vertexCount,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer((void*)vertices.data());
+    stagingBuffer->map();
+    stagingBuffer->writeToBuffer((void*)vertices.data());
 
     vertexBuffer = std::make_unique<VulkanBuffer>(
         device,
         vertexSize,
         vertexCount,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | extraUsage,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    device.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+    if (deferUpload)
+    {
+        vertexStaging = std::move(stagingBuffer);
+        return;
+    }
+
+    device.copyBuffer(stagingBuffer->getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+}
+
+/// \brief Calcula la esfera envolvente (centro de la AABB y distancia máxima).
+/// \param vertices Vector de vértices.
+void Model::computeBounds(const std::vector<Vertex>& vertices)
+{
+    glm::vec3 minimum {std::numeric_limits<float>::max()};
+    glm::vec3 maximum {std::numeric_limits<float>::lowest()};
+
+    for (const Vertex& vertex : vertices)
+    {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+
+    boundsCenter = 0.5f * (minimum + maximum);
+    boundsRadius = 0.0f;
+
+    for (const Vertex& vertex : vertices)
+    {
+        boundsRadius = std::max(boundsRadius, glm::length(vertex.position - boundsCenter));
+    }
 }
 
 /// \brief Crea el \c VkBuffer de índices y transfiere los datos desde CPU.
 /// \param indices Vector de índices (triángulos).
-void Model::createIndexBuffer(const std::vector<uint32_t>& indices)
+/// \param deferUpload Conserva el staging en lugar de copiar de inmediato.
+void Model::createIndexBuffer(const std::vector<uint32_t>& indices, bool deferUpload)
 {
     indexCount = static_cast<uint32_t>(indices.size());
     useIndexBuffer = indexCount > 0;
@@ -108,24 +179,106 @@ void Model::createIndexBuffer(const std::vector<uint32_t>& indices)
     VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
     uint32_t indexSize = sizeof(indices[0]);
 
-    VulkanBuffer stagingBuffer{
+    std::unique_ptr<VulkanBuffer> stagingBuffer = std::make_unique<VulkanBuffer>(
         device,
         indexSize,
         indexCount,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer((void*)indices.data());
+    stagingBuffer->map();
+    stagingBuffer->writeToBuffer((void*)indices.data());
 
     indexBuffer = std::make_unique<VulkanBuffer>(
         device,
         indexSize,
         indexCount,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    device.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+    if (deferUpload)
+    {
+        indexStaging = std::move(stagingBuffer);
+        return;
+    }
+
+    device.copyBuffer(stagingBuffer->getBuffer(), indexBuffer->getBuffer(), bufferSize);
+}
+
+/// \brief Graba en \c commandBuffer las copias staging -> GPU pendientes.
+/// \details Sólo tiene efecto si la malla se creó con \c deferUpload. Quien llama debe
+/// añadir la barrera TRANSFER -> VERTEX_INPUT antes de dibujar y mantener la malla viva
+/// hasta que el command buffer termine; después puede llamar a \c releaseStaging.
+/// \param commandBuffer Command buffer fuera de un render pass.
+void Model::recordUpload(VkCommandBuffer commandBuffer)
+{
+    if (vertexStaging)
+    {
+        VkBufferCopy region {};
+        region.size = static_cast<VkDeviceSize>(vertexCount) * sizeof(Vertex);
+        vkCmdCopyBuffer(commandBuffer, vertexStaging->getBuffer(), vertexBuffer->getBuffer(), 1, &region);
+    }
+
+    if (indexStaging)
+    {
+        VkBufferCopy region {};
+        region.size = static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t);
+        vkCmdCopyBuffer(commandBuffer, indexStaging->getBuffer(), indexBuffer->getBuffer(), 1, &region);
+    }
+}
+
+/// \brief Libera los buffers de staging de una subida diferida ya completada.
+void Model::releaseStaging()
+{
+    vertexStaging.reset();
+    indexStaging.reset();
+}
+
+/// \brief Copia a la CPU los vértices e índices que hay en la GPU.
+/// \details Sirve también para mallas que escribe la GPU (p.ej., skinning).
+/// Espera a que termine la copia.
+/// \param builder Salida con los vértices y los índices (vacíos si no hay).
+void Model::readBack(Builder& builder)
+{
+    VulkanBuffer vertexReadback(
+        device,
+        sizeof(Vertex),
+        vertexCount,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    vertexReadback.map();
+    device.copyBuffer(
+        vertexBuffer->getBuffer(),
+        vertexReadback.getBuffer(),
+        static_cast<VkDeviceSize>(vertexCount) * sizeof(Vertex),
+        vertexOffset);
+
+    const Vertex* vertices = static_cast<const Vertex*>(vertexReadback.getMappedMemory());
+    builder.vertices.assign(vertices, vertices + vertexCount);
+    builder.indices.clear();
+
+    if (!useIndexBuffer)
+    {
+        return;
+    }
+
+    VulkanBuffer indexReadback(
+        device,
+        sizeof(uint32_t),
+        indexCount,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    indexReadback.map();
+    device.copyBuffer(
+        indexBuffer->getBuffer(),
+        indexReadback.getBuffer(),
+        static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t));
+
+    const uint32_t* indices = static_cast<const uint32_t*>(indexReadback.getMappedMemory());
+    builder.indices.assign(indices, indices + indexCount);
 }
 
 /// \brief Enlaza los vertex/index buffers al \c commandBuffer.
@@ -133,7 +286,7 @@ void Model::createIndexBuffer(const std::vector<uint32_t>& indices)
 void Model::bind(VkCommandBuffer commandBuffer)
 {
     VkBuffer buffers[] = {vertexBuffer->getBuffer()};
-    VkDeviceSize offsets[] = {0};
+    VkDeviceSize offsets[] = {vertexOffset};
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
 
     if (useIndexBuffer)
@@ -144,15 +297,16 @@ void Model::bind(VkCommandBuffer commandBuffer)
 
 /// \brief Emite la orden de dibujo (indexed o no) sobre el \c commandBuffer.
 /// \param commandBuffer Command buffer en el que se están grabando comandos.
-void Model::draw(VkCommandBuffer commandBuffer)
+/// \param firstInstance Llega al shader como \c gl_InstanceIndex (p.ej., la lista de luces).
+void Model::draw(VkCommandBuffer commandBuffer, uint32_t firstInstance)
 {
     if (useIndexBuffer)
     {
-        vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+        vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, firstInstance);
     }
     else
     {
-        vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+        vkCmdDraw(commandBuffer, vertexCount, 1, 0, firstInstance);
     }
 }
 
@@ -169,7 +323,7 @@ std::vector<VkVertexInputBindingDescription> Model::Vertex::bindingDescriptions(
 }
 
 /// \brief Descriptores de atributos para el pipeline.
-/// \return Vector con las descripciones de posición, color, normal y UV.
+/// \return Vector con las descripciones de posición, color, normal, UV e irradiancia.
 std::vector<VkVertexInputAttributeDescription> Model::Vertex::attributeDescriptions()
 {
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
@@ -181,9 +335,19 @@ std::vector<VkVertexInputAttributeDescription> Model::Vertex::attributeDescripti
         { 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal) });
     attributeDescriptions.push_back(
         { 3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) });
+    attributeDescriptions.push_back(
+        { 4, 0, VK_FORMAT_R16G16B16A16_SFLOAT, offsetof(Vertex, irradiance) });
     return attributeDescriptions;
 }
 
+/// \brief Empaqueta la luz horneada en \c irradiance.
+/// \param value Luz (r,g,b) y oclusión (a); se redondea a media precisión.
+void Model::Vertex::setIrradiance(const glm::vec4& value)
+{
+    irradiance = glm::uvec2(glm::packHalf2x16(glm::vec2(value.r, value.g)),
+        glm::packHalf2x16(glm::vec2(value.b, value.a)));
+}
+
 /// \brief Carga la malla desde un fichero en disco.
 /// \param filepath Ruta del fichero.
 /// \post \c vertices y \c indices quedan poblados.
@@ -199,6 +363,36 @@ void Model::Builder::loadFromFile(const std::string& filepath)
         throw std::runtime_error(warn + err);
     }
 
+    fromObj(attrib, shapes);
+}
+
+/// \brief Carga la malla desde el contenido de un OBJ ya leído (p.ej., con \c AssetIO).
+/// \details Los materiales (.mtl) no se resuelven; sólo se usan posiciones,
+/// colores, normales y UV, igual que en \c loadFromFile.
+/// \param data Bytes del fichero OBJ.
+/// \post \c vertices y \c indices quedan poblados.
+void Model::Builder::loadFromMemory(const std::vector<char>& data)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    std::istringstream stream(std::string(data.begin(), data.end()));
+
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream))
+    {
+        throw std::runtime_error(warn + err);
+    }
+
+    fromObj(attrib, shapes);
+}
+
+/// \brief Construye vértices únicos e índices a partir de los datos de tinyobjloader.
+/// \param attrib Atributos (posiciones, colores, normales, UV).
+/// \param shapes Formas con sus índices.
+void Model::Builder::fromObj(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes)
+{
     vertices.clear();
     indices.clear();
 
@@ -0,0 +1,657 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: MultiViewPass.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "MultiViewPass.hpp"
+#include "DescriptorWriter.hpp"
+#include "LightGrid.hpp"
+#include "ProbeGrid.hpp"
+#include "SwapChain.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+ /// \brief Push constants del pase (mismo layout que las de \c BasicRenderer).
+struct MultiViewPushConstants
+{
+    glm::mat4 modelMatrix {1.0f};
+    glm::mat4 normalMatrix {1.0f};
+};
+
+/// Campo de visión vertical de las vistas estéreo (el mismo que la cámara principal).
+static constexpr float STEREO_FOV_DEGREES = 50.0f;
+
+/// \brief Crea el destino por capas, el render pass, las tuberías y los descriptores.
+/// \param device Dispositivo lógico Vulkan.
+/// \param globalSetLayout Layout del set global (set 0).
+/// \param lightGrid Listas de luces por objeto (bindings 1 y 2 del set global).
+/// \param probeGrid Sondas de irradiancia (binding 3 del set global).
+/// \param settings Parámetros del pase.
+MultiViewPass::MultiViewPass(
+    VulkanDevice& device,
+    DescriptorSetLayout& globalSetLayout,
+    const LightGrid& lightGrid,
+    const ProbeGrid& probeGrid,
+    const MultiViewSettings& settings)
+    : vulkanDevice{device}, settings{settings}
+{
+    viewCount = (settings.mode == MultiViewMode::Cube) ? 6u : 2u;
+
+    // La especificación garantiza al menos seis vistas cuando hay multivista.
+    useMultiview = vulkanDevice.getCapabilities().multiview;
+
+    stats.views = viewCount;
+    stats.multiview = useMultiview;
+
+    createTargets();
+    createRenderPass();
+    createDescriptors(globalSetLayout, lightGrid, probeGrid);
+    createPipeline(globalSetLayout.get());
+}
+
+/// \brief Libera el destino, el render pass y las tuberías.
+MultiViewPass::~MultiViewPass()
+{
+    VkDevice device = vulkanDevice.getDevice();
+
+    for (VkFramebuffer framebuffer : framebuffers)
+    {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+
+    for (size_t i = 0; i < colorAttachmentViews.size(); ++i)
+    {
+        vkDestroyImageView(device, colorAttachmentViews[i], nullptr);
+        vkDestroyImageView(device, depthAttachmentViews[i], nullptr);
+    }
+
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyRenderPass(device, renderPass, nullptr);
+    vkDestroyImageView(device, colorView, nullptr);
+    vkDestroyImage(device, colorImage, nullptr);
+    vkFreeMemory(device, colorMemory, nullptr);
+    vkDestroyImage(device, depthImage, nullptr);
+    vkFreeMemory(device, depthMemory, nullptr);
+}
+
+/// \brief Nombre legible de un modo.
+/// \param mode Modo a describir.
+const char* MultiViewPass::modeName(MultiViewMode mode)
+{
+    switch (mode)
+    {
+        case MultiViewMode::Stereo:
+            return ("stereo");
+        case MultiViewMode::Cube:
+            return ("cube");
+        default:
+            return ("off");
+    }
+}
+
+/// \brief Crea la imagen de color por capas, la de profundidad y sus vistas.
+void MultiViewPass::createTargets()
+{
+    depthFormat = vulkanDevice.findSupportedFormat(
+        {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags = (settings.mode == MultiViewMode::Cube) ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {settings.size, settings.size, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = viewCount;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    vulkanDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImage, colorMemory);
+
+    imageInfo.flags = 0;
+    imageInfo.format = depthFormat;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    vulkanDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthMemory);
+
+    auto createView = [this](
+        VkImage image,
+        VkImageViewType type,
+        VkFormat format,
+        VkImageAspectFlags aspect,
+        uint32_t baseLayer,
+        uint32_t layerCount)
+    {
+        VkImageViewCreateInfo viewInfo {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image;
+        viewInfo.viewType = type;
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = aspect;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = baseLayer;
+        viewInfo.subresourceRange.layerCount = layerCount;
+
+        VkImageView view = VK_NULL_HANDLE;
+
+        if (vkCreateImageView(vulkanDevice.getDevice(), &viewInfo, nullptr, &view) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create texture image view.");
+        }
+
+        return (view);
+    };
+
+    colorView = createView(
+        colorImage,
+        (settings.mode == MultiViewMode::Cube) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        viewCount);
+
+    // Con multivista el framebuffer ve todas las capas; sin ella, una por render pass.
+    const uint32_t passCount = useMultiview ? 1 : viewCount;
+    const uint32_t layersPerPass = useMultiview ? viewCount : 1;
+    const VkImageViewType passType = useMultiview ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+
+    for (uint32_t pass = 0; pass < passCount; ++pass)
+    {
+        colorAttachmentViews.push_back(createView(
+            colorImage, passType, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, pass, layersPerPass));
+        depthAttachmentViews.push_back(createView(
+            depthImage, passType, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, pass, layersPerPass));
+    }
+}
+
+/// \brief Crea el render pass (con máscara de vistas si hay multivista) y los framebuffers.
+void MultiViewPass::createRenderPass()
+{
+    VkAttachmentDescription colorAttachment {};
+    colorAttachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkAttachmentDescription depthAttachment {};
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    std::array<VkSubpassDependency, 2> dependencies {};
+
+    // Entrada: muestreos del frame anterior y la profundidad del pase anterior.
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // Salida: el destino se muestrea en pases posteriores.
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+
+    // Cada draw se emite una vez y se replica en las vistas de la máscara. Las vistas
+    // estéreo casi coinciden, así que se declaran correlacionadas.
+    const uint32_t viewMask = (1u << viewCount) - 1u;
+    const uint32_t correlationMask = (settings.mode == MultiViewMode::Stereo) ? viewMask : 0u;
+
+    VkRenderPassMultiviewCreateInfo multiviewInfo {};
+    multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+    multiviewInfo.subpassCount = 1;
+    multiviewInfo.pViewMasks = &viewMask;
+    multiviewInfo.correlationMaskCount = (correlationMask != 0) ? 1 : 0;
+    multiviewInfo.pCorrelationMasks = &correlationMask;
+
+    VkRenderPassCreateInfo renderPassInfo {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.pNext = useMultiview ? &multiviewInfo : nullptr;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(
+        vulkanDevice.getDevice(),
+        &renderPassInfo,
+        nullptr,
+        &renderPass) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create render pass.");
+    }
+
+    framebuffers.resize(colorAttachmentViews.size());
+
+    for (size_t i = 0; i < framebuffers.size(); ++i)
+    {
+        std::array<VkImageView, 2> views = {colorAttachmentViews[i], depthAttachmentViews[i]};
+
+        // Con multivista las capas las selecciona la máscara: el framebuffer tiene una.
+        VkFramebufferCreateInfo framebufferInfo {};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = renderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+        framebufferInfo.pAttachments = views.data();
+        framebufferInfo.width = settings.size;
+        framebufferInfo.height = settings.size;
+        framebufferInfo.layers = 1;
+
+        if (vkCreateFramebuffer(
+            vulkanDevice.getDevice(),
+            &framebufferInfo,
+            nullptr,
+            &framebuffers[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create framebuffer.");
+        }
+    }
+}
+
+/// \brief Crea el pool, los UBO por vista y los descriptor sets.
+/// \param globalSetLayout Layout del set global.
+/// \param lightGrid Origen de los SSBO de luces.
+/// \param probeGrid Origen del SSBO de sondas.
+void MultiViewPass::createDescriptors(
+    DescriptorSetLayout& globalSetLayout, const LightGrid& lightGrid, const ProbeGrid& probeGrid)
+{
+    const uint32_t setCount = SwapChain::MAX_FRAMES_IN_FLIGHT * MAX_VIEWS;
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, setCount},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * setCount}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(vulkanDevice, setCount, 0, poolSizes);
+
+    uboBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    descriptorSets.resize(setCount);
+
+    VkDescriptorBufferInfo probesInfo = probeGrid.probesInfo();
+
+    for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        uboBuffers[i] = std::make_unique<VulkanBuffer>(
+            vulkanDevice,
+            sizeof(GlobalUbo),
+            MAX_VIEWS,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            vulkanDevice.deviceProperties.limits.minUniformBufferOffsetAlignment);
+
+        uboBuffers[i]->map();
+
+        VkDescriptorBufferInfo lightsInfo = lightGrid.lightsInfo(i);
+        VkDescriptorBufferInfo listsInfo = lightGrid.listsInfo(i);
+
+        for (int view = 0; view < MAX_VIEWS; ++view)
+        {
+            VkDescriptorBufferInfo bufferInfo = uboBuffers[i]->descriptorInfoForIndex(view);
+
+            DescriptorWriter(globalSetLayout, *descriptorPool)
+                .writeBuffer(0, &bufferInfo)
+                .writeBuffer(1, &lightsInfo)
+                .writeBuffer(2, &listsInfo)
+                .writeBuffer(3, &probesInfo)
+                .build(descriptorSets[i * MAX_VIEWS + view]);
+        }
+    }
+}
+
+/// \brief Crea el pipeline layout y la tubería del pase.
+/// \param globalSetLayout Layout del set global.
+void MultiViewPass::createPipeline(VkDescriptorSetLayout globalSetLayout)
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(MultiViewPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &globalSetLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &layoutInfo,
+        nullptr,
+        &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+
+    PipelineConfig config {};
+    GraphicsPipeline::defaultConfig(config);
+    config.renderPass = renderPass;
+    config.layout = pipelineLayout;
+
+    // Sin multivista cada pase lee su vista de projection/view, como el pase principal.
+    pipeline = std::make_unique<GraphicsPipeline>(
+        vulkanDevice,
+        useMultiview ? "shaders/simple_shader_multiview.vert.spv" : "shaders/simple_shader.vert.spv",
+        "shaders/simple_shader.frag.spv",
+        config);
+}
+
+/// \brief Calcula las matrices de cada vista a partir de la cámara del frame.
+/// \param camera Cámara activa.
+/// \param views Salida con las matrices de vista.
+/// \param projection Salida con la proyección común.
+void MultiViewPass::computeViews(
+    const Camera& camera,
+    std::array<glm::mat4, MAX_VIEWS>& views,
+    glm::mat4& projection) const
+{
+    Camera viewCamera;
+
+    if (settings.mode == MultiViewMode::Cube)
+    {
+        static const std::array<glm::vec3, 6> directions =
+        {
+            glm::vec3{1.0f, 0.0f, 0.0f}, glm::vec3{-1.0f, 0.0f, 0.0f},
+            glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec3{0.0f, -1.0f, 0.0f},
+            glm::vec3{0.0f, 0.0f, 1.0f}, glm::vec3{0.0f, 0.0f, -1.0f}
+        };
+
+        static const std::array<glm::vec3, 6> ups =
+        {
+            glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f},
+            glm::vec3{0.0f, 0.0f, -1.0f}, glm::vec3{0.0f, 0.0f, 1.0f},
+            glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f}
+        };
+
+        const glm::vec3 position = camera.getPosition();
+
+        for (uint32_t face = 0; face < 6; ++face)
+        {
+            viewCamera.lookAtDirection(position, directions[face], ups[face]);
+            views[face] = viewCamera.getViewMatrix();
+        }
+
+        viewCamera.setPerspectiveProjection(glm::radians(90.0f), 1.0f, settings.nearPlane, settings.farPlane);
+    }
+    else
+    {
+        // Cada ojo se desplaza media separación en el eje X de la vista.
+        for (uint32_t eye = 0; eye < 2; ++eye)
+        {
+            const float offset = (eye == 0 ? -0.5f : 0.5f) * settings.eyeSeparation;
+
+            glm::mat4 shift {1.0f};
+            shift[3][0] = -offset;
+
+            views[eye] = shift * camera.getViewMatrix();
+        }
+
+        viewCamera.setPerspectiveProjection(
+            glm::radians(STEREO_FOV_DEGREES), 1.0f, settings.nearPlane, settings.farPlane);
+    }
+
+    projection = viewCamera.getProjectionMatrix();
+}
+
+/// \brief Extrae los planos del frustum de una matriz proyección * vista.
+/// \param viewProjection Matriz a descomponer (profundidad en [0, 1]).
+/// \return Planos normalizados.
+MultiViewPass::Frustum MultiViewPass::extractFrustum(const glm::mat4& viewProjection)
+{
+    auto row = [&viewProjection](int i)
+    {
+        return (glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]});
+    };
+
+    const glm::vec4 r0 = row(0);
+    const glm::vec4 r1 = row(1);
+    const glm::vec4 r2 = row(2);
+    const glm::vec4 r3 = row(3);
+
+    Frustum frustum = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2};
+
+    for (Plane& plane : frustum)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return (frustum);
+}
+
+/// \brief Comprueba si una esfera toca un frustum.
+/// \param frustum Planos de la vista.
+/// \param center Centro de la esfera en mundo.
+/// \param radius Radio de la esfera.
+/// \return \c true si no queda completamente fuera de algún plano.
+bool MultiViewPass::sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+    for (const Plane& plane : frustum)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/// \brief Graba los draws de los objetos indicados.
+/// \param commandBuffer Command buffer con el render pass activo.
+/// \param descriptorSet Set global de la vista (o de todas las vistas).
+/// \param objects Objetos a dibujar.
+void MultiViewPass::recordObjects(
+    VkCommandBuffer commandBuffer,
+    VkDescriptorSet descriptorSet,
+    const std::vector<GameObject*>& objects)
+{
+    VkViewport viewport {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(settings.size);
+    viewport.height = static_cast<float>(settings.size);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor {{0, 0}, {settings.size, settings.size}};
+
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    pipeline->bind(commandBuffer);
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipelineLayout,
+        0,
+        1,
+        &descriptorSet,
+        0,
+        nullptr);
+
+    for (GameObject* object : objects)
+    {
+        MultiViewPushConstants push {};
+        push.modelMatrix = object->transform.matrix();
+        push.normalMatrix = object->transform.normalMatrix();
+
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(MultiViewPushConstants),
+            &push);
+
+        object->model->bind(commandBuffer);
+        object->model->draw(commandBuffer, object->lightList);
+    }
+
+    stats.draws += static_cast<uint32_t>(objects.size());
+}
+
+/// \brief Graba el pase de todas las vistas en el command buffer del frame.
+/// \details Debe llamarse fuera del render pass principal y después de
+/// \c LightGrid::update.
+/// \param frameInfo Contexto del frame.
+/// \param sceneUbo UBO del pase principal (luz ambiental y luces puntuales).
+void MultiViewPass::render(FrameInfo& frameInfo, const GlobalUbo& sceneUbo)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    const Clock::time_point start = Clock::now();
+
+    std::array<glm::mat4, MAX_VIEWS> views {};
+    glm::mat4 projection {1.0f};
+    computeViews(frameInfo.camera, views, projection);
+
+    std::array<Frustum, MAX_VIEWS> frustums {};
+    GlobalUbo ubo = sceneUbo;
+    ubo.viewCount = viewCount;
+
+    for (uint32_t view = 0; view < viewCount; ++view)
+    {
+        ubo.viewProjections[view] = projection * views[view];
+        frustums[view] = extractFrustum(ubo.viewProjections[view]);
+    }
+
+    // Cada instancia lleva todas las vistas (multivista) y la suya en projection/view
+    // (un pase por vista).
+    VulkanBuffer& uboBuffer = *uboBuffers[frameInfo.frameIndex];
+
+    for (uint32_t view = 0; view < viewCount; ++view)
+    {
+        ubo.projection = projection;
+        ubo.view = views[view];
+        ubo.inverseView = glm::inverse(views[view]);
+        uboBuffer.writeToIndex(&ubo, static_cast<int>(view));
+    }
+
+    uboBuffer.flush();
+
+    // Culling contra la unión de los frustums: un objeto se graba si alguna vista lo ve.
+    std::array<std::vector<GameObject*>, MAX_VIEWS> perView {};
+    std::vector<GameObject*> visible;
+    visible.reserve(frameInfo.gameObjects.size());
+    stats.culled = 0;
+    stats.draws = 0;
+
+    for (auto& entry : frameInfo.gameObjects)
+    {
+        GameObject& object = entry.second;
+
+        if (!object.model)
+        {
+            continue;
+        }
+
+        const glm::mat4 transform = object.transform.matrix();
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(object.model->getBoundsCenter(), 1.0f));
+        const float scale = std::max({
+            glm::length(glm::vec3(transform[0])),
+            glm::length(glm::vec3(transform[1])),
+            glm::length(glm::vec3(transform[2]))});
+        const float radius = object.model->getBoundsRadius() * scale;
+
+        bool seen = false;
+
+        for (uint32_t view = 0; view < viewCount; ++view)
+        {
+            if (sphereInFrustum(frustums[view], center, radius))
+            {
+                seen = true;
+
+                if (!useMultiview)
+                {
+                    perView[view].push_back(&object);
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        if (seen)
+        {
+            visible.push_back(&object);
+        }
+        else
+        {
+            stats.culled += 1;
+        }
+    }
+
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = {0.01f, 0.01f, 0.01f, 1.0f};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    beginInfo.renderPass = renderPass;
+    beginInfo.renderArea.offset = {0, 0};
+    beginInfo.renderArea.extent = {settings.size, settings.size};
+    beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    beginInfo.pClearValues = clearValues.data();
+
+    const size_t setBase = static_cast<size_t>(frameInfo.frameIndex) * MAX_VIEWS;
+
+    for (size_t pass = 0; pass < framebuffers.size(); ++pass)
+    {
+        beginInfo.framebuffer = framebuffers[pass];
+
+        vkCmdBeginRenderPass(frameInfo.commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        recordObjects(
+            frameInfo.commandBuffer,
+            descriptorSets[setBase + pass],
+            useMultiview ? visible : perView[pass]);
+
+        vkCmdEndRenderPass(frameInfo.commandBuffer);
+    }
+
+    stats.recordMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
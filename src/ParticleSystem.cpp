@@ -0,0 +1,462 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ParticleSystem.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ParticleSystem.hpp"
+#include "DescriptorWriter.hpp"
+#include "SwapChain.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+
+/// \brief Estado de una partícula en el SSBO (std430, 48 bytes).
+struct GpuParticle
+{
+    /// xyz = posición, w = vida restante (s).
+    glm::vec4 positionLife {};
+    /// xyz = velocidad, w = tamaño.
+    glm::vec4 velocitySize {};
+    /// rgb = color, a = 1 / vida inicial.
+    glm::vec4 color {};
+};
+
+/// \brief Instancia que dibuja el render (std430, 32 bytes).
+/// \details La simulación la escribe en la mitad de la lista viva que produce, por lo
+/// que el render de un frame no lee el estado que la simulación del siguiente modifica.
+struct GpuParticleInstance
+{
+    /// xyz = posición, w = tamaño.
+    glm::vec4 positionSize {};
+    /// rgb = color, a = opacidad según la vida restante.
+    glm::vec4 color {};
+};
+
+/// \brief Contadores del anillo de listas y argumentos indirectos.
+/// \details Debe coincidir con el bloque \c Counters de los shaders de partículas.
+struct ParticleCounters
+{
+    /// Entradas válidas en la lista de muertas.
+    uint32_t deadCount;
+    /// Entradas válidas en cada lista viva.
+    uint32_t aliveCount[2];
+    /// Partículas que se emiten este frame.
+    uint32_t emitCount;
+    /// Argumentos del draw indirecto de cada lista viva (6 vértices por instancia).
+    VkDrawIndirectCommand draw[2];
+    /// Argumentos del dispatch de emisión.
+    VkDispatchIndirectCommand emitDispatch;
+    /// Argumentos del dispatch de simulación.
+    VkDispatchIndirectCommand simulateDispatch;
+};
+
+/// \brief Push constants compartidas por los shaders de cómputo y de render.
+struct ParticlePushConstants
+{
+    /// xyz = posición del emisor, w = dispersión.
+    glm::vec4 emitterPosition {};
+    /// xyz = velocidad inicial, w = vida.
+    glm::vec4 emitterVelocity {};
+    /// rgb = color, w = tamaño.
+    glm::vec4 color {};
+    /// xyz = gravedad, w = rozamiento.
+    glm::vec4 gravity {};
+    /// Delta time del frame (s).
+    float deltaTime = 0.0f;
+    /// Partículas solicitadas este frame.
+    uint32_t emitCount = 0;
+    /// Semilla aleatoria.
+    uint32_t seed = 0;
+    /// Lista viva actual del anillo.
+    uint32_t currentList = 0;
+    /// Capacidad (desplazamiento de la segunda lista viva).
+    uint32_t capacity = 0;
+};
+
+/// Tamaño de grupo de trabajo de los shaders de cómputo (local_size_x).
+static constexpr uint32_t PARTICLE_GROUP_SIZE = 64;
+
+/// \brief Construye el sistema, sus búferes y tuberías.
+/// \param device Dispositivo lógico Vulkan.
+/// \param renderPass Render pass donde se dibujan las partículas.
+/// \param globalSetLayout Layout de descriptores global (set 0 en el pase gráfico).
+/// \param capacity Número máximo de partículas vivas.
+ParticleSystem::ParticleSystem(
+    VulkanDevice& device,
+    VkRenderPass renderPass,
+    VkDescriptorSetLayout globalSetLayout,
+    uint32_t capacity)
+    : vulkanDevice{device}, capacity{capacity}
+{
+    createBuffers();
+    createDescriptors();
+    createPipelineLayouts(globalSetLayout);
+    createPipelines(renderPass);
+}
+
+/// \brief Libera recursos asociados.
+ParticleSystem::~ParticleSystem()
+{
+    vkDestroyPipelineLayout(vulkanDevice.getDevice(), computeLayout, nullptr);
+    vkDestroyPipelineLayout(vulkanDevice.getDevice(), renderLayout, nullptr);
+}
+
+/// \brief Crea los SSBOs y sube el estado inicial (todas las partículas muertas).
+void ParticleSystem::createBuffers()
+{
+    particleBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(GpuParticle),
+        capacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    deadListBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(uint32_t),
+        capacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    aliveListBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(uint32_t),
+        2 * capacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    instanceBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(GpuParticleInstance),
+        2 * capacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    counterBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(ParticleCounters),
+        1,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | 
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | 
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    std::vector<uint32_t> deadList(capacity);
+    std::iota(deadList.begin(), deadList.end(), 0u);
+
+    VulkanBuffer deadStaging{
+        vulkanDevice,
+        sizeof(uint32_t),
+        capacity,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+    deadStaging.map();
+    deadStaging.writeToBuffer(deadList.data());
+
+    vulkanDevice.copyBuffer(
+        deadStaging.getBuffer(), 
+        deadListBuffer->getBuffer(), 
+        sizeof(uint32_t) * capacity);
+
+    ParticleCounters counters {};
+    counters.deadCount = capacity;
+    counters.draw[0] = {6, 0, 0, 0};
+    counters.draw[1] = {6, 0, 0, 0};
+    counters.emitDispatch = {0, 1, 1};
+    counters.simulateDispatch = {0, 1, 1};
+
+    VulkanBuffer counterStaging{
+        vulkanDevice,
+        sizeof(ParticleCounters),
+        1,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+    counterStaging.map();
+    counterStaging.writeToBuffer(&counters);
+
+    vulkanDevice.copyBuffer(
+        counterStaging.getBuffer(), 
+        counterBuffer->getBuffer(), 
+        sizeof(ParticleCounters));
+}
+
+/// \brief Crea el layout, el pool y el descriptor set de los SSBOs.
+void ParticleSystem::createDescriptors()
+{
+    const VkShaderStageFlags stages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings;
+
+    for (uint32_t binding = 0; binding < 5; ++binding)
+    {
+        bindings[binding] = VkDescriptorSetLayoutBinding
+        {
+            binding,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            stages,
+            nullptr
+        };
+    }
+
+    setLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, bindings);
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(vulkanDevice, 1, 0, poolSizes);
+
+    VkDescriptorBufferInfo particleInfo = particleBuffer->descriptorInfo();
+    VkDescriptorBufferInfo deadInfo = deadListBuffer->descriptorInfo();
+    VkDescriptorBufferInfo aliveInfo = aliveListBuffer->descriptorInfo();
+    VkDescriptorBufferInfo counterInfo = counterBuffer->descriptorInfo();
+    VkDescriptorBufferInfo instanceInfo = instanceBuffer->descriptorInfo();
+
+    DescriptorWriter(*setLayout, *descriptorPool)
+        .writeBuffer(0, &particleInfo)
+        .writeBuffer(1, &deadInfo)
+        .writeBuffer(2, &aliveInfo)
+        .writeBuffer(3, &counterInfo)
+        .writeBuffer(4, &instanceInfo)
+        .build(descriptorSet);
+}
+
+/// \brief Crea los pipeline layouts de cómputo y de render.
+/// \param globalSetLayout Layout de descriptores global.
+void ParticleSystem::createPipelineLayouts(VkDescriptorSetLayout globalSetLayout)
+{
+    VkPushConstantRange computeRange {};
+    computeRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    computeRange.offset = 0;
+    computeRange.size = sizeof(ParticlePushConstants);
+
+    VkDescriptorSetLayout computeSets[] = {setLayout->get()};
+
+    VkPipelineLayoutCreateInfo computeInfo {};
+    computeInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    computeInfo.setLayoutCount = 1;
+    computeInfo.pSetLayouts = computeSets;
+    computeInfo.pushConstantRangeCount = 1;
+    computeInfo.pPushConstantRanges = &computeRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &computeInfo,
+        nullptr,
+        &computeLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+
+    VkPushConstantRange renderRange {};
+    renderRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    renderRange.offset = 0;
+    renderRange.size = sizeof(ParticlePushConstants);
+
+    std::vector<VkDescriptorSetLayout> renderSets{globalSetLayout, setLayout->get()};
+
+    VkPipelineLayoutCreateInfo renderInfo {};
+    renderInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    renderInfo.setLayoutCount = static_cast<uint32_t>(renderSets.size());
+    renderInfo.pSetLayouts = renderSets.data();
+    renderInfo.pushConstantRangeCount = 1;
+    renderInfo.pPushConstantRanges = &renderRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &renderInfo,
+        nullptr,
+        &renderLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+}
+
+/// \brief Crea las tuberías de cómputo y la gráfica.
+/// \param renderPass Render pass objetivo.
+void ParticleSystem::createPipelines(VkRenderPass renderPass)
+{
+    kickoffPipeline = std::make_unique<ComputePipeline>(
+        vulkanDevice, "shaders/particle_kickoff.comp.spv", computeLayout);
+
+    emitPipeline = std::make_unique<ComputePipeline>(
+        vulkanDevice, "shaders/particle_emit.comp.spv", computeLayout);
+
+    simulatePipeline = std::make_unique<ComputePipeline>(
+        vulkanDevice, "shaders/particle_simulate.comp.spv", computeLayout);
+
+    PipelineConfig pipelineConfig {};
+    GraphicsPipeline::defaultConfig(pipelineConfig);
+    GraphicsPipeline::enableAlphaBlending(pipelineConfig);
+
+    // Mezcla aditiva: el orden de dibujo de las partículas no importa.
+    pipelineConfig.colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    pipelineConfig.depthStencil.depthWriteEnable = VK_FALSE;
+
+    pipelineConfig.attributes.clear();
+    pipelineConfig.bindings.clear();
+    pipelineConfig.renderPass = renderPass;
+    pipelineConfig.layout = renderLayout;
+
+    renderPipeline = std::make_unique<GraphicsPipeline>(
+        vulkanDevice,
+        "shaders/particle.vert.spv",
+        "shaders/particle.frag.spv",
+        pipelineConfig);
+}
+
+/// \brief Graba emisión y simulación en el command buffer de cómputo del frame.
+/// \details Debe llamarse fuera del render pass y antes de \c render. Sólo usa etapas
+/// válidas en una cola de cómputo; si el cómputo va en el command buffer de gráficos
+/// añade la barrera hacia el draw indirecto, y si va en la cola asíncrona esa
+/// dependencia la aporta el semáforo que espera el envío de gráficos.
+/// \param frameInfo Contexto del frame.
+void ParticleSystem::update(FrameInfo& frameInfo)
+{
+    VkCommandBuffer commandBuffer = frameInfo.computeCommandBuffer;
+
+    emitAccumulator += emitter.rate * frameInfo.frameTime;
+    const uint32_t emitCount = std::min(static_cast<uint32_t>(emitAccumulator), capacity);
+    emitAccumulator -= static_cast<float>(emitCount);
+
+    ParticlePushConstants push {};
+    push.emitterPosition = glm::vec4(emitter.position, emitter.spread);
+    push.emitterVelocity = glm::vec4(emitter.velocity, emitter.lifetime);
+    push.color = glm::vec4(emitter.color, emitter.size);
+    push.gravity = glm::vec4(emitter.gravity, emitter.drag);
+    push.deltaTime = frameInfo.frameTime;
+    push.emitCount = emitCount;
+    push.seed = seed++;
+    push.currentList = currentList;
+    push.capacity = capacity;
+
+    // El cómputo del frame anterior debe haber terminado con los búferes. El render sólo
+    // lee la mitad de instancias y argumentos de su propio frame, que se escribió hace
+    // dos frames y está protegida por el fence del frame en vuelo.
+    static_assert(SwapChain::MAX_FRAMES_IN_FLIGHT == 2,
+        "Particle instances and draw args are double-buffered: one half per frame in flight.");
+
+    VkMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        computeLayout,
+        0,
+        1,
+        &descriptorSet,
+        0,
+        nullptr);
+
+    vkCmdPushConstants(
+        commandBuffer,
+        computeLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(ParticlePushConstants),
+        &push);
+
+    // Entre pasos: escrituras de cómputo visibles para el siguiente dispatch y sus argumentos.
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = 
+        VK_ACCESS_SHADER_READ_BIT | 
+        VK_ACCESS_SHADER_WRITE_BIT | 
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    kickoffPipeline->bind(commandBuffer);
+    vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    emitPipeline->bind(commandBuffer);
+    vkCmdDispatchIndirect(
+        commandBuffer, 
+        counterBuffer->getBuffer(), 
+        offsetof(ParticleCounters, emitDispatch));
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    simulatePipeline->bind(commandBuffer);
+    vkCmdDispatchIndirect(
+        commandBuffer, 
+        counterBuffer->getBuffer(), 
+        offsetof(ParticleCounters, simulateDispatch));
+
+    // La simulación produce las instancias y el instanceCount que consume el draw indirecto.
+    if (commandBuffer == frameInfo.commandBuffer)
+    {
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    currentList = 1u - currentList;
+}
+
+/// \brief Dibuja las partículas vivas con un draw indirecto.
+/// \param frameInfo Contexto del frame con el render pass activo.
+void ParticleSystem::render(FrameInfo& frameInfo)
+{
+    renderPipeline->bind(frameInfo.commandBuffer);
+
+    VkDescriptorSet sets[] = {frameInfo.globalDescriptorSet, descriptorSet};
+
+    vkCmdBindDescriptorSets(
+        frameInfo.commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        renderLayout,
+        0,
+        2,
+        sets,
+        0,
+        nullptr);
+
+    ParticlePushConstants push {};
+    push.currentList = currentList;
+    push.capacity = capacity;
+
+    vkCmdPushConstants(
+        frameInfo.commandBuffer,
+        renderLayout,
+        VK_SHADER_STAGE_VERTEX_BIT,
+        0,
+        sizeof(ParticlePushConstants),
+        &push);
+
+    vkCmdDrawIndirect(
+        frameInfo.commandBuffer,
+        counterBuffer->getBuffer(),
+        offsetof(ParticleCounters, draw) + currentList * sizeof(VkDrawIndirectCommand),
+        1,
+        sizeof(VkDrawIndirectCommand));
+}
@@ -7,8 +7,12 @@
  */
 
 #include "Perf.hpp"
+#include "DeviceCapabilities.hpp"
+
 #include <algorithm>
 #include <cmath>
+#include <iomanip>
+#include <ostream>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -16,13 +20,24 @@
 #endif
 
  /// \brief Inicializa el temporizador de GPU.
+ /// \details Si el dispositivo no admite timestamps en la cola de grficos el
+ /// temporizador queda desactivado y \c resolve nunca devuelve datos.
  /// \param device Dispositivo lgico.
  /// \param framesInFlight N de frames en vuelo.
- /// \param timestampPeriodNs Periodo de timestamp del dispositivo.
-void GpuTimer::init(VkDevice dev, uint32_t framesInFlight, double tsPeriodNs)
+ /// \param capabilities Perfil del dispositivo (timestamps, reinicio desde CPU).
+void GpuTimer::init(VkDevice dev, uint32_t framesInFlight, const DeviceCapabilities& capabilities)
 {
     device = dev;
-    timestampPeriodNs = tsPeriodNs;
+    timestampPeriodNs = capabilities.timestampPeriod;
+    hostReset = capabilities.hostQueryReset;
+    written.assign(framesInFlight, false);
+    ticks.assign(2 * framesInFlight, 0);
+
+    if (!capabilities.timestamps)
+    {
+        std::cout << "[Vulkan API] Timestamps unsupported: GPU frame times disabled." << std::endl;
+        return;
+    }
 
     VkQueryPoolCreateInfo ci{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
     ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
@@ -40,15 +55,44 @@ void GpuTimer::destroy()
     }
 }
 
-/// \brief Registra timestamps de inicio y fin en el \c commandBuffer.
+/// \brief Reinicia las consultas del frame y escribe el timestamp inicial.
+/// \details Con \c hostQueryReset el reinicio se hace desde la CPU; si no, se graba
+/// en \c cb, por lo que debe llamarse fuera de un render pass.
 /// \param cb Command buffer donde insertar las consultas.
 /// \param frameIndex ndice de frame en vuelo.
-void GpuTimer::record(VkCommandBuffer cb, uint32_t frameIndex)
+void GpuTimer::begin(VkCommandBuffer cb, uint32_t frameIndex)
 {
+    if (pool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
     const uint32_t base = frameIndex * queriesPerFrame;
-    vkResetQueryPool(device, pool, base, queriesPerFrame);
+
+    if (hostReset)
+    {
+        vkResetQueryPool(device, pool, base, queriesPerFrame);
+    }
+    else
+    {
+        vkCmdResetQueryPool(cb, pool, base, queriesPerFrame);
+    }
+
     vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, base + 0);
-    vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool, base + 1);
+}
+
+/// \brief Escribe el timestamp final del frame.
+/// \param cb Command buffer donde insertar las consultas.
+/// \param frameIndex ndice de frame en vuelo.
+void GpuTimer::end(VkCommandBuffer cb, uint32_t frameIndex)
+{
+    if (pool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool, frameIndex * queriesPerFrame + 1);
+    written[frameIndex] = true;
 }
 
 /// \brief Lee y resuelve las consultas de \c frameIndex a milisegundos.
@@ -57,6 +101,12 @@ void GpuTimer::record(VkCommandBuffer cb, uint32_t frameIndex)
 /// \return \c true si los resultados estaban listos y \c outGpuMs es vlido.
 bool GpuTimer::resolve(uint32_t frameIndex, double& outGpuMs)
 {
+    // Con WAIT_BIT, leer consultas que nunca se han escrito bloqueara indefinidamente.
+    if (pool == VK_NULL_HANDLE || !written[frameIndex])
+    {
+        return (false);
+    }
+
     const uint32_t base = frameIndex * queriesPerFrame;
     uint64_t ts[2] = {};
     VkResult r = vkGetQueryPoolResults(
@@ -70,11 +120,33 @@ bool GpuTimer::resolve(uint32_t frameIndex, double& outGpuMs)
         return (false);
     }
 
+    ticks[base + 0] = ts[0];
+    ticks[base + 1] = ts[1];
+
     const double dtNs = double(ts[1] - ts[0]) * timestampPeriodNs;
     outGpuMs = dtNs / 1.0e6;
     return (true);
 }
 
+/// \brief Timestamps (ticks de dispositivo) de la ltima resolucin de \c frameIndex.
+/// \param frameIndex ndice de frame en vuelo.
+/// \param begin Salida: timestamp inicial.
+/// \param end Salida: timestamp final.
+/// \return \c false si el frame an no se ha resuelto nunca.
+bool GpuTimer::getTicks(uint32_t frameIndex, uint64_t& begin, uint64_t& end) const
+{
+    const uint32_t base = frameIndex * queriesPerFrame;
+
+    if (base + 1 >= ticks.size() || ticks[base + 1] == 0)
+    {
+        return (false);
+    }
+
+    begin = ticks[base + 0];
+    end = ticks[base + 1];
+    return (true);
+}
+
 /// \brief Convierte un \c FILETIME a entero sin signo de 64 bits.
 /// \details Funcin auxiliar especfica de Windows.
 /// \param ft Estructura \c FILETIME.
@@ -181,16 +253,121 @@ void CpuUsageMonitor::tick(double frameCpuMs)
 #endif
 }
 
+/// \brief Aade una fase a la lnea temporal.
+/// \param name Nombre de la fase.
+/// \param thread Hebra que la ejecut.
+/// \param begin Instante de inicio.
+/// \param end Instante de fin.
+void StartupTimeline::addPhase(
+    const std::string& name,
+    uint32_t thread,
+    std::chrono::high_resolution_clock::time_point begin,
+    std::chrono::high_resolution_clock::time_point end)
+{
+    StartupPhase phase {};
+    phase.name = name;
+    phase.thread = thread;
+    phase.startMs = std::chrono::duration<double, std::milli>(begin - epoch).count();
+    phase.endMs = std::chrono::duration<double, std::milli>(end - epoch).count();
+    phases.push_back(phase);
+}
+
+/// \brief Marca el final del primer frame. Slo la primera llamada tiene efecto.
+void StartupTimeline::markFirstFrame()
+{
+    if (hasFirstFrame())
+    {
+        return;
+    }
+
+    firstFrameMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - epoch).count();
+}
+
+/// \brief Vuelca la lnea temporal en formato texto (una fase por lnea).
+/// \param out Flujo de salida.
+void StartupTimeline::print(std::ostream& out) const
+{
+    std::vector<StartupPhase> sorted = phases;
+    std::sort(sorted.begin(), sorted.end(), [](const StartupPhase& a, const StartupPhase& b)
+    {
+        return a.startMs < b.startMs;
+    });
+
+    out << std::fixed << std::setprecision(2);
+
+    for (const StartupPhase& phase : sorted)
+    {
+        out << "[startup] " << std::left << std::setw(24) << phase.name
+            << " thread " << phase.thread
+            << "  " << std::right << std::setw(9) << phase.startMs
+            << " -> " << std::setw(9) << phase.endMs
+            << " ms  (" << (phase.endMs - phase.startMs) << " ms)\n";
+    }
+
+    out << "[startup] time-to-first-frame: " << firstFrameMs << " ms\n";
+}
+
 #include "imgui.h"
 
+/// Espera mnima en la swapchain (ms) para no considerar un frame limitado por CPU.
+static constexpr double BOUND_MIN_WAIT_MS = 0.25;
+/// Fraccin del periodo de frame que debe ocupar la espera dominante.
+static constexpr double BOUND_WAIT_FRACTION = 0.1;
+/// Fraccin del periodo que la GPU debe estar ejecutando para atribuirle la espera
+/// de un fence; si no, el fence lleg tarde por la presentacin (la GPU no empieza
+/// hasta que la imagen est disponible).
+static constexpr double BOUND_GPU_BUSY_FRACTION = 0.8;
+
+/// \brief Clasifica un frame segn dnde se bloque la CPU.
+/// \param blocking Esperas de la swapchain.
+/// \param periodMs Periodo del frame (ms).
+/// \param gpuMs Tiempo de GPU del ltimo frame resuelto (ms).
+static FrameBound classifyFrame(const FrameBlockingTimes& blocking, double periodMs, double gpuMs)
+{
+    const double fenceWait = double(blocking.fenceWaitMs) + double(blocking.imageFenceMs);
+    const double presentWait = double(blocking.acquireMs) + double(blocking.presentMs);
+    const double threshold = std::max(BOUND_MIN_WAIT_MS, BOUND_WAIT_FRACTION * periodMs);
+
+    if (std::max(fenceWait, presentWait) < threshold)
+    {
+        return (FrameBound::Cpu);
+    }
+
+    if (fenceWait >= presentWait && gpuMs >= BOUND_GPU_BUSY_FRACTION * periodMs)
+    {
+        return (FrameBound::Gpu);
+    }
+
+    return (FrameBound::Present);
+}
+
+/// \brief Nombre legible de una clasificacin.
+const char* Perf::boundName(FrameBound bound)
+{
+    switch (bound)
+    {
+        case FrameBound::Gpu:
+            return ("GPU");
+
+        case FrameBound::Present:
+            return ("present");
+
+        default:
+            return ("CPU");
+    }
+}
+
 /// \brief Inicializa el subsistema de rendimiento.
 /// \param device Dispositivo lgico Vulkan.
 /// \param framesInFlight N de frames en vuelo.
-/// \param timestampPeriodNs Periodo de timestamp del dispositivo.
-void Perf::init(VkDevice device, uint32_t framesInFlight, double timestampPeriodNs)
+/// \param capabilities Perfil del dispositivo.
+void Perf::init(VkDevice device, uint32_t framesInFlight, const DeviceCapabilities& capabilities)
 {
     statsRef = PerfStats {};
-    gpuTimer.init(device, framesInFlight, timestampPeriodNs);
+    gpuTimer.init(device, framesInFlight, capabilities);
+    gpuClock.init(device, capabilities);
+    slotSerials.assign(framesInFlight, 0);
     cpuMonitor.init();
 }
 
@@ -233,16 +410,42 @@ void Perf::endCpuFrame()
 
     statsRef.fpsHistory.push(static_cast<float>(statsRef.fps));
     statsRef.cpuMsHistory.push(static_cast<float>(statsRef.cpuFrameMs));
+    statsRef.cpuFrameMsTotal += statsRef.cpuFrameMs;
+    statsRef.cpuFrameCount += 1;
+
+    const FrameBlockingTimes& blocking = statsRef.blocking;
+    const double blockedMs = double(blocking.fenceWaitMs) + blocking.acquireMs +
+        blocking.imageFenceMs + blocking.presentMs;
+
+    // El primer frame no tiene periodo: se toma la duracin en CPU ms las esperas.
+    statsRef.framePeriodMs = (lastFrameEnd.time_since_epoch().count() != 0) ?
+        std::chrono::duration<double, std::milli>(now - lastFrameEnd).count() : ms + blockedMs;
+    statsRef.cpuWorkMs = std::max(statsRef.framePeriodMs - blockedMs, 0.0);
+    statsRef.bound = classifyFrame(blocking, statsRef.framePeriodMs, statsRef.gpuFrameMs);
+    statsRef.boundFrames[static_cast<uint32_t>(statsRef.bound)] += 1;
+    statsRef.boundHistory.push(static_cast<float>(statsRef.bound));
+    statsRef.blockedMsHistory.push(static_cast<float>(blockedMs));
+    lastFrameEnd = now;
 
     uiAccumMs += ms;
 }
 
-/// \brief Inserta consultas GPU en el \c commandBuffer del frame.
+/// \brief Inserta la consulta GPU de inicio de frame (fuera de un render pass).
 /// \param cb Command buffer actual.
 /// \param frameIndex ndice de frame en vuelo.
-void Perf::recordGpu(VkCommandBuffer cb, uint32_t frameIndex)
+void Perf::beginGpu(VkCommandBuffer cb, uint32_t frameIndex)
 {
-    gpuTimer.record(cb, frameIndex);
+    frameSerial += 1;
+    slotSerials[frameIndex] = frameSerial;
+    gpuTimer.begin(cb, frameIndex);
+}
+
+/// \brief Inserta la consulta GPU de fin de frame.
+/// \param cb Command buffer actual.
+/// \param frameIndex ndice de frame en vuelo.
+void Perf::endGpu(VkCommandBuffer cb, uint32_t frameIndex)
+{
+    gpuTimer.end(cb, frameIndex);
 }
 
 /// \brief Resuelve las consultas GPU del frame y actualiza medias/histricos.
@@ -253,6 +456,24 @@ void Perf::resolveGpu(uint32_t frameIndex)
 
     if (gpuTimer.resolve(frameIndex, gpuMs))
     {
+        // El fence del frame ya se ha esperado: la GPU termin antes de este instante.
+        const std::chrono::steady_clock::time_point observed = std::chrono::steady_clock::now();
+        uint64_t begin = 0;
+        uint64_t end = 0;
+
+        if (gpuTimer.getTicks(frameIndex, begin, end))
+        {
+            gpuClock.update(end, observed);
+
+            if (gpuClock.isValid())
+            {
+                lastGpuFrame.serial = slotSerials[frameIndex];
+                lastGpuFrame.beginNs = gpuClock.toHostNs(begin);
+                lastGpuFrame.endNs = gpuClock.toHostNs(end);
+                hasGpuFrame = true;
+            }
+        }
+
         statsRef.gpuFrameMs = gpuMs;
 
         if (statsRef.gpuFrameMsAvg <= 0.0)
@@ -263,6 +484,8 @@ void Perf::resolveGpu(uint32_t frameIndex)
         statsRef.gpuFrameMsAvg = 0.9 * statsRef.gpuFrameMsAvg + 0.1 * gpuMs;
 
         statsRef.gpuMsHistory.push(static_cast<float>(gpuMs));
+        statsRef.gpuFrameMsTotal += gpuMs;
+        statsRef.gpuFrameCount += 1;
     }
 }
 
@@ -288,6 +511,41 @@ void Perf::tickMonitors()
     }
 }
 
+/// \brief Actualiza el estado del gobernador de calidad y su histrico de nivel.
+/// \param stats Estado del gobernador en este frame.
+void Perf::setQualityStats(const QualityStats& stats)
+{
+    quality = stats;
+    hasQuality = true;
+    qualityHistory.push(static_cast<float>(stats.level));
+}
+
+/// \brief Aade una decisin del gobernador de calidad al histrico.
+/// \param decision Cambio de nivel decidido.
+void Perf::recordQualityDecision(const QualityDecision& decision)
+{
+    qualityDecisions.push_back(decision);
+    qualityDecisionCount += 1;
+
+    if (qualityDecisions.size() > MAX_QUALITY_DECISIONS)
+    {
+        qualityDecisions.pop_front();
+    }
+}
+
+/// \brief Registra un frame lento (se muestra como marca en el panel).
+/// \param hitch Frame detectado.
+void Perf::recordHitch(const HitchRecord& hitch)
+{
+    hitches.push_back(hitch);
+    hitchCount += 1;
+
+    if (hitches.size() > MAX_HITCHES)
+    {
+        hitches.pop_front();
+    }
+}
+
 /// \brief Dibuja el panel de rendimiento en ImGui.
 /// \param pOpen Puntero opcional a flag de visibilidad del panel.
 void Perf::drawImGui(bool* pOpen)
@@ -298,6 +556,15 @@ void Perf::drawImGui(bool* pOpen)
         ImGui::Text("CPU frame: %.2f ms   (avg %.2f ms)", dispCpuMs, dispCpuMsAvg);
         ImGui::Text("GPU frame: %.2f ms   (avg %.2f ms)", dispGpuMs, dispGpuMsAvg);
         ImGui::Text("CPU usage: system %.1f%%   process %.1f%%", dispCpuSys, dispCpuProc);
+        ImGui::Text("Bound: %s", boundName(statsRef.bound));
+
+        if (!hitches.empty())
+        {
+            const HitchRecord& last = hitches.back();
+            ImGui::TextColored(ImVec4(1.0f, 0.45f, 0.3f, 1.0f), "Hitches: %llu   last frame %llu: %.1f ms > %.1f ms",
+                static_cast<unsigned long long>(hitchCount), static_cast<unsigned long long>(last.serial),
+                last.frameMs, last.thresholdMs);
+        }
 
         ImGui::Separator();
         ImGui::PlotLines("FPS",
@@ -322,6 +589,171 @@ void Perf::drawImGui(bool* pOpen)
             0.0f, 33.0f,
             ImVec2(300, 80));
 
+        if (startup && ImGui::CollapsingHeader("Startup"))
+        {
+            const std::vector<StartupPhase>& phases = startup->getPhases();
+            double totalMs = startup->timeToFirstFrameMs();
+
+            for (const StartupPhase& phase : phases)
+            {
+                totalMs = std::max(totalMs, phase.endMs);
+            }
+
+            ImGui::Text("Time to first frame: %.2f ms", startup->timeToFirstFrameMs());
+
+            const float width = 300.0f;
+            const float rowHeight = ImGui::GetTextLineHeight();
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+            for (const StartupPhase& phase : phases)
+            {
+                const ImVec2 origin = ImGui::GetCursorScreenPos();
+                const float x0 = origin.x + float(phase.startMs / totalMs) * width;
+                const float x1 = origin.x + std::max(float(phase.endMs / totalMs) * width, x0 - origin.x + 1.0f);
+
+                drawList->AddRectFilled(
+                    ImVec2(origin.x, origin.y),
+                    ImVec2(origin.x + width, origin.y + rowHeight),
+                    IM_COL32(40, 40, 40, 255));
+                drawList->AddRectFilled(
+                    ImVec2(x0, origin.y),
+                    ImVec2(x1, origin.y + rowHeight),
+                    IM_COL32(90, 160 - 20 * int(phase.thread % 5), 230, 255));
+
+                ImGui::Dummy(ImVec2(width, rowHeight));
+                ImGui::SameLine();
+                ImGui::Text("%-18s t%u %7.2f ms", phase.name.c_str(), phase.thread, phase.endMs - phase.startMs);
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Frame bound"))
+        {
+            const FrameBlockingTimes& blocking = statsRef.blocking;
+
+            ImGui::Text("Period %.2f ms   CPU work %.2f ms   GPU %.2f ms",
+                statsRef.framePeriodMs, statsRef.cpuWorkMs, statsRef.gpuFrameMs);
+            ImGui::Text("Fence %.2f ms   acquire %.2f ms   image fence %.2f ms",
+                blocking.fenceWaitMs, blocking.acquireMs, blocking.imageFenceMs);
+            ImGui::Text("Submit %.2f ms   present %.2f ms",
+                blocking.submitMs, blocking.presentMs);
+            ImGui::Text("GPU clock: %s   deviation %.2f us",
+                ClockCalibration::domainName(gpuClock.getDomain()), gpuClock.getDeviationNs() / 1000.0);
+
+            std::array<int, 3> recent {};
+
+            for (float value : statsRef.boundHistory.data)
+            {
+                recent[std::min(static_cast<size_t>(value), recent.size() - 1)] += 1;
+            }
+
+            const float window = float(PerfRing::Count);
+            ImGui::Text("Last %d frames: CPU %.0f%%   GPU %.0f%%   present %.0f%%",
+                static_cast<int>(PerfRing::Count),
+                100.0f * recent[0] / window, 100.0f * recent[1] / window, 100.0f * recent[2] / window);
+
+            ImGui::PlotLines("Blocked ms",
+                statsRef.blockedMsHistory.raw(),
+                statsRef.blockedMsHistory.size(),
+                statsRef.blockedMsHistory.size() - 1,
+                nullptr,
+                0.0f, 33.0f,
+                ImVec2(300, 60));
+        }
+
+        if (hasStreaming && ImGui::CollapsingHeader("Streaming"))
+        {
+            const double mib = 1.0 / (1024.0 * 1024.0);
+
+            ImGui::Text("Cells: %u resident   %u pending", streaming.residentCells, streaming.pendingCells);
+            ImGui::Text("Host: %.1f / %.1f MiB",
+                double(streaming.hostBytes) * mib, double(streaming.hostBudget) * mib);
+            ImGui::ProgressBar(
+                streaming.hostBudget ? float(double(streaming.hostBytes) / double(streaming.hostBudget)) : 0.0f,
+                ImVec2(300, 0));
+            ImGui::Text("GPU:  %.1f / %.1f MiB",
+                double(streaming.gpuBytes) * mib, double(streaming.gpuBudget) * mib);
+            ImGui::ProgressBar(
+                streaming.gpuBudget ? float(double(streaming.gpuBytes) / double(streaming.gpuBudget)) : 0.0f,
+                ImVec2(300, 0));
+            ImGui::Text("I/O: %.2f MiB/s", streaming.ioBytesPerSecond * mib);
+        }
+
+        if (hasAsyncCompute && ImGui::CollapsingHeader("Async compute"))
+        {
+            if (asyncCompute.enabled)
+            {
+                ImGui::Text("Compute %.3f ms   overlap %.3f ms (%.0f%%)",
+                    asyncCompute.computeMs, asyncCompute.overlapMs, asyncCompute.overlapRatio * 100.0f);
+
+                ImGui::PlotLines("Overlap %",
+                    overlapHistory.raw(),
+                    overlapHistory.size(),
+                    static_cast<int>(overlapHistory.head),
+                    nullptr,
+                    0.0f, 100.0f,
+                    ImVec2(300, 60));
+            }
+            else
+            {
+                ImGui::TextDisabled("No dedicated compute queue: compute runs on the graphics queue.");
+            }
+        }
+
+        if (hasLightGrid && ImGui::CollapsingHeader("Light grid"))
+        {
+            ImGui::Text("Lights %u   objects %u", lightGrid.lights, lightGrid.objects);
+            ImGui::Text("Per object: %.2f lights   %.1f candidates",
+                lightGrid.lightsPerObject, lightGrid.candidatesPerObject);
+            ImGui::Text("Build %.3f ms   assign %.3f ms", lightGrid.buildMs, lightGrid.assignMs);
+
+            ImGui::PlotLines("Grid ms",
+                lightGridHistory.raw(),
+                lightGridHistory.size(),
+                static_cast<int>(lightGridHistory.head),
+                nullptr,
+                0.0f, 2.0f,
+                ImVec2(300, 60));
+        }
+
+        if (hasQuality && ImGui::CollapsingHeader("Quality"))
+        {
+            ImGui::Text("Level %u / %u   frame %.2f ms   target %.2f ms   PID %.2f",
+                quality.level, quality.levelCount - 1, quality.frameMs, quality.targetMs, quality.output);
+
+            if (qualityLock)
+            {
+                ImGui::Checkbox("Lock quality", qualityLock);
+            }
+
+            ImGui::PlotLines("Level",
+                qualityHistory.raw(),
+                qualityHistory.size(),
+                static_cast<int>(qualityHistory.head),
+                nullptr,
+                0.0f, float(quality.levelCount - 1),
+                ImVec2(300, 60));
+
+            const size_t shown = std::min<size_t>(qualityDecisions.size(), 8);
+
+            for (size_t i = qualityDecisions.size() - shown; i < qualityDecisions.size(); ++i)
+            {
+                const QualityDecision& d = qualityDecisions[i];
+                ImGui::Text("%7.2f s  %u -> %u  %.2f ms  lod %.2f  lights %u  ui 1/%u",
+                    d.timeSeconds, d.fromLevel, d.toLevel, d.frameMs,
+                    d.lodBias, d.maxShadedLights, d.uiRefreshInterval);
+            }
+        }
+
+        if (!hitches.empty() && ImGui::CollapsingHeader("Hitches"))
+        {
+            for (auto it = hitches.rbegin(); it != hitches.rend(); ++it)
+            {
+                ImGui::Text("%7.2f s  frame %llu  %.1f ms > %.1f ms  %s",
+                    it->timeSeconds, static_cast<unsigned long long>(it->serial), it->frameMs, it->thresholdMs,
+                    it->tracePath.empty() ? "(rate-limited)" : it->tracePath.c_str());
+            }
+        }
+
         ImGui::Separator();
         ImGui::TextDisabled("UI refresh: %d ms (suavizado EMA 0.1).", uiPeriodMs);
         ImGui::SliderInt("UI period (ms)", &uiPeriodMs, 100, 1000);
@@ -8,8 +8,10 @@
 
 #include "PointLightRenderer.hpp"
 
+#include <algorithm>
 #include <map>
 #include <stdexcept>
+#include <vector>
 
 /// \brief Push constants de la luz puntual.
 /// \details Datos mínimos que el shader necesita por luz: posición, color y radio de influencia.
@@ -101,7 +103,7 @@ void PointLightSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo)
     glm::mat4 rotateLight =
         glm::rotate(glm::mat4(1.0f), 0.5f * frameInfo.frameTime, {0.0f, -1.0f, 0.0f});
 
-    int lightIndex = 0;
+    std::vector<std::pair<float, GameObject*>> lights;
 
     for (std::pair<const unsigned int, GameObject>& kv : frameInfo.gameObjects) 
     {
@@ -112,18 +114,37 @@ void PointLightSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo)
             continue;
         }
 
-        assert(lightIndex < MAX_LIGHTS && "Point lights exceed maximum specified");
+        // Las luces horneadas deben quedarse donde se hornearon.
+        if (!obj.light->baked)
+        {
+            obj.transform.translation =
+                glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.0f));
+        }
 
-        obj.transform.translation =
-            glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.0f));
+        const glm::vec3 offset = frameInfo.camera.getPosition() - obj.transform.translation;
+        lights.push_back({glm::dot(offset, offset), &obj});
+    }
 
-        ubo.pointLights[lightIndex].position = glm::vec4(obj.transform.translation, 1.0f);
-        ubo.pointLights[lightIndex].color = glm::vec4(obj.color, obj.light->intensity);
+    const size_t shaded = std::min(lights.size(), size_t(std::min<uint32_t>(maxShadedLights, MAX_LIGHTS)));
+
+    if (shaded < lights.size())
+    {
+        std::partial_sort(lights.begin(), lights.begin() + shaded, lights.end(),
+            [](const std::pair<float, GameObject*>& a, const std::pair<float, GameObject*>& b)
+        {
+            return (a.first < b.first);
+        });
+    }
+
+    for (size_t i = 0; i < shaded; ++i)
+    {
+        const GameObject& obj = *lights[i].second;
 
-        lightIndex += 1;
+        ubo.pointLights[i].position = glm::vec4(obj.transform.translation, 1.0f);
+        ubo.pointLights[i].color = glm::vec4(obj.color, obj.light->intensity);
     }
 
-    ubo.numLights = lightIndex;
+    ubo.numLights = static_cast<uint32_t>(shaded);
 }
 
 /// \brief Emite los comandos de dibujo de las luces puntuales.
@@ -0,0 +1,435 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: PrecisionBench.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "PrecisionBench.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+/// \brief Indica si el formato tiene cuatro canales de 8 bits (comparable byte a byte).
+static bool isEightBitColor(VkFormat format)
+{
+    switch (format)
+    {
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return (true);
+
+        default:
+            return (false);
+    }
+}
+
+/// \brief Crea las imágenes, el render pass, el framebuffer y el búfer de lectura.
+/// \param device Dispositivo lógico Vulkan.
+/// \param colorFormat Formato de color de la swapchain.
+/// \param depthFormat Formato de profundidad de la swapchain.
+/// \param extent Tamaño de la imagen.
+PrecisionBench::PrecisionBench(
+    VulkanDevice& device, 
+    VkFormat colorFormat, 
+    VkFormat depthFormat, 
+    VkExtent2D extent)
+    : device{device}, colorFormat{colorFormat}, depthFormat{depthFormat}, extent{extent}
+{
+    createRenderPass();
+    createTargets();
+
+    readback = std::make_unique<VulkanBuffer>(
+        device,
+        4,
+        extent.width * extent.height,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    readback->map();
+
+    if (device.getCapabilities().timestamps)
+    {
+        VkQueryPoolCreateInfo queryInfo {};
+        queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryInfo.queryCount = 2 * ITERATIONS;
+
+        if (vkCreateQueryPool(device.getDevice(), &queryInfo, nullptr, &queryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create precision bench query pool.");
+        }
+    }
+}
+
+/// \brief Libera los recursos.
+PrecisionBench::~PrecisionBench()
+{
+    const VkDevice vkDevice = device.getDevice();
+
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(vkDevice, queryPool, nullptr);
+    }
+
+    vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+    vkDestroyImageView(vkDevice, colorView, nullptr);
+    vkDestroyImage(vkDevice, colorImage, nullptr);
+    vkFreeMemory(vkDevice, colorMemory, nullptr);
+    vkDestroyImageView(vkDevice, depthView, nullptr);
+    vkDestroyImage(vkDevice, depthImage, nullptr);
+    vkFreeMemory(vkDevice, depthMemory, nullptr);
+    vkDestroyRenderPass(vkDevice, renderPass, nullptr);
+}
+
+/// \brief Crea el render pass (compatible con el de la swapchain).
+/// \details Mismos adjuntos, formatos y dependencia que \c SwapChain::createRenderPass;
+/// sólo cambia el layout final del color, que queda listo para copiarlo.
+void PrecisionBench::createRenderPass()
+{
+    VkAttachmentDescription colorAttachment {};
+    colorAttachment.format = colorFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkAttachmentDescription depthAttachment {};
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkSubpassDependency dependency {};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | 
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+
+    dependency.dstStageMask = dependency.srcStageMask;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | 
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+    VkRenderPassCreateInfo renderPassInfo {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+
+    if (vkCreateRenderPass(device.getDevice(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create precision bench render pass.");
+    }
+}
+
+/// \brief Crea las imágenes de color y profundidad, sus vistas y el framebuffer.
+void PrecisionBench::createTargets()
+{
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {extent.width, extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = colorFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImage, colorMemory);
+
+    imageInfo.format = depthFormat;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthMemory);
+
+    VkImageViewCreateInfo viewInfo {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = colorImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = colorFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &colorView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create precision bench color view.");
+    }
+
+    viewInfo.image = depthImage;
+    viewInfo.format = depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &depthView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create precision bench depth view.");
+    }
+
+    std::array<VkImageView, 2> attachments = {colorView, depthView};
+
+    VkFramebufferCreateInfo framebufferInfo {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments = attachments.data();
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    if (vkCreateFramebuffer(device.getDevice(), &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create precision bench framebuffer.");
+    }
+}
+
+/// \brief Renderiza \c ITERATIONS veces con una variante y lee la última imagen.
+/// \param renderer Renderizador.
+/// \param frameInfo Contexto del último frame.
+/// \param halfPrecision Variante a usar.
+/// \param pixels Salida: imagen leída.
+/// \return Mediana del tiempo de GPU (ms), o 0 sin timestamps.
+float PrecisionBench::renderVariant(
+    BasicRenderer& renderer,
+    const FrameInfo& frameInfo,
+    bool halfPrecision,
+    std::vector<uint8_t>& pixels)
+{
+    renderer.setHalfPrecision(halfPrecision);
+
+    VkCommandBuffer commandBuffer = device.beginSingleUseCommands();
+
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2 * ITERATIONS);
+    }
+
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = {0.01f, 0.01f, 0.01f, 1.0f};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    beginInfo.renderPass = renderPass;
+    beginInfo.framebuffer = framebuffer;
+    beginInfo.renderArea.extent = extent;
+    beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    beginInfo.pClearValues = clearValues.data();
+
+    VkViewport viewport {0.0f, 0.0f, float(extent.width), float(extent.height), 0.0f, 1.0f};
+    VkRect2D scissor {{0, 0}, extent};
+
+    FrameInfo info = frameInfo;
+    info.commandBuffer = commandBuffer;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        if (queryPool != VK_NULL_HANDLE)
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 2 * i);
+        }
+
+        vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        renderer.render(info);
+
+        vkCmdEndRenderPass(commandBuffer);
+
+        if (queryPool != VK_NULL_HANDLE)
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 2 * i + 1);
+        }
+    }
+
+    VkImageMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = colorImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region {};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {extent.width, extent.height, 1};
+
+    vkCmdCopyImageToBuffer(
+        commandBuffer,
+        colorImage,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        readback->getBuffer(),
+        1,
+        &region);
+
+    device.endSingleUseCommands(commandBuffer);
+
+    const uint8_t* mapped = static_cast<const uint8_t*>(readback->getMappedMemory());
+    pixels.assign(mapped, mapped + size_t(extent.width) * extent.height * 4);
+
+    if (queryPool == VK_NULL_HANDLE)
+    {
+        return (0.0f);
+    }
+
+    std::vector<uint64_t> ticks(2 * ITERATIONS);
+
+    vkGetQueryPoolResults(
+        device.getDevice(),
+        queryPool,
+        0,
+        2 * ITERATIONS,
+        ticks.size() * sizeof(uint64_t),
+        ticks.data(),
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+    std::vector<float> ms(ITERATIONS);
+    const double period = device.getCapabilities().timestampPeriod;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        ms[i] = float(double(ticks[2 * i + 1] - ticks[2 * i]) * period * 1e-6);
+    }
+
+    std::nth_element(ms.begin(), ms.begin() + ITERATIONS / 2, ms.end());
+
+    return (ms[ITERATIONS / 2]);
+}
+
+/// \brief Renderiza con fp32 y fp16 y compara tiempos e imágenes.
+/// \details Deja activa en \c renderer la variante que lo estaba al llamar.
+/// \param renderer Renderizador con variante fp16 disponible.
+/// \param frameInfo Contexto del último frame (su command buffer no se usa).
+/// \return Resultado de la comparación.
+PrecisionBenchResult PrecisionBench::run(BasicRenderer& renderer, const FrameInfo& frameInfo)
+{
+    const bool wasHalf = renderer.isHalfPrecision();
+
+    std::vector<uint8_t> reference;
+    std::vector<uint8_t> half;
+
+    PrecisionBenchResult result {};
+    result.fp32Ms = renderVariant(renderer, frameInfo, false, reference);
+    result.fp16Ms = renderVariant(renderer, frameInfo, true, half);
+    result.timed = queryPool != VK_NULL_HANDLE;
+
+    renderer.setHalfPrecision(wasHalf);
+
+    if (!isEightBitColor(colorFormat))
+    {
+        return (result);
+    }
+
+    result.compared = true;
+
+    uint64_t sum = 0;
+    uint64_t sumSquares = 0;
+    uint64_t differing = 0;
+    const size_t pixelCount = reference.size() / 4;
+
+    for (size_t p = 0; p < pixelCount; ++p)
+    {
+        uint32_t pixelMax = 0;
+
+        // Sólo RGB: el alfa es siempre 1.
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const uint32_t difference = 
+                uint32_t(std::abs(int(reference[4 * p + c]) - int(half[4 * p + c])));
+
+            sum += difference;
+            sumSquares += uint64_t(difference) * difference;
+            pixelMax = std::max(pixelMax, difference);
+        }
+
+        result.maxDifference = std::max(result.maxDifference, pixelMax);
+        differing += (pixelMax > TOLERANCE) ? 1 : 0;
+    }
+
+    const double samples = double(std::max<size_t>(pixelCount * 3, 1));
+    const double mse = double(sumSquares) / samples;
+
+    result.meanDifference = double(sum) / samples;
+    result.psnr = (mse > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / mse) : INFINITY;
+    result.differingPixels = double(differing) / double(std::max<size_t>(pixelCount, 1));
+
+    return (result);
+}
+
+/// \brief Imprime el resultado en una línea.
+/// \param result Resultado de \c run.
+/// \param out Flujo de salida.
+void PrecisionBench::print(const PrecisionBenchResult& result, std::ostream& out)
+{
+    out << std::fixed << "[fp16] ";
+
+    if (result.timed)
+    {
+        out << std::setprecision(3) << "fp32 " << result.fp32Ms << " ms, fp16 " << result.fp16Ms << " ms ("
+            << std::setprecision(2) << (result.fp16Ms > 0.0f ? result.fp32Ms / result.fp16Ms : 0.0f) << "x)";
+    }
+    else
+    {
+        out << "no timestamps";
+    }
+
+    if (result.compared)
+    {
+        out << std::setprecision(3) << ", diff max " << result.maxDifference << "/255, mean "
+            << result.meanDifference << ", PSNR ";
+
+        if (std::isinf(result.psnr))
+        {
+            out << "inf";
+        }
+        else
+        {
+            out << std::setprecision(1) << result.psnr << " dB";
+        }
+
+        out << ", " << std::setprecision(2) << result.differingPixels * 100.0 << "% pixels > " 
+            << TOLERANCE << "/255";
+    }
+    else
+    {
+        out << ", image diff skipped (color format is not 8-bit)";
+    }
+
+    out << '\n';
+}
@@ -0,0 +1,250 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ProbeGrid.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ProbeGrid.hpp"
+#include "DescriptorWriter.hpp"
+#include "LightGrid.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/// Tamaño del grupo de trabajo de \c probe_update.comp.
+static constexpr uint32_t PROBE_GROUP_SIZE = 64;
+/// \c vec4 de la cabecera del SSBO de sondas (origen, separación y resolución).
+static constexpr uint32_t HEADER_VECTORS = 3;
+
+/// \brief Push constants de \c probe_update.comp.
+struct ProbePushConstants
+{
+    /// Posición de la primera sonda (xyz).
+    glm::vec4 origin {};
+    /// Distancia entre sondas (xyz).
+    glm::vec4 spacing {};
+    /// Sondas por eje (xyz) y total (w).
+    glm::uvec4 resolution {};
+    /// Primera sonda a recalcular.
+    uint32_t first = 0;
+    /// Sondas a recalcular.
+    uint32_t count = 0;
+    /// Luces del SSBO de \c LightGrid.
+    uint32_t lightCount = 0;
+    /// Relleno hasta 16 bytes.
+    uint32_t padding = 0;
+};
+
+/// \brief Crea los SSBO de las sondas, los descriptores y la tubería de cómputo.
+/// \param device Dispositivo lógico Vulkan.
+/// \param lightGrid Origen del SSBO de luces de cada frame.
+/// \param framesInFlight Nº de frames en vuelo.
+/// \param settings Resolución, caja y sondas por frame.
+ProbeGrid::ProbeGrid(
+    VulkanDevice& device,
+    const LightGrid& lightGrid,
+    uint32_t framesInFlight,
+    const ProbeGridSettings& settings)
+    : vulkanDevice{device}, settings{settings}
+{
+    // Con menos de dos sondas por eje no hay nada entre lo que interpolar.
+    this->settings.resolution = glm::max(this->settings.resolution, glm::uvec3(2));
+    probeCount = this->settings.resolution.x * this->settings.resolution.y * this->settings.resolution.z;
+
+    setBounds(this->settings.boundsMin, this->settings.boundsMax);
+
+    const uint32_t coefficientCount = probeCount * COEFFICIENTS;
+
+    probeBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(glm::vec4),
+        HEADER_VECTORS + coefficientCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    bakedBuffer = std::make_unique<VulkanBuffer>(
+        vulkanDevice,
+        sizeof(glm::vec4),
+        coefficientCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    bakedBuffer->map();
+    std::memset(bakedBuffer->getMappedMemory(), 0, sizeof(glm::vec4) * coefficientCount);
+
+    createDescriptors(lightGrid, framesInFlight);
+    createPipeline();
+}
+
+/// \brief Libera el pipeline layout.
+ProbeGrid::~ProbeGrid()
+{
+    vkDestroyPipelineLayout(vulkanDevice.getDevice(), pipelineLayout, nullptr);
+}
+
+/// \brief Ajusta la rejilla a una caja: cada sonda queda en el centro de su celda.
+/// \details La siguiente llamada a \c update recalcula todas las sondas.
+/// \param boundsMin Esquina mínima en mundo.
+/// \param boundsMax Esquina máxima en mundo.
+void ProbeGrid::setBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    settings.boundsMin = boundsMin;
+    settings.boundsMax = boundsMax;
+
+    spacing = glm::max(boundsMax - boundsMin, glm::vec3(1e-3f)) / glm::vec3(settings.resolution);
+    origin = boundsMin + 0.5f * spacing;
+    refreshAll = true;
+}
+
+/// \brief Sustituye la parte horneada de las sondas.
+/// \details Debe llamarse antes del primer frame (el SSBO no está protegido contra
+/// lecturas en vuelo).
+/// \param coefficients \c COEFFICIENTS valores por sonda (ver \c LightBaker::bakeProbes).
+void ProbeGrid::setBaked(const std::vector<glm::vec4>& coefficients)
+{
+    const size_t count = std::min(coefficients.size(), size_t(probeCount) * COEFFICIENTS);
+
+    std::memcpy(bakedBuffer->getMappedMemory(), coefficients.data(), sizeof(glm::vec4) * count);
+    refreshAll = true;
+}
+
+/// \brief Recalcula las siguientes \c probesPerFrame sondas en el command buffer del frame.
+/// \details Debe llamarse fuera del render pass, después de \c LightGrid::update y
+/// antes de dibujar la escena. Tras \c setBounds recalcula todas.
+/// \param frameInfo Contexto del frame.
+/// \param lightCount Luces dinámicas al principio del SSBO de \c LightGrid
+/// (\c LightGrid::getDynamicLightCount); las horneadas ya están en \c setBaked.
+void ProbeGrid::update(FrameInfo& frameInfo, uint32_t lightCount)
+{
+    VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+    ProbePushConstants push {};
+    push.origin = glm::vec4(origin, 0.0f);
+    push.spacing = glm::vec4(spacing, 0.0f);
+    push.resolution = glm::uvec4(settings.resolution, probeCount);
+    push.first = refreshAll ? 0 : cursor;
+    push.count = refreshAll ? probeCount : std::clamp(settings.probesPerFrame, 1u, probeCount);
+    push.lightCount = lightCount;
+
+    cursor = (push.first + push.count) % probeCount;
+    refreshAll = false;
+
+    // Sólo un buffer de sondas: los fragmentos de frames anteriores deben haber terminado
+    // de leerlo.
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    updatePipeline->bind(commandBuffer);
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipelineLayout,
+        0,
+        1,
+        &descriptorSets[frameInfo.frameIndex],
+        0,
+        nullptr);
+
+    vkCmdPushConstants(
+        commandBuffer,
+        pipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(ProbePushConstants),
+        &push);
+
+    vkCmdDispatch(commandBuffer, (push.count + PROBE_GROUP_SIZE - 1) / PROBE_GROUP_SIZE, 1, 1);
+
+    // Las sondas recalculadas deben ser visibles para los fragmentos del frame.
+    VkMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+/// \brief Crea el layout, el pool y un descriptor set por frame en vuelo.
+/// \param lightGrid Origen del SSBO de luces.
+/// \param framesInFlight Nº de frames en vuelo.
+void ProbeGrid::createDescriptors(const LightGrid& lightGrid, uint32_t framesInFlight)
+{
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings;
+
+    for (uint32_t binding = 0; binding < 3; ++binding)
+    {
+        bindings[binding] = VkDescriptorSetLayoutBinding
+        {
+            binding,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        };
+    }
+
+    setLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, bindings);
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * framesInFlight}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(vulkanDevice, framesInFlight, 0, poolSizes);
+    descriptorSets.resize(framesInFlight);
+
+    VkDescriptorBufferInfo bakedInfo = bakedBuffer->descriptorInfo();
+    VkDescriptorBufferInfo probeInfo = probeBuffer->descriptorInfo();
+
+    for (uint32_t frame = 0; frame < framesInFlight; ++frame)
+    {
+        VkDescriptorBufferInfo lightsInfo = lightGrid.lightsInfo(frame);
+
+        DescriptorWriter(*setLayout, *descriptorPool)
+            .writeBuffer(0, &lightsInfo)
+            .writeBuffer(1, &bakedInfo)
+            .writeBuffer(2, &probeInfo)
+            .build(descriptorSets[frame]);
+    }
+}
+
+/// \brief Crea el pipeline layout y la tubería de \c probe_update.comp.
+void ProbeGrid::createPipeline()
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(ProbePushConstants);
+
+    VkDescriptorSetLayout sets[] = {setLayout->get()};
+
+    VkPipelineLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = sets;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &layoutInfo,
+        nullptr,
+        &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+
+    updatePipeline = std::make_unique<ComputePipeline>(
+        vulkanDevice, "shaders/probe_update.comp.spv", pipelineLayout);
+}
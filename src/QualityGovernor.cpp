@@ -0,0 +1,156 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: QualityGovernor.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "QualityGovernor.hpp"
+
+#include "LightGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/// \brief Crea el gobernador en el nivel máximo de calidad.
+/// \param settings Configuración del controlador y rangos de los parámetros.
+QualityGovernor::QualityGovernor(const QualityGovernorSettings& settings) : settings(settings)
+{
+    this->settings.levels = std::max(this->settings.levels, 2u);
+
+    // Por encima del tope de LightGrid varios niveles aplicarían el mismo número de luces.
+    this->settings.low.maxShadedLights = std::min(this->settings.low.maxShadedLights, LightGrid::MAX_OBJECT_LIGHTS);
+    this->settings.high.maxShadedLights = std::min(this->settings.high.maxShadedLights, LightGrid::MAX_OBJECT_LIGHTS);
+
+    level = this->settings.levels - 1;
+    applyLevel();
+}
+
+/// \brief Actualiza el controlador con las métricas del último frame.
+/// \details El controlador trabaja en forma posicional: calidad = 1 - salida PID, de
+/// modo que con error nulo y sin integral acumulada se usa la calidad máxima. La
+/// integral sólo se acumula mientras la calidad no está saturada (anti-windup).
+/// \param perf Métricas de rendimiento; recibe el estado y las decisiones.
+/// \param frameTime Duración del último frame (s).
+/// \return \c true si ha cambiado el nivel de calidad.
+bool QualityGovernor::update(Perf& perf, float frameTime)
+{
+    const PerfStats& stats = perf.stats();
+    const float frameMs = static_cast<float>(std::max(stats.cpuFrameMsAvg, stats.gpuFrameMsAvg));
+
+    QualityStats state {};
+    state.level = level;
+    state.levelCount = settings.levels;
+    state.frameMs = frameMs;
+    state.targetMs = settings.targetFrameMs;
+    state.locked = locked;
+
+    if (locked || frameTime <= 0.0f || frameMs <= 0.0f)
+    {
+        perf.setQualityStats(state);
+        return (false);
+    }
+
+    elapsed += frameTime;
+
+    float error = (frameMs - settings.targetFrameMs) / settings.targetFrameMs;
+
+    if (std::fabs(error) < settings.deadband)
+    {
+        error = 0.0f;
+    }
+
+    const float derivative = (error - previousError) / frameTime;
+    previousError = error;
+
+    const float candidateIntegral = integral + error * frameTime;
+    float output = settings.kp * error + settings.ki * candidateIntegral + settings.kd * derivative;
+
+    if (output > 0.0f && output < 1.0f)
+    {
+        integral = candidateIntegral;
+    }
+    else
+    {
+        output = settings.kp * error + settings.ki * integral + settings.kd * derivative;
+    }
+
+    const float quality = std::clamp(1.0f - output, 0.0f, 1.0f);
+    const float continuous = quality * static_cast<float>(settings.levels - 1);
+    const float current = static_cast<float>(level);
+    const double sinceDecision = elapsed - lastDecision;
+
+    uint32_t next = level;
+
+    if (continuous < current - 0.5f - settings.levelHysteresis && sinceDecision >= settings.downHoldSeconds)
+    {
+        // Bajar puede saltar varios niveles: un pico sostenido debe corregirse rápido.
+        next = static_cast<uint32_t>(std::max(0.0f, std::floor(continuous + 0.5f)));
+    }
+    else if (continuous > current + 0.5f + settings.levelHysteresis && sinceDecision >= settings.upHoldSeconds)
+    {
+        // Subir es siempre de un nivel en un nivel.
+        next = level + 1;
+    }
+
+    state.output = output;
+
+    if (next == level)
+    {
+        perf.setQualityStats(state);
+        return (false);
+    }
+
+    QualityDecision decision {};
+    decision.timeSeconds = elapsed;
+    decision.fromLevel = level;
+    decision.toLevel = next;
+    decision.frameMs = frameMs;
+    decision.targetMs = settings.targetFrameMs;
+    decision.output = output;
+
+    level = next;
+    lastDecision = elapsed;
+    applyLevel();
+
+    decision.lodBias = knobs.lodBias;
+    decision.maxShadedLights = knobs.maxShadedLights;
+    decision.uiRefreshInterval = knobs.uiRefreshInterval;
+    perf.recordQualityDecision(decision);
+
+    state.level = level;
+    perf.setQualityStats(state);
+    return (true);
+}
+
+/// \brief Bloquea o desbloquea el nivel actual.
+/// \details Al desbloquear se reinicia el estado del controlador para que el tiempo
+/// pasado bloqueado no cuente en la integral ni en el derivativo.
+/// \param lock \c true para mantener el nivel actual.
+void QualityGovernor::setLocked(bool lock)
+{
+    if (locked && !lock)
+    {
+        integral = 0.0f;
+        previousError = 0.0f;
+        lastDecision = elapsed;
+    }
+
+    locked = lock;
+}
+
+/// \brief Recalcula \c knobs a partir de \c level.
+void QualityGovernor::applyLevel()
+{
+    const float t = static_cast<float>(level) / static_cast<float>(settings.levels - 1);
+
+    auto mixCount = [t](uint32_t low, uint32_t high)
+    {
+        return (static_cast<uint32_t>(std::lround(low + (float(high) - float(low)) * t)));
+    };
+
+    knobs.lodBias = settings.low.lodBias + (settings.high.lodBias - settings.low.lodBias) * t;
+    knobs.maxShadedLights = mixCount(settings.low.maxShadedLights, settings.high.maxShadedLights);
+    knobs.uiRefreshInterval = mixCount(settings.low.uiRefreshInterval, settings.high.uiRefreshInterval);
+}
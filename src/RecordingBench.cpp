@@ -0,0 +1,557 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: RecordingBench.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "RecordingBench.hpp"
+#include "ThreadTopology.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/// Anchura de las barras de la curva de eficiencia (caracteres).
+static constexpr int EFFICIENCY_BAR_WIDTH = 40;
+
+/// \brief Mediana de una muestra (ordena \c samples).
+static float median(std::vector<float>& samples)
+{
+    if (samples.empty())
+    {
+        return (0.0f);
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    return (samples[samples.size() / 2]);
+}
+
+/// \brief Número de hebras de cada punto: potencias de dos y el máximo.
+static std::vector<uint32_t> workerCounts(uint32_t maxWorkers)
+{
+    std::vector<uint32_t> counts;
+
+    for (uint32_t count = 1; count < maxWorkers; count *= 2)
+    {
+        counts.push_back(count);
+    }
+
+    counts.push_back(maxWorkers);
+
+    return (counts);
+}
+
+/// \brief Crea los pools y command buffers de hasta \p maxWorkers hebras.
+/// \param device Dispositivo lógico Vulkan.
+/// \param renderPass Render pass de la swapchain.
+/// \param framebuffer Framebuffer de la swapchain.
+/// \param extent Tamaño del framebuffer.
+/// \param maxWorkers Máximo de hebras (0 = \c std::thread::hardware_concurrency).
+RecordingBench::RecordingBench(
+    VulkanDevice& device,
+    VkRenderPass renderPass,
+    VkFramebuffer framebuffer,
+    VkExtent2D extent,
+    uint32_t maxWorkers)
+    : device{device},
+    renderPass{renderPass},
+    framebuffer{framebuffer},
+    extent{extent}
+{
+    if (maxWorkers == 0)
+    {
+        maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = device.getQueueFamilyIndices().GetGraphicsFamily();
+
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandBufferCount = 1;
+
+    workers.resize(maxWorkers);
+
+    for (Worker& worker : workers)
+    {
+        if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &worker.pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create recording bench command pool.");
+        }
+
+        allocInfo.commandPool = worker.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+        if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &worker.secondary) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to allocate recording bench command buffer.");
+        }
+    }
+
+    if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &primaryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create recording bench command pool.");
+    }
+
+    allocInfo.commandPool = primaryPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+    if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &primary) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to allocate recording bench command buffer.");
+    }
+}
+
+/// \brief Libera pools y mallas.
+RecordingBench::~RecordingBench()
+{
+    for (Worker& worker : workers)
+    {
+        vkDestroyCommandPool(device.getDevice(), worker.pool, nullptr);
+    }
+
+    vkDestroyCommandPool(device.getDevice(), primaryPool, nullptr);
+}
+
+/// \brief Crea \p count mallas distintas (cubos de tamaño ligeramente diferente).
+void RecordingBench::createModels(uint32_t count)
+{
+    static const glm::vec3 normals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    const glm::vec2 uvs[4] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+
+    models.clear();
+    models.reserve(count);
+
+    for (uint32_t m = 0; m < count; ++m)
+    {
+        const float half = 0.5f * (1.0f + 0.001f * float(m));
+
+        Model::Builder builder {};
+
+        for (const glm::vec3& normal : normals)
+        {
+            // Base ortonormal de la cara: u y v recorren sus cuatro esquinas.
+            const glm::vec3 u = (std::abs(normal.x) > 0.5f) ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+            const glm::vec3 v = glm::cross(normal, u);
+            const uint32_t base = static_cast<uint32_t>(builder.vertices.size());
+
+            for (uint32_t corner = 0; corner < 4; ++corner)
+            {
+                const float su = (corner == 1 || corner == 2) ? 1.0f : -1.0f;
+                const float sv = (corner >= 2) ? 1.0f : -1.0f;
+
+                builder.vertices.push_back({half * (normal + su * u + sv * v), {1, 1, 1}, normal, uvs[corner]});
+            }
+
+            builder.indices.insert(builder.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+
+        models.push_back(std::make_shared<Model>(device, builder));
+    }
+}
+
+/// \brief Llena \p gameObjects con una rejilla cúbica de \p objectCount objetos
+/// que se reparten las mallas de \c models.
+void RecordingBench::createScene(
+    uint32_t objectCount,
+    std::unordered_map<unsigned int, GameObject>& gameObjects) const
+{
+    gameObjects.clear();
+    gameObjects.reserve(objectCount);
+
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::cbrt(double(objectCount))));
+
+    for (uint32_t i = 0; i < objectCount; ++i)
+    {
+        GameObject object = GameObject::create();
+        object.model = models[i % models.size()];
+        object.transform.translation = {
+            float(i % side), float((i / side) % side), float(i / (side * side))};
+        object.transform.scale = glm::vec3(0.4f);
+
+        const unsigned int id = object.getId();
+        gameObjects.emplace(id, std::move(object));
+    }
+}
+
+/// \brief Mide una repetición con \p workerCount hebras.
+/// \param renderer Renderizador.
+/// \param frameInfo Contexto con la escena sintética.
+/// \param workerCount Hebras a usar.
+/// \param cpus CPUs donde fijar las hebras (vacío = sin afinidad).
+/// \param sample Salida: tiempos de la repetición.
+void RecordingBench::measure(
+    BasicRenderer& renderer,
+    FrameInfo& frameInfo,
+    uint32_t workerCount,
+    const std::vector<uint32_t>& cpus,
+    RecordingBenchSample& sample)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    for (uint32_t t = 0; t < workerCount; ++t)
+    {
+        vkResetCommandPool(device.getDevice(), workers[t].pool, 0);
+    }
+
+    vkResetCommandPool(device.getDevice(), primaryPool, 0);
+
+    VkCommandBufferInheritanceInfo inherit {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inherit.renderPass = renderPass;
+    inherit.subpass = 0;
+    inherit.framebuffer = framebuffer;
+
+    VkCommandBufferBeginInfo secondaryBegin {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    secondaryBegin.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    secondaryBegin.pInheritanceInfo = &inherit;
+
+    // Mismo esquema que el bucle de render: lista preparada y secundarios abiertos en la
+    // hebra principal y una hebra nueva por rango.
+    const Clock::time_point prepare = Clock::now();
+
+    renderer.prepareRecording(frameInfo);
+
+    const size_t N = renderer.getRecordCount();
+    const size_t chunk = (N + workerCount - 1) / workerCount;
+
+    std::vector<float> threadMs(workerCount, 0.0f);
+    std::vector<VkCommandBuffer> execList;
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+
+    const Clock::time_point launch = Clock::now();
+
+    for (uint32_t t = 0; t < workerCount; ++t)
+    {
+        const size_t begin = std::min(N, size_t(t) * chunk);
+        const size_t end = std::min(N, begin + chunk);
+
+        if (begin >= end)
+        {
+            break;
+        }
+
+        VkCommandBuffer cbSec = workers[t].secondary;
+        vkBeginCommandBuffer(cbSec, &secondaryBegin);
+        execList.push_back(cbSec);
+
+        threads.emplace_back([&, cbSec, begin, end, t]
+        {
+            if (!cpus.empty())
+            {
+                ThreadTopology::pinCurrentThread({cpus[t % cpus.size()]});
+            }
+
+            const Clock::time_point start = Clock::now();
+
+            renderer.recordRange(frameInfo, cbSec, begin, end);
+            vkEndCommandBuffer(cbSec);
+
+            threadMs[t] = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const Clock::time_point joined = Clock::now();
+
+    VkCommandBufferBeginInfo primaryBegin {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    primaryBegin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkRenderPassBeginInfo renderPassInfo {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    renderPassInfo.renderPass = renderPass;
+    renderPassInfo.framebuffer = framebuffer;
+    renderPassInfo.renderArea.extent = extent;
+
+    vkBeginCommandBuffer(primary, &primaryBegin);
+    vkCmdBeginRenderPass(primary, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+    const Clock::time_point executeStart = Clock::now();
+
+    if (!execList.empty())
+    {
+        vkCmdExecuteCommands(primary, static_cast<uint32_t>(execList.size()), execList.data());
+    }
+
+    const Clock::time_point executeEnd = Clock::now();
+
+    vkCmdEndRenderPass(primary);
+    vkEndCommandBuffer(primary);
+
+    const Clock::time_point done = Clock::now();
+
+    const uint32_t used = std::max<uint32_t>(static_cast<uint32_t>(threads.size()), 1);
+    float slowest = 0.0f;
+    float sum = 0.0f;
+
+    for (uint32_t t = 0; t < used && t < workerCount; ++t)
+    {
+        slowest = std::max(slowest, threadMs[t]);
+        sum += threadMs[t];
+    }
+
+    sample.prepareMs = std::chrono::duration<float, std::milli>(launch - prepare).count();
+    sample.recordMs = slowest;
+    sample.recordMeanMs = sum / float(used);
+    sample.joinMs = std::max(std::chrono::duration<float, std::milli>(joined - launch).count() - slowest, 0.0f);
+    sample.executeMs = std::chrono::duration<float, std::milli>(executeEnd - executeStart).count();
+    sample.totalMs = std::chrono::duration<float, std::milli>(done - prepare).count();
+}
+
+/// \brief Ejecuta el barrido.
+/// \param renderer Renderizador cuya grabación se mide.
+/// \param globalDescriptorSet Set global enlazado en cada secundario.
+/// \param settings Puntos del barrido.
+/// \return Una medición por punto, agrupadas por escena y en orden de hebras.
+std::vector<RecordingBenchSample> RecordingBench::run(
+    BasicRenderer& renderer,
+    VkDescriptorSet globalDescriptorSet,
+    const RecordingBenchSettings& settings)
+{
+    const uint32_t maxWorkers = (settings.maxWorkers == 0) ?
+        static_cast<uint32_t>(workers.size()) :
+        std::min(settings.maxWorkers, static_cast<uint32_t>(workers.size()));
+    const uint32_t iterations = std::max(settings.iterations, 1u);
+
+    Camera camera;
+    std::vector<RecordingBenchSample> samples;
+
+    for (uint32_t modelCount : settings.modelCounts)
+    {
+        createModels(std::max(modelCount, 1u));
+
+        for (uint32_t objectCount : settings.objectCounts)
+        {
+            std::unordered_map<unsigned int, GameObject> gameObjects;
+            createScene(objectCount, gameObjects);
+
+            FrameInfo frameInfo{0, 0.0f, primary, camera, globalDescriptorSet, gameObjects};
+            float singleThreadMs = 0.0f;
+
+            for (uint32_t workerCount : workerCounts(maxWorkers))
+            {
+                std::vector<float> prepare, record, recordMean, join, execute, total;
+                RecordingBenchSample sample {};
+
+                // Repetición de calentamiento (cachés, asignaciones de los pools).
+                measure(renderer, frameInfo, workerCount, settings.cpus, sample);
+
+                for (uint32_t i = 0; i < iterations; ++i)
+                {
+                    measure(renderer, frameInfo, workerCount, settings.cpus, sample);
+                    prepare.push_back(sample.prepareMs);
+                    record.push_back(sample.recordMs);
+                    recordMean.push_back(sample.recordMeanMs);
+                    join.push_back(sample.joinMs);
+                    execute.push_back(sample.executeMs);
+                    total.push_back(sample.totalMs);
+                }
+
+                sample.workers = workerCount;
+                sample.objects = objectCount;
+                sample.models = static_cast<uint32_t>(models.size());
+                sample.prepareMs = median(prepare);
+                sample.recordMs = median(record);
+                sample.recordMeanMs = median(recordMean);
+                sample.joinMs = median(join);
+                sample.executeMs = median(execute);
+                sample.totalMs = median(total);
+
+                if (workerCount == 1)
+                {
+                    singleThreadMs = sample.totalMs;
+                }
+
+                sample.speedup = (sample.totalMs > 0.0f) ? singleThreadMs / sample.totalMs : 0.0f;
+                sample.efficiency = sample.speedup / float(workerCount);
+                samples.push_back(sample);
+            }
+        }
+    }
+
+    models.clear();
+
+    return (samples);
+}
+
+/// \brief Compara las variantes del bucle de grabación en una hebra.
+/// \details Graba la misma escena, vista por una cámara que deja parte fuera del
+/// frustum, con el bucle genérico y con el especializado para cada combinación de
+/// culling y omisión de enlaces. Restaura después la variante del renderizador.
+/// \param renderer Renderizador cuya grabación se mide.
+/// \param globalDescriptorSet Set global enlazado en el secundario.
+/// \param settings Escena (\c variantObjects, \c variantModels) y repeticiones.
+/// \return Una medición por variante, genérica y especializada alternas.
+std::vector<RecordVariantSample> RecordingBench::runVariants(
+    BasicRenderer& renderer,
+    VkDescriptorSet globalDescriptorSet,
+    const RecordingBenchSettings& settings)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const uint32_t iterations = std::max(settings.iterations, 1u);
+    const RecordVariant previous = renderer.getRecordVariant();
+
+    createModels(std::max(settings.variantModels, 1u));
+
+    std::unordered_map<unsigned int, GameObject> gameObjects;
+    createScene(settings.variantObjects, gameObjects);
+
+    // Cámara dentro de una esquina de la rejilla mirando a la opuesta: una parte
+    // de los objetos queda detrás o a los lados y el culling tiene trabajo real.
+    const float side = std::ceil(std::cbrt(float(std::max(settings.variantObjects, 1u))));
+
+    Camera camera;
+    camera.setPerspectiveProjection(
+        glm::radians(50.0f), float(extent.width) / float(std::max(extent.height, 1u)), 0.1f, 4.0f * side);
+    camera.lookAtTarget(glm::vec3(0.25f * side), glm::vec3(side));
+
+    FrameInfo frameInfo{0, 0.0f, primary, camera, globalDescriptorSet, gameObjects};
+
+    VkCommandBufferInheritanceInfo inherit {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inherit.renderPass = renderPass;
+    inherit.subpass = 0;
+    inherit.framebuffer = framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inherit;
+
+    std::vector<RecordVariantSample> samples;
+
+    for (uint32_t flags = 0; flags < 8; ++flags)
+    {
+        RecordVariantSample sample {};
+        sample.variant.culling = (flags & 2u) != 0;
+        sample.variant.bindElision = (flags & 4u) != 0;
+        sample.variant.specialized = (flags & 1u) != 0;
+        sample.objects = settings.variantObjects;
+
+        renderer.setRecordVariant(sample.variant);
+
+        std::vector<float> prepare, record;
+
+        // La primera repetición es de calentamiento.
+        for (uint32_t i = 0; i <= iterations; ++i)
+        {
+            vkResetCommandPool(device.getDevice(), workers[0].pool, 0);
+            vkBeginCommandBuffer(workers[0].secondary, &beginInfo);
+
+            const Clock::time_point start = Clock::now();
+            renderer.prepareRecording(frameInfo);
+            const Clock::time_point prepared = Clock::now();
+            sample.drawn = renderer.recordRange(frameInfo, workers[0].secondary, 0, renderer.getRecordCount());
+            const Clock::time_point recorded = Clock::now();
+
+            vkEndCommandBuffer(workers[0].secondary);
+
+            if (i > 0)
+            {
+                prepare.push_back(std::chrono::duration<float, std::milli>(prepared - start).count());
+                record.push_back(std::chrono::duration<float, std::milli>(recorded - prepared).count());
+            }
+        }
+
+        sample.prepareMs = median(prepare);
+        sample.recordMs = median(record);
+        samples.push_back(sample);
+    }
+
+    renderer.setRecordVariant(previous);
+    models.clear();
+
+    return (samples);
+}
+
+/// \brief Imprime la tabla de escalado y una curva de eficiencia por escena.
+/// \param samples Resultado de \c run.
+/// \param out Flujo de salida.
+void RecordingBench::print(const std::vector<RecordingBenchSample>& samples, std::ostream& out)
+{
+    out << "[recording] " << std::setw(8) << "objects" << std::setw(8) << "models" << std::setw(9) << "workers"
+        << std::setw(12) << "prepare ms" << std::setw(11) << "record ms" << std::setw(10) << "mean ms" << std::setw(10) << "join ms"
+        << std::setw(12) << "execute ms" << std::setw(10) << "total ms" << std::setw(9) << "speedup"
+        << std::setw(12) << "efficiency" << '\n';
+
+    out << std::fixed;
+
+    for (const RecordingBenchSample& sample : samples)
+    {
+        out << "[recording] " << std::setw(8) << sample.objects << std::setw(8) << sample.models
+            << std::setw(9) << sample.workers << std::setprecision(3)
+            << std::setw(12) << sample.prepareMs << std::setw(11) << sample.recordMs << std::setw(10) << sample.recordMeanMs
+            << std::setw(10) << sample.joinMs << std::setw(12) << sample.executeMs
+            << std::setw(10) << sample.totalMs << std::setprecision(2) << std::setw(9) << sample.speedup
+            << std::setprecision(0) << std::setw(11) << sample.efficiency * 100.0f << "%\n";
+    }
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const RecordingBenchSample& sample = samples[i];
+
+        if (sample.workers == 1)
+        {
+            out << "[recording] efficiency, " << sample.objects << " objects, " << sample.models << " models\n";
+        }
+
+        const int filled = std::clamp(
+            static_cast<int>(std::lround(sample.efficiency * EFFICIENCY_BAR_WIDTH)), 0, EFFICIENCY_BAR_WIDTH);
+
+        out << "[recording] " << std::setw(4) << sample.workers << " |" << std::string(filled, '#')
+            << std::string(EFFICIENCY_BAR_WIDTH - filled, ' ') << "| " << std::setprecision(0)
+            << std::setw(3) << sample.efficiency * 100.0f << "%\n";
+    }
+}
+
+/// \brief Imprime la comparación de variantes.
+/// \param samples Resultado de \c runVariants.
+/// \param out Flujo de salida.
+void RecordingBench::printVariants(const std::vector<RecordVariantSample>& samples, std::ostream& out)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+
+    out << "[recording] variants, " << samples.front().objects << " objects, 1 worker\n";
+    out << "[recording] " << std::setw(13) << "loop" << std::setw(9) << "culling" << std::setw(14) << "bind elision"
+        << std::setw(8) << "draws" << std::setw(12) << "prepare ms" << std::setw(11) << "record ms"
+        << std::setw(10) << "ns/draw" << std::setw(12) << "vs generic" << '\n';
+
+    out << std::fixed;
+
+    float genericMs = 0.0f;
+
+    for (const RecordVariantSample& sample : samples)
+    {
+        if (!sample.variant.specialized)
+        {
+            genericMs = sample.recordMs;
+        }
+
+        const float nsPerDraw = (sample.drawn > 0) ? sample.recordMs * 1.0e6f / float(sample.drawn) : 0.0f;
+        const float ratio = (sample.recordMs > 0.0f) ? genericMs / sample.recordMs : 0.0f;
+
+        out << "[recording] " << std::setw(13) << (sample.variant.specialized ? "specialized" : "generic")
+            << std::setw(9) << (sample.variant.culling ? "on" : "off")
+            << std::setw(14) << (sample.variant.bindElision ? "on" : "off")
+            << std::setw(8) << sample.drawn << std::setprecision(3)
+            << std::setw(12) << sample.prepareMs << std::setw(11) << sample.recordMs
+            << std::setprecision(1) << std::setw(10) << nsPerDraw
+            << std::setprecision(2) << std::setw(11) << ratio << "x\n";
+    }
+}
@@ -21,11 +21,8 @@ Renderer::Renderer(Window& window, VulkanDevice& device)
     recreateSwapChain();
     createCommandBuffers();
 
-    VkPhysicalDeviceProperties props;
-    std::memset(&props, 0, sizeof(props));
-    vkGetPhysicalDeviceProperties(vulkanDevice.getPhysicalDevice(), &props);
     perf.init(vulkanDevice.getDevice(), SwapChain::MAX_FRAMES_IN_FLIGHT, 
-        props.limits.timestampPeriod);
+        vulkanDevice.getCapabilities());
 }
 
 /// \brief Libera recursos asociados y destruye la swapchain.
@@ -45,7 +42,7 @@ void Renderer::recreateSwapChain()
         glfwWaitEvents();
     }
 
-    vkDeviceWaitIdle(vulkanDevice.getDevice());
+    vulkanDevice.waitIdle();
 
     if (swapChain == nullptr) 
     {
@@ -116,6 +113,10 @@ VkCommandBuffer Renderer::beginFrame()
 
     isFrameStarted = true;
 
+    // acquireNextImage ya esperó al fence de este frame en vuelo: sus consultas de la
+    // vuelta anterior están listas y leerlas aquí no detiene a la CPU.
+    perf.resolveGpu(currentFrameIndex);
+
     VkCommandBuffer commandBuffer = getCurrentCommandBuffer();
 
     VkCommandBufferBeginInfo beginInfo {};
@@ -127,7 +128,7 @@ VkCommandBuffer Renderer::beginFrame()
     }
 
     perf.beginCpuFrame();
-    perf.recordGpu(commandBuffer, currentFrameIndex);
+    perf.beginGpu(commandBuffer, currentFrameIndex);
 
     return commandBuffer;
 }
@@ -139,14 +140,16 @@ void Renderer::endFrame()
 
     VkCommandBuffer commandBuffer = getCurrentCommandBuffer();
 
-    perf.recordGpu(commandBuffer, currentFrameIndex);
+    perf.endGpu(commandBuffer, currentFrameIndex);
 
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) 
     {
         throw std::runtime_error("💥[Vulkan API] Failed to record command buffer.");
     }
 
-    VkResult result = swapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
+    VkResult result = swapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex, &frameWait);
+    frameWait = TimelineWait {};
+    perf.setBlockingTimes(swapChain->getBlockingTimes());
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
         window.wasWindowResized()) {
@@ -161,7 +164,6 @@ void Renderer::endFrame()
     isFrameStarted = false;
 
     perf.endCpuFrame();
-    perf.resolveGpu(currentFrameIndex);
     perf.tickMonitors();
 
     currentFrameIndex = (currentFrameIndex + 1) % SwapChain::MAX_FRAMES_IN_FLIGHT;
@@ -0,0 +1,548 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: SkinningSystem.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "SkinningSystem.hpp"
+#include "DescriptorWriter.hpp"
+#include "SwapChain.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+/// Articulaciones de la cadena del tentáculo.
+static constexpr uint32_t JOINT_COUNT = 6;
+/// Anillos de vértices a lo largo del tentáculo.
+static constexpr uint32_t RING_COUNT = 24;
+/// Lados de cada anillo.
+static constexpr uint32_t SIDE_COUNT = 12;
+/// Longitud del tentáculo (crece hacia -Y, "arriba").
+static constexpr float LENGTH = 0.6f;
+/// Tamaño del grupo de trabajo de \c skin.comp.
+static constexpr uint32_t SKIN_GROUP_SIZE = 64;
+
+/// \brief Push constants de \c skin.comp.
+struct SkinPushConstants
+{
+    /// Vértices de la malla.
+    uint32_t vertexCount = 0;
+    /// Personajes (filas \c y del dispatch).
+    uint32_t instanceCount = 0;
+};
+
+/// \brief Crea el personaje, sus instancias y la tubería de cómputo.
+/// \param device Dispositivo lógico Vulkan.
+/// \param instanceCount Número de personajes animados.
+SkinningSystem::SkinningSystem(VulkanDevice& device, uint32_t instanceCount)
+    : vulkanDevice{device}, instanceCount{instanceCount}
+{
+    createCharacter();
+    createBuffers();
+    createDescriptors();
+    createPipeline();
+    startWorkers();
+}
+
+/// \brief Libera recursos asociados.
+SkinningSystem::~SkinningSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    vkDestroyPipelineLayout(vulkanDevice.getDevice(), pipelineLayout, nullptr);
+}
+
+/// \brief Genera la malla, el esqueleto y el clip del personaje.
+/// \details No hay recursos con skinning en el repositorio, así que el
+/// personaje es un tentáculo procedural: un tubo a lo largo de -Y con una
+/// cadena de articulaciones y un clip de ondulación en bucle.
+void SkinningSystem::createCharacter()
+{
+    const float segment = LENGTH / static_cast<float>(JOINT_COUNT - 1);
+
+    // Esqueleto: cadena lineal, cada articulación cuelga de la anterior.
+    skeleton.parents.resize(JOINT_COUNT);
+    skeleton.inverseBind.resize(JOINT_COUNT);
+
+    for (uint32_t j = 0; j < JOINT_COUNT; ++j)
+    {
+        skeleton.parents[j] = static_cast<int32_t>(j) - 1;
+        skeleton.inverseBind[j] = glm::mat4(1.0f);
+        skeleton.inverseBind[j][3] = glm::vec4(0.0f, segment * j, 0.0f, 1.0f);
+    }
+
+    // Malla: tubo que se estrecha hacia la punta; la columna extra cierra la costura de UV.
+    bindPose.vertices.clear();
+    bindPose.indices.clear();
+    influences.clear();
+
+    for (uint32_t ring = 0; ring < RING_COUNT; ++ring)
+    {
+        const float v = static_cast<float>(ring) / static_cast<float>(RING_COUNT - 1);
+        const float radius = glm::mix(0.05f, 0.01f, v);
+
+        // Posición a lo largo de la cadena: peso lineal entre las dos articulaciones vecinas.
+        const float chain = v * static_cast<float>(JOINT_COUNT - 1);
+        const uint32_t joint = std::min(static_cast<uint32_t>(chain), JOINT_COUNT - 2);
+        const float blend = chain - static_cast<float>(joint);
+
+        for (uint32_t side = 0; side <= SIDE_COUNT; ++side)
+        {
+            const float u = static_cast<float>(side) / static_cast<float>(SIDE_COUNT);
+            const float angle = u * glm::two_pi<float>();
+            const glm::vec3 normal {std::cos(angle), 0.0f, std::sin(angle)};
+
+            Model::Vertex vertex {};
+            vertex.position = glm::vec3(normal.x * radius, -LENGTH * v, normal.z * radius);
+            vertex.color = glm::mix(glm::vec3(0.45f, 0.15f, 0.55f), glm::vec3(0.95f, 0.55f, 0.75f), v);
+            vertex.normal = normal;
+            vertex.uv = {u, v};
+            bindPose.vertices.push_back(vertex);
+
+            SkinInfluence influence {};
+            influence.joints = glm::uvec4(joint, joint + 1, 0u, 0u);
+            influence.weights = glm::vec4(1.0f - blend, blend, 0.0f, 0.0f);
+            influences.push_back(influence);
+        }
+    }
+
+    const uint32_t columns = SIDE_COUNT + 1;
+
+    for (uint32_t ring = 0; ring + 1 < RING_COUNT; ++ring)
+    {
+        for (uint32_t side = 0; side < SIDE_COUNT; ++side)
+        {
+            const uint32_t a = ring * columns + side;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + columns;
+            const uint32_t d = c + 1;
+
+            bindPose.indices.insert(bindPose.indices.end(), {a, c, b, b, c, d});
+        }
+    }
+
+    // Clip: onda que recorre la cadena (desfase por articulación) en un bucle de 2 s.
+    clip.sampleRate = 16.0f;
+    clip.keyCount = 32;
+    clip.jointCount = JOINT_COUNT;
+
+    const size_t channelSize = size_t(clip.keyCount) * JOINT_COUNT;
+    clip.tx.assign(channelSize, 0.0f);
+    clip.ty.assign(channelSize, 0.0f);
+    clip.tz.assign(channelSize, 0.0f);
+    clip.rx.resize(channelSize);
+    clip.ry.resize(channelSize);
+    clip.rz.resize(channelSize);
+    clip.rw.resize(channelSize);
+
+    for (uint32_t key = 0; key < clip.keyCount; ++key)
+    {
+        const float phase = glm::two_pi<float>() * key / static_cast<float>(clip.keyCount);
+
+        for (uint32_t j = 0; j < JOINT_COUNT; ++j)
+        {
+            const size_t index = size_t(key) * JOINT_COUNT + j;
+
+            clip.ty[index] = (j == 0) ? 0.0f : -segment;
+
+            const float swing = 0.35f * std::sin(phase + 0.9f * j);
+            const float twist = 0.20f * std::cos(phase + 0.6f * j);
+
+            const glm::quat rotation =
+                glm::angleAxis(swing, glm::vec3(0.0f, 0.0f, 1.0f)) *
+                glm::angleAxis(twist, glm::vec3(1.0f, 0.0f, 0.0f));
+
+            clip.rx[index] = rotation.x;
+            clip.ry[index] = rotation.y;
+            clip.rz[index] = rotation.z;
+            clip.rw[index] = rotation.w;
+        }
+    }
+
+    // Cada personaje arranca en un punto distinto del bucle.
+    playbackTimes.resize(instanceCount);
+    poses.resize(JOINT_COUNT, instanceCount);
+
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        playbackTimes[i] = clip.duration() * static_cast<float>((i * 7919u) % 97u) / 97.0f;
+    }
+}
+
+/// \brief Crea un búfer local al dispositivo y le copia \p data con un staging temporal.
+/// \param device Dispositivo lógico Vulkan.
+/// \param data Contenido inicial.
+/// \param elementSize Tamaño de cada elemento.
+/// \param count Número de elementos.
+/// \param usage Usos del búfer (se añade \c TRANSFER_DST).
+/// \return Búfer ya inicializado.
+static std::unique_ptr<VulkanBuffer> createDeviceBuffer(
+    VulkanDevice& device,
+    const void* data,
+    VkDeviceSize elementSize,
+    uint32_t count,
+    VkBufferUsageFlags usage)
+{
+    VulkanBuffer staging{
+        device,
+        elementSize,
+        count,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+    staging.map();
+    staging.writeToBuffer(const_cast<void*>(data));
+
+    auto buffer = std::make_unique<VulkanBuffer>(
+        device,
+        elementSize,
+        count,
+        usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    device.copyBuffer(staging.getBuffer(), buffer->getBuffer(), elementSize * count);
+
+    return (buffer);
+}
+
+/// \brief Crea la pose de reposo, las influencias, las paletas y los modelos.
+void SkinningSystem::createBuffers()
+{
+    const uint32_t vertexCount = static_cast<uint32_t>(bindPose.vertices.size());
+
+    bindPoseBuffer = createDeviceBuffer(
+        vulkanDevice,
+        bindPose.vertices.data(),
+        sizeof(Model::Vertex),
+        vertexCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    influenceBuffer = createDeviceBuffer(
+        vulkanDevice,
+        influences.data(),
+        sizeof(SkinInfluence),
+        vertexCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // Todas las instancias empiezan en la pose de reposo; el cómputo sólo reescribe
+    // posiciones y normales, así que color, UV e irradiancia se suben aquí una vez.
+    std::vector<Model::Vertex> initialVertices;
+    initialVertices.reserve(size_t(vertexCount) * instanceCount);
+    std::vector<uint32_t> paletteOffsets(instanceCount);
+
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        initialVertices.insert(initialVertices.end(), bindPose.vertices.begin(), bindPose.vertices.end());
+        paletteOffsets[i] = i * JOINT_COUNT;
+    }
+
+    skinnedVertices = createDeviceBuffer(
+        vulkanDevice,
+        initialVertices.data(),
+        sizeof(Model::Vertex),
+        vertexCount * instanceCount,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+    paletteOffsetBuffer = createDeviceBuffer(
+        vulkanDevice,
+        paletteOffsets.data(),
+        sizeof(uint32_t),
+        instanceCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // La CPU escribe la paleta del frame N mientras la GPU aún puede leer la del N-1.
+    paletteBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+
+    for (std::unique_ptr<VulkanBuffer>& palette : paletteBuffers)
+    {
+        palette = std::make_unique<VulkanBuffer>(
+            vulkanDevice,
+            sizeof(glm::mat4),
+            instanceCount * JOINT_COUNT,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        palette->map();
+    }
+
+    // Cada instancia dibuja su tramo del búfer compartido.
+    instanceModels.resize(instanceCount);
+
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        const VkDeviceSize offset = VkDeviceSize(i) * vertexCount * sizeof(Model::Vertex);
+        instanceModels[i] = std::make_shared<Model>(vulkanDevice, bindPose, skinnedVertices, offset);
+    }
+}
+
+/// \brief Crea el layout, el pool y un descriptor set por frame en vuelo.
+void SkinningSystem::createDescriptors()
+{
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings;
+
+    for (uint32_t binding = 0; binding < 5; ++binding)
+    {
+        bindings[binding] = VkDescriptorSetLayoutBinding
+        {
+            binding,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        };
+    }
+
+    setLayout = std::make_unique<DescriptorSetLayout>(vulkanDevice, bindings);
+
+    const uint32_t setCount = SwapChain::MAX_FRAMES_IN_FLIGHT;
+
+    std::vector<VkDescriptorPoolSize> poolSizes =
+    {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * setCount}
+    };
+
+    descriptorPool = std::make_unique<DescriptorPool>(vulkanDevice, setCount, 0, poolSizes);
+    descriptorSets.resize(setCount);
+
+    VkDescriptorBufferInfo bindPoseInfo = bindPoseBuffer->descriptorInfo();
+    VkDescriptorBufferInfo influenceInfo = influenceBuffer->descriptorInfo();
+    VkDescriptorBufferInfo outputInfo = skinnedVertices->descriptorInfo();
+    VkDescriptorBufferInfo paletteOffsetInfo = paletteOffsetBuffer->descriptorInfo();
+
+    for (uint32_t frame = 0; frame < setCount; ++frame)
+    {
+        VkDescriptorBufferInfo paletteInfo = paletteBuffers[frame]->descriptorInfo();
+
+        DescriptorWriter(*setLayout, *descriptorPool)
+            .writeBuffer(0, &bindPoseInfo)
+            .writeBuffer(1, &influenceInfo)
+            .writeBuffer(2, &paletteInfo)
+            .writeBuffer(3, &outputInfo)
+            .writeBuffer(4, &paletteOffsetInfo)
+            .build(descriptorSets[frame]);
+    }
+}
+
+/// \brief Crea el pipeline layout y la tubería de \c skin.comp.
+void SkinningSystem::createPipeline()
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(SkinPushConstants);
+
+    VkDescriptorSetLayout sets[] = {setLayout->get()};
+
+    VkPipelineLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = sets;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(
+        vulkanDevice.getDevice(),
+        &layoutInfo,
+        nullptr,
+        &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create pipeline layout.");
+    }
+
+    skinPipeline = std::make_unique<ComputePipeline>(
+        vulkanDevice, "shaders/skin.comp.spv", pipelineLayout);
+}
+
+/// \brief Añade un \c GameObject por personaje a la escena.
+/// \param gameObjects Contenedor de objetos de escena.
+void SkinningSystem::populate(std::unordered_map<unsigned int, GameObject>& gameObjects)
+{
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(instanceCount))));
+    const float spacing = 0.15f;
+    const float origin = -0.5f * spacing * static_cast<float>(side - 1);
+
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        GameObject character = GameObject::create();
+        character.model = instanceModels[i];
+        character.color = {1.0f, 1.0f, 1.0f};
+        character.allowImpostor = false;
+        character.transform.translation =
+        {
+            origin + spacing * static_cast<float>(i % side),
+            0.5f,
+            origin + spacing * static_cast<float>(i / side)
+        };
+        gameObjects.emplace(character.getId(), std::move(character));
+    }
+}
+
+/// \brief Crea las hebras que evalúan las poses junto a la hebra llamante.
+void SkinningSystem::startWorkers()
+{
+    const uint32_t M = std::max(1u, std::min(std::thread::hardware_concurrency(), instanceCount / 32u));
+
+    // Tramos múltiplos de 16 personajes: en cada canal de PoseBatch ocupan líneas de
+    // caché completas, así dos hebras nunca escriben en la misma (y los grupos SSE de
+    // sampleBatch no quedan partidos).
+    constexpr uint32_t line = PoseBatch::CACHE_LINE_CHARACTERS;
+    chunk = ((instanceCount + M - 1) / M + line - 1) / line * line;
+
+    const uint32_t ranges = (instanceCount + chunk - 1) / chunk;
+
+    for (uint32_t t = 1; t < ranges; ++t)
+    {
+        workers.emplace_back(&SkinningSystem::workerLoop, this, t);
+    }
+}
+
+/// \brief Muestrea la animación y escribe las paletas del frame en paralelo.
+/// \param frameIndex Frame en vuelo cuya paleta se escribe.
+void SkinningSystem::evaluatePoses(int frameIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        framePalette = static_cast<glm::mat4*>(paletteBuffers[frameIndex]->getMappedMemory());
+        pending = static_cast<uint32_t>(workers.size());
+        ++generation;
+    }
+
+    wakeUp.notify_all();
+
+    // La hebra llamante se queda con el primer tramo.
+    evaluateRange(0, std::min(instanceCount, chunk));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return (pending == 0); });
+}
+
+/// \brief Muestrea y escribe las paletas de un tramo de personajes.
+/// \param begin Primer personaje.
+/// \param end Personaje siguiente al último.
+void SkinningSystem::evaluateRange(uint32_t begin, uint32_t end)
+{
+    AnimationSampler::sampleBatch(clip, playbackTimes.data(), begin, end, poses);
+
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        AnimationSampler::computeSkinMatrices(skeleton, poses, i, framePalette + size_t(i) * JOINT_COUNT);
+    }
+}
+
+/// \brief Bucle de una hebra de poses: evalúa su tramo en cada frame.
+/// \param worker Índice del tramo (el 0 es de la hebra llamante).
+void SkinningSystem::workerLoop(uint32_t worker)
+{
+    const uint32_t begin = std::min(instanceCount, worker * chunk);
+    const uint32_t end = std::min(instanceCount, begin + chunk);
+    uint64_t seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [&] { return (stopping || generation != seen); });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            seen = generation;
+        }
+
+        evaluateRange(begin, end);
+
+        bool last = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = (--pending == 0);
+        }
+
+        if (last)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+/// \brief Avanza la animación y graba el skinning en el command buffer del frame.
+/// \details Debe llamarse fuera del render pass y antes de dibujar la escena.
+/// \param frameInfo Contexto del frame.
+void SkinningSystem::update(FrameInfo& frameInfo)
+{
+    for (float& time : playbackTimes)
+    {
+        time += frameInfo.frameTime;
+    }
+
+    evaluatePoses(frameInfo.frameIndex);
+
+    VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+    // Los draws de frames anteriores deben haber terminado de leer los vértices.
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    skinPipeline->bind(commandBuffer);
+
+    SkinPushConstants push {};
+    push.vertexCount = static_cast<uint32_t>(bindPose.vertices.size());
+    push.instanceCount = instanceCount;
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipelineLayout,
+        0,
+        1,
+        &descriptorSets[frameInfo.frameIndex],
+        0,
+        nullptr);
+
+    vkCmdPushConstants(
+        commandBuffer,
+        pipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(SkinPushConstants),
+        &push);
+
+    // Un único dispatch: x recorre los vértices y y los personajes.
+    const uint32_t groupCount = (push.vertexCount + SKIN_GROUP_SIZE - 1) / SKIN_GROUP_SIZE;
+    vkCmdDispatch(commandBuffer, groupCount, instanceCount, 1);
+
+    // Las escrituras del cómputo deben ser visibles como atributos de vértice.
+    VkMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
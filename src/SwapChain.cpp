@@ -13,6 +13,15 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+
+using Clock = std::chrono::high_resolution_clock;
+
+/// \brief Milisegundos entre dos instantes.
+static float elapsedMs(Clock::time_point begin, Clock::time_point end)
+{
+    return (std::chrono::duration<float, std::milli>(end - begin).count());
+}
 
 /// \brief Construye la swapchain y los recursos asociados.
 /// \param deviceRef Dispositivo lógico y físico de Vulkan.
@@ -426,6 +435,10 @@ VkFormat SwapChain::findDepthFormat()
 /// \return Resultado de la operación de adquisición.
 VkResult SwapChain::acquireNextImage(uint32_t* imageIndex) 
 {
+    blocking = FrameBlockingTimes {};
+
+    const Clock::time_point fenceStart = Clock::now();
+
     vkWaitForFences(
         device.getDevice(),
         1,
@@ -433,6 +446,8 @@ VkResult SwapChain::acquireNextImage(uint32_t* imageIndex)
         VK_TRUE,
         std::numeric_limits<uint64_t>::max());
 
+    const Clock::time_point acquireStart = Clock::now();
+
     VkResult result = vkAcquireNextImageKHR(
         device.getDevice(),
         swapChain,
@@ -441,18 +456,27 @@ VkResult SwapChain::acquireNextImage(uint32_t* imageIndex)
         VK_NULL_HANDLE,
         imageIndex);
 
+    blocking.fenceWaitMs = elapsedMs(fenceStart, acquireStart);
+    blocking.acquireMs = elapsedMs(acquireStart, Clock::now());
+
     return (result);
 }
 
 /// \brief Envía los command buffers para su ejecución y presenta la imagen.
 /// \param buffers Puntero al command buffer grabado del frame.
 /// \param imageIndex Índice de la imagen que se va a presentar.
+/// \param extraWait Espera adicional en un semáforo de línea temporal (opcional).
 /// \return Resultado de la operación de presentación.
-VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex) 
+VkResult SwapChain::submitCommandBuffers(
+    const VkCommandBuffer* buffers, 
+    uint32_t* imageIndex, 
+    const TimelineWait* extraWait) 
 {
     if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) 
     {
+        const Clock::time_point waitStart = Clock::now();
         vkWaitForFences(device.getDevice(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
+        blocking.imageFenceMs = elapsedMs(waitStart, Clock::now());
     }
 
     imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
@@ -460,11 +484,28 @@ VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE};
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0};
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
+
+    // El semáforo binario ignora su valor; el de línea temporal espera a extraWait->value.
+    uint64_t waitValues[] = {0, 0};
+    VkTimelineSemaphoreSubmitInfo timelineInfo {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+
+    if (extraWait && extraWait->semaphore != VK_NULL_HANDLE)
+    {
+        waitSemaphores[1] = extraWait->semaphore;
+        waitStages[1] = extraWait->stages;
+        waitValues[1] = extraWait->value;
+        submitInfo.waitSemaphoreCount = 2;
+
+        timelineInfo.waitSemaphoreValueCount = 2;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        submitInfo.pNext = &timelineInfo;
+    }
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = buffers;
 
@@ -474,15 +515,15 @@ VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_
 
     vkResetFences(device.getDevice(), 1, &inFlightFences[currentFrame]);
 
-    if (vkQueueSubmit(
-        device.getGraphicsQueue(), 
-        1, 
-        &submitInfo, 
-        inFlightFences[currentFrame]) != VK_SUCCESS) 
+    const Clock::time_point submitStart = Clock::now();
+
+    if (device.submitGraphics(1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) 
     {
         throw std::runtime_error("💥[Vulkan API] Failed to submit draw command buffer.");
     }
 
+    blocking.submitMs = elapsedMs(submitStart, Clock::now());
+
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -493,7 +534,10 @@ VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_
     presentInfo.pSwapchains = swapChains;
     presentInfo.pImageIndices = imageIndex;
 
-    VkResult result = vkQueuePresentKHR(device.getPresentQueue(), &presentInfo);
+    const Clock::time_point presentStart = Clock::now();
+    VkResult result = device.present(presentInfo);
+    blocking.presentMs = elapsedMs(presentStart, Clock::now());
+
     currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
     return (result);
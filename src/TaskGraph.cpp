@@ -0,0 +1,186 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: TaskGraph.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "TaskGraph.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+/// \brief Registra una tarea en el grafo.
+/// \param name Nombre legible (se usa en las mediciones).
+/// \param work Trabajo a ejecutar.
+/// \param dependencies Tareas que deben completarse antes de ésta.
+/// \param mainThreadOnly Si es \c true sólo la ejecuta la hebra que llama a \c run
+/// (necesario para llamadas de GLFW que deben hacerse desde la hebra principal).
+/// \return Identificador de la tarea creada.
+TaskGraph::TaskId TaskGraph::addTask(
+    const std::string& name,
+    std::function<void()> work,
+    const std::vector<TaskId>& dependencies,
+    bool mainThreadOnly)
+{
+    const TaskId id = tasks.size();
+
+    Task task {};
+    task.name = name;
+    task.work = std::move(work);
+    task.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    task.mainThreadOnly = mainThreadOnly;
+    tasks.push_back(std::move(task));
+
+    for (TaskId dependency : dependencies)
+    {
+        assert(dependency < id && "💥[Vulkan API] Task dependency must be added before its dependent.");
+        tasks[dependency].dependents.push_back(id);
+    }
+
+    return (id);
+}
+
+/// \brief Ejecuta todas las tareas respetando sus dependencias.
+/// \details La hebra llamante participa como trabajadora; con \c threadCount igual
+/// a 1 las tareas se ejecutan en serie en orden topológico.
+/// \param threadCount Número total de hebras a utilizar (mínimo 1).
+void TaskGraph::run(uint32_t threadCount)
+{
+    timings.clear();
+    timings.reserve(tasks.size());
+
+    std::vector<uint32_t> pending(tasks.size());
+    std::deque<TaskId> ready;
+    std::deque<TaskId> readyMain;
+
+    auto enqueue = [&](TaskId id)
+    {
+        if (tasks[id].mainThreadOnly)
+        {
+            readyMain.push_back(id);
+        }
+        else
+        {
+            ready.push_back(id);
+        }
+    };
+
+    for (TaskId id = 0; id < tasks.size(); ++id)
+    {
+        pending[id] = tasks[id].dependencyCount;
+
+        if (pending[id] == 0)
+        {
+            enqueue(id);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    size_t finished = 0;
+    size_t running = 0;
+    std::exception_ptr failure;
+
+    auto workerLoop = [&](uint32_t worker)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            const bool isMain = (worker == 0);
+
+            wakeUp.wait(lock, [&]
+            {
+                return !ready.empty() || (isMain && !readyMain.empty()) ||
+                    finished == tasks.size() || (failure && running == 0);
+            });
+
+            if (finished == tasks.size() || failure)
+            {
+                wakeUp.notify_all();
+                return;
+            }
+
+            std::deque<TaskId>& queue = (isMain && !readyMain.empty()) ? readyMain : ready;
+            const TaskId id = queue.front();
+            queue.pop_front();
+            running += 1;
+
+            lock.unlock();
+
+            TaskTiming timing {};
+            timing.name = tasks[id].name;
+            timing.worker = worker;
+            timing.begin = std::chrono::high_resolution_clock::now();
+
+            std::exception_ptr error;
+
+            try
+            {
+                tasks[id].work();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            timing.end = std::chrono::high_resolution_clock::now();
+
+            lock.lock();
+            running -= 1;
+            timings.push_back(std::move(timing));
+
+            if (error)
+            {
+                if (!failure)
+                {
+                    failure = error;
+                }
+
+                wakeUp.notify_all();
+                continue;
+            }
+
+            finished += 1;
+
+            for (TaskId dependent : tasks[id].dependents)
+            {
+                pending[dependent] -= 1;
+
+                if (pending[dependent] == 0)
+                {
+                    enqueue(dependent);
+                }
+            }
+
+            wakeUp.notify_all();
+        }
+    };
+
+    const uint32_t helperCount = (threadCount > 1) ? threadCount - 1 : 0;
+    std::vector<std::thread> helpers;
+    helpers.reserve(helperCount);
+
+    for (uint32_t t = 0; t < helperCount; ++t)
+    {
+        helpers.emplace_back(workerLoop, t + 1);
+    }
+
+    workerLoop(0);
+
+    for (std::thread& helper : helpers)
+    {
+        helper.join();
+    }
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
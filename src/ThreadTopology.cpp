@@ -0,0 +1,444 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: ThreadTopology.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ThreadTopology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/// Fracción de la capacidad máxima por encima de la cual un núcleo se considera
+/// de rendimiento (absorbe las pequeñas diferencias de turbo entre núcleos iguales).
+static constexpr double PERFORMANCE_CAPACITY_RATIO = 0.9;
+
+/// \brief Lee la primera línea de un fichero (p.ej., de sysfs).
+static bool readLine(const std::string& path, std::string& line)
+{
+    std::ifstream file(path);
+
+    return (static_cast<bool>(std::getline(file, line)));
+}
+
+/// \brief Lee un entero sin signo de un fichero.
+static bool readNumber(const std::string& path, uint64_t& value)
+{
+    std::ifstream file(path);
+
+    return (static_cast<bool>(file >> value));
+}
+
+/// \brief Interpreta una lista de CPUs de sysfs (p.ej., "0-3,8,10-11").
+static std::vector<uint32_t> parseCpuList(const std::string& list)
+{
+    std::vector<uint32_t> result;
+    std::stringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ','))
+    {
+        uint32_t first = 0;
+        uint32_t last = 0;
+        char dash = 0;
+        std::stringstream bounds(range);
+
+        if (!(bounds >> first))
+        {
+            continue;
+        }
+
+        last = (bounds >> dash >> last) ? last : first;
+
+        for (uint32_t cpu = first; cpu <= last; ++cpu)
+        {
+            result.push_back(cpu);
+        }
+    }
+
+    return (result);
+}
+
+/// \brief Detecta la topología del equipo.
+ThreadTopology ThreadTopology::detect()
+{
+    ThreadTopology topology;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool hasMask = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+
+    std::string line;
+    std::vector<uint32_t> online;
+    std::vector<uint32_t> coreList;
+    std::vector<uint32_t> atomList;
+
+    if (readLine("/sys/devices/system/cpu/online", line))
+    {
+        online = parseCpuList(line);
+    }
+
+    if (readLine("/sys/devices/cpu_core/cpus", line))
+    {
+        coreList = parseCpuList(line);
+    }
+
+    if (readLine("/sys/devices/cpu_atom/cpus", line))
+    {
+        atomList = parseCpuList(line);
+    }
+
+    for (uint32_t id : online)
+    {
+        if (hasMask && (id >= CPU_SETSIZE || !CPU_ISSET(id, &allowed)))
+        {
+            continue;
+        }
+
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(id);
+
+        CpuInfo cpu {};
+        cpu.id = id;
+
+        uint64_t coreId = id;
+        uint64_t packageId = 0;
+        readNumber(base + "/topology/core_id", coreId);
+        readNumber(base + "/topology/physical_package_id", packageId);
+
+        // core_id sólo es único dentro de su encapsulado.
+        cpu.package = static_cast<uint32_t>(packageId);
+        cpu.core = static_cast<uint32_t>((packageId << 16) | coreId);
+
+        if (!readNumber(base + "/cpu_capacity", cpu.capacity))
+        {
+            readNumber(base + "/cpufreq/cpuinfo_max_freq", cpu.capacity);
+        }
+
+        // El grupo es el de la caché de mayor nivel (L3 en x86: un CCX en AMD).
+        cpu.cacheGroup = cpu.package;
+        uint64_t bestLevel = 0;
+
+        for (uint32_t index = 0;; ++index)
+        {
+            const std::string cache = base + "/cache/index" + std::to_string(index);
+            uint64_t level = 0;
+
+            if (!readNumber(cache + "/level", level))
+            {
+                break;
+            }
+
+            if (level >= bestLevel && readLine(cache + "/shared_cpu_list", line))
+            {
+                const std::vector<uint32_t> shared = parseCpuList(line);
+
+                if (!shared.empty())
+                {
+                    bestLevel = level;
+                    cpu.cacheGroup = shared.front();
+                }
+            }
+        }
+
+        topology.cpus.push_back(cpu);
+    }
+
+    if (!coreList.empty() && !atomList.empty())
+    {
+        for (CpuInfo& cpu : topology.cpus)
+        {
+            cpu.performance = std::find(coreList.begin(), coreList.end(), cpu.id) != coreList.end();
+        }
+    }
+    else
+    {
+        uint64_t maxCapacity = 0;
+
+        for (const CpuInfo& cpu : topology.cpus)
+        {
+            maxCapacity = std::max(maxCapacity, cpu.capacity);
+        }
+
+        for (CpuInfo& cpu : topology.cpus)
+        {
+            cpu.performance = (maxCapacity == 0) ||
+                (double(cpu.capacity) >= PERFORMANCE_CAPACITY_RATIO * double(maxCapacity));
+        }
+    }
+#endif
+
+    if (topology.cpus.empty())
+    {
+        const uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+
+        for (uint32_t id = 0; id < count; ++id)
+        {
+            CpuInfo cpu {};
+            cpu.id = id;
+            cpu.core = id;
+            topology.cpus.push_back(cpu);
+        }
+    }
+
+    return (topology);
+}
+
+/// \brief Reparte los papeles de hebra según \c policy.
+/// \param policy Política a aplicar.
+/// \param recordingThreads Número de hebras de grabación.
+/// \return Plan de afinidad (vacío con \c AffinityPolicy::None).
+ThreadPlan ThreadTopology::plan(AffinityPolicy policy, uint32_t recordingThreads) const
+{
+    ThreadPlan result {};
+
+    if (policy == AffinityPolicy::None || cpus.size() < 2)
+    {
+        return (result);
+    }
+
+    // Grupo de caché con más núcleos físicos de rendimiento: la hebra principal y
+    // las de grabación comparten datos de escena y se benefician de la misma L3.
+    std::map<uint32_t, std::set<uint32_t>> groupCores;
+
+    for (const CpuInfo& cpu : cpus)
+    {
+        if (cpu.performance)
+        {
+            groupCores[cpu.cacheGroup].insert(cpu.core);
+        }
+    }
+
+    uint32_t bestGroup = 0;
+    size_t bestCores = 0;
+
+    for (const std::pair<const uint32_t, std::set<uint32_t>>& group : groupCores)
+    {
+        if (group.second.size() > bestCores)
+        {
+            bestGroup = group.first;
+            bestCores = group.second.size();
+        }
+    }
+
+    // Un hilo por núcleo físico (primero el grupo elegido), después los hermanos SMT.
+    std::vector<uint32_t> ordered;
+    std::vector<uint32_t> siblings;
+    std::set<uint32_t> usedCores;
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (const CpuInfo& cpu : cpus)
+        {
+            if (!cpu.performance || ((cpu.cacheGroup == bestGroup) != (pass == 0)))
+            {
+                continue;
+            }
+
+            if (usedCores.insert(cpu.core).second)
+            {
+                ordered.push_back(cpu.id);
+            }
+            else
+            {
+                siblings.push_back(cpu.id);
+            }
+        }
+    }
+
+    ordered.insert(ordered.end(), siblings.begin(), siblings.end());
+
+    if (ordered.empty())
+    {
+        return (result);
+    }
+
+    result.render = ordered.front();
+
+    std::vector<uint32_t> recordingPool(ordered.begin() + 1, ordered.end());
+
+    if (recordingPool.empty())
+    {
+        recordingPool = ordered;
+    }
+
+    for (uint32_t i = 0; i < recordingThreads; ++i)
+    {
+        result.recording.push_back(recordingPool[i % recordingPool.size()]);
+    }
+
+    for (const CpuInfo& cpu : cpus)
+    {
+        if (!cpu.performance)
+        {
+            result.loaders.push_back(cpu.id);
+        }
+    }
+
+    // Sin núcleos de eficiencia: las CPUs que no usan la principal ni la grabación
+    // o, si no queda ninguna, todas salvo la principal.
+    if (result.loaders.empty())
+    {
+        for (const CpuInfo& cpu : cpus)
+        {
+            if (cpu.id != result.render &&
+                std::find(result.recording.begin(), result.recording.end(), cpu.id) == result.recording.end())
+            {
+                result.loaders.push_back(cpu.id);
+            }
+        }
+    }
+
+    if (result.loaders.empty())
+    {
+        for (const CpuInfo& cpu : cpus)
+        {
+            if (cpu.id != result.render)
+            {
+                result.loaders.push_back(cpu.id);
+            }
+        }
+    }
+
+    return (result);
+}
+
+/// \brief Fija la afinidad de la hebra actual.
+/// \param cpuIds CPUs permitidas (vacío = no hace nada).
+/// \return \c true si el sistema aceptó la afinidad.
+bool ThreadTopology::pinCurrentThread(const std::vector<uint32_t>& cpuIds)
+{
+    if (cpuIds.empty())
+    {
+        return (false);
+    }
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (uint32_t id : cpuIds)
+    {
+        if (id < CPU_SETSIZE)
+        {
+            CPU_SET(id, &set);
+        }
+    }
+
+    return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+
+    for (uint32_t id : cpuIds)
+    {
+        if (id < sizeof(DWORD_PTR) * 8)
+        {
+            mask |= DWORD_PTR(1) << id;
+        }
+    }
+
+    return (mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0);
+#else
+    return (false);
+#endif
+}
+
+/// \brief Baja la prioridad de la hebra actual al mínimo (trabajo de fondo).
+/// \details En Linux usa \c SCHED_IDLE (no requiere privilegios); en Windows,
+/// \c THREAD_PRIORITY_LOWEST.
+/// \return \c true si el sistema aceptó el cambio.
+bool ThreadTopology::lowerCurrentThreadPriority()
+{
+#if defined(__linux__)
+    sched_param param {};
+    param.sched_priority = 0;
+
+    return (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0);
+#elif defined(_WIN32)
+    return (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST) != 0);
+#else
+    return (false);
+#endif
+}
+
+/// \brief Indica si hay núcleos de rendimiento y de eficiencia.
+bool ThreadTopology::isHybrid() const
+{
+    return (std::any_of(cpus.begin(), cpus.end(), [](const CpuInfo& cpu)
+    {
+        return (!cpu.performance);
+    }));
+}
+
+/// \brief Nombre legible de una política.
+const char* ThreadTopology::policyName(AffinityPolicy policy)
+{
+    return ((policy == AffinityPolicy::Performance) ? "performance" : "none");
+}
+
+/// \brief Vuelca la topología y el plan en texto.
+/// \param threadPlan Plan a describir.
+/// \param out Flujo de salida.
+void ThreadTopology::print(const ThreadPlan& threadPlan, std::ostream& out) const
+{
+    std::set<uint32_t> cores;
+    std::set<uint32_t> groups;
+
+    for (const CpuInfo& cpu : cpus)
+    {
+        cores.insert(cpu.core);
+        groups.insert(cpu.cacheGroup);
+    }
+
+    auto printList = [&out](const std::vector<uint32_t>& list)
+    {
+        if (list.empty())
+        {
+            out << "any";
+            return;
+        }
+
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            out << (i ? "," : "") << list[i];
+        }
+    };
+
+    out << "[threads] " << cpus.size() << " cpus, " << cores.size() << " cores, " <<
+        groups.size() << " cache groups, hybrid: " << (isHybrid() ? "yes" : "no") << '\n';
+
+    out << "[threads] render: ";
+
+    if (threadPlan.render == ThreadPlan::ANY_CPU)
+    {
+        out << "any";
+    }
+    else
+    {
+        out << threadPlan.render;
+    }
+
+    out << "  recording: ";
+    printList(threadPlan.recording);
+    out << "  loaders: ";
+    printList(threadPlan.loaders);
+    out << '\n';
+}
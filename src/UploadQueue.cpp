@@ -0,0 +1,271 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: UploadQueue.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "UploadQueue.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+/// \brief Crea el command pool, el semáforo y la hebra de espera.
+/// \param device Dispositivo Vulkan.
+/// \param scheduler Planificador en el que se reanudan las corrutinas.
+UploadQueue::UploadQueue(VulkanDevice& device, AsyncScheduler& scheduler)
+    : device(device), scheduler(scheduler)
+{
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = device.getQueueFamilyIndices().graphicsFamily;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create upload command pool.");
+    }
+
+    if (device.getCapabilities().timelineSemaphore)
+    {
+        VkSemaphoreTypeCreateInfo typeInfo {};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+
+        if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &timeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("💥[Vulkan API] Failed to create upload timeline semaphore.");
+        }
+    }
+    else
+    {
+        std::cout << "[Vulkan API] Timeline semaphores unavailable: uploads wait on per-submit fences." << std::endl;
+    }
+
+    waiterThread = std::thread(&UploadQueue::waitLoop, this);
+}
+
+/// \brief Espera a los envíos pendientes y libera los recursos.
+UploadQueue::~UploadQueue()
+{
+    waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+    waiterThread.join();
+
+    if (timeline != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(device.getDevice(), timeline, nullptr);
+    }
+
+    vkDestroyCommandPool(device.getDevice(), commandPool, nullptr);
+}
+
+/// \brief Graba y envía un command buffer de transferencia sin esperar a la GPU.
+/// \param record Función que graba los comandos.
+/// \param keepAlive Recurso que debe vivir hasta que la GPU termine (p.ej., staging).
+/// \return Ticket del envío.
+UploadTicket UploadQueue::submit(
+    const std::function<void(VkCommandBuffer)>& record,
+    std::shared_ptr<void> keepAlive)
+{
+    std::lock_guard<std::mutex> poolLock(poolMutex);
+
+    Submission submission {};
+    submission.value = lastValue + 1;
+    submission.keepAlive = std::move(keepAlive);
+
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &submission.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to allocate upload command buffer.");
+    }
+
+    VkCommandBufferBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(submission.commandBuffer, &beginInfo);
+    record(submission.commandBuffer);
+    vkEndCommandBuffer(submission.commandBuffer);
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &submission.value;
+
+    VkSubmitInfo submitInfo {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &submission.commandBuffer;
+
+    if (timeline != VK_NULL_HANDLE)
+    {
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &timeline;
+    }
+    else
+    {
+        VkFenceCreateInfo fenceInfo {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device.getDevice(), &fenceInfo, nullptr, &submission.fence) != VK_SUCCESS)
+        {
+            vkFreeCommandBuffers(device.getDevice(), commandPool, 1, &submission.commandBuffer);
+            throw std::runtime_error("💥[Vulkan API] Failed to create upload fence.");
+        }
+    }
+
+    if (device.submitGraphics(1, &submitInfo, submission.fence) != VK_SUCCESS)
+    {
+        if (submission.fence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(device.getDevice(), submission.fence, nullptr);
+        }
+
+        vkFreeCommandBuffers(device.getDevice(), commandPool, 1, &submission.commandBuffer);
+        throw std::runtime_error("💥[Vulkan API] Failed to submit upload command buffer.");
+    }
+
+    lastValue = submission.value;
+    const UploadTicket ticket {submission.value};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(submission));
+    }
+
+    wakeUp.notify_one();
+    return (ticket);
+}
+
+/// \brief Bloquea hasta que se completan todos los envíos.
+void UploadQueue::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [&] { return (pending.empty()); });
+}
+
+/// \brief Registra una corrutina a la espera de un ticket.
+/// \return \c false si el ticket ya se completó (la corrutina no se suspende).
+bool UploadQueue::addWaiter(UploadTicket ticket, std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (completed.load(std::memory_order_acquire) >= ticket.value)
+    {
+        return (false);
+    }
+
+    waiters.push_back({ticket.value, handle});
+    return (true);
+}
+
+/// \brief Bucle de la hebra que espera a la GPU.
+/// \details Los envíos se completan en orden de valor, así que basta con esperar al
+/// más antiguo; los nuevos envíos sólo se añaden al final de la cola.
+void UploadQueue::waitLoop()
+{
+    while (true)
+    {
+        Submission submission {};
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [&] { return (stopping || !pending.empty()); });
+
+            if (pending.empty())
+            {
+                return;
+            }
+
+            submission.value = pending.front().value;
+            submission.commandBuffer = pending.front().commandBuffer;
+            submission.fence = pending.front().fence;
+        }
+
+        VkResult result;
+
+        if (timeline != VK_NULL_HANDLE)
+        {
+            VkSemaphoreWaitInfo waitInfo {};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &timeline;
+            waitInfo.pValues = &submission.value;
+
+            result = vkWaitSemaphores(device.getDevice(), &waitInfo, UINT64_MAX);
+        }
+        else
+        {
+            result = vkWaitForFences(device.getDevice(), 1, &submission.fence, VK_TRUE, UINT64_MAX);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            std::cerr << "💥[Vulkan API] Upload wait failed (" << result << ")." << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> poolLock(poolMutex);
+            vkFreeCommandBuffers(device.getDevice(), commandPool, 1, &submission.commandBuffer);
+        }
+
+        if (submission.fence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(device.getDevice(), submission.fence, nullptr);
+        }
+
+        std::vector<std::coroutine_handle<>> resumable;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            submission.keepAlive = std::move(pending.front().keepAlive);
+            pending.pop_front();
+            completed.store(submission.value, std::memory_order_release);
+
+            for (size_t i = 0; i < waiters.size();)
+            {
+                if (waiters[i].value <= submission.value)
+                {
+                    resumable.push_back(waiters[i].handle);
+                    waiters[i] = waiters.back();
+                    waiters.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if (pending.empty())
+            {
+                drained.notify_all();
+            }
+        }
+
+        submission.keepAlive.reset();
+
+        for (std::coroutine_handle<> handle : resumable)
+        {
+            scheduler.post(handle);
+        }
+    }
+}
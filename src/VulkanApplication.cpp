@@ -9,64 +9,438 @@
 #include "VulkanApplication.hpp"
 
 #include "DescriptorWriter.hpp"
+#include "FrameCapture.hpp"
+#include "FrameReplay.hpp"
+#include "FrameTrace.hpp"
 #include "KeyboardController.hpp"
 #include "PointLightRenderer.hpp"
 #include "BasicRenderer.hpp"
-
+#include "ClipmapTerrain.hpp"
+#include "AssetIO.hpp"
+#include "AsyncCompute.hpp"
+#include "AsyncScheduler.hpp"
+#include "GraphicsPipeline.hpp"
+#include "ImpostorSystem.hpp"
+#include "LightBaker.hpp"
+#include "LightGrid.hpp"
+#include "MetricsExporter.hpp"
+#include "MultiViewPass.hpp"
+#include "ParticleSystem.hpp"
+#include "PrecisionBench.hpp"
+#include "ProbeGrid.hpp"
+#include "RecordingBench.hpp"
+#include "SkinningSystem.hpp"
+#include "TaskGraph.hpp"
+#include "UploadQueue.hpp"
+#include "WorldStreamer.hpp"
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
 #include <thread>
 
+/// Frames iniciales que no cuentan en \c --bench-frames (cachés, compilación de drivers).
+static constexpr uint32_t BENCH_WARMUP_FRAMES = 30;
+
+/// Hebras del planificador de corrutinas usado para cargar mallas en el arranque.
+static constexpr uint32_t ASYNC_LOAD_THREADS = 2;
+
+/// \brief Lee y parsea un fichero .obj.
+/// \details La lectura no ocupa ninguna hebra: la corrutina se suspende y el parseo
+/// continúa en una hebra del planificador cuando \c AssetIO entrega los datos.
+/// \param scheduler Planificador de corrutinas.
+/// \param io Lector de ficheros.
+/// \param path Ruta del modelo relativa a la raíz del proyecto.
+/// \return Geometría del modelo.
+static Task<Model::Builder> parseObj(AsyncScheduler& scheduler, AssetIO& io, std::string path)
+{
+    const std::vector<char> bytes = co_await scheduler.readFile(io, "../" + path);
+
+    Model::Builder builder {};
+    builder.loadFromMemory(bytes);
+    co_return builder;
+}
 
-struct Threads
+/// \brief Carga una malla: lectura, parseo, subida a la GPU y liberación del staging.
+/// \details Los pasos se escriben en secuencia, pero ninguno bloquea una hebra mientras
+/// espera; varias cargas lanzadas a la vez se solapan entre sí.
+/// \param device Dispositivo Vulkan.
+/// \param scheduler Planificador de corrutinas.
+/// \param io Lector de ficheros.
+/// \param uploads Cola de subidas a la GPU.
+/// \param path Ruta del modelo relativa a la raíz del proyecto.
+/// \param target Destino de la malla creada.
+static Task<void> loadModel(
+    VulkanDevice& device,
+    AsyncScheduler& scheduler,
+    AssetIO& io,
+    UploadQueue& uploads,
+    std::string path,
+    std::shared_ptr<Model>& target)
 {
-    VkCommandPool pool{VK_NULL_HANDLE};
-    std::vector<VkCommandBuffer> sec;
-};
+    const Model::Builder builder = co_await parseObj(scheduler, io, path);
 
+    std::shared_ptr<Model> model = std::make_shared<Model>(device, builder, 0, true);
 
-/// \brief Construye la aplicación y prepara los componentes básicos.
-/// \details No inicia el bucle de ejecución. La inicialización
-/// completa se realiza en \c run .
-VulkanApplication::VulkanApplication() 
+    const UploadTicket ticket = uploads.submit([&model](VkCommandBuffer commandBuffer)
+    {
+        model->recordUpload(commandBuffer);
+    });
+
+    co_await uploads.wait(ticket);
+
+    model->releaseStaging();
+    target = std::move(model);
+}
+
+/// \brief Configuración del gobernador de calidad a partir de las opciones.
+/// \param options Opciones de la aplicación.
+/// \return Configuración con el presupuesto de frame indicado.
+static QualityGovernorSettings qualitySettings(const ApplicationOptions& options)
 {
+    QualityGovernorSettings settings {};
+    settings.targetFrameMs = options.frameBudgetMs;
+
+    return (settings);
+}
+
+/// \brief Imprime media, desviación típica, percentiles y máximo de los tiempos de frame.
+/// \param frameMs Tiempos de frame (ms).
+/// \param out Flujo de salida.
+static void printFrameTimes(std::vector<float> frameMs, std::ostream& out)
+{
+    const size_t count = frameMs.size();
+    double mean = 0.0;
+
+    for (float ms : frameMs)
+    {
+        mean += ms;
+    }
+
+    mean /= double(count);
+
+    double variance = 0.0;
+
+    for (float ms : frameMs)
+    {
+        variance += (ms - mean) * (ms - mean);
+    }
+
+    variance /= double(count);
+
+    std::sort(frameMs.begin(), frameMs.end());
+
+    auto percentile = [&](double p)
+    {
+        return (frameMs[std::min(count - 1, static_cast<size_t>(p * double(count)))]);
+    };
+
+    out << std::fixed << std::setprecision(3) <<
+        "[frames] n=" << count <<
+        " mean=" << mean << " ms" <<
+        " stddev=" << std::sqrt(variance) << " ms" <<
+        " p50=" << percentile(0.50) << " ms" <<
+        " p99=" << percentile(0.99) << " ms" <<
+        " max=" << frameMs.back() << " ms\n";
+}
+
+/// \brief Construye la aplicación e inicializa todos los subsistemas.
+/// \details Ejecuta el grafo de arranque. No inicia el bucle de ejecución.
+/// \param options Opciones de ejecución.
+VulkanApplication::VulkanApplication(const ApplicationOptions& options)
+    : options{options},
+    editorUI{!(options.headless || options.benchStartup || options.benchFrames > 0)},
+    qualityGovernor{qualitySettings(options)},
+    qualityLocked{options.lockQuality}
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    // La ventana se crea al construir editorUI, justo después del origen de la línea temporal.
+    startupTimeline.addPhase("window", 0, startupTimeline.getEpoch(), Clock::now());
+
+    Clock::time_point phaseBegin = Clock::now();
     vulkanDevice = std::make_unique<VulkanDevice>(editorUI.getWindow());
-    renderer = std::make_unique<Renderer>(editorUI.getWindow(), *vulkanDevice);
+    startupTimeline.addPhase("device", 0, phaseBegin, Clock::now());
 
-    editorUI.init(vulkanDevice->getInstance(),
-        vulkanDevice->getPhysicalDevice(),
-        vulkanDevice->getDevice(),
-        vulkanDevice->getQueueFamilyIndices().GetGraphicsFamily(),
-        vulkanDevice->getGraphicsQueue(),
-        renderer->getSwapChainRenderPass(),
-        renderer->getSwapChainImageCount());
+    phaseBegin = Clock::now();
+    editorUI.createContext();
+    startupTimeline.addPhase("imgui.context", 0, phaseBegin, Clock::now());
 
-    std::vector<VkDescriptorPoolSize> poolSizes = 
+    // La hebra principal se fija en run(): las hebras creadas antes heredarían su afinidad.
+    phaseBegin = Clock::now();
+    threadTopology = ThreadTopology::detect();
+    threadPlan = threadTopology.plan(options.affinity, std::max(2u, std::thread::hardware_concurrency()));
+    startupTimeline.addPhase("thread.topology", 0, phaseBegin, Clock::now());
+
+    // A partir de aquí el dispositivo existe: el resto del arranque se expresa
+    // como un grafo de dependencias y se reparte entre varias hebras.
+    TaskGraph graph;
+
+    const std::vector<std::string> shaderPaths =
     {
-     {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, SwapChain::MAX_FRAMES_IN_FLIGHT}
+        "shaders/simple_shader.vert.spv",
+        "shaders/simple_shader.frag.spv",
+        "shaders/simple_shader_multiview.vert.spv",
+        "shaders/point_light.vert.spv",
+        "shaders/point_light.frag.spv",
+        "shaders/particle.vert.spv",
+        "shaders/particle.frag.spv",
+        "shaders/particle_kickoff.comp.spv",
+        "shaders/particle_emit.comp.spv",
+        "shaders/particle_simulate.comp.spv",
+        "shaders/skin.comp.spv",
+        "shaders/probe_update.comp.spv",
+        "shaders/terrain.vert.spv",
+        "shaders/terrain.frag.spv",
+        "shaders/impostor_bake.vert.spv",
+        "shaders/impostor_bake.frag.spv",
+        "shaders/impostor.vert.spv",
+        "shaders/impostor.frag.spv"
     };
 
-    globalPool = std::make_unique<DescriptorPool>(
-        *vulkanDevice,
-        SwapChain::MAX_FRAMES_IN_FLIGHT,
-        0,
-        poolSizes
-    );
+    const std::vector<std::string> modelPaths = {"models/room.obj"};
+
+    // Los shaders del arranque se piden en un único lote: con io_uring quedan en
+    // vuelo a la vez en lugar de leerse uno por hebra.
+    AssetIO assetIO;
+
+    const TaskGraph::TaskId readTask = graph.addTask(
+        std::string("asset.read ") + AssetIO::backendName(assetIO.getBackend()), [&]
+    {
+        std::vector<AssetReadRequest> requests;
+
+        for (const std::string& path : shaderPaths)
+        {
+            AssetReadRequest request {};
+            request.path = "../" + path;
+            request.onComplete = [path](AssetReadResult& result)
+            {
+                if (result.ok)
+                {
+                    GraphicsPipeline::storeShader(path, std::move(result.data));
+                }
+            };
+            requests.push_back(std::move(request));
+        }
+
+        assetIO.submit(std::move(requests))->wait();
+    });
+
+    // GLFW (tamaño del framebuffer, eventos) sólo puede usarse desde la hebra principal.
+    const TaskGraph::TaskId swapChainTask = graph.addTask("swapchain", [this]
+    {
+        renderer = std::make_unique<Renderer>(editorUI.getWindow(), *vulkanDevice);
+    }, {}, true);
+
+    const TaskGraph::TaskId fontsTask = graph.addTask("imgui.fonts", [this]
+    {
+        editorUI.buildFonts();
+    });
+
+    graph.addTask("imgui.backend", [this]
+    {
+        editorUI.init(vulkanDevice->getInstance(),
+            vulkanDevice->getPhysicalDevice(),
+            vulkanDevice->getDevice(),
+            vulkanDevice->getQueueFamilyIndices().GetGraphicsFamily(),
+            vulkanDevice->getGraphicsQueue(),
+            renderer->getSwapChainRenderPass(),
+            renderer->getSwapChainImageCount());
+    }, {swapChainTask, fontsTask});
+
+    // Incluye la tubería de probe_update.comp, de ahí la dependencia de la lectura.
+    const TaskGraph::TaskId descriptorsTask = graph.addTask("descriptors", [this]
+    {
+        createGlobalDescriptors();
+    }, {readTask});
+
+    graph.addTask("recording.workers", [this]
+    {
+        createRecordingWorkers();
+    });
+
+    std::vector<std::shared_ptr<Model>> loadedModels(modelPaths.size());
+
+    // Cada malla es una corrutina (leer, parsear, subir); la subida usa su propio
+    // command pool y el acceso a la cola está serializado en VulkanDevice, así que no
+    // hace falta esperar a la swapchain. Esta tarea sólo espera a que terminen todas.
+    const TaskGraph::TaskId modelsTask = graph.addTask("models.async", [&]
+    {
+        AsyncScheduler scheduler(ASYNC_LOAD_THREADS, threadPlan.loaders);
+        UploadQueue uploads(*vulkanDevice, scheduler);
+
+        for (size_t i = 0; i < modelPaths.size(); ++i)
+        {
+            scheduler.spawn(loadModel(
+                *vulkanDevice, scheduler, assetIO, uploads, modelPaths[i], loadedModels[i]));
+        }
+
+        scheduler.waitIdle();
+    });
+
+    graph.addTask("pipeline.basic", [this]
+    {
+        basicRenderer = std::make_unique<BasicRenderer>(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            globalSetLayout->get());
+    }, {swapChainTask, descriptorsTask, readTask});
+
+    graph.addTask("pipeline.pointlight", [this]
+    {
+        pointLightSystem = std::make_unique<PointLightSystem>(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            globalSetLayout->get());
+    }, {swapChainTask, descriptorsTask, readTask});
+
+    graph.addTask("pipeline.particles", [this]
+    {
+        particleSystem = std::make_unique<ParticleSystem>(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            globalSetLayout->get());
+
+        asyncCompute = std::make_unique<AsyncCompute>(
+            *vulkanDevice,
+            SwapChain::MAX_FRAMES_IN_FLIGHT,
+            options.asyncCompute);
+    }, {swapChainTask, descriptorsTask, readTask});
+
+    const TaskGraph::TaskId terrainTask = graph.addTask("pipeline.terrain", [this]
+    {
+        terrain = std::make_unique<ClipmapTerrain>(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            globalSetLayout->get());
+    }, {swapChainTask, descriptorsTask, readTask});
+
+    graph.addTask("pipeline.impostors", [this]
+    {
+        impostorSystem = std::make_unique<ImpostorSystem>(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            globalSetLayout->get());
+    }, {swapChainTask, descriptorsTask, readTask});
+
+    if (options.multiView != MultiViewMode::Off)
+    {
+        graph.addTask("pipeline.multiview", [this]
+        {
+            MultiViewSettings multiViewSettings {};
+            multiViewSettings.mode = options.multiView;
+
+            multiViewPass = std::make_unique<MultiViewPass>(
+                *vulkanDevice,
+                *globalSetLayout,
+                *lightGrid,
+                *probeGrid,
+                multiViewSettings);
+        }, {descriptorsTask, readTask});
+    }
+
+    // Las hebras de carga crean las mallas con subida diferida: no usan la cola.
+    graph.addTask("world.streamer", [this]
+    {
+        const ClipmapTerrain* ground = terrain.get();
+
+        WorldStreamerSettings streamerSettings {};
+        streamerSettings.workerCpus = threadPlan.loaders;
+
+        worldStreamer = std::make_unique<WorldStreamer>(*vulkanDevice, [ground](float x, float z)
+        {
+            return (ground->surfaceY(x, z));
+        }, streamerSettings);
+    }, {terrainTask});
+
+    // Copia búferes con el command pool principal, que la creación de la swapchain
+    // también utiliza para sus command buffers.
+    const TaskGraph::TaskId skinningTask = graph.addTask("skinning", [this]
+    {
+        skinningSystem = std::make_unique<SkinningSystem>(*vulkanDevice);
+    }, {swapChainTask, readTask});
+
+    graph.addTask("scene", [&]
+    {
+        for (size_t i = 0; i < modelPaths.size(); ++i)
+        {
+            models[modelPaths[i]] = loadedModels[i];
+        }
 
-    loadGameObjects();
+        loadGameObjects();
+        skinningSystem->populate(gameObjects);
+    }, {modelsTask, skinningTask});
+
+    const uint32_t threadCount = options.serialStartup ?
+        1u : std::max(2u, std::thread::hardware_concurrency());
+
+    graph.run(threadCount);
+
+    if (options.probeLighting)
+    {
+        fitProbeGrid();
+    }
+
+    if (options.bakeLighting)
+    {
+        bakeStaticLighting();
+    }
+
+    lightGrid->setProbeLighting(options.probeLighting);
+
+    for (const TaskTiming& timing : graph.getTimings())
+    {
+        startupTimeline.addPhase(timing.name, timing.worker, timing.begin, timing.end);
+    }
+
+    editorUI.setPerf(&renderer->getPerf());
+    renderer->getPerf().setStartupTimeline(&startupTimeline);
+    renderer->getPerf().setQualityLock(&qualityLocked);
+
+    impostorSwitchDistance = impostorSystem->getSettings().switchDistance;
+    applyQualityKnobs();
+
+    basicRenderer->setHalfPrecision(options.halfPrecision);
+
+    RecordVariant recordVariant {};
+    recordVariant.culling = options.frustumCulling;
+    basicRenderer->setRecordVariant(recordVariant);
 }
 
 /// \brief Libera los recursos administrados por la aplicación.
 VulkanApplication::~VulkanApplication() 
 {
+    for (RecordingWorker& worker : workers)
+    {
+        if (worker.pool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(vulkanDevice->getDevice(), worker.pool, nullptr);
+        }
+    }
 }
 
-/// \brief Ejecuta la aplicación.
-/// \details Lleva a cabo la inicialización restante, entra en el
-/// bucle principal de render y procesa eventos hasta que el usuario
-/// cierra la ventana. Al salir, sincroniza y limpia recursos.
-void VulkanApplication::run() 
+/// \brief Crea el pool, los UBO, el layout y los descriptor sets globales.
+/// \details El set global incluye también los SSBO de luces y de listas por objeto
+/// de \c LightGrid (bindings 1 y 2) y el de sondas de \c ProbeGrid (binding 3).
+void VulkanApplication::createGlobalDescriptors()
 {
-    std::vector<std::unique_ptr<VulkanBuffer>> uboBuffers(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    std::vector<VkDescriptorPoolSize> poolSizes = 
+    {
+     {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, SwapChain::MAX_FRAMES_IN_FLIGHT},
+     {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * SwapChain::MAX_FRAMES_IN_FLIGHT}
+    };
+
+    globalPool = std::make_unique<DescriptorPool>(
+        *vulkanDevice,
+        SwapChain::MAX_FRAMES_IN_FLIGHT,
+        0,
+        poolSizes
+    );
+
+    uboBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
 
     for (int i = 0; i < uboBuffers.size(); ++i) 
     {
@@ -80,6 +454,10 @@ void VulkanApplication::run()
         uboBuffers[i]->map();
     }
 
+    lightGrid = std::make_unique<LightGrid>(*vulkanDevice, SwapChain::MAX_FRAMES_IN_FLIGHT);
+    probeGrid = std::make_unique<ProbeGrid>(
+        *vulkanDevice, *lightGrid, SwapChain::MAX_FRAMES_IN_FLIGHT, options.probes);
+
     std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> globalBindings = 
     {
         {
@@ -92,31 +470,67 @@ void VulkanApplication::run()
                 VK_SHADER_STAGE_ALL_GRAPHICS,
                 nullptr
             }
+        },
+        {
+            1,
+            VkDescriptorSetLayoutBinding 
+            {
+                1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
+            }
+        },
+        {
+            2,
+            VkDescriptorSetLayoutBinding 
+            {
+                2,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
+            }
+        },
+        {
+            3,
+            VkDescriptorSetLayoutBinding 
+            {
+                3,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
+            }
         }
     };
 
-    std::unique_ptr<DescriptorSetLayout> globalSetLayout =
-        std::make_unique<DescriptorSetLayout>(*vulkanDevice, globalBindings);
+    globalSetLayout = std::make_unique<DescriptorSetLayout>(*vulkanDevice, globalBindings);
 
-    std::vector<VkDescriptorSet> globalDescriptorSets(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    globalDescriptorSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
 
     for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
     {
         VkDescriptorBufferInfo bufferInfo = uboBuffers[i]->descriptorInfo();
+        VkDescriptorBufferInfo lightsInfo = lightGrid->lightsInfo(i);
+        VkDescriptorBufferInfo listsInfo = lightGrid->listsInfo(i);
+        VkDescriptorBufferInfo probesInfo = probeGrid->probesInfo();
 
         DescriptorWriter(*globalSetLayout, *globalPool)
             .writeBuffer(0, &bufferInfo)
+            .writeBuffer(1, &lightsInfo)
+            .writeBuffer(2, &listsInfo)
+            .writeBuffer(3, &probesInfo)
             .build(globalDescriptorSets[i]);
     }
+}
 
-    BasicRenderer basicRenderer(
-        *vulkanDevice,
-        renderer->getSwapChainRenderPass(),
-        globalSetLayout->get()
-    );
-
+/// \brief Crea un command pool y sus command buffers secundarios por hebra de grabación.
+void VulkanApplication::createRecordingWorkers()
+{
     const int M = std::max(2u, std::thread::hardware_concurrency());
-    std::vector<Threads> workers(M);
+    workers.resize(M);
 
     for (int t = 0; t < M; ++t) 
     {
@@ -126,22 +540,168 @@ void VulkanApplication::run()
 
         vkCreateCommandPool(vulkanDevice->getDevice(), &pci, nullptr, &workers[t].pool);
 
-        workers[t].sec.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+        workers[t].secondary.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
 
         VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
 
         ai.commandPool = workers[t].pool;
         ai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
-        ai.commandBufferCount = (uint32_t)workers[t].sec.size();
+        ai.commandBufferCount = (uint32_t)workers[t].secondary.size();
 
-        vkAllocateCommandBuffers(vulkanDevice->getDevice(), &ai, workers[t].sec.data());
+        vkAllocateCommandBuffers(vulkanDevice->getDevice(), &ai, workers[t].secondary.data());
     }
+}
 
-    PointLightSystem pointLightSystem(
-        *vulkanDevice,
-        renderer->getSwapChainRenderPass(),
-        globalSetLayout->get()
-    );
+/// \brief Ejecuta la aplicación.
+/// \details Entra en el bucle principal de render y procesa eventos hasta
+/// que el usuario cierra la ventana (o tras el primer frame con
+/// \c benchStartup, o tras \c benchFrames frames medidos). La hebra principal
+/// y las de grabación se fijan a las CPUs de \c threadPlan. Al salir,
+/// sincroniza y limpia recursos.
+void VulkanApplication::run() 
+{
+    const int M = static_cast<int>(workers.size());
+
+    if (threadPlan.render != ThreadPlan::ANY_CPU)
+    {
+        ThreadTopology::pinCurrentThread({threadPlan.render});
+    }
+
+    if (!options.replayPath.empty())
+    {
+        FrameReplay replay(
+            *vulkanDevice,
+            FrameCapture::load(options.replayPath),
+            renderer->getSwapChainImageFormat(),
+            renderer->getSwapChainDepthFormat(),
+            renderer->getSwapChainExtent());
+
+        FrameReplay::print(
+            replay.run(
+                *basicRenderer,
+                *pointLightSystem,
+                *lightGrid,
+                *uboBuffers[0],
+                globalDescriptorSets[0],
+                options.replayIterations),
+            std::cout);
+
+        vulkanDevice->waitIdle();
+        editorUI.cleanup(vulkanDevice->getDevice());
+
+        return;
+    }
+
+    if (options.benchRecordingObjects > 0)
+    {
+        RecordingBenchSettings settings {};
+        settings.cpus = threadPlan.recording;
+
+        std::erase_if(settings.objectCounts, [&](uint32_t count)
+        {
+            return (count > options.benchRecordingObjects);
+        });
+
+        if (settings.objectCounts.empty() || settings.objectCounts.back() != options.benchRecordingObjects)
+        {
+            settings.objectCounts.push_back(options.benchRecordingObjects);
+        }
+
+        RecordingBench bench(
+            *vulkanDevice,
+            renderer->getSwapChainRenderPass(),
+            renderer->getCurrentFrameBuffer(),
+            renderer->getSwapChainExtent(),
+            settings.maxWorkers);
+
+        threadTopology.print(threadPlan, std::cout);
+        RecordingBench::print(bench.run(*basicRenderer, globalDescriptorSets[0], settings), std::cout);
+
+        settings.variantObjects = std::min(settings.variantObjects, options.benchRecordingObjects);
+        RecordingBench::printVariants(bench.runVariants(*basicRenderer, globalDescriptorSets[0], settings), std::cout);
+
+        vulkanDevice->waitIdle();
+        editorUI.cleanup(vulkanDevice->getDevice());
+
+        return;
+    }
+
+    if (!options.metricsSocket.empty())
+    {
+        metricsExporter = std::make_unique<MetricsExporter>(options.metricsSocket);
+
+        if (!metricsExporter->start())
+        {
+            metricsExporter.reset();
+        }
+    }
+
+    std::unique_ptr<FrameTrace> frameTrace;
+
+    if (!options.tracePath.empty())
+    {
+        frameTrace = std::make_unique<FrameTrace>(options.traceFrames);
+    }
+
+    auto finishTrace = [&]()
+    {
+        frameTrace->write(options.tracePath);
+        frameTrace->print(renderer->getPerf().getGpuClock(), std::cout);
+        std::cout << "[timeline] trace -> " << options.tracePath << '\n';
+        frameTrace.reset();
+    };
+
+    std::unique_ptr<HitchDetector> hitchDetector;
+    std::vector<HitchRecord> hitches;
+
+    if (options.hitchDetection)
+    {
+        hitchDetector = std::make_unique<HitchDetector>(options.hitch);
+    }
+
+    uint32_t lastAllocationCount = vulkanDevice->getAllocationCount();
+    uint64_t lastAllocatedBytes = vulkanDevice->getAllocatedBytes();
+
+    // Contadores del frame para las trazas; las asignaciones se cuentan por diferencia.
+    auto sampleCounters = [&]()
+    {
+        const Perf& perf = renderer->getPerf();
+        const PerfStats& stats = perf.stats();
+
+        TraceCounters counters {};
+        counters.cpuFrameMs = float(stats.cpuFrameMs);
+        counters.gpuFrameMs = float(stats.gpuFrameMs);
+        counters.blockedMs = stats.blocking.fenceWaitMs + stats.blocking.acquireMs +
+            stats.blocking.imageFenceMs + stats.blocking.presentMs;
+
+        if (const AsyncComputeStats* compute = perf.getAsyncComputeStats())
+        {
+            counters.asyncComputeMs = compute->computeMs;
+        }
+
+        if (const LightGridStats* lights = perf.getLightGridStats())
+        {
+            counters.lightGridMs = lights->buildMs + lights->assignMs;
+        }
+
+        if (const StreamingStats* streaming = perf.getStreamingStats())
+        {
+            counters.pendingCells = streaming->pendingCells;
+        }
+
+        const uint32_t allocationCount = vulkanDevice->getAllocationCount();
+        const uint64_t allocatedBytes = vulkanDevice->getAllocatedBytes();
+        counters.allocations = allocationCount - lastAllocationCount;
+        counters.allocatedBytes = allocatedBytes - lastAllocatedBytes;
+        lastAllocationCount = allocationCount;
+        lastAllocatedBytes = allocatedBytes;
+
+        return (counters);
+    };
+
+    std::vector<float> benchFrameMs;
+    uint32_t benchFrameIndex = 0;
+    FrameTraceMarks traceMarks {};
 
     Camera camera;
     GameObject viewerObject = GameObject::create();
@@ -151,8 +711,6 @@ void VulkanApplication::run()
     std::chrono::time_point<std::chrono::high_resolution_clock> currentTime = 
         std::chrono::high_resolution_clock::now();
 
-    editorUI.setPerf(&renderer->getPerf());
-
     while (!editorUI.getWindow().shouldClose())
     {
         glfwPollEvents();
@@ -168,12 +726,32 @@ void VulkanApplication::run()
         float aspect = renderer->getAspectRatio();
         camera.setPerspectiveProjection(glm::radians(50.f), aspect, 0.1f, 100.f);
 
+        traceMarks.acquire = std::chrono::steady_clock::now();
+
         if (VkCommandBuffer commandBuffer = renderer->beginFrame()) 
         {
             int frameIndex = renderer->getFrameIndex();
+            traceMarks.update = std::chrono::steady_clock::now();
+
+            const GpuFrameSpan* gpuFrame = renderer->getPerf().getLastGpuFrame();
+
+            if (hitchDetector && gpuFrame)
+            {
+                hitchDetector->addGpuFrame(*gpuFrame);
+            }
 
-            renderer->getPerf().beginCpuFrame();
-            renderer->getPerf().recordGpu(commandBuffer, static_cast<uint32_t>(frameIndex));
+            if (frameTrace)
+            {
+                if (gpuFrame)
+                {
+                    frameTrace->addGpuFrame(*gpuFrame);
+                }
+
+                if (frameTrace->isComplete())
+                {
+                    finishTrace();
+                }
+            }
 
             FrameInfo frameInfo{
                 frameIndex,
@@ -183,20 +761,68 @@ void VulkanApplication::run()
                 globalDescriptorSets[frameIndex],
                 gameObjects};
 
+            qualityGovernor.setLocked(qualityLocked);
+
+            if (qualityGovernor.update(renderer->getPerf(), frameTime))
+            {
+                applyQualityKnobs();
+            }
+
             GlobalUbo ubo;
             ubo.projection = camera.getProjectionMatrix();
             ubo.view = camera.getViewMatrix();
             ubo.inverseView = camera.getInverseViewMatrix();
+            ubo.viewProjections[0] = ubo.projection * ubo.view;
 
-            pointLightSystem.update(frameInfo, ubo);
+            pointLightSystem->update(frameInfo, ubo);
             uboBuffers[frameIndex]->writeToBuffer(&ubo);
             uboBuffers[frameIndex]->flush();
 
+            // Pases sólo de cómputo: en la cola asíncrona se solapan con el render del
+            // frame anterior y el envío de gráficos de este frame espera a su semáforo.
+            VkCommandBuffer computeCommandBuffer = 
+                asyncCompute->begin(static_cast<uint32_t>(frameIndex), renderer->getPerf());
+            frameInfo.computeCommandBuffer = 
+                (computeCommandBuffer != VK_NULL_HANDLE) ? computeCommandBuffer : commandBuffer;
+
+            particleSystem->update(frameInfo);
+
+            if (computeCommandBuffer != VK_NULL_HANDLE)
+            {
+                renderer->setFrameWait(asyncCompute->submit(static_cast<uint32_t>(frameIndex)));
+            }
+
+            renderer->getPerf().setAsyncComputeStats(asyncCompute->getStats());
+
+            skinningSystem->update(frameInfo);
+            terrain->update(frameInfo);
+            worldStreamer->update(frameInfo);
+            impostorSystem->update(frameInfo);
+            lightGrid->update(frameInfo);
+
+            if (options.probeLighting)
+            {
+                probeGrid->update(frameInfo, lightGrid->getDynamicLightCount());
+            }
+            renderer->getPerf().setStreamingStats(worldStreamer->getStats());
+            renderer->getPerf().setLightGridStats(lightGrid->getStats());
+
+            if (multiViewPass)
+            {
+                multiViewPass->render(frameInfo, ubo);
+            }
+
+            traceMarks.record = std::chrono::steady_clock::now();
             renderer->beginSwapChainRenderPass(commandBuffer);
 
             editorUI.beginFrame();
             editorUI.drawGameObjects(gameObjects);
 
+            if (editorUI.getDebugView() != basicRenderer->getDebugView())
+            {
+                basicRenderer->setDebugView(editorUI.getDebugView());
+            }
+
             /// Una hebra
             //basicRenderer.render(frameInfo);
 
@@ -208,14 +834,9 @@ void VulkanApplication::run()
             inherit.subpass = 0;
             inherit.framebuffer = renderer->getCurrentFrameBuffer();
 
-            std::vector<std::pair<unsigned, GameObject*>> view; view.reserve(gameObjects.size());
+            basicRenderer->prepareRecording(frameInfo);
 
-            for (auto& go : gameObjects)
-            {
-                view.push_back({go.first, &go.second });
-            }
-
-            const size_t N = view.size();
+            const size_t N = basicRenderer->getRecordCount();
             const size_t chunk = (N + M - 1)/M;
 
             std::vector<std::thread> threads;
@@ -231,7 +852,7 @@ void VulkanApplication::run()
                     break;
                 }
 
-                VkCommandBuffer cbSec = workers[t].sec[frameIndex];
+                VkCommandBuffer cbSec = workers[t].secondary[frameIndex];
 
                 VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
                 bi.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | 
@@ -240,9 +861,14 @@ void VulkanApplication::run()
                 bi.pInheritanceInfo = &inherit;
                 vkBeginCommandBuffer(cbSec, &bi);
 
-                threads.emplace_back([&, cbSec, begin, end] 
+                threads.emplace_back([&, cbSec, begin, end, t] 
                 {
-                    basicRenderer.recordRange(frameInfo, cbSec, begin, end);
+                    if (!threadPlan.recording.empty())
+                    {
+                        ThreadTopology::pinCurrentThread({threadPlan.recording[t % threadPlan.recording.size()]});
+                    }
+
+                    basicRenderer->recordRange(frameInfo, cbSec, begin, end);
                     vkEndCommandBuffer(cbSec);
                 });
             }
@@ -256,7 +882,7 @@ void VulkanApplication::run()
 
             for (int t = 0; t < (int)threads.size(); ++t) 
             {
-                execList.push_back(workers[t].sec[frameIndex]);
+                execList.push_back(workers[t].secondary[frameIndex]);
             }
 
             if (!execList.empty())
@@ -264,31 +890,177 @@ void VulkanApplication::run()
                 vkCmdExecuteCommands(commandBuffer, (uint32_t)execList.size(), execList.data());
             }
 
-            pointLightSystem.render(frameInfo);
+            // El mapa de overdraw sólo cuenta la geometría de BasicRenderer.
+            if (basicRenderer->getDebugView() != DebugView::Overdraw)
+            {
+                terrain->render(frameInfo);
+                impostorSystem->render(frameInfo);
+            }
+
+            basicRenderer->renderBounds(frameInfo);
+            pointLightSystem->render(frameInfo);
+            particleSystem->render(frameInfo);
 
             editorUI.endFrame(commandBuffer);
 
             renderer->endSwapChainRenderPass(commandBuffer);
-            renderer->getPerf().recordGpu(commandBuffer, static_cast<uint32_t>(frameIndex));
+
+            const uint64_t frameSerial = renderer->getPerf().getFrameSerial();
+            traceMarks.submit = std::chrono::steady_clock::now();
             renderer->endFrame();
+            traceMarks.end = std::chrono::steady_clock::now();
+
+            benchFrameIndex += 1;
+
+            const TraceCounters counters = sampleCounters();
+
+            if (frameTrace && benchFrameIndex > BENCH_WARMUP_FRAMES)
+            {
+                frameTrace->addFrame(frameSerial, traceMarks, counters);
+            }
+
+            if (hitchDetector && hitchDetector->addFrame(frameSerial, traceMarks, counters, hitches))
+            {
+                for (const HitchRecord& hitch : hitches)
+                {
+                    renderer->getPerf().recordHitch(hitch);
+
+                    std::cout << "[hitch] frame " << hitch.serial << ": " << std::fixed
+                        << std::setprecision(2) << hitch.frameMs << " ms > " << hitch.thresholdMs
+                        << " ms -> " << (hitch.tracePath.empty() ? "(rate-limited)" : hitch.tracePath)
+                        << std::defaultfloat << '\n';
+                }
+            }
+
+            if (metricsExporter)
+            {
+                metricsExporter->publish(renderer->getPerf(), benchFrameIndex);
+            }
 
-            renderer->getPerf().endCpuFrame();
-            renderer->getPerf().resolveGpu(static_cast<uint32_t>(frameIndex));
-            renderer->getPerf().tickMonitors();
+            if (!options.capturePath.empty() && benchFrameIndex == BENCH_WARMUP_FRAMES)
+            {
+                vulkanDevice->waitIdle();
+
+                const FrameCapture capture =
+                    FrameCapture::capture(frameInfo, ubo, basicRenderer->isHalfPrecision());
+
+                capture.save(options.capturePath);
+
+                std::cout << "[capture] " << capture.getDrawCount() << " draws, "
+                    << capture.getModels().size() << " meshes, " << capture.getObjects().size()
+                    << " objects -> " << options.capturePath << '\n';
+                break;
+            }
+
+            if (options.benchFrames > 0)
+            {
+                if (benchFrameIndex > BENCH_WARMUP_FRAMES)
+                {
+                    benchFrameMs.push_back(frameTime * 1000.0f);
+                }
+
+                if (benchFrameMs.size() >= options.benchFrames)
+                {
+                    threadTopology.print(threadPlan, std::cout);
+                    std::cout << "[threads] policy: " << ThreadTopology::policyName(options.affinity) << '\n';
+                    printFrameTimes(benchFrameMs, std::cout);
+                    std::cout << "[quality] level " << qualityGovernor.getLevel() << '/'
+                        << (qualityGovernor.getSettings().levels - 1)
+                        << (qualityGovernor.isLocked() ? " (locked)" : "") << ", "
+                        << renderer->getPerf().getQualityDecisionCount() << " decisions\n";
+
+                    const AsyncComputeStats& compute = asyncCompute->getStats();
+                    std::cout << "[async-compute] " << (compute.enabled ? "on" : "off");
+
+                    if (compute.enabled)
+                    {
+                        std::cout << std::fixed << std::setprecision(3) << ", compute " << compute.computeMs
+                            << " ms, overlap " << compute.overlapMs << " ms ("
+                            << std::setprecision(0) << compute.overlapRatio * 100.0f << "%)";
+                    }
+
+                    std::cout << '\n';
+
+                    const PerfStats& perfStats = renderer->getPerf().stats();
+                    const double classified = double(std::max<uint64_t>(
+                        perfStats.boundFrames[0] + perfStats.boundFrames[1] + perfStats.boundFrames[2], 1));
+
+                    std::cout << std::fixed << std::setprecision(1) << "[bound] CPU "
+                        << 100.0 * double(perfStats.boundFrames[0]) / classified << "%, GPU "
+                        << 100.0 * double(perfStats.boundFrames[1]) / classified << "%, present "
+                        << 100.0 * double(perfStats.boundFrames[2]) / classified << "% of frames\n";
+
+                    if (multiViewPass)
+                    {
+                        const MultiViewStats& multiView = multiViewPass->getStats();
+                        std::cout << "[multiview] " << MultiViewPass::modeName(options.multiView) << ", "
+                            << multiView.views << " views, " << (multiView.multiview ? "single pass" : "one pass per view")
+                            << ", " << multiView.draws << " draws, " << multiView.culled << " culled, "
+                            << std::setprecision(3) << multiView.recordMs << " ms\n";
+                    }
+
+                    if (basicRenderer->supportsHalfPrecision())
+                    {
+                        vulkanDevice->waitIdle();
+
+                        PrecisionBench precisionBench(
+                            *vulkanDevice,
+                            renderer->getSwapChainImageFormat(),
+                            renderer->getSwapChainDepthFormat(),
+                            renderer->getSwapChainExtent());
+
+                        PrecisionBench::print(precisionBench.run(*basicRenderer, frameInfo), std::cout);
+                    }
+                    else
+                    {
+                        std::cout << "[fp16] unsupported, fp32 shading path\n";
+                    }
+
+                    break;
+                }
+            }
+
+            if (!startupTimeline.hasFirstFrame())
+            {
+                startupTimeline.markFirstFrame();
+
+                if (options.benchStartup)
+                {
+                    startupTimeline.print(std::cout);
+                    break;
+                }
+            }
         }
     }
 
-    vkDeviceWaitIdle(vulkanDevice->getDevice());
+    vulkanDevice->waitIdle();
+
+    // Si la aplicación termina antes de completar la traza se escribe lo grabado.
+    if (frameTrace && !frameTrace->getFrames().empty())
+    {
+        finishTrace();
+    }
 
     editorUI.cleanup(vulkanDevice->getDevice());
 }
 
+/// \brief Aplica a los sistemas de render los parámetros del nivel de calidad actual.
+void VulkanApplication::applyQualityKnobs()
+{
+    const QualityKnobs& knobs = qualityGovernor.getKnobs();
+
+    impostorSystem->getSettings().switchDistance = impostorSwitchDistance * knobs.lodBias;
+    pointLightSystem->setMaxShadedLights(knobs.maxShadedLights);
+    lightGrid->setMaxLightsPerObject(knobs.maxShadedLights);
+    editorUI.setRefreshInterval(knobs.uiRefreshInterval);
+}
+
 /// \brief Carga y registra los \c GameObject de la escena.
 /// \details Construye la geometría y las luces necesarias para
 /// validar el motor, añadiéndolas al contenedor \c gameObjects .
 void VulkanApplication::loadGameObjects() 
 {
-    std::shared_ptr<Model> model = Model::fromFile(*vulkanDevice, "models/room.obj");
+    std::shared_ptr<Model> model = models.at("models/room.obj");
 
     Model::Builder builder;
     builder.vertices = 
@@ -382,6 +1154,7 @@ void VulkanApplication::loadGameObjects()
     room.transform.scale = {0.5f, 0.5f, 0.5f};
     room.transform.rotation =  {glm::pi<float>(), 0.0f, 0.0f};
     room.transform.translation = {0.0f, 0.5f, 0.0f};
+    room.staticGeometry = true;
     gameObjects.emplace(room.getId(), std::move(room));
 
     std::vector<glm::vec3> lightColors = 
@@ -447,3 +1220,117 @@ void VulkanApplication::loadGameObjects()
     }
 }
 
+/// \brief Hornea las luces de la escena en la geometría estática.
+/// \details Lee de la GPU las mallas marcadas con \c staticGeometry, hornea con
+/// \c LightBaker la luz de todas las luces puntuales (que quedan fijas y sólo iluminan
+/// en ejecución a los objetos dinámicos) y sustituye cada malla por una copia con la
+/// irradiancia horneada.
+/// Con \c probeLighting hornea también la parte estática de las sondas.
+void VulkanApplication::bakeStaticLighting()
+{
+    LightBaker baker(options.bake);
+
+    for (std::pair<const unsigned int, GameObject>& kv : gameObjects)
+    {
+        GameObject& obj = kv.second;
+
+        if (obj.light == nullptr)
+        {
+            continue;
+        }
+
+        // Mismo alcance con el que LightGrid recorta las luces en ejecución.
+        BakeLight light {};
+        light.position = obj.transform.translation;
+        light.color = obj.color;
+        light.intensity = std::max(obj.light->intensity, 0.0f);
+        light.range = std::sqrt(light.intensity / lightGrid->getSettings().influenceCutoff);
+
+        baker.addLight(light);
+        obj.light->baked = true;
+    }
+
+    std::vector<GameObject*> objects;
+
+    for (std::pair<const unsigned int, GameObject>& kv : gameObjects)
+    {
+        if (kv.second.staticGeometry && kv.second.model != nullptr)
+        {
+            objects.push_back(&kv.second);
+        }
+    }
+
+    std::vector<Model::Builder> builders(objects.size());
+    std::vector<BakeTarget> targets(objects.size());
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        objects[i]->model->readBack(builders[i]);
+        targets[i].builder = &builders[i];
+        targets[i].transform = objects[i]->transform.matrix();
+    }
+
+    baker.bake(targets, std::cout);
+
+    // Las sondas reciben las luces horneadas con sombras y un rebote; en ejecución
+    // probe_update.comp sólo les suma las dinámicas.
+    if (options.probeLighting)
+    {
+        static_assert(LightBaker::PROBE_COEFFICIENTS == ProbeGrid::COEFFICIENTS);
+
+        std::vector<glm::vec4> coefficients;
+        baker.bakeProbes(
+            probeGrid->getOrigin(), probeGrid->getSpacing(), probeGrid->getResolution(), coefficients, std::cout);
+        probeGrid->setBaked(coefficients);
+    }
+
+    // Una copia por objeto: la misma malla puede compartirse con transformaciones distintas.
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        objects[i]->model = std::make_shared<Model>(*vulkanDevice, builders[i]);
+    }
+
+    LightBaker::print(baker.getStats(), std::cout);
+}
+
+/// \brief Ajusta la rejilla de sondas a la caja de la geometría estática.
+/// \details Lee de la GPU los vértices de los objetos con \c staticGeometry; si no
+/// hay ninguno se mantiene la caja de \c ProbeGridSettings.
+void VulkanApplication::fitProbeGrid()
+{
+    glm::vec3 boundsMin {std::numeric_limits<float>::max()};
+    glm::vec3 boundsMax {-std::numeric_limits<float>::max()};
+    bool found = false;
+
+    for (std::pair<const unsigned int, GameObject>& kv : gameObjects)
+    {
+        GameObject& obj = kv.second;
+
+        if (!obj.staticGeometry || obj.model == nullptr)
+        {
+            continue;
+        }
+
+        Model::Builder builder;
+        obj.model->readBack(builder);
+
+        const glm::mat4 transform = obj.transform.matrix();
+
+        for (const Model::Vertex& vertex : builder.vertices)
+        {
+            const glm::vec3 position = glm::vec3(transform * glm::vec4(vertex.position, 1.0f));
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        probeGrid->setBounds(boundsMin, boundsMax);
+    }
+
+    std::cout << "[probes] " << probeGrid->getProbeCount() << " probes, spacing "
+        << probeGrid->getSpacing().x << " x " << probeGrid->getSpacing().y << " x " << probeGrid->getSpacing().z << '\n';
+}
+
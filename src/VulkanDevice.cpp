@@ -12,9 +12,12 @@
 #include <unordered_set>
 #include <set>
 
- /// \brief Callback de validación de Vulkan (Debug Utils).
- /// \details Recibe los mensajes del validador de Vulkan y los escribe en stderr.
- /// Devuelve \c VK_FALSE para indicar que la llamada no debe interrumpir la ejecución.
+ /// Versión de Vulkan solicitada a la instancia; el perfil del dispositivo se limita a ella.
+static constexpr uint32_t INSTANCE_API_VERSION = VK_API_VERSION_1_3;
+
+/// \brief Callback de validación de Vulkan (Debug Utils).
+/// \details Recibe los mensajes del validador de Vulkan y los escribe en stderr.
+/// Devuelve \c VK_FALSE para indicar que la llamada no debe interrumpir la ejecución.
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
     VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -107,7 +110,7 @@ void VulkanDevice::createInstance()
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "Vulkan Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = INSTANCE_API_VERSION;
 
     VkInstanceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -198,16 +201,26 @@ void VulkanDevice::selectPhysicalDevice()
 
     vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
     std::cout << "[Vulkan API] Selected GPU: " << deviceProperties.deviceName << std::endl;
+
+    queueFamilies = findQueueFamilies(physicalDevice);
+    swapChainSupport = querySwapChainSupport(physicalDevice);
+    capabilities = DeviceCapabilities::query(physicalDevice, INSTANCE_API_VERSION);
+    capabilities.print(std::cout);
 }
 
 /// \brief Crea el dispositivo lógico y obtiene colas de gráficos y presentación.
 void VulkanDevice::createLogicalDevice() 
 {
-    QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+    const QueueFamilyIndices& indices = queueFamilies;
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
 
+    if (hasAsyncCompute())
+    {
+        uniqueQueueFamilies.insert(indices.computeFamily);
+    }
+
     float queuePriority = 1.0f;
 
     for (uint32_t queueFamily : uniqueQueueFamilies) 
@@ -220,16 +233,25 @@ void VulkanDevice::createLogicalDevice()
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures {};
-    deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // Se habilitan todas las características opcionales soportadas; cada subsistema
+    // consulta getCapabilities() para elegir su camino.
+    const DeviceFeatureChain features(capabilities);
+
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+
+    if (capabilities.calibratedTimestamps)
+    {
+        enabledExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+    }
 
     VkDeviceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.pEnabledFeatures = nullptr;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
+    createInfo.pNext = features.head();
 
     if (enableValidationLayers) 
     {
@@ -248,6 +270,11 @@ void VulkanDevice::createLogicalDevice()
 
     vkGetDeviceQueue(logicalDevice, indices.graphicsFamily, 0, &graphicsQueue);
     vkGetDeviceQueue(logicalDevice, indices.presentFamily, 0, &presentQueue);
+
+    if (hasAsyncCompute())
+    {
+        vkGetDeviceQueue(logicalDevice, indices.computeFamily, 0, &computeQueue);
+    }
 }
 
 /// \brief Crea el command pool principal.
@@ -378,6 +405,22 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) cons
         }
     }
 
+    // Una familia sólo de cómputo suele corresponder a colas de hardware
+    // independientes, capaces de avanzar mientras la de gráficos rasteriza.
+    for (uint32_t i = 0; i < queueFamilies.size(); ++i)
+    {
+        const VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+        if (queueFamilies[i].queueCount > 0 && 
+            (flags & VK_QUEUE_COMPUTE_BIT) && 
+            !(flags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            indices.computeFamily = i;
+            indices.hasComputeFamily = true;
+            break;
+        }
+    }
+
     return (indices);
 }
 
@@ -491,6 +534,18 @@ SwapChainSupportDetails VulkanDevice::querySwapChainSupport(VkPhysicalDevice dev
     return (details);
 }
 
+/// \brief Devuelve el soporte de swapchain del dispositivo físico actual.
+/// \details Formatos y modos de presentación se consultan una vez al elegir el
+/// dispositivo; sólo las capacidades de la surface (que cambian con el tamaño de
+/// la ventana) se vuelven a consultar en cada llamada.
+SwapChainSupportDetails VulkanDevice::getSwapChainSupportDetails() const
+{
+    SwapChainSupportDetails details = swapChainSupport;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &details.capabilities);
+
+    return (details);
+}
+
 /// \brief Busca un tipo de memoria de dispositivo que cumpla las propiedades requeridas.
 /// \param typeFilter Máscara de tipos aceptables.
 /// \param properties Propiedades de memoria requeridas.
@@ -546,6 +601,9 @@ VkFormat VulkanDevice::findSupportedFormat(
 }
 
 /// \brief Crea un VkBuffer y asigna su memoria en el dispositivo.
+/// \details Con cómputo asíncrono los búferes de almacenamiento se comparten entre
+/// las familias de gráficos y de cómputo (\c VK_SHARING_MODE_CONCURRENT), de modo
+/// que no hacen falta transferencias de propiedad entre colas.
 /// \param size Tamaño del búfer.
 /// \param usage Flags de uso del búfer.
 /// \param properties Propiedades de la memoria requerida.
@@ -565,6 +623,15 @@ void VulkanDevice::createBuffer(
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    const uint32_t sharedFamilies[] = {queueFamilies.graphicsFamily, queueFamilies.computeFamily};
+
+    if (hasAsyncCompute() && (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = sharedFamilies;
+    }
+
     if (vkCreateBuffer(logicalDevice, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) 
     {
         throw std::runtime_error("💥[Vulkan API] Failed to create buffer.");
@@ -583,6 +650,9 @@ void VulkanDevice::createBuffer(
         throw std::runtime_error("💥[Vulkan API] Failed to allocate buffer memory.");
     }
 
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(memRequirements.size, std::memory_order_relaxed);
+
     vkBindBufferMemory(logicalDevice, buffer, bufferMemory, 0);
 }
 
@@ -617,21 +687,82 @@ void VulkanDevice::endSingleUseCommands(VkCommandBuffer commandBuffer) {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    VkFenceCreateInfo fenceInfo {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkFence fence;
+
+    if (vkCreateFence(logicalDevice, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("💥[Vulkan API] Failed to create single-use fence.");
+    }
+
+    // Se espera sólo a este envío (no a toda la cola) para no bloquear a
+    // otras hebras que estén subiendo recursos o enviando el frame.
+    submitGraphics(1, &submitInfo, fence);
+    vkWaitForFences(logicalDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence(logicalDevice, fence, nullptr);
 
     vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
 }
 
+/// \brief Envía trabajo a la cola de gráficos serializando el acceso a la cola.
+/// \param submitCount Número de estructuras de envío.
+/// \param submits Estructuras de envío.
+/// \param fence Fence a señalizar al terminar (puede ser \c VK_NULL_HANDLE).
+/// \return Resultado de \c vkQueueSubmit.
+VkResult VulkanDevice::submitGraphics(uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return (vkQueueSubmit(graphicsQueue, submitCount, submits, fence));
+}
+
+/// \brief Envía trabajo a la cola de cómputo asíncrono serializando su acceso.
+/// \param submitCount Número de estructuras de envío.
+/// \param submits Estructuras de envío.
+/// \param fence Fence a señalizar al terminar (puede ser \c VK_NULL_HANDLE).
+/// \return Resultado de \c vkQueueSubmit.
+VkResult VulkanDevice::submitCompute(uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence)
+{
+    std::lock_guard<std::mutex> lock(computeQueueMutex);
+    return (vkQueueSubmit(computeQueue, submitCount, submits, fence));
+}
+
+/// \brief Presenta una imagen serializando el acceso a la cola de presentación.
+/// \param presentInfo Información de presentación.
+/// \return Resultado de \c vkQueuePresentKHR.
+VkResult VulkanDevice::present(const VkPresentInfoKHR& presentInfo)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return (vkQueuePresentKHR(presentQueue, &presentInfo));
+}
+
+/// \brief Espera a que el dispositivo quede inactivo sin competir con otros envíos.
+void VulkanDevice::waitIdle()
+{
+    std::scoped_lock lock(queueMutex, computeQueueMutex);
+    vkDeviceWaitIdle(logicalDevice);
+}
+
 /// \brief Copia datos entre búferes con un comando inmediato.
 /// \param srcBuffer Origen.
 /// \param dstBuffer Destino.
 /// \param size Tamaño de la copia.
-void VulkanDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) 
+/// \param srcOffset Desplazamiento en el origen.
+/// \param dstOffset Desplazamiento en el destino.
+void VulkanDevice::copyBuffer(
+    VkBuffer srcBuffer,
+    VkBuffer dstBuffer,
+    VkDeviceSize size,
+    VkDeviceSize srcOffset,
+    VkDeviceSize dstOffset)
 {
+    std::lock_guard<std::mutex> lock(singleUseMutex);
     VkCommandBuffer commandBuffer = beginSingleUseCommands();
 
     VkBufferCopy copyRegion {};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = dstOffset;
     copyRegion.size = size;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
@@ -651,6 +782,7 @@ void VulkanDevice::copyBufferToImage(
     uint32_t height, 
     uint32_t layerCount) 
 {
+    std::lock_guard<std::mutex> lock(singleUseMutex);
     VkCommandBuffer commandBuffer = beginSingleUseCommands();
 
     VkBufferImageCopy region {};
@@ -707,6 +839,9 @@ void VulkanDevice::createImageWithInfo(
         throw std::runtime_error("💥[Vulkan API] Failed to allocate image memory.");
     }
 
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(memRequirements.size, std::memory_order_relaxed);
+
     if (vkBindImageMemory(logicalDevice, image, imageMemory, 0) != VK_SUCCESS) 
     {
         throw std::runtime_error("💥[Vulkan API] Failed to bind image memory.");
@@ -15,7 +15,8 @@
  /// \param w Anchura inicial en píxeles.
  /// \param h Altura inicial en píxeles.
  /// \param name Título de la ventana.
-Window::Window(int w, int h, std::string name) : width{w}, height{h}, windowName{name} 
+ /// \param visible Si es \c false la ventana se crea oculta (ejecuciones sin interfaz).
+Window::Window(int w, int h, std::string name, bool visible) : width{w}, height{h}, windowName{name}, visible{visible} 
 {
   initWindow();
 }
@@ -33,6 +34,7 @@ void Window::initWindow()
   glfwInit();
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
   glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+  glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
   window = glfwCreateWindow(width, height, windowName.c_str(), nullptr, nullptr);
   glfwSetWindowUserPointer(window, this);
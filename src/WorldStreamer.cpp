@@ -0,0 +1,706 @@
+﻿/*
+ * Project: VulkanAPI
+ * File: WorldStreamer.cpp
+ * Author: Santiago Carbó García
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "WorldStreamer.hpp"
+#include "SwapChain.hpp"
+#include "ThreadTopology.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+/// Rocas generadas en cada celda sin fichero.
+static constexpr uint32_t ROCKS_PER_CELL = 6;
+
+/// Desplazamiento máximo de las esquinas de la roca respecto al cubo unidad.
+static constexpr float ROCK_JITTER = 0.35f;
+
+/// Esquinas (bits x, y, z) de cada cara del cubo, en el mismo orden que el cubo de la escena.
+static constexpr uint32_t ROCK_FACES[6][4] =
+{
+    {1, 3, 7, 5},
+    {4, 6, 2, 0},
+    {2, 6, 7, 3},
+    {4, 0, 1, 5},
+    {4, 5, 7, 6},
+    {1, 0, 2, 3}
+};
+
+/// Normal nominal de cada cara de \c ROCK_FACES.
+static constexpr float ROCK_AXES[6][3] =
+{
+    {+1, 0, 0}, {-1, 0, 0}, {0, +1, 0}, {0, -1, 0}, {0, 0, +1}, {0, 0, -1}
+};
+
+/// \brief Hash entero de una celda y una semilla a [0, 1).
+static float cellHash(int32_t x, int32_t z, uint32_t salt)
+{
+    uint32_t h = static_cast<uint32_t>(x) * 2246822519u ^ static_cast<uint32_t>(z) * 3266489917u ^
+        salt * 668265263u;
+    h = (h ^ (h >> 15)) * 2246822519u;
+    h = (h ^ (h >> 13)) * 3266489917u;
+    h ^= h >> 16;
+
+    return (static_cast<float>(h) * (1.0f / 4294967296.0f));
+}
+
+/// \brief Lanza las hebras de carga.
+/// \param device Dispositivo lógico Vulkan.
+/// \param groundHeight Altura del suelo (debe poder llamarse desde cualquier hebra).
+/// \param settings Parámetros del streaming.
+WorldStreamer::WorldStreamer(
+    VulkanDevice& device,
+    GroundFunction groundHeight,
+    const WorldStreamerSettings& settings)
+    : vulkanDevice {device},
+    groundHeight {std::move(groundHeight)},
+    settings {settings}
+{
+    const uint32_t workerCount = std::max(1u, settings.workerCount);
+    workers.reserve(workerCount);
+
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(&WorldStreamer::workerLoop, this);
+    }
+}
+
+/// \brief Detiene las hebras de carga y libera las celdas.
+WorldStreamer::~WorldStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+
+    queueCondition.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/// \brief Planifica cargas y descargas e inserta las celdas ya cargadas.
+/// \details Debe llamarse fuera del render pass y antes de grabar la escena:
+/// añade y elimina entradas de \c frameInfo.gameObjects y graba en
+/// \c frameInfo.commandBuffer las copias de las mallas insertadas.
+/// \param frameInfo Contexto del frame.
+void WorldStreamer::update(FrameInfo& frameInfo)
+{
+    frameCounter += 1;
+
+    // Los command buffers de hace MAX_FRAMES_IN_FLIGHT frames ya han terminado
+    // (beginFrame espera a su fence), así que lo retirado entonces puede liberarse.
+    while (!retired.empty() && frameCounter - retired.front().frame >= SwapChain::MAX_FRAMES_IN_FLIGHT)
+    {
+        Retired& entry = retired.front();
+
+        if (entry.stagingOnly)
+        {
+            for (const std::shared_ptr<Model>& model : entry.models)
+            {
+                model->releaseStaging();
+            }
+        }
+
+        hostBytes -= entry.hostBytes;
+        retired.pop_front();
+    }
+
+    const glm::vec3 position = frameInfo.camera.getPosition();
+
+    if (hasLastPosition && frameInfo.frameTime > 0.0f)
+    {
+        velocity = glm::mix(velocity, (position - lastPosition) / frameInfo.frameTime, 0.1f);
+    }
+
+    lastPosition = position;
+    hasLastPosition = true;
+
+    const glm::vec2 viewer {position.x, position.z};
+    const glm::vec2 planarVelocity {velocity.x, velocity.z};
+    const float speed = glm::length(planarVelocity);
+    const glm::vec2 heading = (speed > 0.1f) ? planarVelocity / speed : glm::vec2(0.0f);
+    const glm::vec2 predicted = viewer + planarVelocity * settings.lookAheadSeconds;
+
+    auto cellCenter = [this](CellKey key)
+    {
+        return (glm::vec2(keyX(key) + 0.5f, keyZ(key) + 0.5f) * settings.cellSize);
+    };
+
+    // Distancia a la posición actual o a la prevista, la menor: una celda que la
+    // cámara va a alcanzar no se descarta aunque aún esté lejos.
+    auto reach = [&](CellKey key)
+    {
+        const glm::vec2 center = cellCenter(key);
+        return (std::min(glm::length(center - viewer), glm::length(center - predicted)));
+    };
+
+    // Las celdas en la dirección de avance cuentan hasta la mitad de su distancia.
+    auto priorityOf = [&](CellKey key)
+    {
+        const glm::vec2 offset = cellCenter(key) - viewer;
+        const float distance = glm::length(offset);
+        const float alignment = (distance > 0.0f) ? glm::dot(offset / distance, heading) : 0.0f;
+
+        return (distance * (1.0f - 0.5f * std::max(alignment, 0.0f)));
+    };
+
+    std::vector<std::unique_ptr<CellPayload>> arrived;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        arrived.swap(completed);
+    }
+
+    for (std::unique_ptr<CellPayload>& payload : arrived)
+    {
+        inFlight -= 1;
+        loadedCellCount += 1;
+        averageCellBytes = (averageCellBytes * (loadedCellCount - 1) + payload->gpuBytes) / loadedCellCount;
+
+        std::unordered_map<CellKey, Cell>::iterator found = cells.find(payload->key);
+
+        // Celda cancelada mientras se cargaba (o duplicada): sus mallas nunca se han usado.
+        if (found == cells.end() || found->second.resident || found->second.payload)
+        {
+            continue;
+        }
+
+        hostBytes += payload->hostBytes;
+        gpuBytes += payload->gpuBytes;
+        found->second.payload = std::move(payload);
+    }
+
+    for (std::unordered_map<CellKey, Cell>::iterator it = cells.begin(); it != cells.end();)
+    {
+        if (reach(it->first) <= settings.unloadRadius)
+        {
+            it->second.priority = priorityOf(it->first);
+            ++it;
+            continue;
+        }
+
+        if (it->second.resident)
+        {
+            evictCell(it->second, frameInfo);
+        }
+        else if (it->second.payload)
+        {
+            discardPayload(it->second);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            std::deque<CellKey>::iterator queued = std::find(requests.begin(), requests.end(), it->first);
+
+            if (queued != requests.end())
+            {
+                requests.erase(queued);
+                inFlight -= 1;
+            }
+        }
+
+        it = cells.erase(it);
+    }
+
+    // Celda residente o cargada menos prioritaria que \c limit (o \c cells.end()).
+    auto findVictim = [this](float limit)
+    {
+        std::unordered_map<CellKey, Cell>::iterator victim = cells.end();
+
+        for (std::unordered_map<CellKey, Cell>::iterator it = cells.begin(); it != cells.end(); ++it)
+        {
+            const Cell& cell = it->second;
+
+            if ((cell.resident || cell.payload) && cell.priority > limit &&
+                (victim == cells.end() || cell.priority > victim->second.priority))
+            {
+                victim = it;
+            }
+        }
+
+        return (victim);
+    };
+
+    auto release = [&](std::unordered_map<CellKey, Cell>::iterator victim)
+    {
+        if (victim->second.resident)
+        {
+            evictCell(victim->second, frameInfo);
+        }
+        else
+        {
+            discardPayload(victim->second);
+        }
+
+        cells.erase(victim);
+    };
+
+    // Si la estimación de las cargas se quedó corta se retiran las celdas menos
+    // prioritarias; quedan fuera de \c cells y no se vuelven a pedir mientras el
+    // presupuesto no lo permita.
+    while (gpuBytes > settings.gpuBudget)
+    {
+        std::unordered_map<CellKey, Cell>::iterator victim = findVictim(-1.0f);
+
+        if (victim == cells.end())
+        {
+            break;
+        }
+
+        release(victim);
+    }
+
+    std::vector<std::pair<float, CellKey>> ready;
+
+    for (const std::pair<const CellKey, Cell>& entry : cells)
+    {
+        if (entry.second.payload)
+        {
+            ready.push_back({entry.second.priority, entry.first});
+        }
+    }
+
+    std::sort(ready.begin(), ready.end());
+
+    const size_t insertCount = std::min<size_t>(ready.size(), settings.maxInsertionsPerFrame);
+
+    for (size_t i = 0; i < insertCount; ++i)
+    {
+        insertCell(cells.at(ready[i].second), frameInfo);
+    }
+
+    if (insertCount > 0)
+    {
+        VkMemoryBarrier barrier {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            frameInfo.commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr);
+    }
+
+    const glm::vec2 low = glm::min(viewer, predicted) - settings.loadRadius;
+    const glm::vec2 high = glm::max(viewer, predicted) + settings.loadRadius;
+    const int32_t minX = static_cast<int32_t>(std::floor(low.x / settings.cellSize));
+    const int32_t maxX = static_cast<int32_t>(std::floor(high.x / settings.cellSize));
+    const int32_t minZ = static_cast<int32_t>(std::floor(low.y / settings.cellSize));
+    const int32_t maxZ = static_cast<int32_t>(std::floor(high.y / settings.cellSize));
+
+    std::vector<std::pair<float, CellKey>> candidates;
+
+    for (int32_t z = minZ; z <= maxZ; ++z)
+    {
+        for (int32_t x = minX; x <= maxX; ++x)
+        {
+            const CellKey key = makeKey(x, z);
+
+            if (cells.count(key) == 0 && reach(key) <= settings.loadRadius)
+            {
+                candidates.push_back({priorityOf(key), key});
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<CellKey> newRequests;
+
+    for (const std::pair<float, CellKey>& candidate : candidates)
+    {
+        if (inFlight + newRequests.size() >= settings.maxInFlight)
+        {
+            break;
+        }
+
+        const uint64_t expected = (inFlight + newRequests.size() + 1) * averageCellBytes;
+
+        // Hueco en GPU: se retiran celdas menos prioritarias que la candidata.
+        while (gpuBytes + expected > settings.gpuBudget)
+        {
+            std::unordered_map<CellKey, Cell>::iterator victim = findVictim(candidate.first);
+
+            if (victim == cells.end())
+            {
+                break;
+            }
+
+            release(victim);
+        }
+
+        // La memoria de CPU es transitoria (staging): si no cabe, se espera a que se libere.
+        if (gpuBytes + expected > settings.gpuBudget || hostBytes + expected > settings.hostBudget)
+        {
+            break;
+        }
+
+        Cell cell {};
+        cell.priority = candidate.first;
+        cells.emplace(candidate.second, std::move(cell));
+        newRequests.push_back(candidate.second);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        requests.insert(requests.end(), newRequests.begin(), newRequests.end());
+
+        std::stable_sort(requests.begin(), requests.end(), [this](CellKey a, CellKey b)
+        {
+            return (cells.at(a).priority < cells.at(b).priority);
+        });
+    }
+
+    inFlight += static_cast<uint32_t>(newRequests.size());
+    queueCondition.notify_all();
+
+    stats.pendingCells = 0;
+    stats.residentCells = 0;
+
+    for (const std::pair<const CellKey, Cell>& entry : cells)
+    {
+        if (entry.second.resident)
+        {
+            stats.residentCells += 1;
+        }
+        else
+        {
+            stats.pendingCells += 1;
+        }
+    }
+
+    stats.hostBytes = hostBytes;
+    stats.hostBudget = settings.hostBudget;
+    stats.gpuBytes = gpuBytes;
+    stats.gpuBudget = settings.gpuBudget;
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const double windowSeconds = std::chrono::duration<double>(now - ioWindowStart).count();
+
+    if (windowSeconds >= 1.0)
+    {
+        const uint64_t totalBytes = ioBytes.load();
+        stats.ioBytesPerSecond = static_cast<double>(totalBytes - ioWindowBytes) / windowSeconds;
+        ioWindowBytes = totalBytes;
+        ioWindowStart = now;
+    }
+}
+
+/// \brief Bucle de una hebra de carga.
+void WorldStreamer::workerLoop()
+{
+    ThreadTopology::pinCurrentThread(settings.workerCpus);
+
+    while (true)
+    {
+        CellKey key = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]
+            {
+                return (stopping || !requests.empty());
+            });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            key = requests.front();
+            requests.pop_front();
+        }
+
+        std::unique_ptr<CellPayload> payload;
+
+        try
+        {
+            payload = loadCell(key);
+        }
+        catch (const std::exception& e)
+        {
+            // Una celda corrupta queda vacía en lugar de reintentarse cada frame.
+            std::cerr << "💥[Vulkan API] World cell " << keyX(key) << "," << keyZ(key) <<
+                " failed to load: " << e.what() << '\n';
+
+            payload = std::make_unique<CellPayload>();
+            payload->key = key;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        completed.push_back(std::move(payload));
+    }
+}
+
+/// \brief Carga una celda desde disco (o la genera) y crea sus mallas.
+/// \param key Celda a cargar.
+/// \return Datos listos para insertar.
+std::unique_ptr<WorldStreamer::CellPayload> WorldStreamer::loadCell(CellKey key)
+{
+    std::unique_ptr<CellPayload> payload = std::make_unique<CellPayload>();
+    payload->key = key;
+
+    std::vector<Model::Builder> builders;
+
+    const std::string path = settings.directory + "/cell_" +
+        std::to_string(keyX(key)) + "_" + std::to_string(keyZ(key)) + ".chunk";
+
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        generateCell(key, builders, payload->placements);
+    }
+    else
+    {
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string text = contents.str();
+        ioBytes += text.size();
+
+        std::unordered_map<std::string, uint32_t> modelIndices;
+        std::istringstream lines(text);
+        std::string line;
+
+        while (std::getline(lines, line))
+        {
+            std::istringstream tokens(line);
+            std::string keyword;
+
+            if (!(tokens >> keyword) || keyword[0] == '#')
+            {
+                continue;
+            }
+
+            if (keyword != "object")
+            {
+                throw std::runtime_error("💥[Vulkan API] Unknown entry '" + keyword + "' in " + path);
+            }
+
+            std::string modelPath;
+            Placement placement {};
+            Transform& transform = placement.transform;
+
+            if (!(tokens >> modelPath >>
+                transform.translation.x >> transform.translation.y >> transform.translation.z >>
+                transform.rotation.x >> transform.rotation.y >> transform.rotation.z >>
+                transform.scale.x >> transform.scale.y >> transform.scale.z))
+            {
+                throw std::runtime_error("💥[Vulkan API] Malformed object entry in " + path);
+            }
+
+            glm::vec3 color {};
+
+            if (tokens >> color.r >> color.g >> color.b)
+            {
+                placement.color = color;
+            }
+
+            std::unordered_map<std::string, uint32_t>::iterator found = modelIndices.find(modelPath);
+
+            if (found == modelIndices.end())
+            {
+                const std::string objPath = "../" + modelPath;
+
+                builders.emplace_back();
+                builders.back().loadFromFile(objPath);
+
+                std::ifstream obj(objPath, std::ios::binary | std::ios::ate);
+                ioBytes += static_cast<uint64_t>(std::max<std::streamoff>(obj.tellg(), 0));
+
+                found = modelIndices.emplace(modelPath, static_cast<uint32_t>(builders.size() - 1)).first;
+            }
+
+            placement.modelIndex = found->second;
+            payload->placements.push_back(placement);
+        }
+    }
+
+    for (const Model::Builder& builder : builders)
+    {
+        std::shared_ptr<Model> model = std::make_shared<Model>(vulkanDevice, builder, 0, true);
+
+        // El staging replica los búferes de dispositivo hasta que se libera.
+        payload->hostBytes += model->getDeviceBytes();
+        payload->gpuBytes += model->getDeviceBytes();
+        payload->models.push_back(std::move(model));
+    }
+
+    payload->hostBytes += payload->placements.size() * sizeof(Placement);
+
+    return (payload);
+}
+
+/// \brief Genera las rocas procedurales de una celda sin fichero.
+/// \param key Celda a generar.
+/// \param builders Salida con la malla de roca.
+/// \param placements Salida con las instancias.
+void WorldStreamer::generateCell(
+    CellKey key,
+    std::vector<Model::Builder>& builders,
+    std::vector<Placement>& placements) const
+{
+    const int32_t cellX = keyX(key);
+    const int32_t cellZ = keyZ(key);
+
+    // Las cuatro celdas que tocan el origen quedan libres para la escena de la aplicación.
+    if (cellX >= -1 && cellX <= 0 && cellZ >= -1 && cellZ <= 0)
+    {
+        return;
+    }
+
+    glm::vec3 corners[8];
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const glm::vec3 jitter {
+            cellHash(cellX, cellZ, 3 * i + 0),
+            cellHash(cellX, cellZ, 3 * i + 1),
+            cellHash(cellX, cellZ, 3 * i + 2)};
+
+        corners[i] = glm::vec3(
+            (i & 1) ? 0.5f : -0.5f,
+            (i & 2) ? 0.5f : -0.5f,
+            (i & 4) ? 0.5f : -0.5f) + (jitter - 0.5f) * ROCK_JITTER;
+    }
+
+    const glm::vec2 uvs[4] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+
+    Model::Builder rock {};
+
+    for (uint32_t face = 0; face < 6; ++face)
+    {
+        const glm::vec3& p0 = corners[ROCK_FACES[face][0]];
+        const glm::vec3& p1 = corners[ROCK_FACES[face][1]];
+        const glm::vec3& p2 = corners[ROCK_FACES[face][2]];
+        const glm::vec3& p3 = corners[ROCK_FACES[face][3]];
+        const glm::vec3 axis {ROCK_AXES[face][0], ROCK_AXES[face][1], ROCK_AXES[face][2]};
+
+        // Normal plana de las dos diagonales, orientada hacia fuera.
+        glm::vec3 normal = glm::normalize(glm::cross(p2 - p0, p3 - p1));
+
+        if (glm::dot(normal, axis) < 0.0f)
+        {
+            normal = -normal;
+        }
+
+        const uint32_t base = static_cast<uint32_t>(rock.vertices.size());
+
+        for (uint32_t corner = 0; corner < 4; ++corner)
+        {
+            rock.vertices.push_back({corners[ROCK_FACES[face][corner]], {1, 1, 1}, normal, uvs[corner]});
+        }
+
+        rock.indices.insert(rock.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    builders.push_back(std::move(rock));
+
+    for (uint32_t i = 0; i < ROCKS_PER_CELL; ++i)
+    {
+        const uint32_t salt = 100 + 8 * i;
+        const float x = (cellX + cellHash(cellX, cellZ, salt + 0)) * settings.cellSize;
+        const float z = (cellZ + cellHash(cellX, cellZ, salt + 1)) * settings.cellSize;
+        const float size = 0.3f + 0.9f * cellHash(cellX, cellZ, salt + 2);
+        const float grey = 0.35f + 0.2f * cellHash(cellX, cellZ, salt + 3);
+
+        Placement placement {};
+        placement.modelIndex = 0;
+        placement.transform.scale = {size, size * (0.6f + 0.4f * cellHash(cellX, cellZ, salt + 4)), size};
+        placement.transform.rotation = {0.0f, cellHash(cellX, cellZ, salt + 5) * glm::two_pi<float>(), 0.0f};
+
+        // -Y es "arriba": el centro queda por encima del suelo y la base algo enterrada.
+        placement.transform.translation = {x, groundHeight(x, z) - 0.35f * placement.transform.scale.y, z};
+        placement.color = {grey, grey * 0.95f, grey * 0.9f};
+        placements.push_back(placement);
+    }
+}
+
+/// \brief Inserta en escena una celda cargada y graba la subida de sus mallas.
+/// \param cell Estado de la celda (con \c payload).
+/// \param frameInfo Contexto del frame.
+void WorldStreamer::insertCell(Cell& cell, FrameInfo& frameInfo)
+{
+    std::unique_ptr<CellPayload> payload = std::move(cell.payload);
+
+    for (const std::shared_ptr<Model>& model : payload->models)
+    {
+        model->recordUpload(frameInfo.commandBuffer);
+    }
+
+    for (const Placement& placement : payload->placements)
+    {
+        GameObject object = GameObject::create();
+        object.model = payload->models[placement.modelIndex];
+        object.transform = placement.transform;
+        object.color = placement.color;
+
+        // Los atlas de impostores se guardan por modelo; las mallas de celdas
+        // entran y salen continuamente y agotarían la caché.
+        object.allowImpostor = false;
+
+        cell.objectIds.push_back(object.getId());
+        frameInfo.gameObjects.emplace(object.getId(), std::move(object));
+    }
+
+    cell.models = payload->models;
+    cell.gpuBytes = payload->gpuBytes;
+    cell.resident = true;
+
+    Retired staging {};
+    staging.frame = frameCounter;
+    staging.models = std::move(payload->models);
+    staging.stagingOnly = true;
+    staging.hostBytes = payload->hostBytes;
+    retired.push_back(std::move(staging));
+}
+
+/// \brief Descarta los datos cargados y aún no insertados de una celda.
+/// \details Sus mallas no se han usado en ningún command buffer, así que se
+/// destruyen de inmediato.
+/// \param cell Celda con \c payload.
+void WorldStreamer::discardPayload(Cell& cell)
+{
+    hostBytes -= cell.payload->hostBytes;
+    gpuBytes -= cell.payload->gpuBytes;
+    cell.payload.reset();
+}
+
+/// \brief Retira de escena una celda residente y programa la destrucción de sus mallas.
+/// \param cell Celda a retirar.
+/// \param frameInfo Contexto del frame.
+void WorldStreamer::evictCell(Cell& cell, FrameInfo& frameInfo)
+{
+    for (unsigned int id : cell.objectIds)
+    {
+        frameInfo.gameObjects.erase(id);
+    }
+
+    gpuBytes -= cell.gpuBytes;
+
+    Retired entry {};
+    entry.frame = frameCounter;
+    entry.models = std::move(cell.models);
+    retired.push_back(std::move(entry));
+
+    cell.objectIds.clear();
+    cell.gpuBytes = 0;
+    cell.resident = false;
+}
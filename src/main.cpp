@@ -6,19 +6,244 @@
  *
  */
 
+#include "AssetIO.hpp"
 #include "VulkanApplication.hpp"
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 /// \brief Punto de entrada de la aplicación.
 /// \details Crea una instancia de \c VulkanApplication y ejecuta su bucle principal con \c run.
 /// Gestiona excepciones de tipo \c std::exception para imprimir un mensaje de error
 /// y devolver un código de salida distinto de cero en caso de fallo.
-int main()
+/// Opciones reconocidas:
+/// - \c --headless: crea la ventana oculta.
+/// - \c --bench-startup: mide el tiempo hasta el primer frame, imprime la línea
+///   temporal de arranque y termina (implica \c --headless).
+/// - \c --serial-startup: ejecuta el arranque en una sola hebra.
+/// - \c --affinity none|performance: política de afinidad de hebras (por defecto
+///   \c performance).
+/// - \c --bench-frames N: mide N frames, imprime la topología de hebras y la
+///   variación del tiempo de frame y termina (implica \c --headless).
+/// - \c --lock-quality: mantiene fijo el nivel del gobernador de calidad.
+/// - \c --frame-budget MS: presupuesto de tiempo de frame del gobernador de calidad
+///   (por defecto 16.67 ms).
+/// - \c --no-async-compute: graba los pases de cómputo en el command buffer de
+///   gráficos aunque haya una cola de cómputo dedicada (referencia para comparar).
+/// - \c --no-fp16: usa los shaders fp32 aunque el dispositivo admita los de media
+///   precisión (\c --bench-frames compara ambas variantes igualmente).
+/// - \c --frustum-culling: descarta en la grabación de \c BasicRenderer los objetos
+///   fuera del frustum de la cámara.
+/// - \c --multiview stereo|cube: dibuja además la escena en dos vistas estéreo o en las
+///   seis caras de un cubo con un único pase multivista (un pase por vista si el
+///   dispositivo no admite \c VK_KHR_multiview).
+/// - \c --capture-frame PATH: guarda en PATH la captura (draws, UBO y mallas) del
+///   primer frame tras el calentamiento y termina (implica \c --headless).
+/// - \c --replay PATH [N]: reproduce N veces (por defecto 1000) la captura PATH sólo
+///   con \c BasicRenderer y \c PointLightSystem, imprime los tiempos de grabación,
+///   envío y GPU y termina (implica \c --headless).
+/// - \c --trace PATH [N]: escribe en PATH una traza conjunta CPU/GPU de N frames (por
+///   defecto 300) en formato Chrome Trace Event, con los timestamps de GPU llevados al
+///   reloj de la CPU (\c VK_EXT_calibrated_timestamps o una estimación), e imprime la
+///   latencia de cola y las burbujas de la GPU.
+/// - \c --metrics-socket PATH: sirve las métricas en vivo (tiempos de frame, esperas de
+///   la swapchain, streaming, cómputo asíncrono, luces y calidad) en formato de texto
+///   de Prometheus por un socket de dominio UNIX (sólo Linux).
+/// - \c --hitch-threshold MS|Nx|off: umbral de frame lento, absoluto en ms o relativo a
+///   la mediana del periodo de frame (por defecto 3x, con un mínimo de 8 ms); con \c off
+///   desactiva la detección. Cada frame lento vuelca la traza de los 3 s anteriores y
+///   los 0,5 s posteriores (como mucho una cada 10 s).
+/// - \c --hitch-dir DIR: directorio de las trazas de frames lentos (por defecto el actual).
+/// - \c --bake-lighting [direct|ao|full]: hornea al arrancar, en varias hebras, las luces
+///   puntuales en los vértices de la geometría estática (luz directa con
+///   sombras, más oclusión ambiental con \c ao y un rebote indirecto con \c full, el valor
+///   por defecto); las luces quedan fijas y en ejecución sólo se sombrean las dinámicas.
+/// - \c --probes [N]: ilumina los objetos dinámicos con una rejilla de sondas SH L2 que
+///   cubre la geometría estática, recalculando N sondas por frame (por defecto 16) en un
+///   pase de cómputo; con \c --bake-lighting las sondas incluyen las luces horneadas.
+/// - \c --bench-recording [N]: mide la grabación multihebra barriendo hebras (1 hasta
+///   \c hardware_concurrency), objetos (1k hasta N, por defecto 1M) y mallas distintas;
+///   imprime tiempos de grabación, espera y \c vkCmdExecuteCommands, el escalado y la
+///   eficiencia, compara después las variantes del bucle de grabación (genérico y
+///   especializado, con y sin culling y enlaces redundantes) y termina (implica
+///   \c --headless).
+/// - \c --bench-io: mide el throughput (MB/s) y las IOPS de \c AssetIO leyendo los
+///   assets del proyecto con cada implementación disponible y termina.
+int main(int argc, char** argv)
 {
+    ApplicationOptions options {};
+    bool benchIo = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            options.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-startup") == 0)
+        {
+            options.benchStartup = true;
+            options.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--serial-startup") == 0)
+        {
+            options.serialStartup = true;
+        }
+        else if (std::strcmp(argv[i], "--affinity") == 0 && i + 1 < argc &&
+            (std::strcmp(argv[i + 1], "none") == 0 || std::strcmp(argv[i + 1], "performance") == 0))
+        {
+            i += 1;
+            options.affinity = (std::strcmp(argv[i], "none") == 0) ?
+                AffinityPolicy::None : AffinityPolicy::Performance;
+        }
+        else if (std::strcmp(argv[i], "--bench-frames") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+        {
+            i += 1;
+            options.benchFrames = static_cast<uint32_t>(std::atoi(argv[i]));
+            options.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-recording") == 0)
+        {
+            options.benchRecordingObjects = 1000000;
+            options.headless = true;
+
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            {
+                i += 1;
+                options.benchRecordingObjects = static_cast<uint32_t>(std::atoi(argv[i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--lock-quality") == 0)
+        {
+            options.lockQuality = true;
+        }
+        else if (std::strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc && std::atof(argv[i + 1]) > 0.0)
+        {
+            i += 1;
+            options.frameBudgetMs = static_cast<float>(std::atof(argv[i]));
+        }
+        else if (std::strcmp(argv[i], "--no-async-compute") == 0)
+        {
+            options.asyncCompute = false;
+        }
+        else if (std::strcmp(argv[i], "--no-fp16") == 0)
+        {
+            options.halfPrecision = false;
+        }
+        else if (std::strcmp(argv[i], "--frustum-culling") == 0)
+        {
+            options.frustumCulling = true;
+        }
+        else if (std::strcmp(argv[i], "--multiview") == 0 && i + 1 < argc &&
+            (std::strcmp(argv[i + 1], "stereo") == 0 || std::strcmp(argv[i + 1], "cube") == 0))
+        {
+            i += 1;
+            options.multiView = (std::strcmp(argv[i], "stereo") == 0) ?
+                MultiViewMode::Stereo : MultiViewMode::Cube;
+        }
+        else if (std::strcmp(argv[i], "--capture-frame") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            options.capturePath = argv[i];
+            options.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            options.replayPath = argv[i];
+            options.headless = true;
+
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            {
+                i += 1;
+                options.replayIterations = static_cast<uint32_t>(std::atoi(argv[i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            options.tracePath = argv[i];
+
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            {
+                i += 1;
+                options.traceFrames = static_cast<uint32_t>(std::atoi(argv[i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            options.metricsSocket = argv[i];
+        }
+        else if (std::strcmp(argv[i], "--hitch-threshold") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            const size_t length = std::strlen(argv[i]);
+
+            if (std::strcmp(argv[i], "off") == 0)
+            {
+                options.hitchDetection = false;
+            }
+            else if (length > 0 && argv[i][length - 1] == 'x')
+            {
+                options.hitch.relativeThreshold = static_cast<float>(std::atof(argv[i]));
+                options.hitch.thresholdMs = 0.0f;
+            }
+            else
+            {
+                options.hitch.thresholdMs = static_cast<float>(std::atof(argv[i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--hitch-dir") == 0 && i + 1 < argc)
+        {
+            i += 1;
+            options.hitch.directory = argv[i];
+        }
+        else if (std::strcmp(argv[i], "--bake-lighting") == 0)
+        {
+            options.bakeLighting = true;
+
+            if (i + 1 < argc && (std::strcmp(argv[i + 1], "direct") == 0 ||
+                std::strcmp(argv[i + 1], "ao") == 0 || std::strcmp(argv[i + 1], "full") == 0))
+            {
+                i += 1;
+                options.bake.ambientOcclusion = (std::strcmp(argv[i], "direct") != 0);
+                options.bake.bounce = (std::strcmp(argv[i], "full") == 0);
+            }
+        }
+        else if (std::strcmp(argv[i], "--probes") == 0)
+        {
+            options.probeLighting = true;
+
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            {
+                i += 1;
+                options.probes.probesPerFrame = static_cast<uint32_t>(std::atoi(argv[i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--bench-io") == 0)
+        {
+            benchIo = true;
+        }
+        else
+        {
+            std::cerr << "💥[Vulkan API] Unknown option: " << argv[i] << '\n';
+
+            return (EXIT_FAILURE);
+        }
+    }
+
     try
     {
-        VulkanApplication app;
+        if (benchIo)
+        {
+            AssetIO::benchmark({"../shaders", "../models", "../world"}, std::cout);
+
+            return (EXIT_SUCCESS);
+        }
+
+        VulkanApplication app(options);
         app.run();
     }
     catch (const std::exception& e)